@@ -23,6 +23,10 @@ build_drivers() {
     make -C ./drivers -f Makefile -j
 }
 
+build_sim() {
+    make -C ./projects/sim_bench run
+}
+
 build_doxygen() {
     sudo apt-get install -y graphviz
     # Install a recent version of doxygen
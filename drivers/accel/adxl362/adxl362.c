@@ -41,7 +41,9 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdlib.h>
+#include <stdbool.h>
 #include "adxl362.h"
+#include "error.h"
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -77,6 +79,9 @@ int32_t adxl362_init(struct adxl362_dev **device,
 		status = -1;
 
 	dev->selected_range = 2; // Measurement Range: +/- 2g (reset default).
+	dev->fifo_watermark = 0x80; // FIFO samples reset default.
+	dev->fifo_temp = 0;
+	dev->fifo_overruns = 0;
 
 	*device = dev;
 
@@ -392,17 +397,137 @@ void adxl362_fifo_setup(struct adxl362_dev *dev,
 {
 	uint8_t write_val = 0;
 
+	/* Bit 8 of the watermark is the AH bit of FIFO_CTL */
 	write_val = ADXL362_FIFO_CTL_FIFO_MODE(mode) |
 		    (en_temp_read * ADXL362_FIFO_CTL_FIFO_TEMP) |
-		    ADXL362_FIFO_CTL_AH;
+		    ((water_mark_lvl & 0x100) ? ADXL362_FIFO_CTL_AH : 0);
 	adxl362_set_register_value(dev,
 				   write_val,
 				   ADXL362_REG_FIFO_CTL,
 				   1);
 	adxl362_set_register_value(dev,
-				   water_mark_lvl,
+				   water_mark_lvl & 0xFF,
 				   ADXL362_REG_FIFO_SAMPLES,
-				   2);
+				   1);
+
+	dev->fifo_watermark = water_mark_lvl;
+	dev->fifo_temp = en_temp_read;
+}
+
+/***************************************************************************//**
+ * @brief Burst reads FIFO entries into a caller owned buffer and decodes them
+ *        in place, using the axis tags. Samples are sign extended and packed
+ *        as complete x, y, z (, temperature) sets. Entries preceding the
+ *        first x-axis entry and incomplete sets are dropped, so the output is
+ *        always aligned.
+ *
+ * @param dev        - The device structure.
+ * @param buf        - Buffer of at least nb_entries + 1 elements. On return
+ *                     it holds the decoded sets.
+ * @param nb_entries - Number of FIFO entries to read (up to 511).
+ * @param nb_sets    - Number of complete sets decoded.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t adxl362_fifo_stream_read(struct adxl362_dev *dev,
+				 int16_t *buf,
+				 uint16_t nb_entries,
+				 uint16_t *nb_sets)
+{
+	uint8_t  *raw = (uint8_t *)buf;
+	uint8_t  set_size;
+	uint8_t  axis;
+	uint16_t entry;
+	uint16_t i, out, set_start;
+	int32_t  ret;
+	bool     synced;
+
+	if (!nb_entries || nb_entries > ADXL362_FIFO_MAX_ENTRIES)
+		return -EINVAL;
+
+	/* Read in place, the entries follow the command byte */
+	raw[0] = ADXL362_WRITE_FIFO;
+	ret = spi_write_and_read(dev->spi_desc, raw, nb_entries * 2 + 1);
+	if (ret < 0)
+		return ret;
+	raw++;
+
+	/*
+	 * Output sample "out" never lands past input entry "i", and both
+	 * bytes of an entry are read before it can be overwritten.
+	 */
+	set_size = dev->fifo_temp ? 4 : 3;
+	synced = false;
+	axis = 0;
+	out = 0;
+	set_start = 0;
+	for (i = 0; i < nb_entries; i++) {
+		entry = raw[2 * i] | (raw[2 * i + 1] << 8);
+		if (ADXL362_FIFO_TAG(entry) == ADXL362_FIFO_TAG_X) {
+			/* An x-axis entry restarts the set */
+			synced = true;
+			out = set_start;
+			axis = 0;
+		} else if (ADXL362_FIFO_TAG(entry) != axis) {
+			synced = false;
+		}
+		if (!synced)
+			continue;
+
+		buf[out++] = (int16_t)(entry << 2) >> 2;
+		if (++axis == set_size) {
+			axis = 0;
+			set_start = out;
+		}
+	}
+
+	*nb_sets = set_start / set_size;
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Services a FIFO watermark event. Reads up to the watermark number of
+ *        entries, in whole sets. Overruns are counted in dev->fifo_overruns.
+ *
+ * @param dev     - The device structure.
+ * @param buf     - Buffer of at least fifo_watermark + 1 elements.
+ * @param nb_sets - Number of complete sets decoded, 0 if the FIFO holds less
+ *                  than a set.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t adxl362_fifo_stream_service(struct adxl362_dev *dev,
+				    int16_t *buf,
+				    uint16_t *nb_sets)
+{
+	uint8_t  status[5];
+	uint16_t fifo_entries;
+	uint16_t nb_entries;
+	uint8_t  set_size;
+	int32_t  ret;
+
+	*nb_sets = 0;
+
+	status[0] = ADXL362_READ_REG;
+	status[1] = ADXL362_REG_STATUS;
+	ret = spi_write_and_read(dev->spi_desc, status, sizeof(status));
+	if (ret < 0)
+		return ret;
+
+	if (status[2] & ADXL362_STATUS_FIFO_OVERRUN)
+		dev->fifo_overruns++;
+
+	fifo_entries = status[3] | ((status[4] & 0x3) << 8);
+	set_size = dev->fifo_temp ? 4 : 3;
+	nb_entries = fifo_entries;
+	if (dev->fifo_watermark && nb_entries > dev->fifo_watermark)
+		nb_entries = dev->fifo_watermark;
+	nb_entries -= nb_entries % set_size;
+	if (!nb_entries)
+		return 0;
+
+	return adxl362_fifo_stream_read(dev, buf, nb_entries, nb_sets);
 }
 
 /***************************************************************************//**
@@ -144,6 +144,12 @@
 #define ADXL362_INTMAP2_FIFO_READY      (1 << 1)
 #define ADXL362_INTMAP2_DATA_READY      (1 << 0)
 
+/* ADXL362 FIFO entry: axis tag in bits 15:14, sign extended sample below */
+#define ADXL362_FIFO_TAG(x)             (((x) >> 14) & 0x3)
+#define ADXL362_FIFO_TAG_X              0
+#define ADXL362_FIFO_TAG_TEMP           3
+#define ADXL362_FIFO_MAX_ENTRIES        511
+
 /* ADXL362_REG_FILTER_CTL definitions */
 #define ADXL362_FILTER_CTL_RANGE(x)     (((x) & 0x3) << 6)
 #define ADXL362_FILTER_CTL_RES          (1 << 5)
@@ -205,6 +211,12 @@ struct adxl362_dev {
 	spi_desc	*spi_desc;
 	/** Measurement Range: */
 	uint8_t		selected_range;
+	/** FIFO watermark, in entries */
+	uint16_t	fifo_watermark;
+	/** Temperature is stored in the FIFO after each x, y, z set */
+	uint8_t		fifo_temp;
+	/** Number of FIFO overruns seen while servicing the FIFO */
+	uint32_t	fifo_overruns;
 };
 
 /**
@@ -280,6 +292,17 @@ void adxl362_fifo_setup(struct adxl362_dev *dev,
 			uint16_t water_mark_lvl,
 			uint8_t  en_temp_read);
 
+/*! Burst reads FIFO entries and decodes them in place. */
+int32_t adxl362_fifo_stream_read(struct adxl362_dev *dev,
+				 int16_t *buf,
+				 uint16_t nb_entries,
+				 uint16_t *nb_sets);
+
+/*! Reads the watermark number of FIFO entries, if available. */
+int32_t adxl362_fifo_stream_service(struct adxl362_dev *dev,
+				    int16_t *buf,
+				    uint16_t *nb_sets);
+
 /*! Configures activity detection. */
 void adxl362_setup_activity_detection(struct adxl362_dev *dev,
 				      uint8_t  ref_or_abs,
@@ -45,6 +45,9 @@
 #include <stdbool.h>
 #include <string.h>
 #include "adxl372.h"
+#include "error.h"
+#include "unpack.h"
+#include "trace.h"
 
 /******************************************************************************/
 /************************** Functions Implementation **************************/
@@ -555,8 +558,10 @@ int32_t adxl372_service_fifo_ev(struct adxl372_dev *dev,
 	if (ret)
 		return ret;
 
+	trace_event2(TRACE_ID_ADXL372_FIFO, status1, *fifo_entries);
+
 	if (ADXL372_STATUS_1_FIFO_OVR(status1)) {
-		printf("FIFO overrun\n");
+		dev->fifo_overruns++;
 		return -1;
 	}
 
@@ -592,7 +597,6 @@ int32_t adxl372_get_fifo_xyz_data(struct adxl372_dev *dev,
 				  uint16_t cnt)
 {
 	uint8_t buf[1024];
-	uint16_t i;
 	int32_t ret;
 
 
@@ -609,14 +613,146 @@ int32_t adxl372_get_fifo_xyz_data(struct adxl372_dev *dev,
 	if (ret < 0)
 		return ret;
 
-	for (i = 0; i < cnt * 2; i += 6) {
-		samples->x = ((buf[i] << 4) | (buf[i+1] >> 4));
-		samples->y = ((buf[i+2] << 4) | (buf[i+3] >> 4));
-		samples->z = ((buf[i+4] << 4) | (buf[i+5] >> 4));
-		samples++;
+	/* Each entry holds a 12-bit axis sample in its MSBs */
+	return unpack_ljust16_u16((uint16_t *)samples, buf, cnt - cnt % 3, 12);
+}
+
+/**
+ * Number of axes stored in the FIFO for each sample set.
+ * @param format - FIFO format.
+ * @return Number of FIFO entries per sample set.
+ */
+static uint8_t adxl372_fifo_set_size(enum adxl372_fifo_format format)
+{
+	switch (format) {
+	case ADXL372_X_FIFO:
+	case ADXL372_Y_FIFO:
+	case ADXL372_Z_FIFO:
+		return 1;
+	case ADXL372_XY_FIFO:
+	case ADXL372_XZ_FIFO:
+	case ADXL372_YZ_FIFO:
+		return 2;
+	default:
+		return 3;
 	}
+}
 
-	return ret;
+/**
+ * Burst read FIFO entries into a caller owned buffer and decode them in place.
+ * Entries are sign extended and packed as complete sample sets, in the axis
+ * order of the FIFO format. Entries preceding the first series start marker
+ * and incomplete sets are dropped, so the output is always aligned.
+ * @param dev - The device structure.
+ * @param buf - Buffer of at least nb_entries + 1 elements. On return it holds
+ *		nb_sets * (axes per set) decoded samples.
+ * @param nb_entries - Number of FIFO entries to read (up to 512).
+ * @param nb_sets - Number of complete sample sets decoded.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adxl372_fifo_stream_read(struct adxl372_dev *dev,
+				 int16_t *buf,
+				 uint16_t nb_entries,
+				 uint16_t *nb_sets)
+{
+	uint8_t *raw = (uint8_t *)buf;
+	uint8_t set_size;
+	uint8_t axis;
+	uint16_t entry;
+	bool synced;
+	uint16_t i, out, set_start;
+	int32_t ret;
+
+	if (!nb_entries || nb_entries > ADXL372_FIFO_MAX_ENTRIES)
+		return -EINVAL;
+
+	if (dev->comm_type == SPI) {
+		/* Read in place, the entries follow the command byte */
+		raw[0] = ADXL372_REG_READ(ADXL372_FIFO_DATA);
+		ret = spi_write_and_read(dev->spi_desc, raw, nb_entries * 2 + 1);
+		raw++;
+	} else {
+		ret = dev->reg_read_multiple(dev, ADXL372_FIFO_DATA, raw,
+					     nb_entries * 2);
+	}
+	if (ret < 0)
+		return ret;
+
+	/*
+	 * Output sample "out" never lands past input entry "i", and both
+	 * bytes of an entry are read before it can be overwritten.
+	 */
+	set_size = adxl372_fifo_set_size(dev->fifo_config.fifo_format);
+	synced = false;
+	axis = 0;
+	out = 0;
+	set_start = 0;
+	for (i = 0; i < nb_entries; i++) {
+		entry = (raw[2 * i] << 8) | raw[2 * i + 1];
+		if (ADXL372_FIFO_SERIES_START(entry)) {
+			/* A marker restarts the set, dropping a partial one */
+			synced = true;
+			out = set_start;
+			axis = 0;
+		} else if (!axis) {
+			/* The first axis of a set must carry the marker */
+			synced = false;
+		}
+		if (!synced)
+			continue;
+
+		buf[out++] = (int16_t)entry >> 4;
+		if (++axis == set_size) {
+			axis = 0;
+			set_start = out;
+		}
+	}
+
+	*nb_sets = set_start / set_size;
+
+	return 0;
+}
+
+/**
+ * Service a FIFO watermark event. Reads the watermark number of entries,
+ * leaving at least one sample set in the FIFO as required when reading
+ * multiple axes. Overruns are counted in dev->fifo_overruns.
+ * @param dev - The device structure.
+ * @param buf - Buffer of at least fifo_samples + 1 elements.
+ * @param nb_sets - Number of complete sample sets decoded, 0 if the watermark
+ *		    was not reached.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adxl372_fifo_stream_service(struct adxl372_dev *dev,
+				    int16_t *buf,
+				    uint16_t *nb_sets)
+{
+	uint8_t status1, status2;
+	uint16_t fifo_entries;
+	uint16_t nb_entries;
+	uint8_t set_size;
+	int32_t ret;
+
+	*nb_sets = 0;
+
+	ret = adxl372_get_status(dev, &status1, &status2, &fifo_entries);
+	if (ret < 0)
+		return ret;
+
+	if (ADXL372_STATUS_1_FIFO_OVR(status1))
+		dev->fifo_overruns++;
+
+	set_size = adxl372_fifo_set_size(dev->fifo_config.fifo_format);
+	if (fifo_entries < set_size)
+		return 0;
+
+	nb_entries = min_t(uint16_t, dev->fifo_config.fifo_samples,
+			   fifo_entries - set_size);
+	nb_entries -= nb_entries % set_size;
+	if (!nb_entries)
+		return 0;
+
+	return adxl372_fifo_stream_read(dev, buf, nb_entries, nb_sets);
 }
 
 /**
@@ -708,6 +844,7 @@ int32_t adxl372_init(struct adxl372_dev **device,
 		goto error;
 
 	dev->comm_type = init_param.comm_type;
+	dev->fifo_overruns = 0;
 	if (dev->comm_type == SPI) {
 		/* SPI */
 		ret = spi_init(&dev->spi_desc, &init_param.spi_init);
@@ -816,3 +953,26 @@ error:
 	mdelay(1000);
 	return ret;
 }
+
+/**
+ * Free the resources allocated by adxl372_init().
+ * @param dev - The device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adxl372_remove(struct adxl372_dev *dev)
+{
+	int32_t ret;
+
+	if (!dev)
+		return -1;
+
+	if (dev->comm_type == SPI)
+		ret = spi_remove(dev->spi_desc);
+	else
+		ret = i2c_remove(dev->i2c_desc);
+	ret |= gpio_remove(dev->gpio_int1);
+	ret |= gpio_remove(dev->gpio_int2);
+	free(dev);
+
+	return ret;
+}
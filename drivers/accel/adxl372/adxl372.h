@@ -170,6 +170,10 @@
 #define ADXL372_STATUS_1_AWAKE(x)		(((x) >> 6) & 0x1)
 #define ADXL372_STATUS_1_ERR_USR_REGS(x)	(((x) >> 7) & 0x1)
 
+/* ADXL372_FIFO_DATA, 12-bit left justified, bit 0 marks the first axis */
+#define ADXL372_FIFO_SERIES_START(x)		((x) & 0x1)
+#define ADXL372_FIFO_MAX_ENTRIES		512
+
 /* ADXL372_INT1_MAP */
 #define ADXL372_INT1_MAP_DATA_RDY_MSK		BIT(0)
 #define ADXL372_INT1_MAP_DATA_RDY_MODE(x)	(((x) & 0x1) << 0)
@@ -384,6 +388,8 @@ struct adxl372_dev {
 	enum adxl372_instant_on_th_mode	th_mode;
 	struct adxl372_fifo_config	fifo_config;
 	enum adxl372_comm_type		comm_type;
+	/* Number of FIFO overruns seen while servicing the FIFO */
+	uint32_t			fifo_overruns;
 };
 
 struct adxl372_init_param {
@@ -436,6 +442,12 @@ int32_t adxl372_i2c_reg_read_multiple(struct adxl372_dev *dev,
 				      uint8_t reg_addr,
 				      uint8_t *reg_data,
 				      uint16_t count);
+int32_t adxl372_read_reg(struct adxl372_dev *dev,
+			 uint8_t reg_addr,
+			 uint8_t *reg_data);
+int32_t adxl372_write_reg(struct adxl372_dev *dev,
+			  uint8_t reg_addr,
+			  uint8_t reg_data);
 int32_t adxl372_write_mask(struct adxl372_dev *dev,
 			   uint8_t reg_addr,
 			   uint32_t mask,
@@ -480,11 +492,19 @@ int32_t adxl372_get_fifo_xyz_data(struct adxl372_dev *dev,
 int32_t adxl372_service_fifo_ev(struct adxl372_dev *dev,
 				struct adxl372_xyz_accel_data *fifo_data,
 				uint16_t *fifo_entries);
+int32_t adxl372_fifo_stream_read(struct adxl372_dev *dev,
+				 int16_t *buf,
+				 uint16_t nb_entries,
+				 uint16_t *nb_sets);
+int32_t adxl372_fifo_stream_service(struct adxl372_dev *dev,
+				    int16_t *buf,
+				    uint16_t *nb_sets);
 int32_t adxl372_get_highest_peak_data(struct adxl372_dev *dev,
 				      struct adxl372_xyz_accel_data *max_peak);
 int32_t adxl372_get_accel_data(struct adxl372_dev *dev,
 			       struct adxl372_xyz_accel_data *accel_data);
 int32_t adxl372_init(struct adxl372_dev **device,
 		     struct adxl372_init_param init_param);
+int32_t adxl372_remove(struct adxl372_dev *dev);
 
 #endif // ADXL372_H_
@@ -193,6 +193,7 @@ int32_t ad400x_remove(struct ad400x_dev *dev)
 {
 	int32_t ret;
 
+	spi_engine_offload_remove(dev->spi_desc);
 	ret = spi_remove(dev->spi_desc);
 
 	free(dev);
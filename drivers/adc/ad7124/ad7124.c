@@ -201,6 +201,10 @@ int32_t ad7124_read_register(struct ad7124_dev *dev,
 {
 	int32_t ret;
 
+	/* Registers are not accessible in continuous read mode */
+	if (dev->cont_read)
+		return INVALID_VAL;
+
 	if (p_reg->addr != AD7124_ERR_REG && dev->check_ready) {
 		ret = ad7124_wait_for_spi_ready(dev,
 						dev->spi_rdy_poll_cnt);
@@ -250,6 +254,10 @@ int32_t ad7124_write_register(struct ad7124_dev *dev,
 {
 	int32_t ret;
 
+	/* Registers are not accessible in continuous read mode */
+	if (dev->cont_read)
+		return INVALID_VAL;
+
 	if (dev->check_ready) {
 		ret = ad7124_wait_for_spi_ready(dev,
 						dev->spi_rdy_poll_cnt);
@@ -462,6 +470,108 @@ int32_t ad7124_get_read_chan_id(struct ad7124_dev *dev, uint32_t *status)
 	return ret;
 }
 
+/***************************************************************************//**
+ * @brief Enters continuous read mode with the status byte appended to the data.
+ *        The ADC is switched to continuous conversion mode. Conversion results
+ *        are then clocked out directly after each falling edge of DOUT/RDY,
+ *        without a command byte, until ad7124_cont_read_stop() is called.
+ *        No register can be accessed in this mode.
+ *
+ * @param dev - The handler of the instance of the driver.
+ *
+ * @return Returns 0 for success or negative error code.
+*******************************************************************************/
+int32_t ad7124_cont_read_start(struct ad7124_dev *dev)
+{
+	struct ad7124_st_reg *ctrl;
+	int32_t ret;
+
+	if(!dev)
+		return INVALID_VAL;
+
+	ctrl = &dev->regs[AD7124_ADC_Control];
+	ctrl->value &= ~AD7124_ADC_CTRL_REG_MODE(0xF);
+	ctrl->value |= AD7124_ADC_CTRL_REG_CONT_READ |
+		       AD7124_ADC_CTRL_REG_DATA_STATUS;
+
+	ret = ad7124_write_register(dev, *ctrl);
+	if(ret < 0)
+		return ret;
+
+	dev->cont_read = 1;
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Reads one conversion result in continuous read mode, in a single
+ *        transfer. Must be called after a falling edge of DOUT/RDY.
+ *
+ * @param dev    - The handler of the instance of the driver.
+ * @param p_data - Pointer to store the conversion result.
+ * @param p_ch   - Pointer to store the channel of the result, taken from the
+ *                 appended status byte.
+ *
+ * @return Returns 0 for success or negative error code.
+*******************************************************************************/
+int32_t ad7124_cont_read_sample(struct ad7124_dev *dev,
+				int32_t *p_data,
+				uint8_t *p_ch)
+{
+	uint8_t buffer[5] = {0, 0, 0, 0, 0};
+	uint8_t len;
+	int32_t ret;
+
+	if(!dev || !dev->cont_read)
+		return INVALID_VAL;
+
+	/* 24-bit data and status, then the CRC of both */
+	len = (dev->use_crc != AD7124_DISABLE_CRC) ? 5 : 4;
+
+	ret = spi_write_and_read(dev->spi_desc, buffer, len);
+	if(ret < 0)
+		return ret;
+
+	if((dev->use_crc != AD7124_DISABLE_CRC) &&
+	   ad7124_compute_crc8(buffer, len) != 0)
+		return COMM_ERR;
+
+	*p_data = (buffer[0] << 16) | (buffer[1] << 8) | buffer[2];
+	*p_ch = AD7124_STATUS_REG_CH_ACTIVE(buffer[3]);
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Exits continuous read mode by issuing a read data command while the
+ *        result is shifted out. Must be called after a falling edge of
+ *        DOUT/RDY; the conversion read by this call is discarded.
+ *
+ * @param dev - The handler of the instance of the driver.
+ *
+ * @return Returns 0 for success or negative error code.
+*******************************************************************************/
+int32_t ad7124_cont_read_stop(struct ad7124_dev *dev)
+{
+	uint8_t buffer[5] = {0, 0, 0, 0, 0};
+	int32_t ret;
+
+	if(!dev || !dev->cont_read)
+		return INVALID_VAL;
+
+	buffer[0] = AD7124_COMM_REG_WEN | AD7124_COMM_REG_RD |
+		    AD7124_COMM_REG_RA(AD7124_DATA_REG);
+	ret = spi_write_and_read(dev->spi_desc, buffer,
+				 (dev->use_crc != AD7124_DISABLE_CRC) ? 5 : 4);
+	if(ret < 0)
+		return ret;
+
+	dev->regs[AD7124_ADC_Control].value &= ~AD7124_ADC_CTRL_REG_CONT_READ;
+	dev->cont_read = 0;
+
+	return ret;
+}
+
 /***************************************************************************//**
  * @brief Computes the CRC checksum for a data buffer.
  *
@@ -561,6 +671,8 @@ int32_t ad7124_setup(struct ad7124_dev **device,
 
 	dev->regs = init_param->regs;
 	dev->spi_rdy_poll_cnt = init_param->spi_rdy_poll_cnt;
+	dev->cont_read = 0;
+	dev->iio_stream = NULL;
 
 	/* Initialize the SPI communication. */
 	ret = spi_init(&dev->spi_desc, init_param->spi_init);
@@ -342,6 +342,9 @@ enum ad7124_registers {
  * @spi_rdy_poll_cnt: Number of times the driver should read the Error register
  *                    to check if the device is ready to accept user requests,
  *                    before a timeout error will be issued.
+ * @cont_read: Set while the device is in continuous read mode.
+ * @iio_stream: Continuous read streaming state of the IIO front end, set by
+ *              iio_ad7124_stream_init().
  */
 struct ad7124_dev {
 	/* SPI */
@@ -351,6 +354,8 @@ struct ad7124_dev {
 	int16_t use_crc;
 	int16_t check_ready;
 	int16_t spi_rdy_poll_cnt;
+	int16_t cont_read;
+	struct iio_ad7124_stream *iio_stream;
 };
 
 struct ad7124_init_param {
@@ -418,6 +423,17 @@ int32_t ad7124_read_data(struct ad7124_dev *dev,
 /*! Get the ID of the channel of the latest conversion. */
 int32_t ad7124_get_read_chan_id(struct ad7124_dev *dev, uint32_t *status);
 
+/*! Enters continuous read mode with the status byte appended. */
+int32_t ad7124_cont_read_start(struct ad7124_dev *dev);
+
+/*! Reads one conversion result in continuous read mode. */
+int32_t ad7124_cont_read_sample(struct ad7124_dev *dev,
+				int32_t *p_data,
+				uint8_t *p_ch);
+
+/*! Exits continuous read mode. */
+int32_t ad7124_cont_read_stop(struct ad7124_dev *dev);
+
 /*! Computes the CRC checksum for a data buffer. */
 uint8_t ad7124_compute_crc8(uint8_t* p_buf,
 			    uint8_t buf_size);
@@ -42,6 +42,7 @@
 /******************************************************************************/
 
 #include <stdlib.h>
+#include <string.h>
 #include <stdio.h>
 #include <inttypes.h>
 #include <math.h>
@@ -49,8 +50,16 @@
 #include "iio.h"
 #include "iio_ad7124.h"
 #include "util.h"
+#include "delay.h"
 #include "ad7124.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Conversions to wait for the device to leave continuous read mode */
+#define IIO_AD7124_STOP_TIMEOUT_MS	100
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -210,7 +219,7 @@ static ssize_t ad7124_iio_change_offset_chan(void *device, char *buf,
 	if (ret != SUCCESS)
 		return ret;
 
-	sscanf(buf, "%ld", &reg_val);
+	sscanf(buf, "%"SCNu32, &reg_val);
 
 	ret = ad7124_write_register2(desc, (AD7124_OFFS0_REG + config_opt),
 				     reg_val);
@@ -329,7 +338,7 @@ static ssize_t ad7124_iio_write_filter_3db(void *device, char *buf, size_t len,
 	if (ret != SUCCESS)
 		return ret;
 
-	sscanf(buf, "%ld", &freq);
+	sscanf(buf, "%"SCNu32, &freq);
 
 	sinc4_3db_odr = (freq * 1000) / 230;
 	sinc3_3db_odr = (freq * 1000) / 262;
@@ -407,7 +416,7 @@ static ssize_t ad7124_iio_change_odr_chan(void *device, char *buf, size_t len,
 	if (ret != SUCCESS)
 		return ret;
 
-	sscanf(buf, "%ld", &new_odr);
+	sscanf(buf, "%"SCNu32, &new_odr);
 
 	ret = ad7124_set_odr(desc, (float)new_odr, config_opt);
 	if (ret != SUCCESS)
@@ -555,6 +564,115 @@ static bool get_next_ch_idx(uint32_t ch_mask, uint32_t last_idx,
 	return 1;
 }
 
+/**
+ * @brief Number of channels in a channel mask.
+ * @param mask - Channel mask.
+ * @return Number of bits set in the mask.
+ */
+static uint32_t iio_ad7124_nb_channels(uint32_t mask)
+{
+	return hweight8(mask & 0xFF) + hweight8((mask >> 8) & 0xFF);
+}
+
+/**
+ * @brief DOUT/RDY falling edge handler, called through the trigger. Clocks
+ *	  out one conversion and stores it in the scan slot of the channel
+ *	  reported by the status byte.
+ * @param device - Stream descriptor.
+ * @param scan - Scan being assembled.
+ * @return SUCCESS once the scan is complete, -EAGAIN while it is not, negative
+ *	   error code if a sample or a partial scan was dropped.
+ */
+static int32_t iio_ad7124_stream_read_scan(void *device, void *scan)
+{
+	struct iio_ad7124_stream *stream = device;
+	struct iio_trigger_desc *trig = stream->trig;
+	int32_t value;
+	uint8_t ch;
+	int32_t ret;
+
+	/* Reading clocks DOUT/RDY, keep those edges out of the handler */
+	irq_disable(trig->irq_ctrl, trig->irq_id);
+
+	/* The exit command is only accepted while RDY is low */
+	if (stream->stop) {
+		ad7124_cont_read_stop(stream->dev);
+		return -EAGAIN;
+	}
+
+	ret = ad7124_cont_read_sample(stream->dev, &value, &ch);
+	irq_enable(trig->irq_ctrl, trig->irq_id);
+	if (ret < 0) {
+		/* The channel of the sample is unknown, restart the scan */
+		stream->crc_errors++;
+		stream->seq.fill = 0;
+		return ret;
+	}
+
+	return iio_trigger_seq_add(&stream->seq, scan, ch, &value);
+}
+
+/**
+ * @brief Enter continuous read mode and start acquiring scans.
+ * @param stream - Stream descriptor.
+ * @param mask - Channels to stream.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t iio_ad7124_stream_start(struct iio_ad7124_stream *stream,
+				       uint32_t mask)
+{
+	int32_t ret;
+
+	if (!mask || (mask & ~(uint32_t)stream->ch_mask))
+		return -EINVAL;
+
+	iio_trigger_seq_reset(&stream->seq, mask, sizeof(int32_t));
+	stream->stop = false;
+	stream->crc_errors = 0;
+
+	/* DOUT/RDY toggles while ADC_CONTROL is written, enable the IRQ after */
+	ret = ad7124_cont_read_start(stream->dev);
+	if (ret < 0)
+		return ret;
+
+	ret = iio_trigger_enable(stream->trig);
+	if (ret < 0) {
+		ad7124_cont_read_stop(stream->dev);
+		return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Leave continuous read mode. Scans already in the ring can still be
+ *	  read.
+ * @param stream - Stream descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t iio_ad7124_stream_stop(struct iio_ad7124_stream *stream)
+{
+	uint32_t timeout = IIO_AD7124_STOP_TIMEOUT_MS;
+	int32_t ret;
+
+	if (!stream->dev->cont_read)
+		return SUCCESS;
+
+	/* Let the handler send the exit command on the next conversion */
+	stream->stop = true;
+	while (stream->dev->cont_read && timeout--)
+		mdelay(1);
+
+	ret = iio_trigger_disable(stream->trig);
+	if (ret < 0)
+		return ret;
+
+	if (stream->dev->cont_read)
+		return ad7124_cont_read_stop(stream->dev);
+
+	return SUCCESS;
+}
+
 /**
  * @brief Update active channels.
  * @param [in] dev - Application descriptor.
@@ -582,6 +700,9 @@ static int32_t iio_ad7124_update_active_channels(void *dev, uint32_t mask)
 			return ret;
 	}
 
+	if (desc->iio_stream)
+		return iio_ad7124_stream_start(desc->iio_stream, mask);
+
 	return SUCCESS;
 }
 
@@ -597,6 +718,12 @@ static int32_t iio_ad7124_close_channels(void *dev)
 	int32_t ret;
 	uint32_t reg_temp;
 
+	if (desc->iio_stream) {
+		ret = iio_ad7124_stream_stop(desc->iio_stream);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
 	for (ch_idx = 0; ch_idx < 16; ch_idx++) {
 		ret = ad7124_read_register2(desc,
 					    (AD7124_CH0_MAP_REG + ch_idx),
@@ -640,6 +767,22 @@ static int32_t iio_ad7124_get_active_channels(struct ad7124_dev * desc,
 	return SUCCESS;
 }
 
+/**
+ * @brief Get a number of scans from the trigger ring. Blocks until they are
+ *	  available.
+ * @param stream - Stream descriptor.
+ * @param buff - Sample buffer.
+ * @param nb_samples - Number of scans to get.
+ * @return Number of scans read, negative error code otherwise.
+ */
+static int32_t iio_ad7124_stream_read(struct iio_ad7124_stream *stream,
+				      int32_t *buff, uint32_t nb_samples)
+{
+	return iio_trigger_read(stream->trig, buff,
+				iio_ad7124_nb_channels(stream->seq.mask) *
+				sizeof(*buff), nb_samples, NULL);
+}
+
 /**
  * @brief Get a number of samples from all the active channels.
  * @param [in] dev - Device descriptor.
@@ -656,6 +799,9 @@ static int32_t iio_ad7124_read_samples(void *dev, int32_t *buff,
 	uint32_t ch_id = -1, test;
 	uint32_t mask;
 
+	if (desc->iio_stream)
+		return iio_ad7124_stream_read(desc->iio_stream, buff, nb_samples);
+
 	ret = iio_ad7124_get_active_channels(desc, &mask);
 	if (ret != SUCCESS)
 		return ret;
@@ -702,3 +848,74 @@ struct iio_device iio_ad7124_device = {
 	.debug_reg_write = (int32_t (*)())ad7124_write_register2
 };
 
+/**
+ * @brief Stream conversions through the DOUT/RDY interrupt. Once set up,
+ *	  buffer reads of iio_ad7124_device are served from a trigger ring of
+ *	  scans filled in continuous read mode instead of polling the device.
+ * @param stream - Stream descriptor.
+ * @param param - Configuration structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_ad7124_stream_init(struct iio_ad7124_stream **stream,
+			       struct iio_ad7124_stream_init_param *param)
+{
+	struct iio_trigger_init_param trig_param;
+	struct iio_ad7124_stream *desc;
+	int32_t ret;
+
+	if (!stream || !param || !param->dev || !param->irq_ctrl ||
+	    !param->ch_mask || !param->ring_scans)
+		return -EINVAL;
+
+	if (param->dev->iio_stream)
+		return -EBUSY;
+
+	desc = (struct iio_ad7124_stream *)calloc(1, sizeof(*desc));
+	if (!desc)
+		return -ENOMEM;
+
+	desc->dev = param->dev;
+	desc->ch_mask = param->ch_mask;
+
+	memset(&trig_param, 0, sizeof(trig_param));
+	trig_param.irq_ctrl = param->irq_ctrl;
+	trig_param.irq_id = param->irq_id;
+	trig_param.irq_config = param->irq_config;
+	trig_param.dev = desc;
+	trig_param.read_scan = iio_ad7124_stream_read_scan;
+	trig_param.scan_size = iio_ad7124_nb_channels(desc->ch_mask) *
+			       sizeof(int32_t);
+	trig_param.nb_scans = param->ring_scans;
+	trig_param.get_time_ns = param->get_time_ns;
+	ret = iio_trigger_init(&desc->trig, &trig_param);
+	if (ret < 0) {
+		free(desc);
+		return ret;
+	}
+
+	desc->dev->iio_stream = desc;
+	*stream = desc;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Stop streaming and free resources. Buffer reads go back to polling
+ *	  the device.
+ * @param stream - Stream descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_ad7124_stream_remove(struct iio_ad7124_stream *stream)
+{
+	if (!stream)
+		return -EINVAL;
+
+	iio_ad7124_stream_stop(stream);
+	if (stream->dev->iio_stream == stream)
+		stream->dev->iio_stream = NULL;
+
+	iio_trigger_remove(stream->trig);
+	free(stream);
+
+	return SUCCESS;
+}
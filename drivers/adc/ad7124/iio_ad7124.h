@@ -45,7 +45,63 @@
 /******************************************************************************/
 
 #include "iio.h"
+#include "iio_trigger.h"
+#include "ad7124.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct iio_ad7124_stream_init_param
+ * @brief Continuous read streaming configuration.
+ */
+struct iio_ad7124_stream_init_param {
+	/** AD7124 device, already initialized */
+	struct ad7124_dev	*dev;
+	/** Interrupt controller the DOUT/RDY line is connected to */
+	struct irq_ctrl_desc	*irq_ctrl;
+	/** Interrupt of the DOUT/RDY line */
+	uint32_t		irq_id;
+	/** Platform specific interrupt configuration (falling edge) */
+	void			*irq_config;
+	/** Channels that may be streamed, one bit per channel */
+	uint16_t		ch_mask;
+	/** Number of scans buffered between reads */
+	uint32_t		ring_scans;
+	/** Monotonic time source in nanoseconds, may be NULL */
+	uint64_t		(*get_time_ns)(void);
+};
+
+/**
+ * @struct iio_ad7124_stream
+ * @brief Continuous read streaming descriptor.
+ */
+struct iio_ad7124_stream {
+	/** AD7124 device */
+	struct ad7124_dev	*dev;
+	/** DOUT/RDY trigger, one int32_t sample per active channel per scan */
+	struct iio_trigger_desc	*trig;
+	/** Channels that may be streamed */
+	uint16_t		ch_mask;
+	/** Assembly of the scans of the channels being streamed */
+	struct iio_trigger_seq	seq;
+	/** Set to leave continuous read mode on the next conversion */
+	volatile bool		stop;
+	/** Samples dropped due to a checksum mismatch or bus error */
+	uint32_t		crc_errors;
+};
 
 extern struct iio_device iio_ad7124_device;
 
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Stream conversions through the DOUT/RDY interrupt in continuous read mode. */
+int32_t iio_ad7124_stream_init(struct iio_ad7124_stream **stream,
+			       struct iio_ad7124_stream_init_param *param);
+/* Stop using the DOUT/RDY interrupt and free resources. */
+int32_t iio_ad7124_stream_remove(struct iio_ad7124_stream *stream);
+
 #endif /** IIO_AD7124_H */
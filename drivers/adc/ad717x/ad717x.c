@@ -99,7 +99,8 @@ int32_t AD717X_ReadRegister(ad717x_dev *device,
 	uint8_t msgBuf[8] = {0, 0, 0, 0, 0, 0, 0, 0};
 	ad717x_st_reg *pReg;
 
-	if(!device)
+	/* Registers are not accessible in continuous read mode */
+	if(!device || device->cont_read)
 		return INVALID_VAL;
 
 	pReg = AD717X_GetReg(device, addr);
@@ -171,7 +172,8 @@ int32_t AD717X_WriteRegister(ad717x_dev *device,
 	uint8_t crc8     = 0;
 	ad717x_st_reg *preg;
 
-	if(!device)
+	/* Registers are not accessible in continuous read mode */
+	if(!device || device->cont_read)
 		return INVALID_VAL;
 
 	preg = AD717X_GetReg(device, addr);
@@ -222,6 +224,11 @@ int32_t AD717X_Reset(ad717x_dev *device)
 	ret = spi_write_and_read(device->spi_desc,
 				 wrBuf,
 				 8);
+	if(ret < 0)
+		return ret;
+
+	/* The reset also leaves continuous read mode */
+	device->cont_read = 0;
 
 	return ret;
 }
@@ -295,6 +302,143 @@ int32_t AD717X_ReadData(ad717x_dev *device,
 	return ret;
 }
 
+/***************************************************************************//**
+* @brief Enables continuous read mode with the status byte appended to the data.
+*        The ADC is switched to continuous conversion mode. Conversion results
+*        are then clocked out directly after each falling edge of DOUT/RDY,
+*        without a command byte, until AD717X_DisableContRead() is called. No
+*        register can be accessed in this mode.
+*
+* @param device - The handler of the instance of the driver.
+*
+* @return Returns 0 for success or negative error code.
+*******************************************************************************/
+int32_t AD717X_EnableContRead(ad717x_dev *device)
+{
+	ad717x_st_reg *adcmodeReg;
+	ad717x_st_reg *ifmodeReg;
+	int32_t ret;
+
+	if(!device || !device->regs)
+		return INVALID_VAL;
+
+	adcmodeReg = AD717X_GetReg(device, AD717X_ADCMODE_REG);
+	ifmodeReg = AD717X_GetReg(device, AD717X_IFMODE_REG);
+	if (!adcmodeReg || !ifmodeReg)
+		return INVALID_VAL;
+
+	/* Mode 0 is continuous conversion */
+	adcmodeReg->value &= ~AD717X_ADCMODE_REG_MODE(0x7);
+	ret = AD717X_WriteRegister(device, AD717X_ADCMODE_REG);
+	if(ret < 0)
+		return ret;
+
+	ifmodeReg->value |= AD717X_IFMODE_REG_CONT_READ |
+			    AD717X_IFMODE_REG_DATA_STAT;
+	ret = AD717X_ComputeDataregSize(device);
+	if(ret < 0)
+		return ret;
+
+	ret = AD717X_WriteRegister(device, AD717X_IFMODE_REG);
+	if(ret < 0) {
+		ifmodeReg->value &= ~AD717X_IFMODE_REG_CONT_READ;
+		return ret;
+	}
+
+	device->cont_read = 1;
+
+	return ret;
+}
+
+/***************************************************************************//**
+* @brief Reads one conversion result in continuous read mode, in a single
+*        transfer. Must be called after a falling edge of DOUT/RDY.
+*
+* @param device - The handler of the instance of the driver.
+* @param pData  - Pointer to store the conversion result.
+* @param pCh    - Pointer to store the channel of the result, taken from the
+*                 appended status byte.
+*
+* @return Returns 0 for success or negative error code.
+*******************************************************************************/
+int32_t AD717X_ContReadSample(ad717x_dev *device,
+			      int32_t *pData,
+			      uint8_t *pCh)
+{
+	ad717x_st_reg *dataReg;
+	uint8_t buffer[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+	uint8_t len;
+	uint8_t i;
+	int32_t ret;
+
+	if(!device || !device->regs || !device->cont_read)
+		return INVALID_VAL;
+
+	dataReg = AD717X_GetReg(device, AD717X_DATA_REG);
+	if (!dataReg)
+		return INVALID_VAL;
+
+	/* Data and status, then the checksum of both */
+	len = dataReg->size;
+	if(device->useCRC != AD717X_DISABLE)
+		len++;
+
+	ret = spi_write_and_read(device->spi_desc, buffer, len);
+	if(ret < 0)
+		return ret;
+
+	if((device->useCRC == AD717X_USE_CRC &&
+	    AD717X_ComputeCRC8(buffer, len) != 0) ||
+	   (device->useCRC == AD717X_USE_XOR &&
+	    AD717X_ComputeXOR8(buffer, len) != 0))
+		return COMM_ERR;
+
+	*pData = 0;
+	for(i = 0; i < dataReg->size - 1; i++)
+		*pData = (*pData << 8) | buffer[i];
+	*pCh = AD717X_STATUS_REG_CH(buffer[dataReg->size - 1]);
+
+	return ret;
+}
+
+/***************************************************************************//**
+* @brief Exits continuous read mode by issuing a read data command while the
+*        result is shifted out. Must be called after a falling edge of
+*        DOUT/RDY; the conversion read by this call is discarded.
+*
+* @param device - The handler of the instance of the driver.
+*
+* @return Returns 0 for success or negative error code.
+*******************************************************************************/
+int32_t AD717X_DisableContRead(ad717x_dev *device)
+{
+	ad717x_st_reg *ifmodeReg;
+	ad717x_st_reg *dataReg;
+	uint8_t buffer[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+	int32_t ret;
+
+	if(!device || !device->regs || !device->cont_read)
+		return INVALID_VAL;
+
+	ifmodeReg = AD717X_GetReg(device, AD717X_IFMODE_REG);
+	dataReg = AD717X_GetReg(device, AD717X_DATA_REG);
+	if (!ifmodeReg || !dataReg)
+		return INVALID_VAL;
+
+	buffer[0] = AD717X_COMM_REG_WEN | AD717X_COMM_REG_RD |
+		    AD717X_COMM_REG_RA(AD717X_DATA_REG);
+	ret = spi_write_and_read(device->spi_desc, buffer,
+				 (device->useCRC != AD717X_DISABLE) ?
+				 dataReg->size + 1 : dataReg->size);
+	if(ret < 0)
+		return ret;
+
+	ifmodeReg->value &= ~AD717X_IFMODE_REG_CONT_READ;
+	device->cont_read = 0;
+
+	return ret;
+}
+
 /***************************************************************************//**
 * @brief Computes data register read size to account for bit number and status
 * 		 read.
@@ -436,6 +580,7 @@ int32_t AD717X_Init(ad717x_dev **device,
 
 	dev->regs = init_param.regs;
 	dev->num_regs = init_param.num_regs;
+	dev->cont_read = 0;
 
 	/* Initialize the SPI communication. */
 	ret = spi_init(&dev->spi_desc, &init_param.spi_init);
@@ -73,6 +73,7 @@ typedef struct {
  *       provide when calling the Setup() function.
  * @num_regs: The length of the register list.
  * @userCRC: Error check type to use on SPI transfers.
+ * @cont_read: Set while the device is in continuous read mode.
  */
 typedef struct {
 	/* SPI */
@@ -81,6 +82,7 @@ typedef struct {
 	ad717x_st_reg		*regs;
 	uint8_t			num_regs;
 	ad717x_crc_mode		useCRC;
+	uint8_t			cont_read;
 } ad717x_dev;
 
 typedef struct {
@@ -309,6 +311,18 @@ int32_t AD717X_WaitForReady(ad717x_dev *device,
 int32_t AD717X_ReadData(ad717x_dev *device,
 			int32_t* pData);
 
+/*! Enables continuous conversion and read mode with the status byte
+ *  appended. */
+int32_t AD717X_EnableContRead(ad717x_dev *device);
+
+/*! Reads one conversion result in continuous read mode. */
+int32_t AD717X_ContReadSample(ad717x_dev *device,
+			      int32_t *pData,
+			      uint8_t *pCh);
+
+/*! Exits continuous read mode. */
+int32_t AD717X_DisableContRead(ad717x_dev *device);
+
 /*! Computes data register read size to account for bit number and status
  *  read. */
 int32_t AD717X_ComputeDataregSize(ad717x_dev *device);
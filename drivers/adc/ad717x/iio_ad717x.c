@@ -0,0 +1,399 @@
+/***************************************************************************//**
+ *   @file   iio_ad717x.c
+ *   @brief  Continuous read streaming of AD717X conversions through IIO.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "util.h"
+#include "delay.h"
+#include "iio_ad717x.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define IIO_AD717X_NB_CHANNELS		16
+/* Conversions to wait for the device to leave continuous read mode */
+#define IIO_AD717X_STOP_TIMEOUT_MS	100
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static ssize_t iio_ad717x_get_errors(void *device, char *buf, size_t len,
+				     const struct iio_ch_info *channel,
+				     intptr_t priv)
+{
+	struct iio_ad717x_desc *desc = device;
+
+	if (priv)
+		return snprintf(buf, len, "%"PRIu32, desc->trig->overruns);
+
+	return snprintf(buf, len, "%"PRIu32, desc->crc_errors);
+}
+
+static struct iio_attribute iio_ad717x_attrs[] = {
+	{
+		.name = "crc_errors",
+		.show = iio_ad717x_get_errors,
+		.priv = 0,
+	},
+	{
+		.name = "buffer_overruns",
+		.show = iio_ad717x_get_errors,
+		.priv = 1,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+/* 24-bit results, 32-bit on the AD7177-2 */
+static struct scan_type iio_ad717x_scan_type = {
+	.sign = 'u',
+	.realbits = 32,
+	.storagebits = 32,
+	.shift = 0,
+	.is_big_endian = false
+};
+
+#define IIO_AD717X_CHANNEL(_idx) {			\
+	.ch_type = IIO_VOLTAGE,				\
+	.channel = _idx,				\
+	.scan_index = _idx,				\
+	.scan_type = &iio_ad717x_scan_type,		\
+	.ch_out = false,				\
+	.indexed = true,				\
+}
+
+static struct iio_channel iio_ad717x_channels[IIO_AD717X_NB_CHANNELS] = {
+	IIO_AD717X_CHANNEL(0), IIO_AD717X_CHANNEL(1),
+	IIO_AD717X_CHANNEL(2), IIO_AD717X_CHANNEL(3),
+	IIO_AD717X_CHANNEL(4), IIO_AD717X_CHANNEL(5),
+	IIO_AD717X_CHANNEL(6), IIO_AD717X_CHANNEL(7),
+	IIO_AD717X_CHANNEL(8), IIO_AD717X_CHANNEL(9),
+	IIO_AD717X_CHANNEL(10), IIO_AD717X_CHANNEL(11),
+	IIO_AD717X_CHANNEL(12), IIO_AD717X_CHANNEL(13),
+	IIO_AD717X_CHANNEL(14), IIO_AD717X_CHANNEL(15),
+};
+
+/**
+ * @brief Number of channels in a channel mask.
+ * @param mask - Channel mask.
+ * @return Number of bits set in the mask.
+ */
+static uint32_t iio_ad717x_nb_channels(uint32_t mask)
+{
+	return hweight8(mask & 0xFF) + hweight8((mask >> 8) & 0xFF);
+}
+
+/**
+ * @brief DOUT/RDY falling edge handler, called through the trigger. Clocks
+ *	  out one conversion and stores it in the scan slot of the channel
+ *	  reported by the status byte.
+ * @param device - iio_ad717x descriptor.
+ * @param scan - Scan being assembled.
+ * @return SUCCESS once the scan is complete, -EAGAIN while it is not, negative
+ *	   error code if a sample or a partial scan was dropped.
+ */
+static int32_t iio_ad717x_read_scan(void *device, void *scan)
+{
+	struct iio_ad717x_desc	*desc = device;
+	struct iio_trigger_desc	*trig = desc->trig;
+	int32_t			value;
+	uint8_t			ch;
+	int32_t			ret;
+
+	/* Reading clocks DOUT/RDY, keep those edges out of the handler */
+	irq_disable(trig->irq_ctrl, trig->irq_id);
+
+	/* The exit command is only accepted while RDY is low */
+	if (desc->stop) {
+		AD717X_DisableContRead(desc->dev);
+		return -EAGAIN;
+	}
+
+	ret = AD717X_ContReadSample(desc->dev, &value, &ch);
+	irq_enable(trig->irq_ctrl, trig->irq_id);
+	if (ret < 0) {
+		/* The channel of the sample is unknown, restart the scan */
+		desc->crc_errors++;
+		desc->seq.fill = 0;
+		return ret;
+	}
+
+	return iio_trigger_seq_add(&desc->seq, scan, ch, &value);
+}
+
+/**
+ * @brief Enable the channels of the mask in the sequencer, disable the others.
+ * @param desc - iio_ad717x descriptor.
+ * @param mask - Channels to enable.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t iio_ad717x_set_channels(struct iio_ad717x_desc *desc,
+				       uint32_t mask)
+{
+	ad717x_st_reg	*reg;
+	uint8_t		ch;
+	int32_t		ret;
+
+	for (ch = 0; ch < IIO_AD717X_NB_CHANNELS; ch++) {
+		reg = AD717X_GetReg(desc->dev, AD717X_CHMAP0_REG + ch);
+		if (!reg) {
+			/* Parts with fewer channels end their map earlier */
+			if (mask & BIT(ch))
+				return -EINVAL;
+			continue;
+		}
+
+		if (mask & BIT(ch))
+			reg->value |= AD717X_CHMAP_REG_CH_EN;
+		else
+			reg->value &= ~AD717X_CHMAP_REG_CH_EN;
+
+		ret = AD717X_WriteRegister(desc->dev, reg->addr);
+		if (ret < 0)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Enter continuous read mode and start acquiring scans of the active
+ *	  channels.
+ * @param device - iio_ad717x descriptor.
+ * @param mask - Active channels.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t iio_ad717x_prepare_transfer(void *device, uint32_t mask)
+{
+	struct iio_ad717x_desc	*desc = device;
+	int32_t			ret;
+
+	if (!mask || (mask & ~(uint32_t)desc->ch_mask))
+		return -EINVAL;
+
+	ret = iio_ad717x_set_channels(desc, mask);
+	if (ret < 0)
+		return ret;
+
+	iio_trigger_seq_reset(&desc->seq, mask, sizeof(int32_t));
+	desc->stop = false;
+	desc->crc_errors = 0;
+
+	/* DOUT/RDY toggles while IFMODE is written, enable the IRQ after */
+	ret = AD717X_EnableContRead(desc->dev);
+	if (ret < 0)
+		return ret;
+
+	ret = iio_trigger_enable(desc->trig);
+	if (ret < 0) {
+		AD717X_DisableContRead(desc->dev);
+		return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Leave continuous read mode. Scans already in the ring can still be
+ *	  read.
+ * @param device - iio_ad717x descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t iio_ad717x_end_transfer(void *device)
+{
+	struct iio_ad717x_desc	*desc = device;
+	uint32_t		timeout = IIO_AD717X_STOP_TIMEOUT_MS;
+	int32_t			ret;
+
+	if (!desc->dev->cont_read)
+		return SUCCESS;
+
+	/* Let the handler send the exit command on the next conversion */
+	desc->stop = true;
+	while (desc->dev->cont_read && timeout--)
+		mdelay(1);
+
+	ret = iio_trigger_disable(desc->trig);
+	if (ret < 0)
+		return ret;
+
+	if (desc->dev->cont_read)
+		return AD717X_DisableContRead(desc->dev);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read scans from the ring. Blocks until they are available.
+ * @param device - iio_ad717x descriptor.
+ * @param buff - Where to store the samples.
+ * @param nb_samples - Number of scans.
+ * @return Number of scans read or negative error code.
+ */
+static int32_t iio_ad717x_read_dev(void *device, void *buff,
+				   uint32_t nb_samples)
+{
+	struct iio_ad717x_desc *desc = device;
+
+	return iio_trigger_read(desc->trig, buff,
+				iio_ad717x_nb_channels(desc->seq.mask) *
+				sizeof(int32_t), nb_samples, NULL);
+}
+
+static int32_t iio_ad717x_reg_read(void *device, uint32_t reg, uint32_t *val)
+{
+	struct iio_ad717x_desc	*desc = device;
+	ad717x_st_reg		*preg;
+	int32_t			ret;
+
+	preg = AD717X_GetReg(desc->dev, reg);
+	if (!preg)
+		return -EINVAL;
+
+	ret = AD717X_ReadRegister(desc->dev, reg);
+	*val = preg->value;
+
+	return ret;
+}
+
+static int32_t iio_ad717x_reg_write(void *device, uint32_t reg, uint32_t val)
+{
+	struct iio_ad717x_desc	*desc = device;
+	ad717x_st_reg		*preg;
+
+	preg = AD717X_GetReg(desc->dev, reg);
+	if (!preg)
+		return -EINVAL;
+
+	preg->value = val;
+
+	return AD717X_WriteRegister(desc->dev, reg);
+}
+
+/**
+ * @brief Get iio device descriptor.
+ * @param desc - Descriptor.
+ * @param dev_descriptor - iio device descriptor.
+ */
+void iio_ad717x_get_dev_descriptor(struct iio_ad717x_desc *desc,
+				   struct iio_device **dev_descriptor)
+{
+	*dev_descriptor = &desc->dev_descriptor;
+}
+
+/**
+ * @brief Init for continuous read streaming of an AD717X device. Each
+ *	  conversion is read on the DOUT/RDY interrupt and scans of the active
+ *	  channels are queued in the ring of a trigger.
+ * @param desc - Descriptor.
+ * @param param - Configuration structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_ad717x_init(struct iio_ad717x_desc **desc,
+			struct iio_ad717x_init_param *param)
+{
+	struct iio_trigger_init_param	trig_param;
+	struct iio_ad717x_desc		*iio_ad717x;
+	int32_t				ret;
+
+	if (!desc || !param || !param->dev || !param->irq_ctrl ||
+	    !param->ch_mask || !param->ring_scans)
+		return -EINVAL;
+
+	iio_ad717x = (struct iio_ad717x_desc *)calloc(1, sizeof(*iio_ad717x));
+	if (!iio_ad717x)
+		return -ENOMEM;
+
+	iio_ad717x->dev = param->dev;
+	iio_ad717x->ch_mask = param->ch_mask;
+
+	memset(&trig_param, 0, sizeof(trig_param));
+	trig_param.irq_ctrl = param->irq_ctrl;
+	trig_param.irq_id = param->irq_id;
+	trig_param.irq_config = param->irq_config;
+	trig_param.dev = iio_ad717x;
+	trig_param.read_scan = iio_ad717x_read_scan;
+	trig_param.scan_size = iio_ad717x_nb_channels(param->ch_mask) *
+			       sizeof(int32_t);
+	trig_param.nb_scans = param->ring_scans;
+	trig_param.get_time_ns = param->get_time_ns;
+	ret = iio_trigger_init(&iio_ad717x->trig, &trig_param);
+	if (ret < 0) {
+		free(iio_ad717x);
+		return ret;
+	}
+
+	iio_ad717x->dev_descriptor.num_ch = ARRAY_SIZE(iio_ad717x_channels);
+	iio_ad717x->dev_descriptor.channels = iio_ad717x_channels;
+	iio_ad717x->dev_descriptor.attributes = iio_ad717x_attrs;
+	iio_ad717x->dev_descriptor.prepare_transfer =
+		iio_ad717x_prepare_transfer;
+	iio_ad717x->dev_descriptor.end_transfer = iio_ad717x_end_transfer;
+	iio_ad717x->dev_descriptor.read_dev = iio_ad717x_read_dev;
+	iio_ad717x->dev_descriptor.debug_reg_read = iio_ad717x_reg_read;
+	iio_ad717x->dev_descriptor.debug_reg_write = iio_ad717x_reg_write;
+
+	*desc = iio_ad717x;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Release resources.
+ * @param desc - Descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_ad717x_remove(struct iio_ad717x_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	iio_ad717x_end_transfer(desc);
+	iio_trigger_remove(desc->trig);
+	free(desc);
+
+	return SUCCESS;
+}
@@ -0,0 +1,110 @@
+/***************************************************************************//**
+ *   @file   iio_ad717x.h
+ *   @brief  Header file of AD717X iio streaming.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef IIO_AD717X_H_
+#define IIO_AD717X_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "iio_types.h"
+#include "iio_trigger.h"
+#include "ad717x.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct iio_ad717x_init_param
+ * @brief iio_ad717x configuration.
+ */
+struct iio_ad717x_init_param {
+	/** AD717X device, already initialized */
+	ad717x_dev		*dev;
+	/** Interrupt controller the DOUT/RDY line is connected to */
+	struct irq_ctrl_desc	*irq_ctrl;
+	/** Interrupt of the DOUT/RDY line */
+	uint32_t		irq_id;
+	/** Platform specific interrupt configuration (falling edge) */
+	void			*irq_config;
+	/** Channels that may be streamed, one bit per channel */
+	uint16_t		ch_mask;
+	/** Number of scans buffered between reads */
+	uint32_t		ring_scans;
+	/** Monotonic time source in nanoseconds, may be NULL */
+	uint64_t		(*get_time_ns)(void);
+};
+
+/**
+ * @struct iio_ad717x_desc
+ * @brief iio_ad717x descriptor.
+ */
+struct iio_ad717x_desc {
+	/** iio device descriptor */
+	struct iio_device	dev_descriptor;
+	/** AD717X device */
+	ad717x_dev		*dev;
+	/** DOUT/RDY trigger, one int32_t sample per active channel per scan */
+	struct iio_trigger_desc	*trig;
+	/** Channels that may be streamed */
+	uint16_t		ch_mask;
+	/** Assembly of the scans of the channels being streamed */
+	struct iio_trigger_seq	seq;
+	/** Set to leave continuous read mode on the next conversion */
+	volatile bool		stop;
+	/** Samples dropped due to a checksum mismatch or bus error */
+	uint32_t		crc_errors;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Init function. */
+int32_t iio_ad717x_init(struct iio_ad717x_desc **desc,
+			struct iio_ad717x_init_param *param);
+/* Get desciptor. */
+void iio_ad717x_get_dev_descriptor(struct iio_ad717x_desc *desc,
+				   struct iio_device **dev_descriptor);
+/* Free the resources allocated by iio_ad717x_init(). */
+int32_t iio_ad717x_remove(struct iio_ad717x_desc *desc);
+
+#endif /* IIO_AD717X_H_ */
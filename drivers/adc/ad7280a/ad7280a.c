@@ -43,7 +43,23 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
 #include "ad7280a.h"
+#include "crc8.h"
+#include "error.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/* Keeps the compiler from moving memory accesses across it */
+#define AD7280A_BARRIER()	__asm__ __volatile__("" : : : "memory")
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+DECLARE_CRC8_TABLE(ad7280a_crc8);
+static bool ad7280a_crc8_ready;
 
 /*****************************************************************************/
 /************************ Functions Definitions ******************************/
@@ -66,11 +82,21 @@ int8_t ad7280a_init(struct ad7280a_dev **device,
 	struct ad7280a_dev *dev;
 	int8_t status;
 	uint32_t value;
+	uint8_t i;
 
-	dev = (struct ad7280a_dev *)malloc(sizeof(*dev));
+	dev = (struct ad7280a_dev *)calloc(1, sizeof(*dev));
 	if (!dev)
 		return -1;
 
+	/* One in-place 32-bit frame per conversion result, CS toggled in
+	between */
+	for (i = 0; i < AD7280A_NUM_READS; i++) {
+		dev->read_msgs[i].tx_buff = &dev->read_buf[i * 4];
+		dev->read_msgs[i].rx_buff = &dev->read_buf[i * 4];
+		dev->read_msgs[i].bytes_number = 4;
+		dev->read_msgs[i].cs_change = 1;
+	}
+
 	/* GPIO */
 	status = gpio_get(&dev->gpio_pd, &init_param.gpio_pd);
 	status |= gpio_get(&dev->gpio_cnvst, &init_param.gpio_cnvst);
@@ -83,7 +109,7 @@ int8_t ad7280a_init(struct ad7280a_dev **device,
 	AD7280A_ALERT_IN;
 
 	/* Wait 250us */
-	mdelay(250);
+	udelay(250);
 
 	status |= spi_init(&dev->spi_desc, &init_param.spi_init);
 
@@ -127,6 +153,9 @@ int32_t ad7280a_remove(struct ad7280a_dev *dev)
 {
 	int32_t ret;
 
+	if (dev->scan_irq_ctrl)
+		ad7280a_scan_disable(dev);
+
 	ret = spi_remove(dev->spi_desc);
 
 	ret |= gpio_remove(dev->gpio_pd);
@@ -170,6 +199,35 @@ uint32_t ad7280a_transfer_32bits(struct ad7280a_dev *dev,
 	return received_data;
 }
 
+/******************************************************************************
+ * @brief Computes the CRC of up to 24 message bits, with the table built on
+ *        first use.
+ *
+ * The device feeds the message bits straight into the CRC register, without
+ * augmenting it, so each byte is added after the register is shifted.
+ * Leading zero bits leave the register at 0, so shorter messages can be
+ * zero padded to 24 bits.
+ *
+ * @param bits : The message, right aligned.
+ *
+ * @return The CRC.
+******************************************************************************/
+static uint8_t ad7280a_crc(uint32_t bits)
+{
+	uint8_t crc = 0;
+	int8_t i;
+
+	if (!ad7280a_crc8_ready) {
+		crc8_populate_msb(ad7280a_crc8, AD7280A_CRC8_POLY);
+		ad7280a_crc8_ready = true;
+	}
+
+	for (i = 16; i >= 0; i -= 8)
+		crc = ad7280a_crc8[crc] ^ ((bits >> i) & 0xff);
+
+	return crc;
+}
+
 /******************************************************************************
  * @brief Computes the CRC value for a write transmission, and prepares the
  *        complete write codeword
@@ -181,45 +239,9 @@ uint32_t ad7280a_transfer_32bits(struct ad7280a_dev *dev,
 ******************************************************************************/
 uint32_t ad7280a_crc_write(uint32_t message)
 {
-	int32_t i;
-	int32_t crc;
-	int32_t xor1 = 0;
-	int32_t xor2 = 0;
-	int32_t xor3 = 0;
-	int32_t xor4 = 0;
-	int32_t xor5 = 0;
-	uint32_t data_out = 0;
-	int32_t crc0 = 0;
-	int32_t crc1 = 0;
-	int32_t crc2 = 0;
-	int32_t crc3 = 0;
-	int32_t crc4 = 0;
-	int32_t crc5 = 0;
-	int32_t crc6 = 0;
-	int32_t crc7 = 0;
-
 	message = message >> 11;
-	for (i = NUMBITS_WRITE; i >= 0; i--) {
-		xor5 = (crc4 ^ crc7) ? 1 : 0;
-		xor4 = (crc2 ^ crc7) ? 1 : 0;
-		xor3 = (crc1 ^ crc7) ? 1 : 0;
-		xor2 = (crc0 ^ crc7) ? 1 : 0;
-		xor1 = ((message & (1 << i)) ? 1 : 0) ^ (crc7 ? 1 : 0);
-		crc7 = crc6;
-		crc6 = crc5;
-		crc5 = xor5;
-		crc4 = crc3;
-		crc3 = xor4;
-		crc2 = xor3;
-		crc1 = xor2;
-		crc0 = xor1;
-	}
-	crc = (crc0 ? (1 << 0) : 0) | (crc1 ? (1 << 1) : 0) | (crc2 ? (1 << 2) : 0) |
-	      (crc3 ? (1 << 3) : 0) | (crc4 ? (1 << 4) : 0) | (crc5 ? (1 << 5) : 0) |
-	      (crc6 ? (1 << 6) : 0) | (crc7 ? (1 << 7) : 0);
-	data_out = (message << 11) | (crc << 3) | 2;
 
-	return data_out;
+	return (message << 11) | ((uint32_t)ad7280a_crc(message) << 3) | 2;
 }
 
 /******************************************************************************
@@ -233,63 +255,22 @@ uint32_t ad7280a_crc_write(uint32_t message)
 ******************************************************************************/
 int32_t ad7280a_crc_read(uint32_t message)
 {
-	int32_t i;
-	uint32_t data_in = 0;
-	int32_t crc_rec;
-	int32_t crc_computed;
-	int32_t xor1 = 0;
-	int32_t xor2 = 0;
-	int32_t xor3 = 0;
-	int32_t xor4 = 0;
-	int32_t xor5 = 0;
-	int32_t crc0 = 0;
-	int32_t crc1 = 0;
-	int32_t crc2 = 0;
-	int32_t crc3 = 0;
-	int32_t crc4 = 0;
-	int32_t crc5 = 0;
-	int32_t crc6 = 0;
-	int32_t crc7 = 0;
-
-	crc_rec= (message >> 2) & 0xFF;
-	data_in = message >> 10;
-	for (i = NUMBITS_READ; i >= 0; i--) {
-		xor5 = (crc4 ^ crc7) ? 1 : 0;
-		xor4 = (crc2 ^ crc7) ? 1 : 0;
-		xor3 = (crc1 ^ crc7) ? 1 : 0;
-		xor2 = (crc0 ^ crc7) ? 1 : 0;
-		xor1 = ((data_in & (1 << i)) ? 1 : 0) ^ (crc7 ? 1 : 0);
-		crc7 = crc6;
-		crc6 = crc5;
-		crc5 = xor5;
-		crc4 = crc3;
-		crc3 = xor4;
-		crc2 = xor3;
-		crc1 = xor2;
-		crc0 = xor1;
-	}
-	crc_computed = (crc0 ? (1 << 0) : 0) | (crc1 ? (1 << 1) : 0) |
-		       (crc2 ? (1 << 2) : 0) | (crc3 ? (1 << 3) : 0) |
-		       (crc4 ? (1 << 4) : 0) | (crc5 ? (1 << 5) : 0) |
-		       (crc6 ? (1 << 6) : 0) | (crc7 ? (1 << 7) : 0);
-	if (crc_rec == crc_computed) {
-		return 1;
-	} else {
-		return 0;
-	}
+	uint8_t crc_rec = (message >> 2) & 0xFF;
+
+	return ad7280a_crc(message >> 10) == crc_rec;
 }
 
 /******************************************************************************
- * @brief Performs a read from all registers on 2 devices.
+ * @brief Configures the chain and starts the conversion of all channels. The
+ *        results can be read with ad7280a_scan_fetch() AD7280A_T_CONV_US
+ *        later.
  *
  * @param dev - The device structure.
  *
- * @return 1.
+ * @return 0 in case of success, -1 otherwise.
 ******************************************************************************/
-int8_t ad7280a_convert_read_all(struct ad7280a_dev *dev)
+int8_t ad7280a_scan_start(struct ad7280a_dev *dev)
 {
-	uint8_t i;
-	//long err = 1;
 	uint32_t value;
 
 	/* Configure Control HB register. Read all register, convert all registers,
@@ -313,36 +294,244 @@ int8_t ad7280a_convert_read_all(struct ad7280a_dev *dev)
 				  (1 << 12));
 	ad7280a_transfer_32bits(dev,
 				value);
-	/* Wait 100us */
-	mdelay(100);
+	udelay(AD7280A_T_SETUP_US);
 	/* Toggle CNVST pin */
-	AD7280A_CNVST_LOW;
-	/* Wait 50us */
-	mdelay(50);
-	AD7280A_CNVST_HIGH;
-	/* Wait 300us */
-	mdelay(300);
-	/* Read data from both devices */
-	for(i = 0; i < 24; i++) {
-		dev->read_data[i] = ad7280a_transfer_32bits(dev,
-				    AD7280A_READ_TXVAL);
+	if (AD7280A_CNVST_LOW)
+		return -1;
+	udelay(AD7280A_T_CNVST_US);
+	if (AD7280A_CNVST_HIGH)
+		return -1;
+
+	return 0;
+}
+
+/******************************************************************************
+ * @brief Reads the conversion results of all devices in one chained transfer
+ *        and converts them to float values.
+ *
+ * @param dev - The device structure.
+ *
+ * @return 0 in case of success, -1 if the transfer failed or a frame had a
+ *         CRC mismatch.
+******************************************************************************/
+int8_t ad7280a_scan_fetch(struct ad7280a_dev *dev)
+{
+	uint8_t *rx = dev->read_buf;
+	int8_t status = 0;
+	uint8_t i;
+
+	/* The frames are received in place of the read commands */
+	for (i = 0; i < AD7280A_NUM_READS; i++) {
+		rx[i * 4] = (AD7280A_READ_TXVAL >> 24) & 0xff;
+		rx[i * 4 + 1] = (AD7280A_READ_TXVAL >> 16) & 0xff;
+		rx[i * 4 + 2] = (AD7280A_READ_TXVAL >> 8) & 0xff;
+		rx[i * 4 + 3] = (AD7280A_READ_TXVAL >> 0) & 0xff;
 	}
 
-	// Optionally check all received data to make sure CRC is correct
-	/*for(i=0;i<24;i++)
-	{
-	    if ( crc_read(dev->readData[i]) == 0 )
-	    {
-	        err = 0;
-	    }
-	}*/
+	if (spi_transfer(dev->spi_desc, dev->read_msgs, AD7280A_NUM_READS))
+		return -1;
+
+	for (i = 0; i < AD7280A_NUM_READS; i++, rx += 4) {
+		dev->read_data[i] = ((uint32_t)rx[0] << 24) |
+				    ((uint32_t)rx[1] << 16) |
+				    ((uint32_t)rx[2] << 8) | rx[3];
+		if (!ad7280a_crc_read(dev->read_data[i])) {
+			dev->crc_errors++;
+			status = -1;
+		}
+	}
+	if (status)
+		return status;
 
 	/* Convert the received data to float values. */
 	ad7280a_convert_data_all(dev);
 
+	return 0;
+}
+
+/******************************************************************************
+ * @brief Performs a read from all registers on 2 devices.
+ *
+ * @param dev - The device structure.
+ *
+ * @return 1 in case of success, -1 if the transfer failed or a frame had a
+ *         CRC mismatch.
+******************************************************************************/
+int8_t ad7280a_convert_read_all(struct ad7280a_dev *dev)
+{
+	if (ad7280a_scan_start(dev))
+		return -1;
+
+	udelay(AD7280A_T_CONV_US);
+
+	if (ad7280a_scan_fetch(dev))
+		return -1;
+
 	return (1);
 }
 
+/******************************************************************************
+ * @brief Periodic interrupt handler of the background scan. The conversion
+ *        started by ad7280a_scan_restart() is left running for one full
+ *        period, then its results are fetched into the snapshot. Nothing
+ *        else is done here: no delays and no buffer allocation.
+ *
+ * @param ctx   - The device structure.
+ *        event - Unused.
+ *        extra - Unused.
+******************************************************************************/
+static void ad7280a_scan_handler(void *ctx, uint32_t event, void *extra)
+{
+	struct ad7280a_dev *dev = ctx;
+
+	switch (dev->scan_state) {
+	case AD7280A_SCAN_STARTED:
+		dev->scan_state = AD7280A_SCAN_CONVERTING;
+		return;
+	case AD7280A_SCAN_CONVERTING:
+		break;
+	default:
+		return;
+	}
+
+	if (!ad7280a_scan_fetch(dev)) {
+		dev->snapshot_seq++;
+		AD7280A_BARRIER();
+		memcpy(dev->snapshot.cell_voltage, dev->cell_voltage,
+		       sizeof(dev->snapshot.cell_voltage));
+		memcpy(dev->snapshot.aux_adc, dev->aux_adc,
+		       sizeof(dev->snapshot.aux_adc));
+		dev->snapshot.nb_scans++;
+		AD7280A_BARRIER();
+		dev->snapshot_seq++;
+	}
+
+	dev->scan_state = AD7280A_SCAN_IDLE;
+}
+
+/******************************************************************************
+ * @brief Starts scanning the chain in the background, with a first
+ *        conversion. The interrupt fetches the results, the next conversions
+ *        are started by ad7280a_scan_restart().
+ *
+ * @param dev   - The device structure.
+ *        param - The periodic interrupt to use.
+ *
+ * @return SUCCESS in case of success, negative error code otherwise.
+******************************************************************************/
+int32_t ad7280a_scan_enable(struct ad7280a_dev *dev,
+			    struct ad7280a_scan_init_param *param)
+{
+	int32_t ret;
+
+	if (!dev || !param || !param->irq_ctrl || dev->scan_irq_ctrl)
+		return -EINVAL;
+
+	dev->scan_irq_ctrl = param->irq_ctrl;
+	dev->scan_irq_id = param->irq_id;
+	dev->scan_cb.callback = ad7280a_scan_handler;
+	dev->scan_cb.ctx = dev;
+	dev->scan_cb.config = param->irq_config;
+	dev->scan_state = AD7280A_SCAN_IDLE;
+	dev->snapshot.nb_scans = 0;
+
+	ret = irq_register_callback(dev->scan_irq_ctrl, dev->scan_irq_id,
+				    &dev->scan_cb);
+	if (ret < 0)
+		goto error;
+
+	ret = irq_enable(dev->scan_irq_ctrl, dev->scan_irq_id);
+	if (ret < 0)
+		goto error_unregister;
+
+	ret = ad7280a_scan_restart(dev);
+	if (ret < 0)
+		goto error_disable;
+
+	return SUCCESS;
+error_disable:
+	irq_disable(dev->scan_irq_ctrl, dev->scan_irq_id);
+error_unregister:
+	irq_unregister(dev->scan_irq_ctrl, dev->scan_irq_id);
+error:
+	dev->scan_irq_ctrl = NULL;
+
+	return ret;
+}
+
+/******************************************************************************
+ * @brief Starts the next background scan once the previous one has been
+ *        fetched. The register writes and the CNVST pulse take about
+ *        AD7280A_T_SETUP_US + AD7280A_T_CNVST_US, so this is called from
+ *        task context, typically from the main loop.
+ *
+ * @param dev - The device structure.
+ *
+ * @return SUCCESS in case of success, -EBUSY if a scan is still in progress,
+ *         negative error code otherwise.
+******************************************************************************/
+int32_t ad7280a_scan_restart(struct ad7280a_dev *dev)
+{
+	if (!dev || !dev->scan_irq_ctrl)
+		return -EINVAL;
+
+	if (dev->scan_state != AD7280A_SCAN_IDLE)
+		return -EBUSY;
+
+	if (ad7280a_scan_start(dev))
+		return FAILURE;
+
+	/* The interrupt does not touch the bus until this is set */
+	dev->scan_state = AD7280A_SCAN_STARTED;
+
+	return SUCCESS;
+}
+
+/******************************************************************************
+ * @brief Stops the background scan. The last snapshot stays available.
+ *
+ * @param dev - The device structure.
+ *
+ * @return SUCCESS in case of success, negative error code otherwise.
+******************************************************************************/
+int32_t ad7280a_scan_disable(struct ad7280a_dev *dev)
+{
+	int32_t ret;
+
+	if (!dev || !dev->scan_irq_ctrl)
+		return -EINVAL;
+
+	ret = irq_disable(dev->scan_irq_ctrl, dev->scan_irq_id);
+	if (ret < 0)
+		return ret;
+
+	irq_unregister(dev->scan_irq_ctrl, dev->scan_irq_id);
+	dev->scan_irq_ctrl = NULL;
+	dev->scan_state = AD7280A_SCAN_IDLE;
+
+	return SUCCESS;
+}
+
+/******************************************************************************
+ * @brief Gets a consistent copy of the last background scan result, retrying
+ *        if the scan updated it during the copy.
+ *
+ * @param dev      - The device structure.
+ *        snapshot - Where to store the copy.
+******************************************************************************/
+void ad7280a_get_snapshot(struct ad7280a_dev *dev,
+			  struct ad7280a_snapshot *snapshot)
+{
+	uint32_t seq;
+
+	do {
+		seq = dev->snapshot_seq;
+		AD7280A_BARRIER();
+		memcpy(snapshot, &dev->snapshot, sizeof(*snapshot));
+		AD7280A_BARRIER();
+	} while ((seq & 1) || seq != dev->snapshot_seq);
+}
+
 /******************************************************************************
  * @brief Converts acquired data from all channels to float values.
  *
@@ -407,7 +596,7 @@ int16_t ad7280a_read_register(struct ad7280a_dev *dev,
 	ad7280a_transfer_32bits(dev,
 				value);
 	/* Wait 100us */
-	mdelay(100);
+	udelay(100);
 	/* Configure the Read register */
 	value = ad7280a_crc_write((uint32_t) (dev_addr << 31) |
 				  (AD7280A_READ << 21) |
@@ -465,7 +654,7 @@ int16_t ad7280a_read_conversion(struct ad7280a_dev *dev,
 	ad7280a_transfer_32bits(dev,
 				value);
 	/* Wait 100us */
-	mdelay(100);
+	udelay(100);
 	/*  */
 	value = ad7280a_crc_write((uint32_t)(dev_addr << 31) |
 				  (AD7280A_CONTROL_HB << 21) |
@@ -474,7 +663,7 @@ int16_t ad7280a_read_conversion(struct ad7280a_dev *dev,
 	ad7280a_transfer_32bits(dev,
 				value);
 	/* Wait 100us */
-	mdelay(100);
+	udelay(100);
 	/* Allow conversions to be initiated using CNVST pin on selected part */
 	value=ad7280a_crc_write((uint32_t)(dev_addr << 31) |
 				(AD7280A_CNVST_N_CONTROL << 21) |
@@ -486,10 +675,10 @@ int16_t ad7280a_read_conversion(struct ad7280a_dev *dev,
 	AD7280A_CNVST_LOW;
 	/* Allow sufficient time for all conversions to be completed */
 	/* Wait 50us */
-	mdelay(50);
+	udelay(50);
 	AD7280A_CNVST_HIGH;
 	/* Wait 300us */
-	mdelay(300);
+	udelay(300);
 	/* Perform the read */
 	value = ad7280a_transfer_32bits(dev,
 					AD7280A_READ_TXVAL);
@@ -701,7 +890,7 @@ void ad7280a_selftest_all(struct ad7280a_dev *dev,
 	ad7280a_transfer_32bits(dev,
 				value);
 	/* Wait 100us */
-	mdelay(100);
+	udelay(100);
 	value = ad7280a_crc_write((uint32_t) (AD7280A_READ << 21) |
 				  (AD7280A_SELF_TEST << 15)            |
 				  (1 << 12));
@@ -716,10 +905,10 @@ void ad7280a_selftest_all(struct ad7280a_dev *dev,
 				value);
 	AD7280A_CNVST_LOW;
 	/* wait 100us */
-	mdelay(100);
+	udelay(100);
 	AD7280A_CNVST_HIGH;
 	/* wait 300us */
-	mdelay(300);
+	udelay(300);
 	value = ad7280a_crc_write((uint32_t) (AD7280A_CNVST_N_CONTROL << 21) |
 				  (1 << 13)                       |
 				  (1 << 12));
@@ -50,6 +50,7 @@
 #include "delay.h"
 #include "gpio.h"
 #include "spi.h"
+#include "irq.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -165,9 +166,39 @@
 #define NUMBITS_READ        22   // Number of bits for CRC when reading
 #define NUMBITS_WRITE       21   // Number of bits for CRC when writing
 
+/* CRC-8 polynomial x^8 + x^5 + x^3 + x^2 + x + 1 */
+#define AD7280A_CRC8_POLY       0x2F
+
+/* Daisy chain */
+#define AD7280A_NUM_DEVICES     2
+#define AD7280A_NUM_READS       (AD7280A_NUM_DEVICES * 12)
+
+/* Timings, in microseconds */
+#define AD7280A_T_SETUP_US      100  // Control register update to CNVST
+#define AD7280A_T_CNVST_US      50   // CNVST low pulse
+#define AD7280A_T_CONV_US       300  // Conversion of all channels, 8 averages
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
+/* Progress of the background scan. */
+enum ad7280a_scan_state {
+	/* No conversion, ad7280a_scan_restart() starts one */
+	AD7280A_SCAN_IDLE,
+	/* Conversion started, no interrupt seen yet */
+	AD7280A_SCAN_STARTED,
+	/* Converting, the next interrupt fetches the results */
+	AD7280A_SCAN_CONVERTING,
+};
+
+/* Result of the last complete scan of the chain. */
+struct ad7280a_snapshot {
+	float			cell_voltage[AD7280A_NUM_READS / 2];
+	float			aux_adc[AD7280A_NUM_READS / 2];
+	/* Number of scans completed since the scan was enabled */
+	uint32_t		nb_scans;
+};
+
 struct ad7280a_dev {
 	/* SPI */
 	spi_desc		*spi_desc;
@@ -176,9 +207,32 @@ struct ad7280a_dev {
 	struct gpio_desc	*gpio_cnvst;
 	struct gpio_desc	*gpio_alert;
 	/* Device Settings */
-	uint32_t		read_data[24];
-	float			cell_voltage[12];
-	float			aux_adc[12];
+	uint32_t		read_data[AD7280A_NUM_READS];
+	float			cell_voltage[AD7280A_NUM_READS / 2];
+	float			aux_adc[AD7280A_NUM_READS / 2];
+	/* Chained read of all the conversion results, in place */
+	uint8_t			read_buf[AD7280A_NUM_READS * 4];
+	struct spi_msg		read_msgs[AD7280A_NUM_READS];
+	/* Frames received with a CRC mismatch */
+	uint32_t		crc_errors;
+	/* Background scan */
+	struct irq_ctrl_desc	*scan_irq_ctrl;
+	uint32_t		scan_irq_id;
+	struct callback_desc	scan_cb;
+	volatile enum ad7280a_scan_state	scan_state;
+	struct ad7280a_snapshot	snapshot;
+	/* Odd while the snapshot is being updated */
+	volatile uint32_t	snapshot_seq;
+};
+
+struct ad7280a_scan_init_param {
+	/*
+	 * Periodic interrupt, its period must exceed AD7280A_T_CONV_US. The
+	 * results are fetched one to two periods after the conversion start.
+	 */
+	struct irq_ctrl_desc	*irq_ctrl;
+	uint32_t		irq_id;
+	void			*irq_config;
 };
 
 struct ad7280a_init_param {
@@ -215,6 +269,26 @@ int32_t ad7280a_crc_read(uint32_t message);
 /* Performs a read from all registers on 2 devices. */
 int8_t ad7280a_convert_read_all(struct ad7280a_dev *dev);
 
+/* Configures the chain and starts the conversion of all channels. */
+int8_t ad7280a_scan_start(struct ad7280a_dev *dev);
+
+/* Reads the conversion results of all devices in one chained transfer. */
+int8_t ad7280a_scan_fetch(struct ad7280a_dev *dev);
+
+/* Starts scanning the chain in the background on a periodic interrupt. */
+int32_t ad7280a_scan_enable(struct ad7280a_dev *dev,
+			    struct ad7280a_scan_init_param *param);
+
+/* Starts the next background scan, from task context. */
+int32_t ad7280a_scan_restart(struct ad7280a_dev *dev);
+
+/* Stops the background scan. */
+int32_t ad7280a_scan_disable(struct ad7280a_dev *dev);
+
+/* Gets a consistent copy of the last background scan result. */
+void ad7280a_get_snapshot(struct ad7280a_dev *dev,
+			  struct ad7280a_snapshot *snapshot);
+
 /* Converts acquired data to float values. */
 int8_t ad7280a_convert_data_all(struct ad7280a_dev *dev);
 
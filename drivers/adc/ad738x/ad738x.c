@@ -268,16 +268,12 @@ int32_t ad738x_reference_sel(struct ad738x_dev *dev,
 }
 
 /**
- * @brief Read from device.
- *        Enter register mode to read/write registers
+ * @brief Load the SPI Engine offload message used by ad738x_read_data(), so
+ *        each capture only has to start the DMA.
  * @param dev - ad738x_dev device handler.
- * @param buf - data buffer.
- * @param samples - sample number.
  * @return \ref SUCCESS in case of success, \ref FAILURE otherwise.
  */
-int32_t ad738x_read_data(struct ad738x_dev *dev,
-			 uint32_t *buf,
-			 uint16_t samples)
+static int32_t ad738x_capture_setup(struct ad738x_dev *dev)
 {
 	int32_t ret;
 	uint32_t commands_data[2] = {0, 0};
@@ -288,6 +284,9 @@ int32_t ad738x_read_data(struct ad738x_dev *dev,
 		CS_HIGH,
 	};
 
+	if (!dev->offload_init_param)
+		return SUCCESS;
+
 	ret = spi_engine_offload_init(dev->spi_desc, dev->offload_init_param);
 	if (ret != SUCCESS)
 		return ret;
@@ -295,14 +294,30 @@ int32_t ad738x_read_data(struct ad738x_dev *dev,
 	msg.commands_data = commands_data;
 	msg.commands = spi_eng_msg_cmds;
 	msg.no_commands = ARRAY_SIZE(spi_eng_msg_cmds);
-	msg.rx_addr = (uint32_t)buf;
 
-	ret = spi_engine_offload_transfer(dev->spi_desc, msg, samples);
+	return spi_engine_offload_load(dev->spi_desc, &msg);
+}
+
+/**
+ * @brief Read from device.
+ *        Enter register mode to read/write registers
+ * @param dev - ad738x_dev device handler.
+ * @param buf - data buffer.
+ * @param samples - sample number.
+ * @return \ref SUCCESS in case of success, \ref FAILURE otherwise.
+ */
+int32_t ad738x_read_data(struct ad738x_dev *dev,
+			 uint32_t *buf,
+			 uint16_t samples)
+{
+	int32_t ret;
+
+	ret = spi_engine_offload_arm(dev->spi_desc, 0, (uint32_t)buf, samples);
 	if (ret != SUCCESS)
 		return ret;
 
 	if (dev->dcache_invalidate_range)
-		dev->dcache_invalidate_range(msg.rx_addr, samples * 2);
+		dev->dcache_invalidate_range((uint32_t)buf, samples * 2);
 
 	return ret;
 }
@@ -338,6 +353,8 @@ int32_t ad738x_init(struct ad738x_dev **device,
 	ret |= ad738x_set_conversion_mode(dev, dev->conv_mode);
 	/* Set internal or external reference */
 	ret |= ad738x_reference_sel(dev, dev->ref_sel);
+	/* Load the offload message once, captures only kick the DMA */
+	ret |= ad738x_capture_setup(dev);
 
 	*device = dev;
 
@@ -356,6 +373,7 @@ int32_t ad738x_remove(struct ad738x_dev *dev)
 {
 	int32_t ret;
 
+	spi_engine_offload_remove(dev->spi_desc);
 	ret = spi_remove(dev->spi_desc);
 
 	free(dev);
@@ -50,6 +50,7 @@
 #include "error.h"
 #include "util.h"
 #include "crc.h"
+#include "unpack.h"
 
 struct ad7606_chip_info {
 	uint8_t num_channels;
@@ -354,52 +355,6 @@ int32_t ad7606_spi_write_mask(struct ad7606_dev *dev,
 	return ad7606_spi_reg_write(dev, addr, reg_data);
 }
 
-/* Internal function to copy the content of a buffer in 18-bit chunks to a 32-bit buffer by
- * extending the chunks to 32-bit size. */
-static int32_t cpy18b32b(uint8_t *psrc, uint32_t srcsz, uint32_t *pdst)
-{
-	unsigned int i, j;
-
-	if (srcsz % 9)
-		return -EINVAL;
-
-	for(i = 0; i < srcsz; i += 9) {
-		j = 4 * (i / 9);
-		pdst[j+0] = ((uint32_t)(psrc[i+0] & 0xff) << 10) | ((uint32_t)psrc[i+1] << 2)
-			    | ((uint32_t)psrc[i+2] >> 6);
-		pdst[j+1] = ((uint32_t)(psrc[i+2] & 0x3f) << 12) | ((uint32_t)psrc[i+3] << 4)
-			    | ((uint32_t)psrc[i+4] >> 4);
-		pdst[j+2] = ((uint32_t)(psrc[i+4] & 0x0f) << 14) | ((uint32_t)psrc[i+5] << 6)
-			    | ((uint32_t)psrc[i+6] >> 2);
-		pdst[j+3] = ((uint32_t)(psrc[i+6] & 0x03) << 16) | ((uint32_t)psrc[i+7] << 8)
-			    | ((uint32_t)psrc[i+8] >> 0);
-	}
-	return SUCCESS;
-}
-
-/* Internal function to copy the content of a buffer in 26-bit chunks to a 32-bit buffer by
- * extending the chunks to 32-bit size. */
-static int32_t cpy26b32b(uint8_t *psrc, uint32_t srcsz, uint32_t *pdst)
-{
-	unsigned int i, j;
-
-	if (srcsz % 13)
-		return -EINVAL;
-
-	for(i = 0; i < srcsz; i += 13) {
-		j = 4 * (i / 13);
-		pdst[j+0] = ((uint32_t)(psrc[i+0] & 0xff) << 18) | ((uint32_t)psrc[i+1] << 10)
-			    | ((uint32_t)psrc[i+2] << 2) | ((uint32_t)psrc[i+3] >> 6);
-		pdst[j+1] = ((uint32_t)(psrc[i+3] & 0x3f) << 20) | ((uint32_t)psrc[i+4] << 12)
-			    | ((uint32_t)psrc[i+5] << 4) | ((uint32_t)psrc[i+6] >> 4);
-		pdst[j+2] = ((uint32_t)(psrc[i+6] & 0x0f) << 22) | ((uint32_t)psrc[i+7] << 14)
-			    | ((uint32_t)psrc[i+8] << 6) | ((uint32_t)psrc[i+9] >> 2);
-		pdst[j+3] = ((uint32_t)(psrc[i+9] & 0x03) << 24) | ((uint32_t)psrc[i+10] << 16)
-			    | ((uint32_t)psrc[i+11] << 8) | ((uint32_t)psrc[i+12] >> 0);
-	}
-	return SUCCESS;
-}
-
 /***************************************************************************//**
  * @brief Toggle the CONVST pin to start a conversion.
  *
@@ -436,31 +391,11 @@ int32_t ad7606_convst(struct ad7606_dev *dev)
 	return gpio_set_value(dev->gpio_convst, 1);
 }
 
-/***************************************************************************//**
- * @brief Read conversion data.
- *
- * This function performs CRC16 computation and checking if enabled in the device.
- * If the status is enabled in device settings, each sample of data will contain
- * status information in the lowest 8 bits.
- *
- * The output buffer provided by the user should be as wide as to be able to
- * contain 1 sample from each channel since this function reads conversion data
- * across all channels.
- *
- * @param dev        - The device structure.
- * @param data       - Pointer to location of buffer where to store the data.
- *
- * @return ret - return code.
- *         Example: -EIO - SPI communication error.
- *                  -EBADMSG - CRC computation mismatch.
- *                  -ENOTSUP - Device bits per sample not supported.
- *                  SUCCESS - No errors encountered.
-*******************************************************************************/
-int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
+/* Internal function to get the size in bytes of a conversion data frame,
+ * including the CRC if enabled. */
+static uint32_t ad7606_frame_size(struct ad7606_dev *dev)
 {
 	uint32_t sz;
-	int32_t ret, i;
-	uint16_t crc, icrc;
 	uint8_t bits = ad7606_chip_info_tbl[dev->device_id].bits;
 	uint8_t sbits = dev->config.status_header ? 8 : 0;
 	uint8_t nchannels = ad7606_chip_info_tbl[dev->device_id].num_channels;
@@ -481,10 +416,18 @@ int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
 		sz += 2;
 	}
 
-	memset(dev->data, 0, sz);
-	ret = spi_write_and_read(dev->spi_desc, dev->data, sz);
-	if (ret < 0)
-		return ret;
+	return sz;
+}
+
+/* Internal function to check the CRC of the conversion data frame in
+ * dev->data and unpack the samples. */
+static int32_t ad7606_frame_decode(struct ad7606_dev *dev, uint32_t *data)
+{
+	uint32_t sz = ad7606_frame_size(dev);
+	uint16_t crc, icrc;
+	uint8_t bits = ad7606_chip_info_tbl[dev->device_id].bits;
+	uint8_t sbits = dev->config.status_header ? 8 : 0;
+	uint8_t nchannels = ad7606_chip_info_tbl[dev->device_id].num_channels;
 
 	if (dev->digital_diag_enable.int_crc_err_en) {
 		sz -= 2;
@@ -497,31 +440,45 @@ int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
 
 	switch(bits) {
 	case 18:
-		if (dev->config.status_header)
-			ret = cpy26b32b(dev->data, sz, data);
-		else
-			ret = cpy18b32b(dev->data, sz, data);
-		if (ret < 0)
-			return ret;
-		break;
 	case 16:
-		for(i = 0; i < nchannels; i++) {
-			if (dev->config.status_header) {
-				data[i] = (uint32_t)dev->data[i*3] << 16;
-				data[i] |= (uint32_t)dev->data[i*3+1] << 8;
-				data[i] |= (uint32_t)dev->data[i*3+2];
-			} else {
-				data[i] = (uint32_t)dev->data[i*2] << 8;
-				data[i] |= (uint32_t)dev->data[i*2+1];
-			}
-		}
-		break;
+		/* The status byte, if enabled, is kept in the lowest 8 bits */
+		return unpack_u32(data, dev->data, nchannels, bits + sbits);
 	default:
-		ret = -ENOTSUP;
-		break;
+		return -ENOTSUP;
 	};
+}
 
-	return ret;
+/***************************************************************************//**
+ * @brief Read conversion data.
+ *
+ * This function performs CRC16 computation and checking if enabled in the device.
+ * If the status is enabled in device settings, each sample of data will contain
+ * status information in the lowest 8 bits.
+ *
+ * The output buffer provided by the user should be as wide as to be able to
+ * contain 1 sample from each channel since this function reads conversion data
+ * across all channels.
+ *
+ * @param dev        - The device structure.
+ * @param data       - Pointer to location of buffer where to store the data.
+ *
+ * @return ret - return code.
+ *         Example: -EIO - SPI communication error.
+ *                  -EBADMSG - CRC computation mismatch.
+ *                  -ENOTSUP - Device bits per sample not supported.
+ *                  SUCCESS - No errors encountered.
+*******************************************************************************/
+int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
+{
+	uint32_t sz = ad7606_frame_size(dev);
+	int32_t ret;
+
+	memset(dev->data, 0, sz);
+	ret = spi_write_and_read(dev->spi_desc, dev->data, sz);
+	if (ret < 0)
+		return ret;
+
+	return ad7606_frame_decode(dev, data);
 }
 
 /***************************************************************************//**
@@ -1233,6 +1190,9 @@ int32_t ad7606_remove(struct ad7606_dev *dev)
 {
 	int32_t ret;
 
+	if (dev->burst)
+		ad7606_burst_remove(dev);
+
 	gpio_remove(dev->gpio_reset);
 	gpio_remove(dev->gpio_convst);
 	gpio_remove(dev->gpio_busy);
@@ -1249,3 +1209,249 @@ int32_t ad7606_remove(struct ad7606_dev *dev)
 
 	return ret;
 }
+
+/* Internal function called on the BUSY falling edge during burst acquisition.
+ * Reads the frame, checks its CRC and unpacks it into the ring. */
+static void ad7606_busy_handler(void *ctx, uint32_t event, void *extra)
+{
+	struct ad7606_dev *dev = ctx;
+	struct ad7606_burst *burst = dev->burst;
+	uint32_t sz;
+	int32_t ret;
+
+	if (!burst->active)
+		return;
+
+	/* Drop the frame rather than overwrite the ones not read yet */
+	cb_size(burst->ring, &sz);
+	if (sz + burst->frame_size > burst->ring_size) {
+		burst->overruns++;
+		return;
+	}
+
+	sz = ad7606_frame_size(dev);
+	memset(dev->data, 0, sz);
+	ret = spi_write_and_read(dev->spi_desc, dev->data, sz);
+	if (ret == SUCCESS)
+		ret = ad7606_frame_decode(dev, burst->frame);
+	if (ret < 0) {
+		burst->errors++;
+		return;
+	}
+
+	cb_write(burst->ring, burst->frame, burst->frame_size);
+
+	if (burst->frames_left && !--burst->frames_left) {
+		pwm_disable(burst->convst_pwm);
+		burst->active = false;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Set up burst acquisition.
+ *
+ * Conversions are started by a PWM on CONVST and every frame is read on the
+ * BUSY falling edge interrupt, without CPU involvement between frames. The
+ * frames are checked against their CRC, if enabled, and unpacked into a ring
+ * allocated here.
+ *
+ * @param dev        - The device structure.
+ * @param param      - Burst acquisition parameters.
+ *
+ * @return ret - return code.
+ *         Example: -EINVAL - Invalid parameters.
+ *                  -ENOMEM - Memory allocation failure.
+ *                  SUCCESS - No errors encountered.
+*******************************************************************************/
+int32_t ad7606_burst_init(struct ad7606_dev *dev,
+			  struct ad7606_burst_init_param *param)
+{
+	struct ad7606_burst *burst;
+	int32_t ret;
+
+	if (!dev || dev->burst || !param || !param->convst_pwm ||
+	    !param->irq_ctrl || !param->ring_frames)
+		return -EINVAL;
+
+	burst = (struct ad7606_burst *)calloc(1, sizeof(*burst));
+	if (!burst)
+		return -ENOMEM;
+
+	burst->irq_ctrl = param->irq_ctrl;
+	burst->busy_irq_id = param->busy_irq_id;
+	burst->busy_cb.callback = ad7606_busy_handler;
+	burst->busy_cb.ctx = dev;
+	burst->busy_cb.config = param->busy_irq_config;
+	burst->frame_size = dev->num_channels * sizeof(uint32_t);
+	burst->ring_size = param->ring_frames * burst->frame_size;
+
+	ret = cb_init(&burst->ring, burst->ring_size);
+	if (ret < 0)
+		goto error_burst;
+
+	ret = pwm_init(&burst->convst_pwm, param->convst_pwm);
+	if (ret < 0)
+		goto error_ring;
+
+	ret = irq_register_callback(burst->irq_ctrl, burst->busy_irq_id,
+				    &burst->busy_cb);
+	if (ret < 0)
+		goto error_pwm;
+
+	dev->burst = burst;
+
+	return SUCCESS;
+
+error_pwm:
+	pwm_remove(burst->convst_pwm);
+error_ring:
+	cb_remove(burst->ring);
+error_burst:
+	free(burst);
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Start burst acquisition.
+ *
+ * Frames left in the ring from a previous burst are discarded.
+ *
+ * @param dev        - The device structure.
+ * @param nb_frames  - Number of frames to collect, 0 to run until
+ *                     ad7606_burst_stop().
+ *
+ * @return ret - return code.
+ *         Example: -EINVAL - Burst acquisition not set up.
+ *                  -EIO - SPI communication error.
+ *                  SUCCESS - No errors encountered.
+*******************************************************************************/
+int32_t ad7606_burst_start(struct ad7606_dev *dev, uint32_t nb_frames)
+{
+	struct ad7606_burst *burst;
+	uint32_t sz;
+	int32_t ret;
+
+	if (!dev || !dev->burst)
+		return -EINVAL;
+
+	burst = dev->burst;
+	if (burst->active)
+		return -EBUSY;
+
+	if (dev->reg_mode) {
+		/* Enter ADC reading mode by writing at address zero. */
+		ret = ad7606_spi_reg_write(dev, 0, 0);
+		if (ret < 0)
+			return ret;
+
+		dev->reg_mode = false;
+	}
+
+	cb_size(burst->ring, &sz);
+	while (sz) {
+		cb_read(burst->ring, burst->frame, burst->frame_size);
+		sz -= burst->frame_size;
+	}
+	burst->overruns = 0;
+	burst->errors = 0;
+	burst->frames_left = nb_frames;
+	burst->active = true;
+
+	ret = irq_enable(burst->irq_ctrl, burst->busy_irq_id);
+	if (ret < 0)
+		goto error;
+
+	ret = pwm_enable(burst->convst_pwm);
+	if (ret < 0)
+		goto error_irq;
+
+	return SUCCESS;
+
+error_irq:
+	irq_disable(burst->irq_ctrl, burst->busy_irq_id);
+error:
+	burst->active = false;
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Read frames collected by burst acquisition.
+ *
+ * Blocks until nb_frames frames are available. Each frame holds one sample
+ * per channel, in the same format as ad7606_spi_data_read().
+ *
+ * @param dev        - The device structure.
+ * @param data       - Buffer of nb_frames * num_channels samples.
+ * @param nb_frames  - Number of frames to read.
+ *
+ * @return ret - return code.
+ *         Example: -EINVAL - Burst acquisition not set up.
+ *                  SUCCESS - No errors encountered.
+*******************************************************************************/
+int32_t ad7606_burst_read(struct ad7606_dev *dev, uint32_t *data,
+			  uint32_t nb_frames)
+{
+	if (!dev || !dev->burst || !data)
+		return -EINVAL;
+
+	return cb_read(dev->burst->ring, data,
+		       nb_frames * dev->burst->frame_size);
+}
+
+/***************************************************************************//**
+ * @brief Stop burst acquisition.
+ *
+ * Frames already in the ring can still be read.
+ *
+ * @param dev        - The device structure.
+ *
+ * @return ret - return code.
+ *         Example: -EINVAL - Burst acquisition not set up.
+ *                  SUCCESS - No errors encountered.
+*******************************************************************************/
+int32_t ad7606_burst_stop(struct ad7606_dev *dev)
+{
+	struct ad7606_burst *burst;
+	int32_t ret;
+
+	if (!dev || !dev->burst)
+		return -EINVAL;
+
+	burst = dev->burst;
+	ret = pwm_disable(burst->convst_pwm);
+	if (ret < 0)
+		return ret;
+
+	burst->active = false;
+
+	return irq_disable(burst->irq_ctrl, burst->busy_irq_id);
+}
+
+/***************************************************************************//**
+ * @brief Free the resources allocated by ad7606_burst_init().
+ *
+ * @param dev        - The device structure.
+ *
+ * @return ret - return code.
+ *         Example: -EINVAL - Burst acquisition not set up.
+ *                  SUCCESS - No errors encountered.
+*******************************************************************************/
+int32_t ad7606_burst_remove(struct ad7606_dev *dev)
+{
+	struct ad7606_burst *burst;
+
+	if (!dev || !dev->burst)
+		return -EINVAL;
+
+	burst = dev->burst;
+	ad7606_burst_stop(dev);
+	irq_unregister(burst->irq_ctrl, burst->busy_irq_id);
+	pwm_remove(burst->convst_pwm);
+	cb_remove(burst->ring);
+	free(burst);
+	dev->burst = NULL;
+
+	return SUCCESS;
+}
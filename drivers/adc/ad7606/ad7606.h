@@ -48,6 +48,9 @@
 #include "delay.h"
 #include "gpio.h"
 #include "spi.h"
+#include "pwm.h"
+#include "irq.h"
+#include "circular_buffer.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -263,6 +266,54 @@ struct ad7606_digital_diag {
 	bool interface_check_en: 1;
 };
 
+/**
+ * @struct ad7606_burst_init_param
+ * @brief Burst acquisition initialization parameters
+ */
+struct ad7606_burst_init_param {
+	/** CONVST PWM initialization parameters, the period sets the rate */
+	struct pwm_init_param *convst_pwm;
+	/** Interrupt controller the BUSY line is connected to */
+	struct irq_ctrl_desc *irq_ctrl;
+	/** Interrupt of the BUSY line */
+	uint32_t busy_irq_id;
+	/** Platform specific interrupt configuration (falling edge) */
+	void *busy_irq_config;
+	/** Number of frames the ring can hold */
+	uint32_t ring_frames;
+};
+
+/**
+ * @struct ad7606_burst
+ * @brief Burst acquisition state
+ */
+struct ad7606_burst {
+	/** CONVST PWM descriptor */
+	struct pwm_desc *convst_pwm;
+	/** Interrupt controller */
+	struct irq_ctrl_desc *irq_ctrl;
+	/** Interrupt of the BUSY line */
+	uint32_t busy_irq_id;
+	/** BUSY falling edge callback */
+	struct callback_desc busy_cb;
+	/** Ring of decoded frames, one uint32_t per channel */
+	struct circular_buffer *ring;
+	/** Size of the ring in bytes */
+	uint32_t ring_size;
+	/** Size of a decoded frame in bytes */
+	uint32_t frame_size;
+	/** Decoded frame, written to the ring once complete */
+	uint32_t frame[AD7606_MAX_CHANNELS];
+	/** Frames left to collect, 0 when running until stopped */
+	volatile uint32_t frames_left;
+	/** Whether conversions are running */
+	volatile bool active;
+	/** Frames dropped because the ring was full */
+	uint32_t overruns;
+	/** Frames dropped because of a CRC mismatch or SPI error */
+	uint32_t errors;
+};
+
 /**
  * @struct ad7606_dev
  * @brief Device driver structure
@@ -314,6 +365,8 @@ struct ad7606_dev {
 	struct ad7606_range range_ch[AD7606_MAX_CHANNELS];
 	/** Data buffer (used internally by the SPI communication functions) */
 	uint8_t data[28];
+	/** Burst acquisition state, NULL unless ad7606_burst_init() was called */
+	struct ad7606_burst *burst;
 };
 
 /**
@@ -394,4 +447,11 @@ int32_t ad7606_set_digital_diag(struct ad7606_dev *dev,
 int32_t ad7606_init(struct ad7606_dev **device,
 		    struct ad7606_init_param *init_param);
 int32_t ad7606_remove(struct ad7606_dev *dev);
+int32_t ad7606_burst_init(struct ad7606_dev *dev,
+			  struct ad7606_burst_init_param *param);
+int32_t ad7606_burst_start(struct ad7606_dev *dev, uint32_t nb_frames);
+int32_t ad7606_burst_read(struct ad7606_dev *dev, uint32_t *data,
+			  uint32_t nb_frames);
+int32_t ad7606_burst_stop(struct ad7606_dev *dev);
+int32_t ad7606_burst_remove(struct ad7606_dev *dev);
 #endif /* AD7606_H_ */
@@ -376,49 +376,87 @@ int32_t ad7616_set_oversampling_ratio(struct ad7616_dev *dev,
 }
 
 /**
- * @brief Read from device in serial mode.
- *        Enter register mode to read/write registers
+ * @brief Set up the capture path once: load the SPI Engine offload message
+ *        (serial interface) or allocate the DMAC (parallel interface).
+ *        Captures then only have to start the DMA.
  * @param dev - ad7616_dev device handler.
- * @param buf - data buffer.
- * @param samples - sample number.
  * @return \ref SUCCESS in case of success, \ref FAILURE otherwise.
  */
-int32_t ad7616_read_data_serial(struct ad7616_dev *dev,
-				uint32_t *buf,
-				uint32_t samples)
+static int32_t ad7616_capture_setup(struct ad7616_dev *dev)
 {
 	int32_t ret;
+	enum spi_mode mode;
 	uint32_t commands_data[1] = {0x00};
 	struct spi_engine_offload_message msg;
+	struct axi_dmac_init dmac_init;
 	uint32_t spi_eng_msg_cmds[3] = {
 		CS_LOW,
 		READ(2),
 		CS_HIGH,
 	};
 
-	dev->spi_desc->mode = SPI_MODE_3;
-	spi_engine_set_speed(dev->spi_desc, dev->spi_desc->max_speed_hz);
+	if (!dev->offload_init_param)
+		return SUCCESS;
+
+	if (dev->interface == AD7616_PARALLEL) {
+		dmac_init.name = "ADC DMAC";
+		dmac_init.base = dev->offload_init_param->rx_dma_baseaddr;
+		dmac_init.flags = 0;
+		dmac_init.direction = DMA_DEV_TO_MEM;
+
+		axi_dmac_init(&dev->dmac, &dmac_init);
+		if (!dev->dmac)
+			return FAILURE;
+
+		return SUCCESS;
+	}
 
 	ret = spi_engine_offload_init(dev->spi_desc, dev->offload_init_param);
 	if (ret != SUCCESS)
 		return ret;
 
+	/* Conversion results are read in mode 3, at full speed. */
+	mode = dev->spi_desc->mode;
+	dev->spi_desc->mode = SPI_MODE_3;
+	spi_engine_set_speed(dev->spi_desc, dev->spi_desc->max_speed_hz);
+
 	msg.commands_data = commands_data;
 	msg.commands = spi_eng_msg_cmds;
 	msg.no_commands = ARRAY_SIZE(spi_eng_msg_cmds);
-	msg.rx_addr = (uint32_t)buf;
+
+	ret = spi_engine_offload_load(dev->spi_desc, &msg);
+
+	dev->spi_desc->mode = mode;
+	spi_engine_set_speed(dev->spi_desc, dev->reg_access_speed);
+
+	return ret;
+}
+
+/**
+ * @brief Read from device in serial mode.
+ *        Enter register mode to read/write registers
+ * @param dev - ad7616_dev device handler.
+ * @param buf - data buffer.
+ * @param samples - sample number.
+ * @return \ref SUCCESS in case of success, \ref FAILURE otherwise.
+ */
+int32_t ad7616_read_data_serial(struct ad7616_dev *dev,
+				uint32_t *buf,
+				uint32_t samples)
+{
+	int32_t ret;
 
 	axi_io_write(dev->core_baseaddr, AD7616_REG_UP_CTRL,
 		     AD7616_CTRL_RESETN | AD7616_CTRL_CNVST_EN);
 
-	ret = spi_engine_offload_transfer(dev->spi_desc, msg, samples);
+	ret = spi_engine_offload_arm(dev->spi_desc, 0, (uint32_t)buf, samples);
 	if (ret != SUCCESS)
 		return ret;
 
 	axi_io_write(dev->core_baseaddr, AD7616_REG_UP_CTRL, AD7616_CTRL_RESETN);
 
 	if (dev->dcache_invalidate_range)
-		dev->dcache_invalidate_range(msg.rx_addr, samples * 2);
+		dev->dcache_invalidate_range((uint32_t)buf, samples * 2);
 
 	return ret;
 }
@@ -436,22 +474,14 @@ int32_t ad7616_read_data_parallel(struct ad7616_dev *dev,
 				  uint32_t samples)
 {
 	int32_t ret;
-	struct axi_dmac			*dmac;
-	struct axi_dmac_init	dmac_init;
 
-	dmac_init.name = "ADC DMAC";
-	dmac_init.base = dev->offload_init_param->rx_dma_baseaddr;
-	dmac_init.flags = 0;
-	dmac_init.direction = DMA_DEV_TO_MEM;
-
-	axi_dmac_init(&dmac, &dmac_init);
-	if(!dmac)
+	if (!dev->dmac)
 		return FAILURE;
 
 	axi_io_write(dev->core_baseaddr, AD7616_REG_UP_CTRL,
 		     AD7616_CTRL_RESETN | AD7616_CTRL_CNVST_EN);
 
-	ret = axi_dmac_transfer(dmac, (uint32_t)&buf, samples);
+	ret = axi_dmac_transfer(dev->dmac, (uint32_t)buf, samples);
 	if (ret != SUCCESS)
 		return ret;
 
@@ -503,7 +533,7 @@ int32_t ad7616_setup(struct ad7616_dev **device,
 	uint8_t i;
 	int32_t ret = 0;
 
-	dev = (struct ad7616_dev *)malloc(sizeof(*dev));
+	dev = (struct ad7616_dev *)calloc(1, sizeof(*dev));
 	if (!dev) {
 		return FAILURE;
 	}
@@ -575,6 +605,10 @@ int32_t ad7616_setup(struct ad7616_dev **device,
 	if (ret != SUCCESS)
 		return ret;
 
+	ret = ad7616_capture_setup(dev);
+	if (ret != SUCCESS)
+		return ret;
+
 	*device = dev;
 
 	if (!ret)
@@ -582,3 +616,41 @@ int32_t ad7616_setup(struct ad7616_dev **device,
 
 	return ret;
 }
+
+/**
+ * Free the resources allocated by ad7616_setup().
+ * @param dev - The device structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad7616_remove(struct ad7616_dev *dev)
+{
+	int32_t ret = SUCCESS;
+
+	if (!dev)
+		return FAILURE;
+
+	if (dev->spi_desc) {
+		spi_engine_offload_remove(dev->spi_desc);
+		ret |= spi_remove(dev->spi_desc);
+	}
+
+	if (dev->dmac)
+		axi_dmac_remove(dev->dmac);
+
+	if (dev->gpio_hw_rngsel0)
+		ret |= gpio_remove(dev->gpio_hw_rngsel0);
+	if (dev->gpio_hw_rngsel1)
+		ret |= gpio_remove(dev->gpio_hw_rngsel1);
+	if (dev->gpio_reset)
+		ret |= gpio_remove(dev->gpio_reset);
+	if (dev->gpio_os0)
+		ret |= gpio_remove(dev->gpio_os0);
+	if (dev->gpio_os1)
+		ret |= gpio_remove(dev->gpio_os1);
+	if (dev->gpio_os2)
+		ret |= gpio_remove(dev->gpio_os2);
+
+	free(dev);
+
+	return ret;
+}
@@ -144,6 +144,8 @@ struct ad7616_dev {
 	struct spi_desc		*spi_desc;
 	struct spi_engine_offload_init_param *offload_init_param;
 	uint32_t reg_access_speed;
+	/* DMAC used for parallel interface captures */
+	struct axi_dmac		*dmac;
 	/* GPIO */
 	struct gpio_desc	*gpio_hw_rngsel0;
 	struct gpio_desc	*gpio_hw_rngsel1;
@@ -246,4 +248,6 @@ int32_t ad7616_core_setup(struct ad7616_dev *dev);
 /* Initialize the device. */
 int32_t ad7616_setup(struct ad7616_dev **device,
 		     struct ad7616_init_param *init_param);
+/* Free the resources allocated by ad7616_setup(). */
+int32_t ad7616_remove(struct ad7616_dev *dev);
 #endif
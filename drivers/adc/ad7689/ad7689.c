@@ -37,6 +37,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *******************************************************************************/
 #include <stdlib.h>
+#include <string.h>
 #include "ad7689.h"
 #include "util.h"
 #include "error.h"
@@ -68,6 +69,37 @@ static struct ad7689_config *_ad7689_config_get(struct ad7689_dev *dev)
 	return &dev->configs[1];
 }
 
+static uint16_t _ad7689_config_to_cfg(struct ad7689_config *config)
+{
+	uint16_t cfg = 0;
+
+	cfg |= field_prep(AD7689_CFG_CFG_MSK, 1);
+	cfg |= field_prep(AD7689_CFG_INCC_MSK, config->incc);
+	cfg |= field_prep(AD7689_CFG_INX_MSK, config->inx);
+	cfg |= field_prep(AD7689_CFG_BW_MSK, config->bw);
+	cfg |= field_prep(AD7689_CFG_REF_MSK, config->ref);
+	cfg |= field_prep(AD7689_CFG_SEQ_MSK, config->seq);
+	cfg |= field_prep(AD7689_CFG_RB_MSK, !config->rb);
+
+	return cfg << 2;
+}
+
+static uint16_t _ad7689_scan_len(struct ad7689_config *config)
+{
+	uint16_t len;
+
+	if (config->incc == AD7689_BIPOLAR_DIFFERENTIAL_PAIRS ||
+	    config->incc == AD7689_UNIPOLAR_DIFFERENTIAL_PAIRS)
+		len = config->inx / 2 + 1;
+	else
+		len = config->inx + 1;
+
+	if (config->seq == AD7689_SEQ_SCAN_ALL_THEN_TEMP)
+		len++;
+
+	return len;
+}
+
 static int32_t _ad7689_rac(struct ad7689_dev *dev,
 			   struct ad7689_config *config_in, struct ad7689_config *config_out,
 			   uint16_t *data)
@@ -84,14 +116,7 @@ static int32_t _ad7689_rac(struct ad7689_dev *dev,
 	c = _ad7689_config_get(dev);
 
 	if (config_in) {
-		cfg |= field_prep(AD7689_CFG_CFG_MSK, 1);
-		cfg |= field_prep(AD7689_CFG_INCC_MSK, config_in->incc);
-		cfg |= field_prep(AD7689_CFG_INX_MSK, config_in->inx);
-		cfg |= field_prep(AD7689_CFG_BW_MSK, config_in->bw);
-		cfg |= field_prep(AD7689_CFG_REF_MSK, config_in->ref);
-		cfg |= field_prep(AD7689_CFG_SEQ_MSK, config_in->seq);
-		cfg |= field_prep(AD7689_CFG_RB_MSK, !config_in->rb);
-		cfg <<= 2;
+		cfg = _ad7689_config_to_cfg(config_in);
 		buf[0] = cfg >> 8;
 		buf[1] = cfg;
 	}
@@ -272,6 +297,121 @@ int32_t ad7689_read(struct ad7689_dev *dev, uint16_t *data, uint32_t nb_samples)
 	return SUCCESS;
 }
 
+/***************************************************************************//**
+ * @brief Read full sequencer scans in a single chained SPI transfer.
+ *
+ * The last written configuration must enable the channel sequencer
+ * (AD7689_SEQ_SCAN_ALL or AD7689_SEQ_SCAN_ALL_THEN_TEMP). It is written again
+ * at the start of the transfer to restart the sequence from IN0, with the
+ * readback disabled so every conversion is a 16-bit frame. The two frames
+ * that carry results of the previous configuration are dropped, so data[0]
+ * always holds IN0 of the first scan. If the readback was enabled, the last
+ * frame writes the configuration back with the readback on.
+ *
+ * All the conversions are queued as in-place segments of one SPI message,
+ * with CS (CNV) toggled and held high for the conversion time between them.
+ * Platforms with a native multi-segment transfer (SPI Engine, spidev) run the
+ * whole message at once, the others transfer it one segment at a time.
+ *
+ * @param dev - Device descriptor.
+ * @param data - Buffer of nb_scans times the scan length, where the samples
+ *               get stored interleaved (IN0, IN1, ..., INX[, TEMP], IN0, ...).
+ * @param nb_scans - Number of scans to read.
+ *
+ * @return Returns negative error code or SUCCESS in case of success.
+ *         Example: -EINVAL - Bad input parameters.
+ *                  -ENOMEM - Failed to allocate memory.
+ *                  SUCCESS - No errors encountered.
+*******************************************************************************/
+int32_t ad7689_read_scans(struct ad7689_dev *dev, uint16_t *data,
+			  uint32_t nb_scans)
+{
+	struct ad7689_config config;
+	struct ad7689_config norb;
+	struct spi_msg msg = {
+		.bytes_number = 2,
+		.cs_change = 1,
+		.delay_us = AD7689_TCONV_US,
+	};
+	uint8_t cfg_buf[2];
+	uint8_t skip_buf[2] = {0, 0};
+	uint8_t *raw;
+	uint32_t nb_samples;
+	uint32_t i;
+	uint16_t cfg;
+	int32_t ret;
+
+	if (!dev || !data)
+		return -EINVAL;
+	if (!nb_scans)
+		return SUCCESS;
+
+	// dev->configs[0] is the last written config
+	config = dev->configs[0];
+	if (config.seq != AD7689_SEQ_SCAN_ALL &&
+	    config.seq != AD7689_SEQ_SCAN_ALL_THEN_TEMP)
+		return -EINVAL;
+	norb = config;
+	norb.rb = false;
+
+	nb_samples = nb_scans * _ad7689_scan_len(&config);
+
+	cfg = _ad7689_config_to_cfg(&norb);
+	cfg_buf[0] = cfg >> 8;
+	cfg_buf[1] = cfg;
+
+	// a frame of zeros keeps the configuration (CFG bit cleared)
+	raw = (uint8_t *)data;
+	memset(raw, 0, nb_samples * 2);
+	if (config.rb) {
+		cfg = _ad7689_config_to_cfg(&config);
+		raw[(nb_samples - 1) * 2] = cfg >> 8;
+		raw[(nb_samples - 1) * 2 + 1] = cfg;
+	}
+
+	spi_msg_queue_reset(dev->spi_desc);
+
+	// restart the sequence, then skip the conversion already in flight
+	msg.tx_buff = cfg_buf;
+	msg.rx_buff = cfg_buf;
+	ret = spi_msg_queue_add(dev->spi_desc, &msg);
+	if (ret < 0)
+		goto error;
+	msg.tx_buff = skip_buf;
+	msg.rx_buff = skip_buf;
+	ret = spi_msg_queue_add(dev->spi_desc, &msg);
+	if (ret < 0)
+		goto error;
+
+	for (i = 0; i < nb_samples; i++) {
+		msg.tx_buff = &raw[i * 2];
+		msg.rx_buff = &raw[i * 2];
+		ret = spi_msg_queue_add(dev->spi_desc, &msg);
+		if (ret < 0)
+			goto error;
+	}
+
+	ret = spi_msg_queue_submit(dev->spi_desc);
+	if (ret < 0)
+		return ret;
+
+	_ad7689_config_put(dev, &norb);
+	_ad7689_config_put(dev, config.rb ? &config : NULL);
+
+	// frames are MSB first, convert in place
+	for (i = 0; i < nb_samples; i++) {
+		data[i] = ((uint16_t)raw[i * 2] << 8) | raw[i * 2 + 1];
+		if (dev->id == ID_AD7949)
+			data[i] = (int16_t)data[i] / 4;
+	}
+
+	return SUCCESS;
+error:
+	spi_msg_queue_reset(dev->spi_desc);
+
+	return ret;
+}
+
 /***************************************************************************//**
  * @brief Remove the driver's descriptor by freeing the associated resources.
  *
@@ -51,6 +51,9 @@
 #define AD7689_CFG_SEQ_MSK      GENMASK(2,1)
 #define AD7689_CFG_RB_MSK       BIT(0)
 
+/* Maximum conversion time, rounded up to whole microseconds */
+#define AD7689_TCONV_US         3
+
 /**
  * @enum ad7689_device_id
  * @brief Device ID definitions
@@ -177,6 +180,8 @@ int32_t ad7689_read_config(struct ad7689_dev *dev,
 			   struct ad7689_config *config);
 int32_t ad7689_read(struct ad7689_dev *dev, uint16_t *data,
 		    uint32_t nb_samples);
+int32_t ad7689_read_scans(struct ad7689_dev *dev, uint16_t *data,
+			  uint32_t nb_scans);
 int32_t ad7689_remove(struct ad7689_dev *dev);
 
 #endif
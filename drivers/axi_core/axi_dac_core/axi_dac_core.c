@@ -380,6 +380,58 @@ int32_t axi_dac_set_datasel(struct axi_dac *dac,
 	return SUCCESS;
 }
 
+/***************************************************************************//**
+ * @brief axi_dac_dds_freq_to_incr
+ *
+ * freq is in Hz (i.e. set to 1*1000*1000 for 1 MHz)
+ *******************************************************************************/
+static uint32_t axi_dac_dds_freq_to_incr(struct axi_dac *dac,
+		uint32_t freq_hz)
+{
+	uint64_t val64;
+
+	val64 = (uint64_t) freq_hz * 0xFFFFULL;
+	val64 = val64 / dac->clock_hz;
+
+	return AXI_DAC_DDS_INCR(val64) | 1;
+}
+
+/***************************************************************************//**
+ * @brief axi_dac_dds_phase_to_init
+ *
+ * phase is in milli angles scaled to 1000 (i.e. 90*1000 is 90 degrees (pi/2))
+ *******************************************************************************/
+static uint32_t axi_dac_dds_phase_to_init(uint32_t phase)
+{
+	uint64_t val64;
+
+	val64 = (uint64_t) phase * 0x10000ULL + (360000 / 2);
+	val64 = val64 / 360000;
+
+	return AXI_DAC_DDS_INIT(val64);
+}
+
+/***************************************************************************//**
+ * @brief axi_dac_dds_scale_to_reg
+ *
+ * scale is in micro units (i.e. 1*1000*1000 is 1.0)
+ *******************************************************************************/
+static uint32_t axi_dac_dds_scale_to_reg(int32_t scale_micro_units)
+{
+	uint32_t scale_reg;
+
+	scale_reg = scale_micro_units;
+	if (scale_micro_units < 0)
+		scale_reg = scale_micro_units * -1;
+	if (scale_reg >= 1999000)
+		scale_reg = 1999000;
+	scale_reg = (uint32_t)(((uint64_t)scale_reg * 0x4000) / 1000000);
+	if (scale_micro_units < 0)
+		scale_reg = scale_reg | 0x8000;
+
+	return AXI_DAC_DDS_SCALE(scale_reg);
+}
+
 /***************************************************************************//**
  * @brief dds_set_frequency
  *
@@ -388,14 +440,14 @@ int32_t axi_dac_set_datasel(struct axi_dac *dac,
 int32_t axi_dac_dds_set_frequency(struct axi_dac *dac,
 				  uint32_t chan, uint32_t freq_hz)
 {
-	uint64_t val64;
 	uint32_t reg;
 
+	reg = dac->dds_init_incr[chan];
+	reg = (reg & ~AXI_DAC_DDS_INCR(~0)) |
+	      axi_dac_dds_freq_to_incr(dac, freq_hz);
+	dac->dds_init_incr[chan] = reg;
+
 	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, 0);
-	axi_dac_read(dac, AXI_DAC_REG_DDS_INIT_INCR(chan), &reg);
-	val64 = (uint64_t) freq_hz * 0xFFFFULL;
-	val64 = val64 / dac->clock_hz;
-	reg = (reg & ~AXI_DAC_DDS_INCR(~0)) | AXI_DAC_DDS_INCR(val64) | 1;
 	axi_dac_write(dac, AXI_DAC_REG_DDS_INIT_INCR(chan), reg);
 	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, AXI_DAC_SYNC);
 
@@ -432,14 +484,13 @@ int32_t axi_dac_dds_get_frequency(struct axi_dac *dac,
 int32_t axi_dac_dds_set_phase(struct axi_dac *dac,
 			      uint32_t chan, uint32_t phase)
 {
-	uint64_t val64;
 	uint32_t reg;
 
+	reg = dac->dds_init_incr[chan];
+	reg = (reg & ~AXI_DAC_DDS_INIT(~0)) | axi_dac_dds_phase_to_init(phase);
+	dac->dds_init_incr[chan] = reg;
+
 	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, 0);
-	axi_dac_read(dac, AXI_DAC_REG_DDS_INIT_INCR(chan), &reg);
-	val64 = (uint64_t) phase * 0x10000ULL + (360000 / 2);
-	val64 = val64 / 360000;
-	reg = (reg & ~AXI_DAC_DDS_INIT(~0)) | AXI_DAC_DDS_INIT(val64);
 	axi_dac_write(dac, AXI_DAC_REG_DDS_INIT_INCR(chan), reg);
 	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, AXI_DAC_SYNC);
 
@@ -478,20 +529,54 @@ int32_t axi_dac_dds_set_scale(struct axi_dac *dac,
 			      uint32_t chan,
 			      int32_t scale_micro_units)
 {
-	uint32_t scale_reg;
+	dac->dds_scale[chan] = axi_dac_dds_scale_to_reg(scale_micro_units);
 
-	scale_reg = scale_micro_units;
-	if (scale_micro_units < 0)
-		scale_reg = scale_micro_units * -1;
-	if (scale_reg >= 1999000)
-		scale_reg = 1999000;
-	scale_reg = (uint32_t)(((uint64_t)scale_reg * 0x4000) / 1000000);
-	if (scale_micro_units < 0)
-		scale_reg = scale_reg | 0x8000;
+	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, 0);
+	axi_dac_write(dac, AXI_DAC_REG_DDS_SCALE(chan), dac->dds_scale[chan]);
+	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, AXI_DAC_SYNC);
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief axi_dac_dds_set_tones
+ *
+ * Program frequency, phase and scale of several DDS channels at once.
+ * The register values are compared against the shadow copies, so nothing
+ * is read back and only the registers that change are written. The new
+ * tones take effect together on a single SYNC, so the outputs switch
+ * phase coherently without intermediate states.
+ *******************************************************************************/
+int32_t axi_dac_dds_set_tones(struct axi_dac *dac,
+			      const struct axi_dac_tone *tones,
+			      uint32_t nb_tones)
+{
+	uint32_t reg;
+	uint32_t i;
+
+	if (!dac || !tones)
+		return -EINVAL;
+
+	for (i = 0; i < nb_tones; i++)
+		if (tones[i].chan >= dac->num_channels * 2)
+			return -EINVAL;
 
 	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, 0);
-	axi_dac_write(dac, AXI_DAC_REG_DDS_SCALE(chan),
-		      AXI_DAC_DDS_SCALE(scale_reg));
+	for (i = 0; i < nb_tones; i++) {
+		reg = axi_dac_dds_freq_to_incr(dac, tones[i].freq_hz) |
+		      axi_dac_dds_phase_to_init(tones[i].phase);
+		if (reg != dac->dds_init_incr[tones[i].chan]) {
+			dac->dds_init_incr[tones[i].chan] = reg;
+			axi_dac_write(dac, AXI_DAC_REG_DDS_INIT_INCR(tones[i].chan),
+				      reg);
+		}
+		reg = axi_dac_dds_scale_to_reg(tones[i].scale_micro_units);
+		if (reg != dac->dds_scale[tones[i].chan]) {
+			dac->dds_scale[tones[i].chan] = reg;
+			axi_dac_write(dac, AXI_DAC_REG_DDS_SCALE(tones[i].chan),
+				      reg);
+		}
+	}
 	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, AXI_DAC_SYNC);
 
 	return SUCCESS;
@@ -808,6 +893,7 @@ int32_t axi_dac_init(struct axi_dac **dac_core,
 	uint32_t reg_data;
 	uint32_t freq;
 	uint32_t ratio;
+	uint32_t i;
 
 	dac = (struct axi_dac *)malloc(sizeof(*dac));
 	if (!dac)
@@ -818,6 +904,13 @@ int32_t axi_dac_init(struct axi_dac **dac_core,
 	dac->num_channels = init->num_channels;
 	dac->channels = init->channels;
 
+	dac->dds_init_incr = (uint32_t *)calloc(dac->num_channels * 2,
+						sizeof(*dac->dds_init_incr));
+	dac->dds_scale = (uint32_t *)calloc(dac->num_channels * 2,
+					    sizeof(*dac->dds_scale));
+	if (!dac->dds_init_incr || !dac->dds_scale)
+		goto error;
+
 	axi_dac_write(dac, AXI_DAC_REG_RSTN, 0);
 	axi_dac_write(dac, AXI_DAC_REG_RSTN,
 		      AXI_DAC_MMCM_RSTN | AXI_DAC_RSTN);
@@ -837,6 +930,12 @@ int32_t axi_dac_init(struct axi_dac **dac_core,
 	dac->clock_hz = freq * ratio;
 	dac->clock_hz = (dac->clock_hz * 390625) >> 8;
 
+	for (i = 0; i < dac->num_channels * 2; i++) {
+		axi_dac_read(dac, AXI_DAC_REG_DDS_INIT_INCR(i),
+			     &dac->dds_init_incr[i]);
+		axi_dac_read(dac, AXI_DAC_REG_DDS_SCALE(i), &dac->dds_scale[i]);
+	}
+
 	axi_dac_data_setup(dac);
 
 	axi_dac_write(dac, AXI_DAC_REG_SYNC_CONTROL, AXI_DAC_SYNC);
@@ -848,6 +947,8 @@ int32_t axi_dac_init(struct axi_dac **dac_core,
 
 	return SUCCESS;
 error:
+	free(dac->dds_init_incr);
+	free(dac->dds_scale);
 	free(dac);
 
 	return FAILURE;
@@ -856,36 +957,38 @@ error:
 int32_t axi_dac_data_setup(struct axi_dac *dac)
 {
 	struct axi_dac_channel *chan;
+	struct axi_dac_tone tones[2];
 	uint32_t i;
 
 	if(dac->channels) {
 		for (i = 0; i < dac->num_channels; i++) {
 			chan = &dac->channels[i];
 			if (chan->sel == AXI_DAC_DATA_SEL_DDS) {
-				axi_dac_dds_set_frequency(dac, ((i*2)+0), chan->dds_frequency_0);
-				axi_dac_dds_set_phase(dac, ((i*2)+0), chan->dds_phase_0);
-				axi_dac_dds_set_scale(dac, ((i*2)+0), chan->dds_scale_0);
-				if (chan->dds_dual_tone == 0) {
-					axi_dac_dds_set_frequency(dac, ((i*2)+1), chan->dds_frequency_0);
-					axi_dac_dds_set_phase(dac, ((i*2)+1), chan->dds_phase_0);
-					axi_dac_dds_set_scale(dac, ((i*2)+1), chan->dds_scale_0);
-				} else {
-					axi_dac_dds_set_frequency(dac, ((i*2)+1), chan->dds_frequency_1);
-					axi_dac_dds_set_phase(dac, ((i*2)+1), chan->dds_phase_1);
-					axi_dac_dds_set_scale(dac, ((i*2)+1), chan->dds_scale_1);
+				tones[0].chan = (i*2)+0;
+				tones[0].freq_hz = chan->dds_frequency_0;
+				tones[0].phase = chan->dds_phase_0;
+				tones[0].scale_micro_units = chan->dds_scale_0;
+				tones[1] = tones[0];
+				tones[1].chan = (i*2)+1;
+				if (chan->dds_dual_tone != 0) {
+					tones[1].freq_hz = chan->dds_frequency_1;
+					tones[1].phase = chan->dds_phase_1;
+					tones[1].scale_micro_units = chan->dds_scale_1;
 				}
+				axi_dac_dds_set_tones(dac, tones, 2);
 			}
 			axi_dac_write(dac, DAC_REG_DATA_PATTERN(i), chan->pat_data);
 			axi_dac_set_datasel(dac, i, chan->sel);
 		}
 	} else {
 		for (i = 0; i < dac->num_channels; i++) {
-			axi_dac_dds_set_frequency(dac, ((i*2)+0), 3*1000*1000);
-			axi_dac_dds_set_frequency(dac, ((i*2)+1), 3*1000*1000);
-			axi_dac_dds_set_phase(dac, ((i*2)+0), (i % 2) ? 0 : 90000);
-			axi_dac_dds_set_phase(dac, ((i*2)+1), (i % 2) ? 0 : 90000);
-			axi_dac_dds_set_scale(dac, ((i*2)+0), 50*1000);
-			axi_dac_dds_set_scale(dac, ((i*2)+1), 50*1000);
+			tones[0].chan = (i*2)+0;
+			tones[0].freq_hz = 3*1000*1000;
+			tones[0].phase = (i % 2) ? 0 : 90000;
+			tones[0].scale_micro_units = 50*1000;
+			tones[1] = tones[0];
+			tones[1].chan = (i*2)+1;
+			axi_dac_dds_set_tones(dac, tones, 2);
 			axi_dac_write(dac, AXI_DAC_REG_DATA_SELECT((i*2)+0), 0);
 			axi_dac_write(dac, AXI_DAC_REG_DATA_SELECT((i*2)+1), 0);
 		}
@@ -898,6 +1001,8 @@ int32_t axi_dac_data_setup(struct axi_dac *dac)
  *******************************************************************************/
 int32_t axi_dac_remove(struct axi_dac *dac)
 {
+	free(dac->dds_init_incr);
+	free(dac->dds_scale);
 	free(dac);
 
 	return SUCCESS;
@@ -53,6 +53,8 @@ struct axi_dac {
 	uint8_t	num_channels;
 	uint64_t clock_hz;
 	struct axi_dac_channel *channels; //dac channels manual configuration
+	uint32_t *dds_init_incr;	// shadow of the DDS_INIT_INCR registers
+	uint32_t *dds_scale;		// shadow of the DDS_SCALE registers
 };
 
 struct axi_dac_init {
@@ -87,6 +89,13 @@ struct axi_dac_channel {
 	enum axi_dac_data_sel sel;      // set to one of the enumerated type above.
 };
 
+struct axi_dac_tone {
+	uint32_t chan;                  // DDS channel, as in axi_dac_dds_set_frequency()
+	uint32_t freq_hz;               // in hz (1000*1000 for MHz)
+	uint32_t phase;                 // in milli angles (90*1000 for 90 degrees = pi/2)
+	int32_t scale_micro_units;      // in micro units (1.0*1000*1000 is 1.0)
+};
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -110,6 +119,9 @@ int32_t axi_dac_dds_set_scale(struct axi_dac *dac,
 int32_t axi_dac_dds_get_scale(struct axi_dac *dac,
 			      uint32_t chan,
 			      int32_t *scale_micro_units);
+int32_t axi_dac_dds_set_tones(struct axi_dac *dac,
+			      const struct axi_dac_tone *tones,
+			      uint32_t nb_tones);
 int32_t axi_dac_set_buff(struct axi_dac *dac,
 			 uint32_t address,
 			 uint16_t *buff,
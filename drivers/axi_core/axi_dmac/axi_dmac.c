@@ -48,6 +48,52 @@
 #include "error.h"
 #include "delay.h"
 #include "axi_dmac.h"
+#include "trace.h"
+
+/***************************************************************************//**
+ * @brief axi_dmac_queue_cyclic
+ *
+ * Queue a cyclic transfer of the buffer and return its transfer ID. The core
+ * ends a cyclic transfer at the end of its current pass once another one is
+ * queued behind it.
+*******************************************************************************/
+static uint32_t axi_dmac_queue_cyclic(struct axi_dmac *dmac,
+				      uint32_t address, uint32_t size)
+{
+	uint32_t id;
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, &id);
+	axi_dmac_write(dmac, AXI_DMAC_REG_SRC_ADDRESS, address);
+	axi_dmac_write(dmac, AXI_DMAC_REG_SRC_STRIDE, 0x0);
+	axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, size - 1);
+	axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
+	axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, dmac->flags | DMA_CYCLIC);
+	axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
+
+	return id;
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_repeat_update
+ *
+ * Complete a pending buffer swap once the transfer of the old buffer is done.
+*******************************************************************************/
+static void axi_dmac_repeat_update(struct axi_dmac *dmac)
+{
+	uint32_t reg_val;
+
+	if (dmac->repeat.swap != AXI_DMA_SWAP_QUEUED)
+		return;
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_DONE, &reg_val);
+	if (!(reg_val & (1u << dmac->repeat.id)))
+		return;
+
+	dmac->repeat.address = dmac->repeat.next_address;
+	dmac->repeat.size = dmac->repeat.next_size;
+	dmac->repeat.id = dmac->repeat.next_id;
+	dmac->repeat.swap = AXI_DMA_SWAP_IDLE;
+}
 
 /***************************************************************************//**
  * @brief dma_isr
@@ -61,6 +107,7 @@ void axi_dmac_default_isr(void *instance)
 	/* Get interrupt sources and clear interrupts. */
 	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
 	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
+	trace_event2(TRACE_ID_AXI_DMAC_IRQ, reg_val, dmac->base);
 
 	if ((reg_val & AXI_DMAC_IRQ_SOT) && (dmac->big_transfer.size != 0)) {
 		remaining_size = dmac->big_transfer.size -
@@ -206,6 +253,7 @@ int32_t axi_dmac_transfer(struct axi_dmac *dmac,
 	if (size == 0)
 		return SUCCESS; /* nothing to do */
 
+	dmac->repeat.address = 0;
 	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
 	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE);
 
@@ -286,6 +334,87 @@ int32_t axi_dmac_transfer(struct axi_dmac *dmac,
 	return SUCCESS;
 }
 
+/***************************************************************************//**
+ * @brief axi_dmac_transfer_repeat
+ *
+ * Play a buffer to the device over and over, without gaps between passes,
+ * as a cyclic transfer. If a buffer is already playing, the new one is
+ * queued behind it and replaces it at the end of the current pass; the old
+ * buffer can be reused once axi_dmac_is_repeat_swapped() reports it. No
+ * interrupt is needed.
+ *******************************************************************************/
+int32_t axi_dmac_transfer_repeat(struct axi_dmac *dmac,
+				 uint32_t address, uint32_t size)
+{
+	uint32_t reg_val;
+
+	if (!dmac || !address || !size || dmac->direction != DMA_MEM_TO_DEV)
+		return -EINVAL;
+
+	if ((size - 1) > dmac->transfer_max_size)
+		return -EINVAL;
+
+	if (dmac->repeat.address) {
+		axi_dmac_repeat_update(dmac);
+		if (dmac->repeat.swap != AXI_DMA_SWAP_IDLE)
+			return -EBUSY;
+
+		dmac->repeat.next_address = address;
+		dmac->repeat.next_size = size;
+		dmac->repeat.next_id = axi_dmac_queue_cyclic(dmac, address,
+							      size);
+		dmac->repeat.swap = AXI_DMA_SWAP_QUEUED;
+
+		return SUCCESS;
+	}
+
+	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
+	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE);
+	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
+	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
+	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
+
+	dmac->repeat.swap = AXI_DMA_SWAP_IDLE;
+	dmac->repeat.size = size;
+	dmac->repeat.address = address;
+	dmac->repeat.id = axi_dmac_queue_cyclic(dmac, address, size);
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_is_repeat_swapped
+ *
+ * swapped is true when no buffer change is pending, so the buffer replaced
+ * by the last axi_dmac_transfer_repeat() call is no longer read.
+ *******************************************************************************/
+int32_t axi_dmac_is_repeat_swapped(struct axi_dmac *dmac, bool *swapped)
+{
+	if (!dmac || !swapped)
+		return -EINVAL;
+
+	axi_dmac_repeat_update(dmac);
+	*swapped = (dmac->repeat.swap == AXI_DMA_SWAP_IDLE);
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief axi_dmac_transfer_stop
+ *******************************************************************************/
+int32_t axi_dmac_transfer_stop(struct axi_dmac *dmac)
+{
+	if (!dmac)
+		return -EINVAL;
+
+	dmac->repeat.address = 0;
+	dmac->repeat.size = 0;
+	dmac->repeat.swap = AXI_DMA_SWAP_IDLE;
+	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
+
+	return SUCCESS;
+}
+
 /***************************************************************************//**
  * @brief axi_dmac_init
  *******************************************************************************/
@@ -306,6 +435,9 @@ int32_t axi_dmac_init(struct axi_dmac **dmac_core,
 	dmac->big_transfer.address = 0;
 	dmac->big_transfer.size = 0;
 	dmac->big_transfer.size_done = 0;
+	dmac->repeat.address = 0;
+	dmac->repeat.size = 0;
+	dmac->repeat.swap = AXI_DMA_SWAP_IDLE;
 
 	axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, dmac->transfer_max_size);
 	axi_dmac_read(dmac, AXI_DMAC_REG_X_LENGTH, &dmac->transfer_max_size);
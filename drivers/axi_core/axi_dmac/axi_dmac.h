@@ -88,6 +88,21 @@ struct axi_dma_transfer {
 	volatile bool transfer_done;
 };
 
+enum axi_dma_swap_state {
+	AXI_DMA_SWAP_IDLE,	// no buffer change pending
+	AXI_DMA_SWAP_QUEUED	// new buffer queued, old one still playing
+};
+
+struct axi_dma_repeat {
+	uint32_t address;	// buffer replayed, 0 if stopped
+	uint32_t size;
+	uint32_t id;		// transfer ID of the buffer replayed
+	uint32_t next_address;	// buffer replacing it
+	uint32_t next_size;
+	uint32_t next_id;
+	enum axi_dma_swap_state swap;
+};
+
 struct axi_dmac {
 	const char *name;
 	uint32_t base;
@@ -95,6 +110,7 @@ struct axi_dmac {
 	uint32_t flags;
 	uint32_t transfer_max_size;
 	volatile struct axi_dma_transfer big_transfer;
+	volatile struct axi_dma_repeat repeat;
 };
 
 struct axi_dmac_init {
@@ -117,6 +133,10 @@ int32_t axi_dmac_transfer_nonblocking(struct axi_dmac *dmac,
 int32_t axi_dmac_is_transfer_ready(struct axi_dmac *dmac, bool *rdy);
 int32_t axi_dmac_transfer(struct axi_dmac *dmac,
 			  uint32_t address, uint32_t size);
+int32_t axi_dmac_transfer_repeat(struct axi_dmac *dmac,
+				 uint32_t address, uint32_t size);
+int32_t axi_dmac_is_repeat_swapped(struct axi_dmac *dmac, bool *swapped);
+int32_t axi_dmac_transfer_stop(struct axi_dmac *dmac);
 int32_t axi_dmac_init(struct axi_dmac **adc_core,
 		      const struct axi_dmac_init *init);
 int32_t axi_dmac_remove(struct axi_dmac *dmac);
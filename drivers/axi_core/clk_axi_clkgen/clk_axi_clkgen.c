@@ -413,14 +413,14 @@ static void axi_clkgen_mmcm_enable(struct axi_clkgen *clkgen,
 }
 
 /**
- * @brief axi_clkgen_set_rate
+ * @brief axi_clkgen_set_params
  */
-int32_t axi_clkgen_set_rate(struct axi_clkgen *clkgen,
-			    uint32_t rate)
+static int32_t axi_clkgen_set_params(struct axi_clkgen *clkgen,
+				     uint32_t d,
+				     uint32_t m,
+				     uint32_t dout,
+				     uint32_t rate)
 {
-	uint32_t d		 = 0;
-	uint32_t m		 = 0;
-	uint32_t dout	 = 0;
 	uint32_t nocount = 0;
 	uint32_t high	 = 0;
 	uint32_t edge	 = 0;
@@ -429,14 +429,6 @@ int32_t axi_clkgen_set_rate(struct axi_clkgen *clkgen,
 	uint32_t lock	 = 0;
 	uint32_t reg_val;
 
-	if (clkgen->parent_rate == 0 || rate == 0)
-		return 0;
-
-	axi_clkgen_calc_params(clkgen, clkgen->parent_rate, rate, &d, &m, &dout);
-
-	if (d == 0 || dout == 0 || m == 0)
-		return 0;
-
 	filter = axi_clkgen_lookup_filter(m - 1);
 	lock = axi_clkgen_lookup_lock(m - 1);
 
@@ -486,6 +478,64 @@ int32_t axi_clkgen_set_rate(struct axi_clkgen *clkgen,
 	return SUCCESS;
 }
 
+/**
+ * @brief axi_clkgen_set_rate
+ */
+int32_t axi_clkgen_set_rate(struct axi_clkgen *clkgen,
+			    uint32_t rate)
+{
+	uint32_t d		 = 0;
+	uint32_t m		 = 0;
+	uint32_t dout	 = 0;
+
+	if (clkgen->parent_rate == 0 || rate == 0)
+		return 0;
+
+	axi_clkgen_calc_params(clkgen, clkgen->parent_rate, rate, &d, &m, &dout);
+
+	if (d == 0 || dout == 0 || m == 0)
+		return 0;
+
+	return axi_clkgen_set_params(clkgen, d, m, dout, rate);
+}
+
+/**
+ * @brief axi_clkgen_clk_plan_solve
+ *
+ * Store the MMCM input divider, feedback multiplier and output divider in
+ * param[0], param[1] and param[2] of the clock plan setting.
+ */
+int32_t axi_clkgen_clk_plan_solve(void *dev, uint32_t chan, uint64_t rate,
+				  struct clk_plan_setting *setting)
+{
+	struct axi_clkgen *clkgen = dev;
+	uint32_t d, m, dout;
+
+	if (clkgen->parent_rate == 0 || rate == 0)
+		return -EINVAL;
+
+	axi_clkgen_calc_params(clkgen, clkgen->parent_rate, rate, &d, &m, &dout);
+	if (d == 0 || dout == 0 || m == 0)
+		return -EINVAL;
+
+	setting->param[0] = d;
+	setting->param[1] = m;
+	setting->param[2] = dout;
+	setting->rate = (uint64_t)clkgen->parent_rate / 1000 * m / d / dout * 1000;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief axi_clkgen_clk_plan_apply
+ */
+int32_t axi_clkgen_clk_plan_apply(void *dev, uint32_t chan,
+				  const struct clk_plan_setting *setting)
+{
+	return axi_clkgen_set_params(dev, setting->param[0], setting->param[1],
+				     setting->param[2], setting->rate);
+}
+
 /**
  * @brief axi_clkgen_get_rate
  */
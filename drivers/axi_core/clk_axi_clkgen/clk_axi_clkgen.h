@@ -43,6 +43,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include "clk_plan.h"
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -67,5 +68,9 @@ int32_t axi_clkgen_get_rate(struct axi_clkgen *clkgen, uint32_t *rate);
 int32_t axi_clkgen_init(struct axi_clkgen **clk,
 			const struct axi_clkgen_init *init);
 int32_t axi_clkgen_remove(struct axi_clkgen *clkgen);
+int32_t axi_clkgen_clk_plan_solve(void *dev, uint32_t chan, uint64_t rate,
+				  struct clk_plan_setting *setting);
+int32_t axi_clkgen_clk_plan_apply(void *dev, uint32_t chan,
+				  const struct clk_plan_setting *setting);
 
 #endif
@@ -49,13 +49,15 @@ significant delays */
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <sleep.h>
+#include <string.h>
 #include <inttypes.h>
 
 #include "axi_dmac.h"
 #include "axi_io.h"
+#include "delay.h"
 #include "error.h"
 #include "spi_engine.h"
+#include "trace.h"
 
 /**
  * @brief Spi engine platform specific SPI platform ops structure
@@ -63,6 +65,7 @@ significant delays */
 const struct spi_platform_ops spi_eng_platform_ops = {
 	.spi_ops_init = &spi_engine_init,
 	.spi_ops_write_and_read = &spi_engine_write_and_read,
+	.spi_ops_transfer = &spi_engine_transfer_msgs,
 	.spi_ops_remove = &spi_engine_remove
 };
 
@@ -228,16 +231,21 @@ static int32_t spi_get_sleep_div(struct spi_desc *desc,
 /**
  * @brief Create a new commands queue used in a spi transfer
  *
+ * @param pool Pool of queue nodes, NULL to use the heap
  * @param fifo Command buffer, usualy used in fifo mode
  * @param cmd Command with wich the buffer will be initiated
  * @return int32_t Failure if the memory allocation failed
  */
-static int32_t spi_engine_queue_new_cmd(struct spi_engine_cmd_queue **fifo,
+static int32_t spi_engine_queue_new_cmd(struct pool *pool,
+					struct spi_engine_cmd_queue **fifo,
 					uint32_t cmd)
 {
 	struct spi_engine_cmd_queue *local_fifo;
 
-	local_fifo = (spi_engine_cmd_queue*)malloc(sizeof(*local_fifo));
+	/* Fall back to the heap if the pool ran out of nodes */
+	local_fifo = (spi_engine_cmd_queue*)pool_alloc(pool);
+	if (!local_fifo)
+		local_fifo = (spi_engine_cmd_queue*)malloc(sizeof(*local_fifo));
 
 	if(!local_fifo)
 		return FAILURE;
@@ -252,10 +260,12 @@ static int32_t spi_engine_queue_new_cmd(struct spi_engine_cmd_queue **fifo,
 /**
  * @brief Add a command at the end of an existing queue
  *
+ * @param pool Pool of queue nodes, NULL to use the heap
  * @param fifo Command buffer, usualy used in fifo mode
  * @param cmd Command to be added
  */
-static void spi_engine_queue_add_cmd(struct spi_engine_cmd_queue **fifo,
+static void spi_engine_queue_add_cmd(struct pool *pool,
+				     struct spi_engine_cmd_queue **fifo,
 				     uint32_t cmd)
 {
 	struct spi_engine_cmd_queue *to_add = NULL;
@@ -268,7 +278,7 @@ static void spi_engine_queue_add_cmd(struct spi_engine_cmd_queue **fifo,
 	}
 
 	// Create a new element
-	spi_engine_queue_new_cmd(&to_add, cmd);
+	spi_engine_queue_new_cmd(pool, &to_add, cmd);
 	// Add as the next element
 	local_fifo->next = to_add;
 }
@@ -276,30 +286,47 @@ static void spi_engine_queue_add_cmd(struct spi_engine_cmd_queue **fifo,
 /**
  * @brief Add a command at the beginning of an existing queue
  *
+ * @param pool Pool of queue nodes, NULL to use the heap
  * @param fifo Command buffer, usualy used in fifo mode
  * @param cmd Command to be added
  */
-static void spi_engine_queue_append_cmd(struct spi_engine_cmd_queue **fifo,
+static void spi_engine_queue_append_cmd(struct pool *pool,
+					struct spi_engine_cmd_queue **fifo,
 					uint32_t cmd)
 {
 	struct spi_engine_cmd_queue *to_add = NULL;
 
 	// Create a new element
-	spi_engine_queue_new_cmd(&to_add, cmd);
+	spi_engine_queue_new_cmd(pool, &to_add, cmd);
 	// Interchange the addresses
 	to_add->next = *fifo;
 	*fifo = to_add;
 }
 
 
+/**
+ * @brief Free a queue node allocated by spi_engine_queue_new_cmd()
+ *
+ * @param pool Pool of queue nodes, NULL to use the heap
+ * @param node The node to be freed
+ */
+static void spi_engine_queue_free_node(struct pool *pool,
+				       struct spi_engine_cmd_queue *node)
+{
+	if (pool_free(pool, node))
+		free(node);
+}
+
 /**
  * @brief Get the command from the beginning of the queue
  *
+ * @param pool Pool of queue nodes, NULL to use the heap
  * @param fifo Command buffer, usualy used in fifo mode
  * @param cmd Value of the command that was extracted
  * @return int32_t Return FAILURE if the queue is empty
  */
-static int32_t spi_engine_queue_get_cmd(struct spi_engine_cmd_queue **fifo,
+static int32_t spi_engine_queue_get_cmd(struct pool *pool,
+					struct spi_engine_cmd_queue **fifo,
 					uint32_t *cmd)
 {
 	struct spi_engine_cmd_queue *local_fifo;
@@ -309,13 +336,8 @@ static int32_t spi_engine_queue_get_cmd(struct spi_engine_cmd_queue **fifo,
 
 	local_fifo = *fifo;
 	*cmd = local_fifo->cmd;
-	if ((*fifo)->next) {
-		*fifo = local_fifo->next;
-		free(local_fifo);
-	} else {
-		free(*fifo);
-		*fifo = NULL;
-	}
+	*fifo = local_fifo->next;
+	spi_engine_queue_free_node(pool, local_fifo);
 
 	return SUCCESS;
 }
@@ -323,16 +345,19 @@ static int32_t spi_engine_queue_get_cmd(struct spi_engine_cmd_queue **fifo,
 /**
  * @brief Free the memory allocated by a queue
  *
+ * @param pool Pool of queue nodes, NULL to use the heap
  * @param fifo The queue that needs it's memory freed
  * @return int32_t This function allways return SUCCESS
  */
-static int32_t spi_engine_queue_free(struct spi_engine_cmd_queue **fifo)
+static int32_t spi_engine_queue_free(struct pool *pool,
+				     struct spi_engine_cmd_queue **fifo)
 {
-	if(*fifo && (*fifo)->next)
-		spi_engine_queue_free(&(*fifo)->next);
-	if((*fifo) != NULL) {
-		free(*fifo);
-		*fifo = NULL;
+	struct spi_engine_cmd_queue *next;
+
+	while (*fifo) {
+		next = (*fifo)->next;
+		spi_engine_queue_free_node(pool, *fifo);
+		*fifo = next;
 	}
 
 	return SUCCESS;
@@ -350,8 +375,8 @@ static int32_t spi_engine_write_cmd_reg(struct spi_engine_desc *desc,
 {
 	int32_t ret;
 
-	/* Check if offload is enabled */
-	if(desc->offload_config & (OFFLOAD_TX_EN | OFFLOAD_RX_EN)) {
+	/* Check if the offload memories are being loaded */
+	if(desc->offload_loading) {
 		ret = spi_engine_write(desc,
 				       SPI_ENGINE_REG_OFFLOAD_CMD_MEM(0),
 				       cmd);
@@ -381,7 +406,8 @@ static int32_t spi_engine_transfer(struct spi_engine_desc *desc,
 
 	words_number = spi_get_words_number(desc, bytes_number);
 
-	desc->offload_tx_len += words_number;
+	if (desc->offload_loading)
+		desc->offload_tx_len += words_number;
 
 	/*
 	 * Engine Wiki:
@@ -520,13 +546,13 @@ static int32_t spi_engine_compile_message(struct spi_desc *desc,
 	desc_extra = desc->extra;
 
 	/* Configure the prescaler */
-	spi_engine_queue_append_cmd(&msg->cmds,
+	spi_engine_queue_append_cmd(msg->pool, &msg->cmds,
 				    SPI_ENGINE_CMD_CONFIG(
 					    SPI_ENGINE_CMD_REG_CLK_DIV,
 					    desc_extra->clk_div));
 
 	/* Set the data transfer length */
-	spi_engine_queue_append_cmd(&msg->cmds,
+	spi_engine_queue_append_cmd(msg->pool, &msg->cmds,
 				    SPI_ENGINE_CMD_CONFIG(
 					    SPI_ENGINE_CMD_DATA_TRANSFER_LEN,
 					    desc_extra->data_width));
@@ -536,13 +562,14 @@ static int32_t spi_engine_compile_message(struct spi_desc *desc,
 	 *	- CPOL
 	 *	- CPHA
 	 */
-	spi_engine_queue_append_cmd(&msg->cmds,
+	spi_engine_queue_append_cmd(msg->pool, &msg->cmds,
 				    SPI_ENGINE_CMD_CONFIG(
 					    SPI_ENGINE_CMD_REG_CONFIG,
 					    desc->mode));
 
 	/* Add a sync command to signal that the transfer has finished */
-	spi_engine_queue_add_cmd(&msg->cmds, SPI_ENGINE_CMD_SYNC(_sync_id));
+	spi_engine_queue_add_cmd(msg->pool, &msg->cmds,
+				 SPI_ENGINE_CMD_SYNC(_sync_id));
 
 	return SUCCESS;
 }
@@ -568,12 +595,11 @@ static int32_t spi_engine_transfer_message(struct spi_desc *desc,
 
 	spi_engine_compile_message(desc, msg);
 
-	offload_en = (desc_extra->offload_config & OFFLOAD_TX_EN) |
-		     (desc_extra->offload_config & OFFLOAD_RX_EN);
+	offload_en = desc_extra->offload_loading;
 
 	/* Write the command fifo buffer */
 	while(msg->cmds != NULL) {
-		spi_engine_queue_get_cmd(&msg->cmds, &data);
+		spi_engine_queue_get_cmd(msg->pool, &msg->cmds, &data);
 		spi_engine_write_cmd(desc, data);
 	}
 
@@ -651,6 +677,12 @@ int32_t spi_engine_init(struct spi_desc **desc,
 	(*desc)->extra = eng_desc;
 
 	eng_desc->offload_config = OFFLOAD_DISABLED;
+	eng_desc->offload_loading = false;
+	eng_desc->offload_loaded = false;
+	eng_desc->offload_tx_dma = NULL;
+	eng_desc->offload_rx_dma = NULL;
+	eng_desc->cmd_pool = NULL;
+	eng_desc->buf_pool = NULL;
 	eng_desc->spi_engine_baseaddr = spi_engine_init->spi_engine_baseaddr;
 	eng_desc->type = spi_engine_init->type;
 	eng_desc->cs_delay = spi_engine_init->cs_delay;
@@ -658,9 +690,22 @@ int32_t spi_engine_init(struct spi_desc **desc,
 	eng_desc->clk_div =  eng_desc->ref_clk_hz /
 			     (2 * param->max_speed_hz) - 1;
 
+	/* A register access queues up to 8 commands */
+	if (spi_engine_init->cmd_pool_size &&
+	    pool_init(&eng_desc->cmd_pool, sizeof(struct spi_engine_cmd_queue),
+		      spi_engine_init->cmd_pool_size) != SUCCESS)
+		goto error;
+
+	/* One TX and one RX buffer per transfer */
+	if (spi_engine_init->buf_pool_words &&
+	    pool_init(&eng_desc->buf_pool,
+		      spi_engine_init->buf_pool_words * sizeof(uint32_t),
+		      2) != SUCCESS)
+		goto error;
+
 	/* Perform a reset */
 	spi_engine_write(eng_desc, SPI_ENGINE_REG_RESET, 0x01);
-	usleep(1000);
+	udelay(1000);
 	spi_engine_write(eng_desc, SPI_ENGINE_REG_RESET, 0x00);
 
 	/* Get current data width */
@@ -678,6 +723,15 @@ int32_t spi_engine_init(struct spi_desc **desc,
 	       (spi_engine_version & 0xFF));
 
 	return SUCCESS;
+
+error:
+	if (eng_desc->cmd_pool)
+		pool_remove(eng_desc->cmd_pool);
+	free(eng_desc);
+	free(*desc);
+	*desc = NULL;
+
+	return FAILURE;
 }
 
 /**
@@ -703,31 +757,47 @@ int32_t spi_engine_write_and_read(struct spi_desc *desc,
 	desc_extra = desc->extra;
 
 	/* If we want to access SPI interface and SPI engine offload module was
-	 * activated, we need to disable it
-	 * This is set in spi_engine_offload_init() */
-	desc_extra->offload_config = OFFLOAD_DISABLED;
-	/* This is set in spi_engine_offload_transfer() */
+	 * activated, we need to disable it. The offload memories are kept, so
+	 * spi_engine_offload_arm() can restart it without reloading them.
+	 * This is set in spi_engine_offload_arm() */
 	spi_engine_write(desc_extra, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0);
 
+	trace_event2(TRACE_ID_SPI_ENGINE_XFER, bytes_number, desc->chip_select);
+
 	words_number = spi_get_words_number(desc_extra, bytes_number);
 
-	msg.cmds = (spi_engine_cmd_queue*)malloc(sizeof(*msg.cmds));
-	if (!msg.cmds)
+	msg.pool = desc_extra->cmd_pool;
+	msg.cmds = NULL;
+	msg.tx_buf = NULL;
+	msg.rx_buf = NULL;
+	msg.length = words_number;
+
+	/* Make sure the CS is HIGH before starting a transaction */
+	if (spi_engine_queue_new_cmd(msg.pool, &msg.cmds, CS_HIGH) != SUCCESS)
 		return FAILURE;
 
-	msg.tx_buf =(uint32_t*)calloc(words_number, sizeof(msg.tx_buf[0]));
-	msg.rx_buf =(uint32_t*)calloc(words_number, sizeof(msg.rx_buf[0]));
-	msg.length = words_number;
+	if (words_number * sizeof(msg.tx_buf[0]) <=
+	    pool_block_size(desc_extra->buf_pool)) {
+		msg.tx_buf = (uint32_t*)pool_alloc(desc_extra->buf_pool);
+		msg.rx_buf = (uint32_t*)pool_alloc(desc_extra->buf_pool);
+	}
+	if (!msg.tx_buf)
+		msg.tx_buf = (uint32_t*)malloc(words_number * sizeof(msg.tx_buf[0]));
+	if (!msg.rx_buf)
+		msg.rx_buf = (uint32_t*)malloc(words_number * sizeof(msg.rx_buf[0]));
+	if (!msg.tx_buf || !msg.rx_buf) {
+		ret = FAILURE;
+		goto out;
+	}
+	memset(msg.tx_buf, 0, words_number * sizeof(msg.tx_buf[0]));
+	memset(msg.rx_buf, 0, words_number * sizeof(msg.rx_buf[0]));
 
 	/* Get the length of transfered word */
 	word_len = spi_get_word_lenght(desc_extra);
 
-	/* Make sure the CS is HIGH before starting a transaction */
-	msg.cmds->next = NULL;
-	msg.cmds->cmd = CS_HIGH;
-	spi_engine_queue_add_cmd(&msg.cmds, CS_LOW);
-	spi_engine_queue_add_cmd(&msg.cmds, WRITE_READ(bytes_number));
-	spi_engine_queue_add_cmd(&msg.cmds, CS_HIGH);
+	spi_engine_queue_add_cmd(msg.pool, &msg.cmds, CS_LOW);
+	spi_engine_queue_add_cmd(msg.pool, &msg.cmds, WRITE_READ(bytes_number));
+	spi_engine_queue_add_cmd(msg.pool, &msg.cmds, CS_HIGH);
 
 	/* Pack the bytes into engine WORDS */
 	for (i = 0; i < bytes_number; i++)
@@ -741,19 +811,281 @@ int32_t spi_engine_write_and_read(struct spi_desc *desc,
 			  (desc_extra->data_width -
 			   ((i) % word_len + 1) * 8);
 
-	spi_engine_queue_free(&msg.cmds);
-	free(msg.tx_buf);
-	free(msg.rx_buf);
+out:
+	spi_engine_queue_free(msg.pool, &msg.cmds);
+	if (pool_free(desc_extra->buf_pool, msg.tx_buf))
+		free(msg.tx_buf);
+	if (pool_free(desc_extra->buf_pool, msg.rx_buf))
+		free(msg.rx_buf);
 
 	return ret;
 }
 
 /**
- * @brief Initialize the SPI engine's offload module
+ * @brief Store the words waiting in the SDI FIFO in the segments of a
+ *	  multi-segment transfer
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param xfer Transfer in progress
+ */
+static void spi_engine_xfer_drain(struct spi_desc *desc,
+				  struct spi_engine_xfer *xfer)
+{
+	struct spi_engine_desc	*desc_extra;
+	struct spi_msg		*msg;
+	uint32_t		level;
+	uint32_t		data;
+	uint8_t			word_len;
+	uint8_t			i;
+
+	desc_extra = desc->extra;
+	word_len = spi_get_word_lenght(desc_extra);
+
+	spi_engine_read(desc_extra, SPI_ENGINE_REG_SDI_FIFO_LEVEL, &level);
+	while (level--) {
+		spi_engine_read(desc_extra, SPI_ENGINE_REG_SDI_DATA_FIFO, &data);
+		xfer->rx_words++;
+
+		while (xfer->rx_seg < xfer->len &&
+		       !xfer->msgs[xfer->rx_seg].bytes_number)
+			xfer->rx_seg++;
+		if (xfer->rx_seg == xfer->len)
+			continue;
+
+		msg = &xfer->msgs[xfer->rx_seg];
+		for (i = 0; i < word_len && xfer->rx_off < msg->bytes_number;
+		     i++, xfer->rx_off++)
+			if (msg->rx_buff)
+				msg->rx_buff[xfer->rx_off] = data >>
+							     (desc_extra->data_width -
+							      (i + 1) * 8);
+
+		if (xfer->rx_off == msg->bytes_number) {
+			xfer->rx_seg++;
+			xfer->rx_off = 0;
+		}
+	}
+}
+
+/**
+ * @brief Write a command of a multi-segment transfer, once the command FIFO
+ *	  has room for it
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param xfer Transfer in progress
+ * @param cmd Command to write
+ */
+static void spi_engine_xfer_cmd(struct spi_desc *desc,
+				struct spi_engine_xfer *xfer,
+				uint32_t cmd)
+{
+	uint32_t room;
+
+	spi_engine_read(desc->extra, SPI_ENGINE_REG_CMD_FIFO_ROOM, &room);
+	while (!room) {
+		spi_engine_xfer_drain(desc, xfer);
+		spi_engine_read(desc->extra, SPI_ENGINE_REG_CMD_FIFO_ROOM, &room);
+	}
+
+	if ((cmd >> 12) == SPI_ENGINE_INST_SYNC_SLEEP)
+		spi_engine_write_cmd_reg(desc->extra, cmd);
+	else
+		spi_engine_write_cmd(desc, cmd);
+}
+
+/**
+ * @brief Write the SDO words of a segment. No more than
+ *	  SPI_ENGINE_XFER_MAX_WORDS words are kept in flight, so the SDI FIFO
+ *	  never overflows.
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param xfer Transfer in progress
+ * @param msg Segment to send
+ */
+static void spi_engine_xfer_tx(struct spi_desc *desc,
+			       struct spi_engine_xfer *xfer,
+			       struct spi_msg *msg)
+{
+	struct spi_engine_desc	*desc_extra;
+	uint32_t		chunk;
+	uint32_t		data;
+	uint32_t		off;
+	uint8_t			word_len;
+	uint8_t			i;
+	uint8_t			j;
+
+	desc_extra = desc->extra;
+	word_len = spi_get_word_lenght(desc_extra);
+
+	for (off = 0; off < msg->bytes_number; off += chunk) {
+		chunk = min_t(uint32_t, msg->bytes_number - off,
+			      SPI_ENGINE_XFER_MAX_WORDS * word_len);
+
+		while (xfer->tx_words - xfer->rx_words +
+		       spi_get_words_number(desc_extra, chunk) >
+		       SPI_ENGINE_XFER_MAX_WORDS)
+			spi_engine_xfer_drain(desc, xfer);
+
+		spi_engine_xfer_cmd(desc, xfer, WRITE_READ(chunk));
+
+		/* Pack the bytes into engine WORDS, MSB first */
+		for (i = 0; i < chunk; i += word_len) {
+			data = 0;
+			if (msg->tx_buff)
+				for (j = 0; j < word_len && i + j < chunk; j++)
+					data |= msg->tx_buff[off + i + j] <<
+						(desc_extra->data_width - (j + 1) * 8);
+			spi_engine_write(desc_extra, SPI_ENGINE_REG_SDO_DATA_FIFO,
+					 data);
+			xfer->tx_words++;
+		}
+	}
+}
+
+/**
+ * @brief Hold the bus idle after a segment
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param xfer Transfer in progress
+ * @param delay_us Delay in microseconds
+ */
+static void spi_engine_xfer_sleep(struct spi_desc *desc,
+				  struct spi_engine_xfer *xfer,
+				  uint32_t delay_us)
+{
+	struct spi_engine_desc	*desc_extra;
+	uint64_t		period;
+	uint32_t		n;
+
+	desc_extra = desc->extra;
+
+	/* A SLEEP lasts (n + 1) SCLK periods */
+	period = (uint64_t)(desc_extra->clk_div + 1) * 2 * 1000000;
+	period = ((uint64_t)delay_us * desc_extra->ref_clk_hz + period - 1) /
+		 period;
+
+	while (period) {
+		n = min_t(uint64_t, period, 256);
+		spi_engine_xfer_cmd(desc, xfer, SPI_ENGINE_CMD_SLEEP(n - 1));
+		period -= n;
+	}
+}
+
+/**
+ * @brief Transfer a multi-segment message
+ *
+ * The whole message runs on the engine: the chip select changes and the
+ * delays between the segments are engine commands, and the FIFOs are
+ * refilled and drained while it executes. A segment may use the same buffer
+ * for tx_buff and rx_buff.
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param msgs Segments of the message
+ * @param len Number of segments
+ * @return int32_t - SUCCESS if the transfer finished
+ *		   - FAILURE if the parameters are invalid
+ */
+int32_t spi_engine_transfer_msgs(struct spi_desc *desc,
+				 struct spi_msg *msgs,
+				 uint32_t len)
+{
+	struct spi_engine_xfer	xfer = {
+		.msgs = msgs,
+		.len = len,
+	};
+	struct spi_engine_desc	*desc_extra;
+	uint32_t		sync_id;
+	bool			cs_low = false;
+	uint32_t		i;
+
+	if (!desc || (!msgs && len))
+		return FAILURE;
+
+	desc_extra = desc->extra;
+
+	/* The offload memories are kept, see spi_engine_write_and_read() */
+	spi_engine_write(desc_extra, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0);
+
+	trace_event2(TRACE_ID_SPI_ENGINE_XFER, len, desc->chip_select);
+
+	spi_engine_xfer_cmd(desc, &xfer,
+			    SPI_ENGINE_CMD_CONFIG(SPI_ENGINE_CMD_REG_CLK_DIV,
+						  desc_extra->clk_div));
+	spi_engine_xfer_cmd(desc, &xfer,
+			    SPI_ENGINE_CMD_CONFIG(SPI_ENGINE_CMD_DATA_TRANSFER_LEN,
+						  desc_extra->data_width));
+	spi_engine_xfer_cmd(desc, &xfer,
+			    SPI_ENGINE_CMD_CONFIG(SPI_ENGINE_CMD_REG_CONFIG,
+						  desc->mode));
+	spi_engine_xfer_cmd(desc, &xfer, CS_HIGH);
+
+	for (i = 0; i < len; i++) {
+		if (!cs_low) {
+			spi_engine_xfer_cmd(desc, &xfer, CS_LOW);
+			cs_low = true;
+		}
+
+		spi_engine_xfer_tx(desc, &xfer, &msgs[i]);
+
+		if (msgs[i].cs_change || i == len - 1) {
+			spi_engine_xfer_cmd(desc, &xfer, CS_HIGH);
+			cs_low = false;
+		}
+
+		if (msgs[i].delay_us)
+			spi_engine_xfer_sleep(desc, &xfer, msgs[i].delay_us);
+	}
+
+	spi_engine_xfer_cmd(desc, &xfer, SPI_ENGINE_CMD_SYNC(_sync_id));
+
+	/* Wait for the end sync signal */
+	do {
+		spi_engine_xfer_drain(desc, &xfer);
+		spi_engine_read(desc_extra, SPI_ENGINE_REG_SYNC_ID, &sync_id);
+	} while (sync_id != _sync_id);
+	_sync_id++;
+
+	spi_engine_xfer_drain(desc, &xfer);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get a DMAC for the offload module, reusing the one of a previous
+ *        spi_engine_offload_init() call when it drives the same core.
+ *
+ * @param dmac The DMAC of the session, updated in place
+ * @param init DMAC init parameters
+ * @return int32_t - SUCCESS if the DMAC is available
+ *		   - FAILURE if the memory allocation failed
+ */
+static int32_t spi_engine_offload_get_dmac(struct axi_dmac **dmac,
+		const struct axi_dmac_init *init)
+{
+	if (*dmac && (*dmac)->base == init->base) {
+		(*dmac)->flags = init->flags;
+		return SUCCESS;
+	}
+
+	axi_dmac_remove(*dmac);
+	*dmac = NULL;
+
+	axi_dmac_init(dmac, init);
+	if (!*dmac)
+		return FAILURE;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Initialize the SPI engine's offload module. The DMACs are kept
+ * 	  until spi_engine_offload_remove(), so calling this again for the same
+ * 	  cores does not allocate anything.
  *
  * @param desc Decriptor containing SPI interface parameters
  * @param param Structure containing the offload init parameters
- * @return int32_t This function allways returns SUCCESS
+ * @return int32_t - SUCCESS if the DMACs are available
+ *		   - FAILURE if the memory allocation failed
  */
 int32_t spi_engine_offload_init(struct spi_desc *desc,
 				const struct spi_engine_offload_init_param *param)
@@ -776,8 +1108,8 @@ int32_t spi_engine_offload_init(struct spi_desc *desc,
 		dmac_init.base = param->tx_dma_baseaddr;
 		dmac_init.direction = DMA_MEM_TO_DEV;
 		dmac_init.flags = dma_flags;
-		axi_dmac_init(&eng_desc->offload_tx_dma, &dmac_init);
-		if(!eng_desc->offload_tx_dma)
+		if (spi_engine_offload_get_dmac(&eng_desc->offload_tx_dma,
+						&dmac_init) != SUCCESS)
 			return FAILURE;
 	}
 	if(param->offload_config & OFFLOAD_RX_EN) {
@@ -785,8 +1117,8 @@ int32_t spi_engine_offload_init(struct spi_desc *desc,
 		dmac_init.base = param->rx_dma_baseaddr;
 		dmac_init.direction = DMA_DEV_TO_MEM;
 		dmac_init.flags = dma_flags;
-		axi_dmac_init(&eng_desc->offload_rx_dma, &dmac_init);
-		if(!eng_desc->offload_rx_dma)
+		if (spi_engine_offload_get_dmac(&eng_desc->offload_rx_dma,
+						&dmac_init) != SUCCESS)
 			return FAILURE;
 	}
 
@@ -794,21 +1126,22 @@ int32_t spi_engine_offload_init(struct spi_desc *desc,
 }
 
 /**
- * @brief Initiate a SPI transfer in offload mode
+ * @brief Load a message in the offload command and SDO memories. The message
+ * 	  is compiled with the current clock divider, data width and SPI mode
+ * 	  and stays loaded until the next call, so it only has to be done
+ * 	  once per capture setup.
  *
  * @param desc Decriptor containing SPI interface parameters
- * @param msg Offload message that get's to be transferred
- * @param no_samples Number of time the messages will be transferred
- * @return int32_t This function allways returns SUCCESS
+ * @param msg Offload message that will be executed on each trigger
+ * @return int32_t - SUCCESS if the message was loaded
+ *		   - FAILURE if offload is disabled or the allocation failed
  */
-int32_t spi_engine_offload_transfer(struct spi_desc *desc,
-				    struct spi_engine_offload_message msg,
-				    uint32_t no_samples)
+int32_t spi_engine_offload_load(struct spi_desc *desc,
+				const struct spi_engine_offload_message *msg)
 {
 	struct spi_engine_msg	transfer;
 	struct spi_engine_desc	*eng_desc;
 	uint32_t 		i;
-	uint8_t 		word_length;
 
 	eng_desc = desc->extra;
 
@@ -817,51 +1150,146 @@ int32_t spi_engine_offload_transfer(struct spi_desc *desc,
 	     (eng_desc->offload_config & OFFLOAD_RX_EN)))
 		return FAILURE;
 
+	if (!msg->no_commands)
+		return FAILURE;
+
+	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0);
 	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_RESET(0), 1);
 	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_RESET(0), 0);
 
+	eng_desc->offload_loaded = false;
 	eng_desc->offload_tx_len = 0;
 	eng_desc->offload_rx_len = 0;
 
-	transfer.cmds = (spi_engine_cmd_queue*)malloc(sizeof(*transfer.cmds));
+	transfer.pool = eng_desc->cmd_pool;
+	transfer.cmds = NULL;
 
-	if (!transfer.cmds)
+	/* Load the commands into the message */
+	if (spi_engine_queue_new_cmd(transfer.pool, &transfer.cmds,
+				     msg->commands[0]) != SUCCESS)
 		return FAILURE;
 
-	transfer.tx_buf = msg.commands_data;
+	transfer.tx_buf = msg->commands_data;
 
-	/* Load the commands into the message */
-	transfer.cmds->next = NULL;
-	transfer.cmds->cmd = msg.commands[0];
 	i = 1;
-	while(i < msg.no_commands) {
-		spi_engine_queue_add_cmd(&transfer.cmds, msg.commands[i++]);
+	while(i < msg->no_commands) {
+		spi_engine_queue_add_cmd(transfer.pool, &transfer.cmds,
+					 msg->commands[i++]);
 
 	}
 
+	eng_desc->offload_loading = true;
 	spi_engine_transfer_message(desc, &transfer);
+	eng_desc->offload_loading = false;
+
+	spi_engine_queue_free(transfer.pool, &transfer.cmds);
+
+	eng_desc->offload_loaded = true;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Start a capture with the message loaded by spi_engine_offload_load().
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param tx_addr The address where the data that will be transmitted is
+ * 	  situated
+ * @param rx_addr The address where the received data will be stored
+ * @param no_samples Number of time the message will be transferred
+ * @return int32_t - SUCCESS if the capture was started
+ *		   - FAILURE if no message is loaded or the DMA failed
+ */
+int32_t spi_engine_offload_arm(struct spi_desc *desc,
+			       uint32_t tx_addr,
+			       uint32_t rx_addr,
+			       uint32_t no_samples)
+{
+	struct spi_engine_desc	*eng_desc;
+	uint32_t		size;
+	bool			cyclic = false;
+	int32_t			ret;
+
+	eng_desc = desc->extra;
+
+	if (!eng_desc->offload_loaded)
+		return FAILURE;
+
+	size = spi_get_word_lenght(eng_desc) * eng_desc->offload_tx_len *
+	       no_samples;
 
 	/* Start transfer */
 	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0x0001);
 
-	word_length = spi_get_word_lenght(eng_desc);
 	if(eng_desc->offload_config & OFFLOAD_TX_EN) {
-		axi_dmac_transfer(eng_desc->offload_tx_dma,
-				  msg.tx_addr,
-				  word_length * eng_desc->offload_tx_len *
-				  no_samples);
+		ret = axi_dmac_transfer(eng_desc->offload_tx_dma, tx_addr, size);
+		if (ret != SUCCESS)
+			return ret;
+		cyclic |= eng_desc->offload_tx_dma->flags & DMA_CYCLIC;
 	}
 
 	if(eng_desc->offload_config & OFFLOAD_RX_EN) {
-		axi_dmac_transfer(eng_desc->offload_rx_dma,
-				  msg.rx_addr,
-				  word_length * eng_desc->offload_tx_len *
-				  no_samples);
+		ret = axi_dmac_transfer(eng_desc->offload_rx_dma, rx_addr, size);
+		if (ret != SUCCESS)
+			return ret;
+		cyclic |= eng_desc->offload_rx_dma->flags & DMA_CYCLIC;
 	}
 
-	usleep(1000);
+	/* Cyclic transfers return right away, let the buffer fill up. */
+	if (cyclic)
+		udelay(1000);
+
+	return SUCCESS;
+}
 
-	spi_engine_queue_free(&transfer.cmds);
+/**
+ * @brief Initiate a SPI transfer in offload mode
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param msg Offload message that get's to be transferred
+ * @param no_samples Number of time the messages will be transferred
+ * @return int32_t - SUCCESS if the transfer was started
+ *		   - FAILURE otherwise
+ */
+int32_t spi_engine_offload_transfer(struct spi_desc *desc,
+				    struct spi_engine_offload_message msg,
+				    uint32_t no_samples)
+{
+	int32_t ret;
+
+	ret = spi_engine_offload_load(desc, &msg);
+	if (ret != SUCCESS)
+		return ret;
+
+	return spi_engine_offload_arm(desc, msg.tx_addr, msg.rx_addr,
+				      no_samples);
+}
+
+/**
+ * @brief Stop the offload module and free the DMACs allocated by
+ * 	  spi_engine_offload_init().
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @return int32_t - SUCCESS if the offload was stopped
+ *		   - FAILURE if the descriptor is invalid
+ */
+int32_t spi_engine_offload_remove(struct spi_desc *desc)
+{
+	struct spi_engine_desc	*eng_desc;
+
+	if (!desc)
+		return FAILURE;
+
+	eng_desc = desc->extra;
+
+	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0);
+
+	axi_dmac_remove(eng_desc->offload_tx_dma);
+	axi_dmac_remove(eng_desc->offload_rx_dma);
+	eng_desc->offload_tx_dma = NULL;
+	eng_desc->offload_rx_dma = NULL;
+	eng_desc->offload_config = OFFLOAD_DISABLED;
+	eng_desc->offload_loaded = false;
 
 	return SUCCESS;
 }
@@ -878,10 +1306,12 @@ int32_t spi_engine_remove(struct spi_desc *desc)
 
 	eng_desc = desc->extra;
 
-	if(eng_desc->offload_config & OFFLOAD_TX_EN)
-		axi_dmac_remove(eng_desc->offload_tx_dma);
-	if(eng_desc->offload_config & OFFLOAD_RX_EN)
-		axi_dmac_remove(eng_desc->offload_rx_dma);
+	axi_dmac_remove(eng_desc->offload_tx_dma);
+	axi_dmac_remove(eng_desc->offload_rx_dma);
+	if (eng_desc->cmd_pool)
+		pool_remove(eng_desc->cmd_pool);
+	if (eng_desc->buf_pool)
+		pool_remove(eng_desc->buf_pool);
 	free(desc->extra);
 	free(desc);
 
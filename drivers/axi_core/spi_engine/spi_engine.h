@@ -44,6 +44,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "spi_extra.h"
@@ -60,6 +61,9 @@
 
 #define SPI_ENGINE_MSG_QUEUE_END	0xFFFFFFFF
 
+/* Words of a multi-segment transfer in flight, below the SDI FIFO depth */
+#define SPI_ENGINE_XFER_MAX_WORDS	16
+
 /* Spi engine commands */
 #define	WRITE(no_bytes)			((SPI_ENGINE_INST_TRANSFER << 12) |\
 	(SPI_ENGINE_INSTRUCTION_TRANSFER_W << 8) | no_bytes)
@@ -96,6 +100,10 @@ struct spi_engine_init_param {
 	uint32_t		cs_delay;
 	/** Data with of one SPI transfer ( in bits ) */
 	uint8_t			data_width;
+	/** Number of preallocated command queue nodes, 0 to use the heap */
+	uint16_t		cmd_pool_size;
+	/** Words of the preallocated TX/RX buffers, 0 to use the heap */
+	uint8_t			buf_pool_words;
 };
 
 
@@ -114,6 +122,10 @@ struct spi_engine_desc {
 	struct axi_dmac		*offload_rx_dma;
 	/** Offload's module transfer direction : TX, RX or both */
 	uint8_t			offload_config;
+	/** Commands are routed to the offload memories instead of the FIFOs */
+	bool			offload_loading;
+	/** The offload memories hold a message, only a DMA kick is needed */
+	bool			offload_loaded;
 	/** Number of words that the module has to send */
 	uint8_t			offload_tx_len;
 	/** Number of words that the module has to receive */
@@ -132,6 +144,10 @@ struct spi_engine_desc {
 	uint8_t			data_width;
 	/** The maximum data width supported by the engine */
 	uint8_t 		max_data_width;
+	/** Pool of command queue nodes, NULL if they come from the heap */
+	struct pool		*cmd_pool;
+	/** Pool of TX/RX buffers, NULL if they come from the heap */
+	struct pool		*buf_pool;
 };
 
 
@@ -197,6 +213,11 @@ int32_t spi_engine_write_and_read(struct spi_desc *desc,
 				  uint8_t *data,
 				  uint16_t bytes_number);
 
+/* Transfer a multi-segment message using the SPI engine */
+int32_t spi_engine_transfer_msgs(struct spi_desc *desc,
+				 struct spi_msg *msgs,
+				 uint32_t len);
+
 /* Free the resources used by the SPI engine device */
 int32_t spi_engine_remove(struct spi_desc *desc);
 
@@ -209,6 +230,19 @@ int32_t spi_engine_offload_transfer(struct spi_desc *desc,
 				    struct spi_engine_offload_message msg,
 				    uint32_t no_samples);
 
+/* Load a message in the offload memories */
+int32_t spi_engine_offload_load(struct spi_desc *desc,
+				const struct spi_engine_offload_message *msg);
+
+/* Start a capture with the message previously loaded */
+int32_t spi_engine_offload_arm(struct spi_desc *desc,
+			       uint32_t tx_addr,
+			       uint32_t rx_addr,
+			       uint32_t no_samples);
+
+/* Stop the offload module and free the DMACs */
+int32_t spi_engine_offload_remove(struct spi_desc *desc);
+
 /* Set SPI transfer width */
 int32_t spi_engine_set_transfer_width(struct spi_desc *desc,
 				      uint8_t data_wdith);
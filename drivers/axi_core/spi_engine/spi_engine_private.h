@@ -45,6 +45,7 @@
 
 #include "spi.h"
 #include "util.h"
+#include "pool.h"
 
 /******************************************************************************/
 /*************************** Spi Engine registers *****************************/
@@ -148,6 +149,19 @@ typedef struct spi_engine_msg {
 	uint32_t			*rx_buf;
 	uint32_t			length;
 	struct spi_engine_cmd_queue	*cmds;
+	struct pool			*pool;
 } spi_engine_msg;
 
+/* Progress of a multi-segment transfer through the engine FIFOs */
+typedef struct spi_engine_xfer {
+	struct spi_msg			*msgs;
+	uint32_t			len;
+	/* Words written to the SDO FIFO and read back from the SDI FIFO */
+	uint32_t			tx_words;
+	uint32_t			rx_words;
+	/* Segment and byte the next SDI word belongs to */
+	uint32_t			rx_seg;
+	uint32_t			rx_off;
+} spi_engine_xfer;
+
 #endif // SPI_ENGINE_PRIVATE_H
@@ -43,10 +43,21 @@
 /***************************** Include Files *********************************/
 /*****************************************************************************/
 #include <stdlib.h>
+#include <string.h>
 #include "error.h"
+#include "util.h"
 #include "adas1000.h"
 #include "crc.h"
 
+/*****************************************************************************/
+/************************ Variable Declarations ******************************/
+/*****************************************************************************/
+
+/** CRC lookup tables, built once by adas1000_init() */
+DECLARE_CRC16_TABLE(adas1000_crc16);
+DECLARE_CRC24_TABLE(adas1000_crc24);
+static bool adas1000_crc_ready;
+
 /*****************************************************************************/
 /************************ Function Definitions *******************************/
 /*****************************************************************************/
@@ -109,6 +120,13 @@ int32_t adas1000_init(struct adas1000_dev **device,
 	/** store the selected frame rate */
 	dev->frame_rate = init_param->frame_rate;
 
+	/** Build the frame CRC tables */
+	if (!adas1000_crc_ready) {
+		crc16_populate_msb(adas1000_crc16, CRC_POLY_128KHZ);
+		crc24_populate_msb(adas1000_crc24, CRC_POLY_2KHZ_16KHZ);
+		adas1000_crc_ready = true;
+	}
+
 	/** Initialize the SPI controller. */
 	ret = spi_init(&dev->spi_desc, &init_param->spi_init);
 	if (ret != SUCCESS) {
@@ -408,14 +426,376 @@ uint32_t adas1000_compute_frame_crc(struct adas1000_dev * device, uint8_t *buff)
 {
 	uint32_t crc = 0xFFFFFFFFul;
 
-	/** Select the CRC poly and word size based on the frame rate. */
-	if(device->frame_rate == ADAS1000_128KHZ_FRAME_RATE) {
-		DECLARE_CRC16_TABLE(adas1000_crc16);
-		crc16_populate_msb(adas1000_crc16, CRC_POLY_128KHZ);
+	/** Select the CRC table and word size based on the frame rate. */
+	if(device->frame_rate == ADAS1000_128KHZ_FRAME_RATE)
 		return crc16(adas1000_crc16, buff, device->frame_size, (uint16_t)crc);
-	} else {
-		DECLARE_CRC24_TABLE(adas1000_crc24);
-		crc24_populate_msb(adas1000_crc24, CRC_POLY_2KHZ_16KHZ);
+	else
 		return crc24(adas1000_crc24, buff, device->frame_size, crc);
+}
+
+/**
+ * @brief Get a big endian frame word.
+ * @param buff - Buffer holding the word.
+ * @param bytes - Word size in bytes.
+ * @return The word value.
+ */
+static uint32_t adas1000_get_word(const uint8_t *buff, uint8_t bytes)
+{
+	uint32_t word = 0;
+
+	while (bytes--)
+		word = (word << 8) | *buff++;
+
+	return word;
+}
+
+/**
+ * @brief Decode a frame read while streaming.
+ * @param device - Device structure.
+ * @param buff - Buffer holding the frame data.
+ * @param frame - The decoded frame.
+ * @return SUCCESS in case of success, -EAGAIN if the frame is not ready,
+ *	   -EBADMSG if the header marker or the CRC is wrong.
+ */
+static int32_t adas1000_frame_decode(struct adas1000_dev *device,
+				     uint8_t *buff, struct adas1000_frame *frame)
+{
+	struct adas1000_stream *stream = device->stream;
+	uint32_t words_no;
+	uint32_t word;
+	uint32_t mask;
+	uint32_t lead;
+	uint32_t i;
+	bool is_signed;
+
+	memset(frame->lead, 0, sizeof(frame->lead));
+
+	/** Lead format data is signed, electrode format only if SIGNEDEN. */
+	is_signed = (stream->frmctl & ADAS1000_FRMCTL_SIGNEDEN) ||
+		    (!(stream->frmctl & ADAS1000_FRMCTL_DATAFMT) &&
+		     device->frame_rate != ADAS1000_128KHZ_FRAME_RATE);
+
+	if (device->frame_rate == ADAS1000_128KHZ_FRAME_RATE) {
+		/** 16-bit words carry no address, the leads come in order. */
+		frame->status = adas1000_get_word(buff, 2) << 16;
+		words_no = device->frame_size / 2;
+	} else {
+		frame->status = adas1000_get_word(buff, 4);
+		words_no = device->frame_size / 4;
+	}
+
+	if (!(frame->status & ADAS1000_FRAMES_MARKER))
+		return -EBADMSG;
+	if (frame->status & ADAS1000_FRAMES_READY_BIT)
+		return -EAGAIN;
+
+	if (!(stream->frmctl & ADAS1000_FRMCTL_CRCDIS)) {
+		if (adas1000_compute_frame_crc(device, buff) !=
+		    ((device->frame_rate == ADAS1000_128KHZ_FRAME_RATE) ?
+		     CRC_CHECK_CONST_128KHz : CRC_CHECK_CONST_2KHZ_16KHZ))
+			return -EBADMSG;
+		words_no--;
+	}
+
+	if (device->frame_rate == ADAS1000_128KHZ_FRAME_RATE) {
+		mask = ADAS1000_FRMCTL_LEAD_I_LADIS;
+		i = 1;
+		for (lead = 0; lead < ADAS1000_NUM_LEADS && i < words_no;
+		     lead++, mask >>= 1) {
+			if (stream->frmctl & mask)
+				continue;
+			word = adas1000_get_word(buff + i++ * 2, 2);
+			frame->lead[lead] = is_signed ? (int16_t)word : (int32_t)word;
+		}
+
+		return SUCCESS;
+	}
+
+	for (i = 1; i < words_no; i++) {
+		word = adas1000_get_word(buff + i * 4, 4);
+		lead = (word >> 24) - ADAS1000_LADATA;
+		if (lead >= ADAS1000_NUM_LEADS)
+			continue;
+		word &= ADAS1000_LADATA_ECG_DATA_MASK;
+		frame->lead[lead] = is_signed ? ((int32_t)(word << 8) >> 8) :
+				    (int32_t)word;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set up frame streaming. Frames are read in batches of
+ *	  frames_per_xfer with a single SPI transfer, checked against their
+ *	  CRC, decoded and buffered in a ring.
+ * @param device - Device structure.
+ * @param param - Streaming parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adas1000_stream_init(struct adas1000_dev *device,
+			     const struct adas1000_stream_init_param *param)
+{
+	struct adas1000_stream *stream;
+	int32_t ret;
+
+	if (!device || !param || !param->frames_per_xfer || !param->ring_frames)
+		return -EINVAL;
+	if (device->stream)
+		return -EBUSY;
+
+	stream = (struct adas1000_stream *)calloc(1, sizeof(*stream));
+	if (!stream)
+		return -ENOMEM;
+
+	stream->frames_per_xfer = param->frames_per_xfer;
+	stream->xfer_buf = calloc(param->frames_per_xfer,
+				  ADAS1000_MAX_FRAME_BYTES);
+	if (!stream->xfer_buf) {
+		ret = -ENOMEM;
+		goto error_stream;
+	}
+
+	stream->ring_size = param->ring_frames * sizeof(struct adas1000_frame);
+	ret = cb_init(&stream->ring, stream->ring_size);
+	if (ret < 0)
+		goto error_buf;
+
+	device->stream = stream;
+
+	return SUCCESS;
+
+error_buf:
+	free(stream->xfer_buf);
+error_stream:
+	free(stream);
+
+	return ret;
+}
+
+/**
+ * @brief Start the frames read sequence. Header repeat and automatic word
+ *	  disable are turned off so that every frame has the same size.
+ * @param device - Device structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adas1000_stream_start(struct adas1000_dev *device)
+{
+	struct adas1000_stream *stream;
+	struct adas1000_frame frame;
+	uint32_t size;
+	int32_t ret;
+
+	if (!device || !device->stream)
+		return -EINVAL;
+
+	stream = device->stream;
+	ret = adas1000_read(device, ADAS1000_FRMCTL, &stream->frmctl);
+	if (ret != SUCCESS)
+		return ret;
+
+	stream->frmctl &= ~(ADAS1000_FRMCTL_RDYRPT | ADAS1000_FRMCTL_ADIS);
+	ret = adas1000_write(device, ADAS1000_FRMCTL, stream->frmctl);
+	if (ret != SUCCESS)
+		return ret;
+
+	/** Empty the ring of a previous capture. */
+	cb_size(stream->ring, &size);
+	while (size) {
+		cb_read(stream->ring, &frame, sizeof(frame));
+		size -= sizeof(frame);
+	}
+	stream->frames_dropped = 0;
+	stream->crc_errors = 0;
+
+	ret = adas1000_write(device, ADAS1000_FRAMES, 0);
+	if (ret != SUCCESS)
+		return ret;
+
+	stream->active = true;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read one batch of frames with a single SPI transfer and move the
+ *	  valid ones to the ring. Frames that do not fit in the ring, have a
+ *	  wrong CRC or were skipped by the device are counted as dropped.
+ * @param device - Device structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adas1000_stream_service(struct adas1000_dev *device)
+{
+	struct adas1000_stream *stream;
+	struct adas1000_frame frame;
+	uint32_t xfer_size;
+	uint32_t size;
+	uint32_t i;
+	int32_t ret;
+
+	if (!device || !device->stream || !device->stream->active)
+		return -EINVAL;
+
+	stream = device->stream;
+	xfer_size = stream->frames_per_xfer * device->frame_size;
+
+	/** Clock out NOPs, the buffer is shifted back in place. */
+	memset(stream->xfer_buf, 0, xfer_size);
+	ret = spi_write_and_read(device->spi_desc, stream->xfer_buf, xfer_size);
+	if (ret != SUCCESS)
+		return ret;
+
+	cb_size(stream->ring, &size);
+	for (i = 0; i < xfer_size; i += device->frame_size) {
+		ret = adas1000_frame_decode(device, stream->xfer_buf + i,
+					    &frame);
+		if (ret == -EAGAIN)
+			continue;
+		if (ret < 0) {
+			stream->crc_errors++;
+			stream->frames_dropped++;
+			continue;
+		}
+
+		stream->frames_dropped += field_get(ADAS1000_FRAMES_OVERFLOW_MASK,
+						    frame.status);
+
+		/** Keep the unread frames, count the new one as dropped. */
+		if (size + sizeof(frame) > stream->ring_size) {
+			stream->frames_dropped++;
+			continue;
+		}
+
+		cb_write(stream->ring, &frame, sizeof(frame));
+		size += sizeof(frame);
 	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read decoded frames, servicing the stream until enough of them are
+ *	  available.
+ * @param device - Device structure.
+ * @param frames - Where to store the frames.
+ * @param frame_cnt - Number of frames to read.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adas1000_stream_read_frames(struct adas1000_dev *device,
+				    struct adas1000_frame *frames,
+				    uint32_t frame_cnt)
+{
+	struct adas1000_stream *stream;
+	uint32_t chunk;
+	uint32_t size;
+	int32_t ret;
+
+	if (!device || !device->stream || !frames)
+		return -EINVAL;
+
+	stream = device->stream;
+	while (frame_cnt) {
+		cb_size(stream->ring, &size);
+		if (!size) {
+			ret = adas1000_stream_service(device);
+			if (ret != SUCCESS)
+				return ret;
+			continue;
+		}
+
+		chunk = min_t(uint32_t, frame_cnt, size / sizeof(*frames));
+		ret = cb_read(stream->ring, frames, chunk * sizeof(*frames));
+		if (ret < 0)
+			return ret;
+
+		frames += chunk;
+		frame_cnt -= chunk;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read decoded frames into per-lead arrays.
+ * @param device - Device structure.
+ * @param leads - One array of frame_cnt samples per lead, NULL to skip a lead.
+ * @param status - Array of frame_cnt frame headers, may be NULL.
+ * @param frame_cnt - Number of frames to read.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adas1000_stream_read(struct adas1000_dev *device,
+			     int32_t *leads[ADAS1000_NUM_LEADS],
+			     uint32_t *status, uint32_t frame_cnt)
+{
+	struct adas1000_frame frames[8];
+	uint32_t chunk;
+	uint32_t done;
+	uint32_t lead;
+	uint32_t i;
+	int32_t ret;
+
+	if (!leads)
+		return -EINVAL;
+
+	for (done = 0; done < frame_cnt; done += chunk) {
+		chunk = min_t(uint32_t, frame_cnt - done, ARRAY_SIZE(frames));
+		ret = adas1000_stream_read_frames(device, frames, chunk);
+		if (ret != SUCCESS)
+			return ret;
+
+		for (i = 0; i < chunk; i++) {
+			for (lead = 0; lead < ADAS1000_NUM_LEADS; lead++)
+				if (leads[lead])
+					leads[lead][done + i] = frames[i].lead[lead];
+			if (status)
+				status[done + i] = frames[i].status;
+		}
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Stop the frames read sequence. Frames already in the ring can still
+ *	  be read.
+ * @param device - Device structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adas1000_stream_stop(struct adas1000_dev *device)
+{
+	uint32_t reg_data;
+
+	if (!device || !device->stream)
+		return -EINVAL;
+
+	if (!device->stream->active)
+		return SUCCESS;
+
+	device->stream->active = false;
+
+	/** A register read ends the frames read sequence. */
+	return adas1000_read(device, ADAS1000_FRMCTL, &reg_data);
+}
+
+/**
+ * @brief Free the resources allocated by adas1000_stream_init().
+ * @param device - Device structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adas1000_stream_remove(struct adas1000_dev *device)
+{
+	int32_t ret;
+
+	if (!device || !device->stream)
+		return -EINVAL;
+
+	ret = adas1000_stream_stop(device);
+	if (ret != SUCCESS)
+		return ret;
+
+	cb_remove(device->stream->ring);
+	free(device->stream->xfer_buf);
+	free(device->stream);
+	device->stream = NULL;
+
+	return SUCCESS;
 }
@@ -49,6 +49,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "spi.h"
+#include "circular_buffer.h"
 
 /******************************************************************************/
 /* ADAS1000 SPI Registers Memory Map */
@@ -1005,6 +1006,7 @@
    10 = 2 frames missed
    11 = 3 or more frames missed */
 #define ADAS1000_FRAMES_OVERFLOW		            (1ul << 28)
+#define ADAS1000_FRAMES_OVERFLOW_MASK		      (0x00000003ul << 28)
 /* Internal device error detected.
    0 = normal operation
    1 = error condition	*/
@@ -1073,6 +1075,14 @@
 #define CRC_POLY_128KHZ				               0x00001021ul
 #define CRC_CHECK_CONST_128KHz			         0x00001D0Ful
 
+/******************************************************************************/
+/* ADAS1000 frame streaming */
+/******************************************************************************/
+/* Number of ECG leads/electrodes carried by a frame */
+#define ADAS1000_NUM_LEADS			            5
+/* Largest frame, in bytes (12 words of 32 bits) */
+#define ADAS1000_MAX_FRAME_BYTES		         48
+
 struct adas1000_dev {
 	/** SPI Descriptor */
 	struct spi_desc *spi_desc;
@@ -1082,6 +1092,8 @@ struct adas1000_dev {
 	uint32_t frame_rate;
 	/** Number of inactive words in a frame */
 	uint32_t inactive_words_no;
+	/** Frame streaming state, NULL if not set up */
+	struct adas1000_stream *stream;
 };
 
 struct adas1000_init_param {
@@ -1105,6 +1117,39 @@ struct read_param {
 	bool ready_repeat;
 };
 
+struct adas1000_frame {
+	/** Frame header, status bits as ADAS1000_FRAMES_* */
+	uint32_t status;
+	/** LA/Lead I, LL/Lead II, RA/Lead III, V1, V2 data, 0 if excluded */
+	int32_t lead[ADAS1000_NUM_LEADS];
+};
+
+struct adas1000_stream_init_param {
+	/** Number of frames read with a single SPI transfer */
+	uint32_t frames_per_xfer;
+	/** Number of decoded frames buffered between reads */
+	uint32_t ring_frames;
+};
+
+struct adas1000_stream {
+	/** Number of frames read with a single SPI transfer */
+	uint32_t frames_per_xfer;
+	/** SPI transfer buffer, frames_per_xfer maximum size frames */
+	uint8_t *xfer_buf;
+	/** Decoded frames waiting to be read */
+	struct circular_buffer *ring;
+	/** Ring size in bytes */
+	uint32_t ring_size;
+	/** Frame Control Register value while streaming */
+	uint32_t frmctl;
+	/** Number of frames lost by the device, the ring or to bad CRCs */
+	uint32_t frames_dropped;
+	/** Number of frames with a wrong CRC or header marker */
+	uint32_t crc_errors;
+	/** Set while streaming */
+	bool active;
+};
+
 
 /******************************************************************************/
 /* Functions Prototypes */
@@ -1146,4 +1191,30 @@ int32_t adas1000_read_data(struct adas1000_dev *device, uint8_t *data_buff,
 uint32_t adas1000_compute_frame_crc(struct adas1000_dev * device,
 				    uint8_t *buff);
 
+/* Set up frame streaming */
+int32_t adas1000_stream_init(struct adas1000_dev *device,
+			     const struct adas1000_stream_init_param *param);
+
+/* Start the frames read sequence */
+int32_t adas1000_stream_start(struct adas1000_dev *device);
+
+/* Read one batch of frames into the ring */
+int32_t adas1000_stream_service(struct adas1000_dev *device);
+
+/* Read decoded frames */
+int32_t adas1000_stream_read_frames(struct adas1000_dev *device,
+				    struct adas1000_frame *frames,
+				    uint32_t frame_cnt);
+
+/* Read decoded frames into per-lead arrays */
+int32_t adas1000_stream_read(struct adas1000_dev *device,
+			     int32_t *leads[ADAS1000_NUM_LEADS],
+			     uint32_t *status, uint32_t frame_cnt);
+
+/* Stop the frames read sequence */
+int32_t adas1000_stream_stop(struct adas1000_dev *device);
+
+/* Free the resources allocated by adas1000_stream_init() */
+int32_t adas1000_stream_remove(struct adas1000_dev *device);
+
 #endif /* _ADAS1000_H_ */
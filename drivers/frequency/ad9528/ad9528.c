@@ -783,90 +783,133 @@ uint32_t ad9528_clk_round_rate(struct ad9528_dev *dev, uint32_t chan,
 }
 
 /***************************************************************************//**
- * @brief Set channel rate.
+ * @brief Compute the clock plan setting of a channel.
  *
  * @param dev - is a pointer to the ad9528_dev data structure.
  * @param chan - Channel number.
  * @param rate - Channel rate in Hz.
+ * @param setting - The computed setting. param[0] is the channel divider (or
+ *                  the SYSREF K divider), param[1] is the signal source.
  *
  * @return 0 in case of success, negative error code otherwise.
  *******************************************************************************/
-int32_t ad9528_clk_set_rate(struct ad9528_dev *dev, uint32_t chan,
-			    uint32_t rate)
+int32_t ad9528_clk_plan_solve(void *dev, uint32_t chan, uint64_t rate,
+			      struct clk_plan_setting *setting)
 {
-	uint32_t div;
-	int32_t ret;
-	uint32_t reg;
+	struct ad9528_dev *ad9528 = dev;
 	uint32_t signal_source;
+	uint32_t freq;
+	uint32_t div;
 
-	if (chan >= dev->pdata->num_channels)
+	if (chan >= ad9528->pdata->num_channels || !rate)
 		return -1;
 
-	signal_source = dev->pdata->channels[chan].signal_source;
+	signal_source = ad9528->pdata->channels[chan].signal_source;
 
-	// if the channel has VCO as source then operate on the channel divider
 	if (signal_source == AD9528_VCO) {
-		div = ad9528_calc_out_div(rate, dev->ad9528_st.vco_out_freq[signal_source]);
-		dev->pdata->channels[chan].channel_divider = div;
+		freq = ad9528->ad9528_st.vco_out_freq[signal_source];
+		div = ad9528_calc_out_div(rate, freq);
+	} else if (signal_source == AD9528_SYSREF) {
+		// SYSREF Generator is sourced from VCXO with a fixed divider of 2 and a K divider
+		freq = ad9528->ad9528_st.vco_out_freq[AD9528_VCXO] / 2;
+		div = DIV_ROUND_CLOSEST(freq, (uint32_t)rate);
+		div = clamp_t(unsigned int,
+			      div,
+			      AD9528_SYSREF_K_DIV_MIN,
+			      AD9528_SYSREF_K_DIV_MAX);
+	} else {
+		// oops, it seems channels were misconfigured.
+		return -2;
+	}
 
-		// make a copy of the channel control register.
-		ret = ad9528_spi_read_n(dev,
-					AD9528_CHANNEL_OUTPUT(chan),
-					&reg);
+	setting->param[0] = div;
+	setting->param[1] = signal_source;
+	setting->rate = DIV_ROUND_CLOSEST(freq, div);
 
-		if (ret < 0)
-			return ret;
+	return 0;
+}
 
-		// set the divide ratio bits.
-		uint32_t divmask = AD9528_CLK_DIST_DIV(0xFF + 1);
+/***************************************************************************//**
+ * @brief Program a precomputed clock plan setting.
+ *
+ * The channel output register is rebuilt from the platform data, so no
+ * read-back is needed before updating the divider.
+ *
+ * @param dev - is a pointer to the ad9528_dev data structure.
+ * @param chan - Channel number.
+ * @param setting - The setting computed by ad9528_clk_plan_solve().
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ *******************************************************************************/
+int32_t ad9528_clk_plan_apply(void *dev, uint32_t chan,
+			      const struct clk_plan_setting *setting)
+{
+	struct ad9528_dev *ad9528 = dev;
+	struct ad9528_channel_spec *ch;
+	uint32_t div = setting->param[0];
+	int32_t ret;
 
-		// clear those bits in the channel register copy.
-		reg &= ~divmask;
+	if (chan >= ad9528->pdata->num_channels)
+		return -1;
 
-		// apply the new channel divider to the register copy.
-		reg |= AD9528_CLK_DIST_DIV(dev->pdata->channels[chan].channel_divider);
+	ch = &ad9528->pdata->channels[chan];
 
-		// apply the new channel divider to hardware.
-		ret = ad9528_spi_write_n(dev,
-					 AD9528_CHANNEL_OUTPUT(dev->pdata->channels[chan].channel_num),
-					 reg);
+	// if the channel has VCO as source then operate on the channel divider
+	if (setting->param[1] == AD9528_VCO) {
+		ret = ad9528_spi_write_n(ad9528,
+					 AD9528_CHANNEL_OUTPUT(ch->channel_num),
+					 AD9528_CLK_DIST_DRIVER_MODE(ch->driver_mode) |
+					 AD9528_CLK_DIST_DIV(div) |
+					 AD9528_CLK_DIST_DIV_PHASE(ch->divider_phase) |
+					 AD9528_CLK_DIST_CTRL(ch->signal_source));
 		if (ret < 0)
 			return ret;
+
+		ch->channel_divider = div;
 	}
 	// if the channel has SYSREF as source then operate on the sysref K divider
 	// note that this affects all other SYSREF sourced channels
-	else if (signal_source == AD9528_SYSREF) {
-		// SYSREF Generator is sourced from VCXO with a fixed divider of 2 and a K divider
-		div = DIV_ROUND_CLOSEST(dev->ad9528_st.vco_out_freq[AD9528_VCXO] / 2, rate);
+	else if (setting->param[1] == AD9528_SYSREF) {
+		if (ad9528->pdata->sysref_k_div == div)
+			return 0;
 
-		div = clamp_t(unsigned int,
-			      div,
-			      AD9528_SYSREF_K_DIV_MIN,
-			      AD9528_SYSREF_K_DIV_MAX);
-
-		// apply the new K divider to hardware.
-		reg = div;
-		ret = ad9528_spi_write_n(dev,
+		ret = ad9528_spi_write_n(ad9528,
 					 AD9528_SYSREF_K_DIVIDER,
-					 reg);
-
-		if(ret < 0)
+					 div);
+		if (ret < 0)
 			return ret;
-		else {
-			dev->pdata->sysref_k_div = div;
-			dev->ad9528_st.vco_out_freq[AD9528_SYSREF] =
-				dev->ad9528_st.vco_out_freq[AD9528_VCXO] / 2 / div;
-		}
+
+		ad9528->pdata->sysref_k_div = div;
+		ad9528->ad9528_st.vco_out_freq[AD9528_SYSREF] =
+			ad9528->ad9528_st.vco_out_freq[AD9528_VCXO] / 2 / div;
 	} else {
 		// oops, it seems channels were misconfigured.
 		return -2;
 	}
 
-	ret = ad9528_io_update(dev);
+	return ad9528_io_update(ad9528);
+}
+
+/***************************************************************************//**
+ * @brief Set channel rate.
+ *
+ * @param dev - is a pointer to the ad9528_dev data structure.
+ * @param chan - Channel number.
+ * @param rate - Channel rate in Hz.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ *******************************************************************************/
+int32_t ad9528_clk_set_rate(struct ad9528_dev *dev, uint32_t chan,
+			    uint32_t rate)
+{
+	struct clk_plan_setting setting;
+	int32_t ret;
+
+	ret = ad9528_clk_plan_solve(dev, chan, rate, &setting);
 	if (ret < 0)
 		return ret;
 
-	return ret;
+	return ad9528_clk_plan_apply(dev, chan, &setting);
 }
 
 /***************************************************************************//**
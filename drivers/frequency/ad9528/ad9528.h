@@ -47,6 +47,7 @@
 #include "delay.h"
 #include "spi.h"
 #include "gpio.h"
+#include "clk_plan.h"
 
 /******************************************************************************/
 /****************************** AD9528 ****************************************/
@@ -529,6 +530,10 @@ uint32_t ad9528_clk_round_rate(struct ad9528_dev *dev, uint32_t chan,
 			       uint32_t rate);
 int32_t ad9528_clk_set_rate(struct ad9528_dev *dev, uint32_t chan,
 			    uint32_t rate);
+int32_t ad9528_clk_plan_solve(void *dev, uint32_t chan, uint64_t rate,
+			      struct clk_plan_setting *setting);
+int32_t ad9528_clk_plan_apply(void *dev, uint32_t chan,
+			      const struct clk_plan_setting *setting);
 int32_t ad9528_reset(struct ad9528_dev *dev);
 int32_t ad9528_remove(struct ad9528_dev *dev);
 
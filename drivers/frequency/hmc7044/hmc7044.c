@@ -319,6 +319,33 @@ uint32_t hmc7044_calc_out_div(uint32_t rate,
 	return div;
 }
 
+/**
+ * Program the output divider of a channel.
+ * @param dev - The device structure.
+ * @param chan - Channel number.
+ * @param div - The output divider.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t hmc7044_write_out_div(struct hmc7044_dev *dev, uint32_t chan,
+				     uint32_t div)
+{
+	int32_t ret;
+
+	ret = hmc7044_write(dev, HMC7044_REG_CH_OUT_CRTL_1(chan),
+			    HMC7044_DIV_LSB(div));
+	if(ret < 0)
+		return ret;
+
+	ret = hmc7044_write(dev, HMC7044_REG_CH_OUT_CRTL_2(chan),
+			    HMC7044_DIV_MSB(div));
+	if(ret < 0)
+		return ret;
+
+	dev->channels[chan].divider = div;
+
+	return SUCCESS;
+}
+
 /**
  * Recalculate rate corresponding to a channel.
  * @param dev - The device structure.
@@ -365,21 +392,59 @@ int32_t hmc7044_clk_set_rate(struct hmc7044_dev *dev, uint32_t chan,
 			     uint64_t rate)
 {
 	uint32_t div;
-	int32_t ret;
 
 	if (chan >= dev->num_channels)
 		return FAILURE;
 
 	div = hmc7044_calc_out_div(rate, dev->pll2_freq);
-	dev->channels[chan].divider = div;
 
-	ret = hmc7044_write(dev, HMC7044_REG_CH_OUT_CRTL_1(chan),
-			    HMC7044_DIV_LSB(div));
-	if(ret < 0)
-		return ret;
+	return hmc7044_write_out_div(dev, chan, div);
+}
+
+/**
+ * Compute the clock plan setting of a channel.
+ * @param dev - The device structure.
+ * @param chan - Channel number.
+ * @param rate - Channel rate.
+ * @param setting - The computed setting (param[0] is the output divider).
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t hmc7044_clk_plan_solve(void *dev, uint32_t chan, uint64_t rate,
+			       struct clk_plan_setting *setting)
+{
+	struct hmc7044_dev *hmc = dev;
+	uint32_t div;
+
+	if (chan >= hmc->num_channels || !rate)
+		return -EINVAL;
+
+	div = hmc7044_calc_out_div(rate, hmc->pll2_freq);
+	setting->param[0] = div;
+	setting->rate = DIV_ROUND_CLOSEST(hmc->pll2_freq, div);
+
+	return SUCCESS;
+}
+
+/**
+ * Program a precomputed clock plan setting.
+ * @param dev - The device structure.
+ * @param chan - Channel number.
+ * @param setting - The setting computed by hmc7044_clk_plan_solve().
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t hmc7044_clk_plan_apply(void *dev, uint32_t chan,
+			       const struct clk_plan_setting *setting)
+{
+	struct hmc7044_dev *hmc = dev;
+
+	if (chan >= hmc->num_channels)
+		return -EINVAL;
+
+	/* Nothing to do if the divider is already in place. */
+	if (hmc->channels[chan].divider == setting->param[0])
+		return SUCCESS;
 
-	return hmc7044_write(dev, HMC7044_REG_CH_OUT_CRTL_2(chan),
-			     HMC7044_DIV_MSB(div));
+	return hmc7044_write_out_div(dev, chan, setting->param[0]);
 }
 
 /**
@@ -46,6 +46,7 @@
 #include <stdint.h>
 #include "delay.h"
 #include "spi.h"
+#include "clk_plan.h"
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -131,5 +132,10 @@ int32_t hmc7044_clk_round_rate(struct hmc7044_dev *dev, uint32_t rate,
 			       uint64_t *rounded_rate);
 int32_t hmc7044_clk_set_rate(struct hmc7044_dev *dev, uint32_t chan,
 			     uint64_t rate);
+/* Clock plan solve/apply callbacks. */
+int32_t hmc7044_clk_plan_solve(void *dev, uint32_t chan, uint64_t rate,
+			       struct clk_plan_setting *setting);
+int32_t hmc7044_clk_plan_apply(void *dev, uint32_t chan,
+			       const struct clk_plan_setting *setting);
 
 #endif // HMC7044_H_
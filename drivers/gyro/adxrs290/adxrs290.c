@@ -384,6 +384,7 @@ int32_t adxrs290_init(struct adxrs290_dev **device,
 
 	// Enable all channels by default
 	dev->ch_mask = ADXRS290_CHANNEL_MASK;
+	dev->trigger = NULL;
 
 	*device = dev;
 
@@ -173,6 +173,8 @@ struct adxrs290_init_param {
 	enum adxrs290_hpf	hpf;
 };
 
+struct iio_trigger_desc;
+
 /**
  * @struct adxrs290_dev
  * @brief Device driver handler
@@ -184,6 +186,8 @@ struct adxrs290_dev {
 	struct gpio_desc	*gpio_sync;
 	/** Active Channels */
 	uint8_t			ch_mask;
+	/** IIO trigger feeding the buffer, NULL when data ready is polled */
+	struct iio_trigger_desc	*trigger;
 };
 
 /******************************************************************************/
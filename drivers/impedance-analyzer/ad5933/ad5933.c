@@ -42,6 +42,8 @@
 /*****************************************************************************/
 #include <stdlib.h>
 #include "ad5933.h"
+#include "delay.h"
+#include "error.h"
 #include <math.h>
 
 /******************************************************************************/
@@ -77,6 +79,7 @@ int32_t ad5933_init(struct ad5933_dev **device,
 	if (!dev)
 		return -1;
 
+	dev->current_settling = AD5933_15_CYCLES;
 	dev->current_sys_clk = init_param.current_sys_clk;
 	dev->current_clock_source = init_param.current_clock_source;
 	dev->current_gain = init_param.current_gain;
@@ -488,4 +491,257 @@ void ad5933_set_settling_time(struct ad5933_dev *dev,
 				  AD5933_REG_SETTLING_CYCLES,
 				  number_cycles | (multiplier << 9),
 				  2);
+
+	/* Store the effective number of cycles, used to time the sweep. */
+	dev->current_settling = (number_cycles & 0x1FF) * (multiplier + 1);
+}
+
+/***************************************************************************//**
+ * @brief Reads consecutive registers in one I2C block read.
+ *
+ * @param dev              - The device structure.
+ * @param register_address - Address of the first register.
+ * @param data             - Buffer where the register values are stored.
+ * @param bytes_number     - Number of bytes.
+ *
+ * @return ret - Result of the I2C transfers.
+*******************************************************************************/
+int32_t ad5933_block_read(struct ad5933_dev *dev,
+			  uint8_t register_address,
+			  uint8_t *data,
+			  uint8_t bytes_number)
+{
+	uint8_t write_data[2];
+	int32_t ret;
+
+	/* Set the register pointer. */
+	write_data[0] = AD5933_ADDR_POINTER;
+	write_data[1] = register_address;
+	ret = i2c_write(dev->i2c_desc, write_data, 2, 1);
+	if (ret < 0)
+		return ret;
+
+	/* Block read command followed by the number of bytes. */
+	write_data[0] = AD5933_BLOCK_READ;
+	write_data[1] = bytes_number;
+	ret = i2c_write(dev->i2c_desc, write_data, 2, 0);
+	if (ret < 0)
+		return ret;
+
+	return i2c_read(dev->i2c_desc, data, bytes_number, 1);
+}
+
+/***************************************************************************//**
+ * @brief Waits for a status bit with an exponential backoff. The first poll
+ *        is done after the expected measurement time.
+ *
+ * @param dev         - The device structure.
+ * @param mask        - Status bit(s) to wait for.
+ * @param expected_us - Expected time until the bit is set.
+ * @param timeout_us  - Time after which the wait is abandoned.
+ *
+ * @return ret - 0 if the bit was set, -ETIMEDOUT or I2C error otherwise.
+*******************************************************************************/
+static int32_t ad5933_wait_status(struct ad5933_dev *dev,
+				  uint8_t mask,
+				  uint32_t expected_us,
+				  uint32_t timeout_us)
+{
+	uint32_t waited = expected_us;
+	uint32_t step = AD5933_POLL_MIN_US;
+	uint8_t write_data[2];
+	uint8_t status;
+	int32_t ret;
+
+	udelay(expected_us);
+
+	/* Point at the status register once, then read it repeatedly. */
+	write_data[0] = AD5933_ADDR_POINTER;
+	write_data[1] = AD5933_REG_STATUS;
+	ret = i2c_write(dev->i2c_desc, write_data, 2, 1);
+	if (ret < 0)
+		return ret;
+
+	while (1) {
+		ret = i2c_read(dev->i2c_desc, &status, 1, 1);
+		if (ret < 0)
+			return ret;
+		if (status & mask)
+			return 0;
+		if (waited >= timeout_us)
+			return -ETIMEDOUT;
+
+		udelay(step);
+		waited += step;
+		if (step < AD5933_POLL_MAX_US)
+			step *= 2;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Expected time of one sweep point: settling cycles at the excitation
+ *        frequency followed by the DFT.
+ *
+ * @param dev  - The device structure.
+ * @param freq - Excitation frequency in Hz.
+ *
+ * @return Time in microseconds.
+*******************************************************************************/
+static uint32_t ad5933_point_time_us(struct ad5933_dev *dev, uint32_t freq)
+{
+	uint64_t settling_us;
+	uint64_t dft_us;
+
+	settling_us = (uint64_t)dev->current_settling * 1000000ul /
+		      (freq ? freq : 1);
+	/* The ADC samples at MCLK / 16. */
+	dft_us = (uint64_t)AD5933_DFT_SAMPLES * 16 * 1000000ul /
+		 dev->current_sys_clk;
+
+	return settling_us + dft_us;
+}
+
+/***************************************************************************//**
+ * @brief Runs a whole frequency sweep without caller involvement between
+ *        points. For each point, DATA_VALID is awaited with a bounded
+ *        backoff, the real and imaginary data are read in one 4-byte block
+ *        read and the point's calibration entry is applied.
+ *
+ * @param dev    - The device structure.
+ * @param param  - Sweep parameters.
+ * @param cal    - Calibration table with param->count entries, built by
+ *                 ad5933_sweep_calibrate(). If NULL, only the raw data is
+ *                 stored.
+ * @param points - Results, param->count entries.
+ *
+ * @return ret - 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t ad5933_sweep(struct ad5933_dev *dev,
+		     const struct ad5933_sweep_param *param,
+		     const struct ad5933_cal_point *cal,
+		     struct ad5933_sweep_point *points)
+{
+	uint8_t function = AD5933_FUNCTION_START_SWEEP;
+	uint8_t data[4];
+	uint32_t point_us;
+	double magnitude;
+	uint16_t i;
+	int32_t ret;
+
+	if (!dev || !param || !points || !param->count ||
+	    param->count > AD5933_MAX_INC_NUM + 1)
+		return -EINVAL;
+
+	ad5933_config_sweep(dev, param->start_freq, param->inc_freq,
+			    param->count - 1);
+
+	ad5933_set_register_value(dev,
+				  AD5933_REG_CONTROL_HB,
+				  AD5933_CONTROL_FUNCTION(AD5933_FUNCTION_STANDBY) |
+				  AD5933_CONTROL_RANGE(dev->current_range) |
+				  AD5933_CONTROL_PGA_GAIN(dev->current_gain),
+				  1);
+	ad5933_reset(dev);
+	ad5933_set_register_value(dev,
+				  AD5933_REG_CONTROL_HB,
+				  AD5933_CONTROL_FUNCTION(AD5933_FUNCTION_INIT_START_FREQ)|
+				  AD5933_CONTROL_RANGE(dev->current_range) |
+				  AD5933_CONTROL_PGA_GAIN(dev->current_gain),
+				  1);
+
+	for (i = 0; i < param->count; i++) {
+		/* Start the sweep, then step to the next frequency. */
+		ad5933_set_register_value(dev,
+					  AD5933_REG_CONTROL_HB,
+					  AD5933_CONTROL_FUNCTION(function) |
+					  AD5933_CONTROL_RANGE(dev->current_range) |
+					  AD5933_CONTROL_PGA_GAIN(dev->current_gain),
+					  1);
+		function = AD5933_FUNCTION_INC_FREQ;
+
+		point_us = ad5933_point_time_us(dev, param->start_freq +
+						i * param->inc_freq);
+		ret = ad5933_wait_status(dev, AD5933_STAT_DATA_VALID, point_us,
+					 2 * point_us + AD5933_POLL_MAX_US);
+		if (ret < 0)
+			return ret;
+
+		ret = ad5933_block_read(dev, AD5933_REG_REAL_DATA, data, 4);
+		if (ret < 0)
+			return ret;
+
+		points[i].real = (int16_t)(((uint16_t)data[0] << 8) | data[1]);
+		points[i].imag = (int16_t)(((uint16_t)data[2] << 8) | data[3]);
+		points[i].phase = atan2(points[i].imag, points[i].real);
+		points[i].impedance = 0;
+		if (!cal)
+			continue;
+
+		magnitude = sqrt((double)points[i].real * points[i].real +
+				 (double)points[i].imag * points[i].imag);
+		if (magnitude != 0)
+			points[i].impedance = 1 / (magnitude *
+						   cal[i].gain_factor);
+		points[i].phase -= cal[i].phase;
+	}
+
+	ad5933_set_register_value(dev,
+				  AD5933_REG_CONTROL_HB,
+				  AD5933_CONTROL_FUNCTION(AD5933_FUNCTION_POWER_DOWN) |
+				  AD5933_CONTROL_RANGE(dev->current_range) |
+				  AD5933_CONTROL_PGA_GAIN(dev->current_gain),
+				  1);
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Runs a sweep on a known impedance and computes the gain factor and
+ *        system phase of every point. Range, gain and settling time must be
+ *        the ones used for the measurement sweeps.
+ *
+ * @param dev                   - The device structure.
+ * @param param                 - Sweep parameters.
+ * @param calibration_impedance - The calibration impedance value.
+ * @param cal                   - Calibration table, param->count entries.
+ *
+ * @return ret - 0 in case of success, negative error code otherwise.
+*******************************************************************************/
+int32_t ad5933_sweep_calibrate(struct ad5933_dev *dev,
+			       const struct ad5933_sweep_param *param,
+			       uint32_t calibration_impedance,
+			       struct ad5933_cal_point *cal)
+{
+	struct ad5933_sweep_point *points;
+	double magnitude;
+	uint16_t i;
+	int32_t ret;
+
+	if (!param || !cal || !calibration_impedance)
+		return -EINVAL;
+
+	points = (struct ad5933_sweep_point *)calloc(param->count,
+			sizeof(*points));
+	if (!points)
+		return -ENOMEM;
+
+	ret = ad5933_sweep(dev, param, NULL, points);
+	if (ret < 0)
+		goto out;
+
+	for (i = 0; i < param->count; i++) {
+		magnitude = sqrt((double)points[i].real * points[i].real +
+				 (double)points[i].imag * points[i].imag);
+		if (magnitude == 0) {
+			ret = -EIO;
+			goto out;
+		}
+		cal[i].gain_factor = 1 / (magnitude * calibration_impedance);
+		cal[i].phase = points[i].phase;
+	}
+
+out:
+	free(points);
+
+	return ret;
 }
@@ -115,6 +115,11 @@
 /* AD5933 Specifications */
 #define AD5933_INTERNAL_SYS_CLK     16000000ul      // 16MHz
 #define AD5933_MAX_INC_NUM          511             // Maximum increment number
+#define AD5933_DFT_SAMPLES          1024            // Samples per DFT
+
+/* AD5933 Sweep engine status polling, in microseconds */
+#define AD5933_POLL_MIN_US          50              // First backoff step
+#define AD5933_POLL_MAX_US          1000            // Largest backoff step
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -128,6 +133,7 @@ struct ad5933_dev {
 	uint8_t current_clock_source;
 	uint8_t current_gain;
 	uint8_t current_range;
+	uint16_t current_settling;
 };
 
 struct ad5933_init_param {
@@ -140,6 +146,34 @@ struct ad5933_init_param {
 	uint8_t current_range;
 };
 
+/* Sweep parameters. */
+struct ad5933_sweep_param {
+	/* Frequency of the first point, in Hz */
+	uint32_t start_freq;
+	/* Frequency step, in Hz */
+	uint32_t inc_freq;
+	/* Number of points, 1 to AD5933_MAX_INC_NUM + 1 */
+	uint16_t count;
+};
+
+/* Calibration of one sweep point, measured on a known impedance. */
+struct ad5933_cal_point {
+	/* Gain factor, 1 / (magnitude * calibration impedance) */
+	double gain_factor;
+	/* System phase, in radians */
+	double phase;
+};
+
+/* Result of one sweep point. */
+struct ad5933_sweep_point {
+	/* Raw DFT result */
+	int16_t real;
+	int16_t imag;
+	/* Calibrated impedance in ohms and phase in radians */
+	double impedance;
+	double phase;
+};
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -208,4 +242,22 @@ void ad5933_set_settling_time(struct ad5933_dev *dev,
 			      uint8_t mulitplier,
 			      uint16_t number_cycles);
 
+/*! Reads consecutive registers in one I2C block read. */
+int32_t ad5933_block_read(struct ad5933_dev *dev,
+			  uint8_t register_address,
+			  uint8_t *data,
+			  uint8_t bytes_number);
+
+/*! Runs a whole sweep and calibrates each point with its own table entry. */
+int32_t ad5933_sweep(struct ad5933_dev *dev,
+		     const struct ad5933_sweep_param *param,
+		     const struct ad5933_cal_point *cal,
+		     struct ad5933_sweep_point *points);
+
+/*! Runs a sweep on a known impedance and builds the calibration table. */
+int32_t ad5933_sweep_calibrate(struct ad5933_dev *dev,
+			       const struct ad5933_sweep_param *param,
+			       uint32_t calibration_impedance,
+			       struct ad5933_cal_point *cal);
+
 #endif /* __AD5933_H__ */
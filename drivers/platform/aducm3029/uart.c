@@ -360,10 +360,11 @@ failure:
  * @param desc:	Descriptor of the UART device
  * @param data:	Buffer where data will be read
  * @param bytes_number:	Number of bytes to be read.
+ * @param bytes_done:	Number of bytes submitted, may be NULL.
  * @return \ref SUCCESS in case of success, \ref FAILURE otherwise.
  */
 int32_t uart_read_nonblocking(struct uart_desc *desc, uint8_t *data,
-			      uint32_t bytes_number)
+			      uint32_t bytes_number, uint32_t *bytes_done)
 {
 	struct aducm_uart_desc	*extra;
 	uint32_t		to_read;
@@ -386,6 +387,8 @@ int32_t uart_read_nonblocking(struct uart_desc *desc, uint8_t *data,
 		(void *const)data,
 		(uint32_t const)to_read,
 		to_read > 4 ? true : false);
+	if (bytes_done)
+		*bytes_done = bytes_number;
 
 	return SUCCESS;
 }
@@ -397,10 +400,11 @@ int32_t uart_read_nonblocking(struct uart_desc *desc, uint8_t *data,
  * @param desc:	Descriptor of the UART device
  * @param data:	Buffer where data will be written
  * @param bytes_number:	Number of bytes to be written.
+ * @param bytes_done:	Number of bytes submitted, may be NULL.
  * @return \ref SUCCESS in case of success, \ref FAILURE otherwise.
  */
 int32_t uart_write_nonblocking(struct uart_desc *desc, const uint8_t *data,
-			       uint32_t bytes_number)
+			       uint32_t bytes_number, uint32_t *bytes_done)
 {
 	struct aducm_uart_desc	*extra;
 	uint32_t		to_write;
@@ -423,6 +427,8 @@ int32_t uart_write_nonblocking(struct uart_desc *desc, const uint8_t *data,
 		(void *const)data,
 		(uint32_t const)to_write,
 		to_write > 4 ? true : false);
+	if (bytes_done)
+		*bytes_done = bytes_number;
 
 	return SUCCESS;
 }
@@ -104,10 +104,11 @@ int32_t uart_write(struct uart_desc *desc, const uint8_t *data,
  * @param desc:	Descriptor of the UART device
  * @param data:	Buffer where data will be read
  * @param bytes_number:	Number of bytes to be read.
+ * @param bytes_done:	Number of bytes submitted, may be NULL.
  * @return \ref SUCCESS in case of success, \ref FAILURE otherwise.
  */
 int32_t uart_read_nonblocking(struct uart_desc *desc, uint8_t *data,
-			      uint32_t bytes_number)
+			      uint32_t bytes_number, uint32_t *bytes_done)
 {
 	if (desc) {
 		// Unused variable - fix compiler warning
@@ -121,6 +122,10 @@ int32_t uart_read_nonblocking(struct uart_desc *desc, uint8_t *data,
 		// Unused variable - fix compiler warning
 	}
 
+	if (bytes_done) {
+		// Unused variable - fix compiler warning
+	}
+
 	return SUCCESS;
 }
 
@@ -131,10 +136,11 @@ int32_t uart_read_nonblocking(struct uart_desc *desc, uint8_t *data,
  * @param desc:	Descriptor of the UART device
  * @param data:	Buffer where data will be written
  * @param bytes_number:	Number of bytes to be written.
+ * @param bytes_done:	Number of bytes submitted, may be NULL.
  * @return \ref SUCCESS in case of success, \ref FAILURE otherwise.
  */
 int32_t uart_write_nonblocking(struct uart_desc *desc, const uint8_t *data,
-			       uint32_t bytes_number)
+			       uint32_t bytes_number, uint32_t *bytes_done)
 {
 	if (desc) {
 		// Unused variable - fix compiler warning
@@ -148,6 +154,10 @@ int32_t uart_write_nonblocking(struct uart_desc *desc, const uint8_t *data,
 		// Unused variable - fix compiler warning
 	}
 
+	if (bytes_done) {
+		// Unused variable - fix compiler warning
+	}
+
 	return SUCCESS;
 }
 
@@ -0,0 +1,593 @@
+/***************************************************************************//**
+ *   @file   linux/linux_gpiod.c
+ *   @brief  Implementation of the Linux GPIO character device driver.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "error.h"
+#include "gpio.h"
+#include "linux_gpiod.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define LINUX_GPIOD_CONSUMER	"no-OS"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_gpiod_desc
+ * @brief Linux GPIO character device specific descriptor
+ */
+struct linux_gpiod_desc {
+	/** /dev/gpiochip"chip_id" file descriptor */
+	int chip_fd;
+	/** Line handle or line event file descriptor, -1 until requested */
+	int line_fd;
+	/** Edges reported by the line */
+	enum linux_gpiod_edge edge;
+	/** Current direction (GPIO_IN or GPIO_OUT) */
+	uint8_t direction;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Open a GPIO chip.
+ * @param chip_id - The chip number.
+ * @return The file descriptor or a negative value on error.
+ */
+static int linux_gpiod_open_chip(uint32_t chip_id)
+{
+	char path[32];
+	int fd;
+
+	snprintf(path, sizeof(path), "/dev/gpiochip%d", chip_id);
+	fd = open(path, O_RDWR | O_CLOEXEC);
+	if (fd < 0)
+		printf("%s: Can't open %s\n\r", __func__, path);
+
+	return fd;
+}
+
+/**
+ * @brief (Re)request the line of a descriptor with a new configuration.
+ * @param desc - The GPIO descriptor.
+ * @param direction - GPIO_IN or GPIO_OUT.
+ * @param value - Initial value for outputs.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_gpiod_request(struct gpio_desc *desc, uint8_t direction,
+				   uint8_t value)
+{
+	struct linux_gpiod_desc *linux_desc = desc->extra;
+	struct gpiohandle_request hreq;
+	struct gpioevent_request ereq;
+	int ret;
+
+	if (linux_desc->line_fd >= 0) {
+		close(linux_desc->line_fd);
+		linux_desc->line_fd = -1;
+	}
+
+	if (direction == GPIO_IN && linux_desc->edge != LINUX_GPIOD_EDGE_NONE) {
+		memset(&ereq, 0, sizeof(ereq));
+		ereq.lineoffset = desc->number;
+		ereq.handleflags = GPIOHANDLE_REQUEST_INPUT;
+		if (linux_desc->edge == LINUX_GPIOD_EDGE_RISING)
+			ereq.eventflags = GPIOEVENT_REQUEST_RISING_EDGE;
+		else if (linux_desc->edge == LINUX_GPIOD_EDGE_FALLING)
+			ereq.eventflags = GPIOEVENT_REQUEST_FALLING_EDGE;
+		else
+			ereq.eventflags = GPIOEVENT_REQUEST_BOTH_EDGES;
+		strncpy(ereq.consumer_label, LINUX_GPIOD_CONSUMER,
+			sizeof(ereq.consumer_label) - 1);
+
+		ret = ioctl(linux_desc->chip_fd, GPIO_GET_LINEEVENT_IOCTL, &ereq);
+		if (ret < 0) {
+			printf("%s: Can't request line events\n\r", __func__);
+			return FAILURE;
+		}
+		linux_desc->line_fd = ereq.fd;
+	} else {
+		memset(&hreq, 0, sizeof(hreq));
+		hreq.lineoffsets[0] = desc->number;
+		hreq.lines = 1;
+		hreq.flags = (direction == GPIO_OUT) ? GPIOHANDLE_REQUEST_OUTPUT :
+			     GPIOHANDLE_REQUEST_INPUT;
+		hreq.default_values[0] = !!value;
+		strncpy(hreq.consumer_label, LINUX_GPIOD_CONSUMER,
+			sizeof(hreq.consumer_label) - 1);
+
+		ret = ioctl(linux_desc->chip_fd, GPIO_GET_LINEHANDLE_IOCTL, &hreq);
+		if (ret < 0) {
+			printf("%s: Can't request line handle\n\r", __func__);
+			return FAILURE;
+		}
+		linux_desc->line_fd = hreq.fd;
+	}
+
+	linux_desc->direction = direction;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Obtain the GPIO decriptor.
+ *
+ * The line is only requested from the kernel by the first direction call,
+ * so an output is never glitched through an input configuration. Lines
+ * with edge events are requested as inputs right away.
+ * @param desc - The GPIO descriptor.
+ * @param param - GPIO initialization parameters
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiod_get(struct gpio_desc **desc,
+			const struct gpio_init_param *param)
+{
+	struct linux_gpiod_init_param *linux_init;
+	struct linux_gpiod_desc *linux_desc;
+	struct gpio_desc *descriptor;
+
+	if (!param || !param->extra)
+		return FAILURE;
+
+	linux_init = param->extra;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return FAILURE;
+
+	linux_desc = calloc(1, sizeof(*linux_desc));
+	if (!linux_desc)
+		goto free_desc;
+
+	descriptor->extra = linux_desc;
+	descriptor->number = param->number;
+	linux_desc->edge = linux_init->edge;
+	linux_desc->line_fd = -1;
+	linux_desc->direction = GPIO_IN;
+
+	linux_desc->chip_fd = linux_gpiod_open_chip(linux_init->chip_id);
+	if (linux_desc->chip_fd < 0)
+		goto free_linux_desc;
+
+	if (linux_desc->edge != LINUX_GPIOD_EDGE_NONE &&
+	    linux_gpiod_request(descriptor, GPIO_IN, 0) != SUCCESS)
+		goto close_chip;
+
+	*desc = descriptor;
+
+	return SUCCESS;
+
+close_chip:
+	close(linux_desc->chip_fd);
+free_linux_desc:
+	free(linux_desc);
+free_desc:
+	free(descriptor);
+
+	return FAILURE;
+}
+
+/**
+ * @brief Get the value of an optional GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param param - GPIO Initialization parameters.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiod_get_optional(struct gpio_desc **desc,
+				 const struct gpio_init_param *param)
+{
+	if (linux_gpiod_get(desc, param) != SUCCESS)
+		*desc = NULL;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by gpio_get().
+ * @param desc - The GPIO descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiod_remove(struct gpio_desc *desc)
+{
+	struct linux_gpiod_desc *linux_desc;
+
+	linux_desc = desc->extra;
+
+	if (linux_desc->line_fd >= 0)
+		close(linux_desc->line_fd);
+	close(linux_desc->chip_fd);
+
+	free(desc->extra);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set the value of the specified GPIO. The line must have been
+ *        configured by linux_gpiod_direction_output() first.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ *                Example: GPIO_HIGH
+ *                         GPIO_LOW
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiod_set_value(struct gpio_desc *desc,
+			      uint8_t value)
+{
+	struct linux_gpiod_desc *linux_desc;
+	struct gpiohandle_data data;
+	int ret;
+
+	linux_desc = desc->extra;
+	if (linux_desc->line_fd < 0) {
+		printf("%s: Line direction not set\n\r", __func__);
+		return FAILURE;
+	}
+
+	memset(&data, 0, sizeof(data));
+	data.values[0] = !!value;
+
+	ret = ioctl(linux_desc->line_fd, GPIOHANDLE_SET_LINE_VALUES_IOCTL, &data);
+	if (ret < 0) {
+		printf("%s: Can't set line value\n\r", __func__);
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the value of the specified GPIO. A line with no direction set
+ *        yet is requested as an input.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ *                Example: GPIO_HIGH
+ *                         GPIO_LOW
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiod_get_value(struct gpio_desc *desc,
+			      uint8_t *value)
+{
+	struct linux_gpiod_desc *linux_desc;
+	struct gpiohandle_data data;
+	int ret;
+
+	linux_desc = desc->extra;
+	if (linux_desc->line_fd < 0 &&
+	    linux_gpiod_request(desc, GPIO_IN, 0) != SUCCESS)
+		return FAILURE;
+
+	ret = ioctl(linux_desc->line_fd, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &data);
+	if (ret < 0) {
+		printf("%s: Can't get line value\n\r", __func__);
+		return FAILURE;
+	}
+
+	*value = data.values[0] ? GPIO_HIGH : GPIO_LOW;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Enable the input direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiod_direction_input(struct gpio_desc *desc)
+{
+	struct linux_gpiod_desc *linux_desc = desc->extra;
+
+	if (linux_desc->direction == GPIO_IN && linux_desc->line_fd >= 0)
+		return SUCCESS;
+
+	return linux_gpiod_request(desc, GPIO_IN, 0);
+}
+
+/**
+ * @brief Enable the output direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ *                Example: GPIO_HIGH
+ *                         GPIO_LOW
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiod_direction_output(struct gpio_desc *desc,
+				     uint8_t value)
+{
+	struct linux_gpiod_desc *linux_desc = desc->extra;
+
+	if (linux_desc->edge != LINUX_GPIOD_EDGE_NONE) {
+		printf("%s: Line requested with edge events\n\r", __func__);
+		return FAILURE;
+	}
+
+	if (linux_desc->direction == GPIO_OUT && linux_desc->line_fd >= 0)
+		return linux_gpiod_set_value(desc, value);
+
+	return linux_gpiod_request(desc, GPIO_OUT, value);
+}
+
+/**
+ * @brief Get the direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param direction - The direction.
+ *                    Example: GPIO_OUT
+ *                             GPIO_IN
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiod_get_direction(struct gpio_desc *desc,
+				  uint8_t *direction)
+{
+	struct linux_gpiod_desc *linux_desc = desc->extra;
+
+	*direction = linux_desc->direction;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Wait for an edge event on a line requested with an edge.
+ * @param desc - The GPIO descriptor.
+ * @param timeout_ms - Timeout in milliseconds, negative to wait forever.
+ * @param event - The event that occurred. May be NULL.
+ * @return SUCCESS in case of success, -ETIMEDOUT if no edge occurred in time,
+ *         FAILURE otherwise.
+ */
+int32_t linux_gpiod_wait_event(struct gpio_desc *desc, int32_t timeout_ms,
+			       struct linux_gpiod_event *event)
+{
+	struct linux_gpiod_desc *linux_desc;
+	struct gpioevent_data data;
+	struct pollfd pfd;
+	int ret;
+
+	linux_desc = desc->extra;
+	if (linux_desc->edge == LINUX_GPIOD_EDGE_NONE)
+		return FAILURE;
+
+	pfd.fd = linux_desc->line_fd;
+	pfd.events = POLLIN | POLLPRI;
+	pfd.revents = 0;
+
+	do {
+		ret = poll(&pfd, 1, timeout_ms);
+	} while (ret < 0 && errno == EINTR);
+	if (ret < 0) {
+		printf("%s: Can't poll line\n\r", __func__);
+		return FAILURE;
+	}
+	if (ret == 0)
+		return -ETIMEDOUT;
+
+	ret = read(linux_desc->line_fd, &data, sizeof(data));
+	if (ret != sizeof(data)) {
+		printf("%s: Can't read line event\n\r", __func__);
+		return FAILURE;
+	}
+
+	if (event) {
+		event->timestamp_ns = data.timestamp;
+		event->value = (data.id == GPIOEVENT_EVENT_RISING_EDGE) ?
+			       GPIO_HIGH : GPIO_LOW;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the file descriptor that becomes readable on an edge event, so
+ *        that it can be multiplexed with poll()/select() by the caller.
+ * @param desc - The GPIO descriptor.
+ * @param fd - The file descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiod_get_event_fd(struct gpio_desc *desc, int *fd)
+{
+	struct linux_gpiod_desc *linux_desc = desc->extra;
+
+	if (linux_desc->edge == LINUX_GPIOD_EDGE_NONE)
+		return FAILURE;
+
+	*fd = linux_desc->line_fd;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Request several lines of one chip with a single handle.
+ * @param bulk - The bulk handle.
+ * @param chip_id - GPIO chip (/dev/gpiochip"chip_id").
+ * @param offsets - Line offsets on the chip.
+ * @param num_lines - Number of lines (up to LINUX_GPIOD_BULK_MAX).
+ * @param direction - GPIO_IN or GPIO_OUT for all the lines.
+ * @param values - Initial output values. May be NULL.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiod_bulk_get(struct linux_gpiod_bulk **bulk, uint32_t chip_id,
+			     const uint32_t *offsets, uint32_t num_lines,
+			     uint8_t direction, const uint8_t *values)
+{
+	struct gpiohandle_request hreq;
+	struct linux_gpiod_bulk *b;
+	uint32_t i;
+	int chip_fd;
+	int ret;
+
+	if (!bulk || !offsets || !num_lines || num_lines > LINUX_GPIOD_BULK_MAX)
+		return FAILURE;
+
+	b = calloc(1, sizeof(*b));
+	if (!b)
+		return FAILURE;
+
+	chip_fd = linux_gpiod_open_chip(chip_id);
+	if (chip_fd < 0)
+		goto free_bulk;
+
+	memset(&hreq, 0, sizeof(hreq));
+	for (i = 0; i < num_lines; i++) {
+		hreq.lineoffsets[i] = offsets[i];
+		if (values)
+			hreq.default_values[i] = !!values[i];
+	}
+	hreq.lines = num_lines;
+	hreq.flags = (direction == GPIO_OUT) ? GPIOHANDLE_REQUEST_OUTPUT :
+		     GPIOHANDLE_REQUEST_INPUT;
+	strncpy(hreq.consumer_label, LINUX_GPIOD_CONSUMER,
+		sizeof(hreq.consumer_label) - 1);
+
+	ret = ioctl(chip_fd, GPIO_GET_LINEHANDLE_IOCTL, &hreq);
+	/* The line handle stays valid after the chip is closed. */
+	close(chip_fd);
+	if (ret < 0) {
+		printf("%s: Can't request line handle\n\r", __func__);
+		goto free_bulk;
+	}
+
+	b->fd = hreq.fd;
+	b->num_lines = num_lines;
+	*bulk = b;
+
+	return SUCCESS;
+
+free_bulk:
+	free(b);
+
+	return FAILURE;
+}
+
+/**
+ * @brief Set all the lines of a bulk handle with one ioctl.
+ * @param bulk - The bulk handle.
+ * @param values - One value per line.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiod_bulk_set_values(struct linux_gpiod_bulk *bulk,
+				    const uint8_t *values)
+{
+	struct gpiohandle_data data;
+	uint32_t i;
+	int ret;
+
+	memset(&data, 0, sizeof(data));
+	for (i = 0; i < bulk->num_lines; i++)
+		data.values[i] = !!values[i];
+
+	ret = ioctl(bulk->fd, GPIOHANDLE_SET_LINE_VALUES_IOCTL, &data);
+	if (ret < 0) {
+		printf("%s: Can't set line values\n\r", __func__);
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get all the lines of a bulk handle with one ioctl.
+ * @param bulk - The bulk handle.
+ * @param values - One value per line.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiod_bulk_get_values(struct linux_gpiod_bulk *bulk,
+				    uint8_t *values)
+{
+	struct gpiohandle_data data;
+	uint32_t i;
+	int ret;
+
+	ret = ioctl(bulk->fd, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &data);
+	if (ret < 0) {
+		printf("%s: Can't get line values\n\r", __func__);
+		return FAILURE;
+	}
+
+	for (i = 0; i < bulk->num_lines; i++)
+		values[i] = data.values[i] ? GPIO_HIGH : GPIO_LOW;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Release a bulk handle.
+ * @param bulk - The bulk handle.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_gpiod_bulk_remove(struct linux_gpiod_bulk *bulk)
+{
+	if (!bulk)
+		return FAILURE;
+
+	close(bulk->fd);
+	free(bulk);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Linux GPIO character device platform ops structure
+ */
+const struct gpio_platform_ops linux_gpiod_platform_ops = {
+	.gpio_ops_get = &linux_gpiod_get,
+	.gpio_ops_get_optional = &linux_gpiod_get_optional,
+	.gpio_ops_remove = &linux_gpiod_remove,
+	.gpio_ops_direction_input = &linux_gpiod_direction_input,
+	.gpio_ops_direction_output = &linux_gpiod_direction_output,
+	.gpio_ops_get_direction = &linux_gpiod_get_direction,
+	.gpio_ops_set_value = &linux_gpiod_set_value,
+	.gpio_ops_get_value = &linux_gpiod_get_value,
+};
@@ -0,0 +1,141 @@
+/*******************************************************************************
+ *   @file   linux/linux_gpiod.h
+ *   @brief  Header containing the GPIO character device platform ops and the
+ *           bulk/edge event extensions.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef LINUX_GPIOD_H_
+#define LINUX_GPIOD_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "gpio.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Maximum number of lines handled by one bulk request. */
+#define LINUX_GPIOD_BULK_MAX	64
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum linux_gpiod_edge
+ * @brief Edges reported by an input line.
+ */
+enum linux_gpiod_edge {
+	/** No edge events, plain line handle */
+	LINUX_GPIOD_EDGE_NONE,
+	/** Report rising edges */
+	LINUX_GPIOD_EDGE_RISING,
+	/** Report falling edges */
+	LINUX_GPIOD_EDGE_FALLING,
+	/** Report both edges */
+	LINUX_GPIOD_EDGE_BOTH
+};
+
+/**
+ * @struct linux_gpiod_init_param
+ * @brief Linux GPIO character device specific initialization parameters.
+ * The gpio_init_param number field holds the line offset on the chip.
+ */
+struct linux_gpiod_init_param {
+	/** GPIO chip (/dev/gpiochip"chip_id") */
+	uint32_t		chip_id;
+	/** Edges to report. Anything else than NONE makes the line input only */
+	enum linux_gpiod_edge	edge;
+};
+
+/**
+ * @struct linux_gpiod_event
+ * @brief An edge event read from a line.
+ */
+struct linux_gpiod_event {
+	/** Kernel timestamp of the edge, in nanoseconds */
+	uint64_t	timestamp_ns;
+	/** GPIO_HIGH for a rising edge, GPIO_LOW for a falling edge */
+	uint8_t		value;
+};
+
+/**
+ * @struct linux_gpiod_bulk
+ * @brief Several lines of one chip driven through a single line handle.
+ */
+struct linux_gpiod_bulk {
+	/** Line handle file descriptor */
+	int		fd;
+	/** Number of lines */
+	uint32_t	num_lines;
+};
+
+/**
+ * @brief Linux GPIO character device platform ops structure
+ */
+extern const struct gpio_platform_ops linux_gpiod_platform_ops;
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Wait for an edge event on a line requested with an edge. */
+int32_t linux_gpiod_wait_event(struct gpio_desc *desc, int32_t timeout_ms,
+			       struct linux_gpiod_event *event);
+
+/* Get the file descriptor that becomes readable on an edge event. */
+int32_t linux_gpiod_get_event_fd(struct gpio_desc *desc, int *fd);
+
+/* Request several lines of one chip with a single handle. */
+int32_t linux_gpiod_bulk_get(struct linux_gpiod_bulk **bulk, uint32_t chip_id,
+			     const uint32_t *offsets, uint32_t num_lines,
+			     uint8_t direction, const uint8_t *values);
+
+/* Set all the lines of a bulk handle with one ioctl. */
+int32_t linux_gpiod_bulk_set_values(struct linux_gpiod_bulk *bulk,
+				    const uint8_t *values);
+
+/* Get all the lines of a bulk handle with one ioctl. */
+int32_t linux_gpiod_bulk_get_values(struct linux_gpiod_bulk *bulk,
+				    uint8_t *values);
+
+/* Release a bulk handle. */
+int32_t linux_gpiod_bulk_remove(struct linux_gpiod_bulk *bulk);
+
+#endif // LINUX_GPIOD_H_
@@ -0,0 +1,551 @@
+/***************************************************************************//**
+ *   @file   linux/linux_irq.c
+ *   @brief  Interrupt controller emulation for the Linux platform.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include "error.h"
+#include "irq.h"
+#include "linux_irq.h"
+#include "linux_gpiod.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+/* After the system headers, it defines abs() */
+#include "util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Values written to stop_fd: joined by the caller, or detached */
+#define LINUX_IRQ_STOP_JOIN	1
+#define LINUX_IRQ_STOP_DETACH	2
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct linux_irq_line
+ * @brief State of one emulated interrupt line.
+ */
+struct linux_irq_line {
+	/** Registered callback */
+	struct callback_desc	callback;
+	/** Line configuration */
+	struct linux_irq_config	config;
+	/** Set when the line is enabled */
+	bool			enabled;
+	/** Set while the source thread runs */
+	bool			running;
+	/** Source thread */
+	pthread_t		thread;
+	/** Wakes the source thread up to stop it */
+	int			stop_fd;
+	/** Timer file descriptor (LINUX_IRQ_TIMER) */
+	int			timer_fd;
+	/** Back reference used by the source thread */
+	struct linux_irq_ctrl	*ctrl;
+	/** Line number */
+	uint32_t		id;
+};
+
+/**
+ * @struct linux_irq_ctrl
+ * @brief Linux specific interrupt controller descriptor.
+ */
+struct linux_irq_ctrl {
+	/** Protects the line state, not held while callbacks run */
+	pthread_mutex_t		lock;
+	/** Set by irq_global_enable() */
+	bool			global_enabled;
+	/** Interrupt lines */
+	struct linux_irq_line	lines[LINUX_IRQ_NB_LINES];
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Monotonic time in nanoseconds.
+ * @return The time elapsed since an unspecified starting point.
+ */
+uint64_t linux_irq_time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+ * @brief Call the callback of a line if the line is enabled.
+ * @param ctrl - The controller.
+ * @param line - The line.
+ * @param extra - Source specific data passed to the callback.
+ */
+static void linux_irq_dispatch(struct linux_irq_ctrl *ctrl,
+			       struct linux_irq_line *line, void *extra)
+{
+	struct callback_desc callback = { 0 };
+
+	pthread_mutex_lock(&ctrl->lock);
+	if (ctrl->global_enabled && line->enabled)
+		callback = line->callback;
+	pthread_mutex_unlock(&ctrl->lock);
+
+	/* Unlocked, so the callback may mask or unregister lines */
+	if (callback.callback)
+		callback.callback(callback.ctx, line->id, extra);
+}
+
+/**
+ * @brief Source thread of a timer or GPIO line.
+ * @param arg - The line.
+ * @return NULL.
+ */
+static void *linux_irq_thread(void *arg)
+{
+	struct linux_irq_line		*line = arg;
+	struct linux_gpiod_event	event;
+	struct pollfd			pfd[2];
+	uint64_t			expirations;
+	uint64_t			stop = 0;
+	/* Copies, the line may be restarted once this thread is detached */
+	int				stop_fd = line->stop_fd;
+	int				timer_fd = line->timer_fd;
+	int				ret;
+
+	pfd[0].fd = stop_fd;
+	pfd[0].events = POLLIN;
+	if (line->config.source == LINUX_IRQ_TIMER) {
+		pfd[1].fd = timer_fd;
+	} else {
+		ret = linux_gpiod_get_event_fd(line->config.gpio, &pfd[1].fd);
+		if (IS_ERR_VALUE(ret))
+			goto wait_stop;
+	}
+	pfd[1].events = POLLIN | POLLPRI;
+
+	while (true) {
+		pfd[0].revents = 0;
+		pfd[1].revents = 0;
+		ret = poll(pfd, 2, -1);
+		if (ret < 0 && errno == EINTR)
+			continue;
+		if (ret < 0 || pfd[0].revents)
+			break;
+
+		if (timer_fd >= 0) {
+			/* Missed periods are coalesced, like a pending flag */
+			if (read(timer_fd, &expirations,
+				 sizeof(expirations)) != sizeof(expirations))
+				continue;
+			linux_irq_dispatch(line->ctrl, line, NULL);
+		} else {
+			ret = linux_gpiod_wait_event(line->config.gpio, 0,
+						     &event);
+			if (ret == SUCCESS)
+				linux_irq_dispatch(line->ctrl, line, &event);
+		}
+	}
+
+wait_stop:
+	/* A detached thread owns its descriptors */
+	while (read(stop_fd, &stop, sizeof(stop)) < 0 && errno == EINTR)
+		;
+	if (stop == LINUX_IRQ_STOP_DETACH) {
+		close(stop_fd);
+		if (timer_fd >= 0)
+			close(timer_fd);
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Start the source thread of a line.
+ * @param line - The line.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t linux_irq_start(struct linux_irq_line *line)
+{
+	struct itimerspec its;
+
+	if (line->running || line->config.source == LINUX_IRQ_SOFTWARE)
+		return SUCCESS;
+
+	if (line->config.source == LINUX_IRQ_TIMER && !line->config.period_us)
+		return -EINVAL;
+	if (line->config.source == LINUX_IRQ_GPIO && !line->config.gpio)
+		return -EINVAL;
+
+	line->stop_fd = eventfd(0, EFD_CLOEXEC);
+	if (line->stop_fd < 0)
+		return FAILURE;
+
+	line->timer_fd = -1;
+	if (line->config.source == LINUX_IRQ_TIMER) {
+		line->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+		if (line->timer_fd < 0)
+			goto error_stop;
+
+		its.it_interval.tv_sec = line->config.period_us / 1000000;
+		its.it_interval.tv_nsec =
+			(line->config.period_us % 1000000) * 1000;
+		its.it_value = its.it_interval;
+		if (timerfd_settime(line->timer_fd, 0, &its, NULL) < 0)
+			goto error_timer;
+	}
+
+	if (pthread_create(&line->thread, NULL, linux_irq_thread, line))
+		goto error_timer;
+
+	line->running = true;
+
+	return SUCCESS;
+
+error_timer:
+	if (line->timer_fd >= 0)
+		close(line->timer_fd);
+error_stop:
+	close(line->stop_fd);
+	printf("%s: Can't start irq %d source\n\r", __func__, line->id);
+
+	return FAILURE;
+}
+
+/**
+ * @brief Stop the source thread of a line. When called from the callback of
+ * the same line the thread can't be joined, it is detached and exits once
+ * the callback returns.
+ * @param line - The line.
+ */
+static void linux_irq_stop(struct linux_irq_line *line)
+{
+	uint64_t stop = LINUX_IRQ_STOP_JOIN;
+
+	if (!line->running)
+		return;
+
+	line->running = false;
+	if (pthread_equal(line->thread, pthread_self())) {
+		stop = LINUX_IRQ_STOP_DETACH;
+		pthread_detach(line->thread);
+		if (write(line->stop_fd, &stop, sizeof(stop)) != sizeof(stop))
+			printf("%s: Can't stop irq %d source\n\r", __func__,
+			       line->id);
+		return;
+	}
+
+	if (write(line->stop_fd, &stop, sizeof(stop)) == sizeof(stop))
+		pthread_join(line->thread, NULL);
+	close(line->stop_fd);
+	if (line->timer_fd >= 0)
+		close(line->timer_fd);
+}
+
+/**
+ * @brief Initialize the interrupt controller emulation.
+ * @param desc - The controller descriptor.
+ * @param param - The structure that contains the controller parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t irq_ctrl_init(struct irq_ctrl_desc **desc,
+		      const struct irq_init_param *param)
+{
+	struct irq_ctrl_desc	*descriptor;
+	struct linux_irq_ctrl	*ctrl;
+	uint32_t		i;
+
+	if (!desc || !param)
+		return -EINVAL;
+
+	descriptor = (struct irq_ctrl_desc *)calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	ctrl = (struct linux_irq_ctrl *)calloc(1, sizeof(*ctrl));
+	if (!ctrl) {
+		free(descriptor);
+		return -ENOMEM;
+	}
+
+	pthread_mutex_init(&ctrl->lock, NULL);
+	for (i = 0; i < LINUX_IRQ_NB_LINES; i++) {
+		ctrl->lines[i].ctrl = ctrl;
+		ctrl->lines[i].id = i;
+	}
+
+	descriptor->irq_ctrl_id = param->irq_ctrl_id;
+	descriptor->extra = ctrl;
+	*desc = descriptor;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by irq_ctrl_init().
+ * @param desc - The controller descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t irq_ctrl_remove(struct irq_ctrl_desc *desc)
+{
+	struct linux_irq_ctrl	*ctrl;
+	uint32_t		i;
+
+	if (!desc)
+		return -EINVAL;
+
+	ctrl = desc->extra;
+	for (i = 0; i < LINUX_IRQ_NB_LINES; i++)
+		linux_irq_stop(&ctrl->lines[i]);
+
+	pthread_mutex_destroy(&ctrl->lock);
+	free(ctrl);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Register a callback on a line. The line stays disabled.
+ * @param desc - The controller descriptor.
+ * @param irq_id - Line number.
+ * @param callback_desc - Callback, its config is a struct linux_irq_config.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t irq_register_callback(struct irq_ctrl_desc *desc, uint32_t irq_id,
+			      struct callback_desc *callback_desc)
+{
+	struct linux_irq_ctrl	*ctrl;
+	struct linux_irq_line	*line;
+
+	if (!desc || irq_id >= LINUX_IRQ_NB_LINES)
+		return -EINVAL;
+
+	if (!callback_desc)
+		return irq_unregister(desc, irq_id);
+
+	ctrl = desc->extra;
+	line = &ctrl->lines[irq_id];
+	if (line->running)
+		return -EBUSY;
+
+	pthread_mutex_lock(&ctrl->lock);
+	line->callback = *callback_desc;
+	if (callback_desc->config)
+		line->config = *(struct linux_irq_config *)callback_desc->config;
+	else
+		line->config.source = LINUX_IRQ_SOFTWARE;
+	pthread_mutex_unlock(&ctrl->lock);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Disable a line and remove its callback.
+ * @param desc - The controller descriptor.
+ * @param irq_id - Line number.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t irq_unregister(struct irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct linux_irq_ctrl *ctrl;
+
+	if (!desc || irq_id >= LINUX_IRQ_NB_LINES)
+		return -EINVAL;
+
+	irq_disable(desc, irq_id);
+
+	ctrl = desc->extra;
+	pthread_mutex_lock(&ctrl->lock);
+	memset(&ctrl->lines[irq_id].callback, 0,
+	       sizeof(ctrl->lines[irq_id].callback));
+	pthread_mutex_unlock(&ctrl->lock);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Let the enabled lines call their callbacks.
+ * @param desc - The controller descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t irq_global_enable(struct irq_ctrl_desc *desc)
+{
+	struct linux_irq_ctrl *ctrl;
+
+	if (!desc)
+		return -EINVAL;
+
+	ctrl = desc->extra;
+	pthread_mutex_lock(&ctrl->lock);
+	ctrl->global_enabled = true;
+	pthread_mutex_unlock(&ctrl->lock);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Mask all the lines. Pending timer periods are dropped.
+ * @param desc - The controller descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t irq_global_disable(struct irq_ctrl_desc *desc)
+{
+	struct linux_irq_ctrl *ctrl;
+
+	if (!desc)
+		return -EINVAL;
+
+	ctrl = desc->extra;
+	pthread_mutex_lock(&ctrl->lock);
+	ctrl->global_enabled = false;
+	pthread_mutex_unlock(&ctrl->lock);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Not supported, GPIO edges are selected when requesting the line.
+ * @param desc - The controller descriptor.
+ * @param irq_id - Line number.
+ * @param trig - Trigger level.
+ * @return -ENOSYS.
+ */
+int32_t irq_trigger_level_set(struct irq_ctrl_desc *desc, uint32_t irq_id,
+			      enum irq_trig_level trig)
+{
+	UNUSED_PARAM(desc);
+	UNUSED_PARAM(irq_id);
+	UNUSED_PARAM(trig);
+
+	return -ENOSYS;
+}
+
+/**
+ * @brief Enable a line and start its source.
+ * @param desc - The controller descriptor.
+ * @param irq_id - Line number.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t irq_enable(struct irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct linux_irq_ctrl	*ctrl;
+	struct linux_irq_line	*line;
+	int32_t			ret;
+
+	if (!desc || irq_id >= LINUX_IRQ_NB_LINES)
+		return -EINVAL;
+
+	ctrl = desc->extra;
+	line = &ctrl->lines[irq_id];
+
+	pthread_mutex_lock(&ctrl->lock);
+	line->enabled = true;
+	pthread_mutex_unlock(&ctrl->lock);
+
+	ret = linux_irq_start(line);
+	if (IS_ERR_VALUE(ret)) {
+		pthread_mutex_lock(&ctrl->lock);
+		line->enabled = false;
+		pthread_mutex_unlock(&ctrl->lock);
+	}
+
+	return ret;
+}
+
+/**
+ * @brief Disable a line and stop its source.
+ * @param desc - The controller descriptor.
+ * @param irq_id - Line number.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t irq_disable(struct irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct linux_irq_ctrl	*ctrl;
+	struct linux_irq_line	*line;
+
+	if (!desc || irq_id >= LINUX_IRQ_NB_LINES)
+		return -EINVAL;
+
+	ctrl = desc->extra;
+	line = &ctrl->lines[irq_id];
+
+	pthread_mutex_lock(&ctrl->lock);
+	line->enabled = false;
+	pthread_mutex_unlock(&ctrl->lock);
+
+	linux_irq_stop(line);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Raise a line from software. The callback runs in the caller thread.
+ * @param desc - The controller descriptor.
+ * @param irq_id - Line number.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t linux_irq_fire(struct irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct linux_irq_ctrl *ctrl;
+
+	if (!desc || irq_id >= LINUX_IRQ_NB_LINES)
+		return -EINVAL;
+
+	ctrl = desc->extra;
+	linux_irq_dispatch(ctrl, &ctrl->lines[irq_id], NULL);
+
+	return SUCCESS;
+}
@@ -0,0 +1,100 @@
+/*******************************************************************************
+ *   @file   linux/linux_irq.h
+ *   @brief  Header file of the Linux interrupt controller emulation.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef LINUX_IRQ_H_
+#define LINUX_IRQ_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "irq.h"
+#include "gpio.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Number of interrupt lines of the emulated controller. */
+#define LINUX_IRQ_NB_LINES	16
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum linux_irq_source
+ * @brief What raises an emulated interrupt line.
+ */
+enum linux_irq_source {
+	/** Only linux_irq_fire() raises the line */
+	LINUX_IRQ_SOFTWARE,
+	/** A periodic timer raises the line */
+	LINUX_IRQ_TIMER,
+	/** Edge events of a GPIO character device line raise the line */
+	LINUX_IRQ_GPIO
+};
+
+/**
+ * @struct linux_irq_config
+ * @brief Per line configuration, passed as callback_desc.config.
+ * A NULL config is the same as LINUX_IRQ_SOFTWARE.
+ */
+struct linux_irq_config {
+	/** Interrupt source */
+	enum linux_irq_source	source;
+	/** Timer period in microseconds (LINUX_IRQ_TIMER) */
+	uint32_t		period_us;
+	/**
+	 * Line requested from linux_gpiod_platform_ops with an edge
+	 * (LINUX_IRQ_GPIO). The callback extra is a struct linux_gpiod_event.
+	 */
+	struct gpio_desc	*gpio;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Raise an interrupt line from software. */
+int32_t linux_irq_fire(struct irq_ctrl_desc *desc, uint32_t irq_id);
+
+/* Monotonic time in nanoseconds, usable as a timestamp source. */
+uint64_t linux_irq_time_ns(void);
+
+#endif // LINUX_IRQ_H_
@@ -48,10 +48,19 @@
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
 #include <linux/spi/spidev.h>
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Maximum number of transfers the spidev ioctl size field can describe. */
+#define LINUX_SPI_MAX_XFERS	(((1 << _IOC_SIZEBITS) - 1) / \
+				 sizeof(struct spi_ioc_transfer))
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -63,6 +72,10 @@
 struct linux_spi_desc {
 	/** /dev/spidev"device_id"."chip_select" file descriptor */
 	int spidev_fd;
+	/** Transfer array reused by linux_spi_transfer() */
+	struct spi_ioc_transfer *xfers;
+	/** Number of entries allocated in xfers */
+	uint32_t xfers_size;
 };
 
 /******************************************************************************/
@@ -94,6 +107,8 @@ int32_t linux_spi_init(struct spi_desc **desc,
 		goto free_desc;
 
 	descriptor->extra = linux_desc;
+	linux_desc->xfers = NULL;
+	linux_desc->xfers_size = 0;
 	linux_init = param->extra;
 
 	snprintf(path, sizeof(path), "/dev/spidev%d.%d",
@@ -159,7 +174,64 @@ int32_t linux_spi_write_and_read(struct spi_desc *desc,
 	linux_desc = desc->extra;
 
 	ret = ioctl(linux_desc->spidev_fd, SPI_IOC_MESSAGE(1), &tr);
-	if (ret == 1) {
+	if (ret < 0) {
+		printf("%s: Can't send spi message\n\r", __func__);
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Transfer a list of message segments with a single spidev ioctl.
+ * @param desc - The SPI descriptor.
+ * @param msgs - The segments to transfer.
+ * @param len - Number of segments.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t linux_spi_transfer(struct spi_desc *desc,
+			   struct spi_msg *msgs,
+			   uint32_t len)
+{
+	struct linux_spi_desc *linux_desc;
+	struct spi_ioc_transfer *tr;
+	uint32_t i;
+	int ret;
+
+	linux_desc = desc->extra;
+
+	if (!len)
+		return SUCCESS;
+
+	if (len > LINUX_SPI_MAX_XFERS)
+		return FAILURE;
+
+	if (len > linux_desc->xfers_size) {
+		tr = realloc(linux_desc->xfers, len * sizeof(*tr));
+		if (!tr)
+			return FAILURE;
+
+		linux_desc->xfers = tr;
+		linux_desc->xfers_size = len;
+	}
+
+	tr = linux_desc->xfers;
+	memset(tr, 0, len * sizeof(*tr));
+	for (i = 0; i < len; i++) {
+		tr[i].tx_buf = (unsigned long)msgs[i].tx_buff;
+		tr[i].rx_buf = (unsigned long)msgs[i].rx_buff;
+		tr[i].len = msgs[i].bytes_number;
+		tr[i].delay_usecs = msgs[i].delay_us;
+		/*
+		 * spidev deasserts CS at the end of a message by default, where
+		 * cs_change means "keep it asserted". Only forward it between
+		 * segments.
+		 */
+		tr[i].cs_change = (i != len - 1) ? msgs[i].cs_change : 0;
+	}
+
+	ret = ioctl(linux_desc->spidev_fd, SPI_IOC_MESSAGE(len), tr);
+	if (ret < 0) {
 		printf("%s: Can't send spi message\n\r", __func__);
 		return FAILURE;
 	}
@@ -185,6 +257,7 @@ int32_t linux_spi_remove(struct spi_desc *desc)
 		return FAILURE;
 	}
 
+	free(linux_desc->xfers);
 	free(desc->extra);
 	free(desc);
 
@@ -197,5 +270,6 @@ int32_t linux_spi_remove(struct spi_desc *desc)
 const struct spi_platform_ops linux_spi_platform_ops = {
 	.spi_ops_init = &linux_spi_init,
 	.spi_ops_write_and_read = &linux_spi_write_and_read,
+	.spi_ops_transfer = &linux_spi_transfer,
 	.spi_ops_remove = &linux_spi_remove
 };
@@ -44,12 +44,17 @@
 #include "uart.h"
 #include "linux_uart.h"
 
+#include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <termios.h>
+#include <time.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <linux/serial.h>
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -81,6 +86,7 @@ int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
 	struct linux_uart_init_param *linux_init;
 	struct linux_uart_desc *linux_desc;
 	struct uart_desc *descriptor;
+	struct serial_struct serial;
 	speed_t speed;
 	char path[64];
 	int ret;
@@ -167,6 +173,36 @@ int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
 	case 38400:
 		speed = B38400;
 		break;
+	case 57600:
+		speed = B57600;
+		break;
+	case 115200:
+		speed = B115200;
+		break;
+	case 230400:
+		speed = B230400;
+		break;
+	case 460800:
+		speed = B460800;
+		break;
+	case 921600:
+		speed = B921600;
+		break;
+	case 1000000:
+		speed = B1000000;
+		break;
+	case 1500000:
+		speed = B1500000;
+		break;
+	case 2000000:
+		speed = B2000000;
+		break;
+	case 3000000:
+		speed = B3000000;
+		break;
+	case 4000000:
+		speed = B4000000;
+		break;
 	default:
 		ret = -EINVAL;
 		goto free;
@@ -218,6 +254,15 @@ int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
 
 	tcsetattr(linux_desc->fd, TCSANOW, linux_desc->terminal);
 
+	/*
+	 * Ask the serial driver to push received data to the tty layer right
+	 * away. Not every driver supports it, so failures are ignored.
+	 */
+	if (!ioctl(linux_desc->fd, TIOCGSERIAL, &serial)) {
+		serial.flags |= ASYNC_LOW_LATENCY;
+		ioctl(linux_desc->fd, TIOCSSERIAL, &serial);
+	}
+
 	tcflush(linux_desc->fd, TCIOFLUSH);
 
 	*desc = descriptor;
@@ -259,51 +304,225 @@ int32_t uart_remove(struct uart_desc *desc)
 };
 
 /**
- * @brief Write data to UART device.
+ * @brief Get the current time in milliseconds.
+ * @return Monotonic time in milliseconds.
+ */
+static int64_t linux_uart_time_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Wait until the UART file descriptor is ready.
+ * @param fd - The file descriptor.
+ * @param events - POLLIN or POLLOUT.
+ * @param timeout_ms - Timeout in milliseconds, negative to wait forever.
+ * @return 1 if ready, 0 on timeout, negative error code otherwise.
+ */
+static int32_t linux_uart_wait(int fd, short events, int32_t timeout_ms)
+{
+	struct pollfd pfd;
+	int ret;
+
+	pfd.fd = fd;
+	pfd.events = events;
+	pfd.revents = 0;
+
+	do {
+		ret = poll(&pfd, 1, timeout_ms);
+	} while (ret < 0 && errno == EINTR);
+	if (ret < 0)
+		return -errno;
+	if (ret && (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)))
+		return -EIO;
+
+	return ret;
+}
+
+/**
+ * @brief Transfer data until done or until the deadline expires.
  * @param desc - Instance of UART.
  * @param data - Pointer to buffer containing data.
- * @param bytes_number - Number of bytes to read.
- * @return SUCCESS in case of success, FAILURE otherwise.
+ * @param bytes_number - Number of bytes to transfer.
+ * @param timeout_ms - Timeout in milliseconds, negative to wait forever.
+ * @param is_write - true for a write, false for a read.
+ * @return Number of bytes transferred, negative error code otherwise.
  */
-int32_t uart_write(struct uart_desc *desc, const uint8_t *data,
-		   uint32_t bytes_number)
+static int32_t linux_uart_xfer(struct uart_desc *desc, uint8_t *data,
+			       uint32_t bytes_number, int32_t timeout_ms,
+			       bool is_write)
 {
 	struct linux_uart_desc *linux_desc;
-	ssize_t count = 0;
-	int32_t ret;
+	int64_t deadline = 0;
+	int32_t remaining;
+	uint32_t count = 0;
+	ssize_t ret;
 
 	linux_desc = desc->extra;
 
+	if (timeout_ms >= 0)
+		deadline = linux_uart_time_ms() + timeout_ms;
+
 	while (count < bytes_number) {
-		ret = write(linux_desc->fd, data, bytes_number);
-		if (ret > 0)
+		if (is_write)
+			ret = write(linux_desc->fd, &data[count],
+				    bytes_number - count);
+		else
+			ret = read(linux_desc->fd, &data[count],
+				   bytes_number - count);
+		if (ret > 0) {
 			count += ret;
+			continue;
+		}
+		if (ret < 0 && errno != EAGAIN && errno != EINTR)
+			return -errno;
+
+		remaining = -1;
+		if (timeout_ms >= 0) {
+			remaining = deadline - linux_uart_time_ms();
+			if (remaining <= 0)
+				break;
+		}
+
+		ret = linux_uart_wait(linux_desc->fd, is_write ? POLLOUT : POLLIN,
+				      remaining);
+		if (ret < 0)
+			return ret;
+		if (ret == 0)
+			break;
 	}
 
+	return count;
+}
+
+/**
+ * @brief Write data to UART device. Blocks in poll() until the device can
+ *        take more data.
+ * @param desc - Instance of UART.
+ * @param data - Pointer to buffer containing data.
+ * @param bytes_number - Number of bytes to write.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t uart_write(struct uart_desc *desc, const uint8_t *data,
+		   uint32_t bytes_number)
+{
+	int32_t ret;
+
+	ret = linux_uart_xfer(desc, (uint8_t *)data, bytes_number, -1, true);
+	if (ret < 0)
+		return ret;
+
 	return SUCCESS;
 };
 
 /**
- * @brief Read data from UART device.
+ * @brief Read data from UART device. Blocks in poll() until enough data has
+ *        been received.
  * @param desc - Instance of UART.
  * @param data - Pointer to buffer containing data.
  * @param bytes_number - Number of bytes to read.
- * @return SUCCESS in case of success, FAILURE otherwise.
+ * @return SUCCESS in case of success, negative error code otherwise.
  */
 int32_t uart_read(struct uart_desc *desc, uint8_t *data,
 		  uint32_t bytes_number)
 {
-	struct linux_uart_desc *linux_desc;
-	ssize_t count = 0;
-	ssize_t ret;
-
-	linux_desc = desc->extra;
+	int32_t ret;
 
-	while (count < bytes_number) {
-		ret = read(linux_desc->fd, &data[count], bytes_number - count);
-		if (ret > 0)
-			count += ret;
-	}
+	ret = linux_uart_xfer(desc, data, bytes_number, -1, false);
+	if (ret < 0)
+		return ret;
 
 	return SUCCESS;
 };
+
+/**
+ * @brief Write as much data as the device can take right now.
+ * @param desc - Instance of UART.
+ * @param data - Pointer to buffer containing data.
+ * @param bytes_number - Number of bytes to write.
+ * @param bytes_done - Number of bytes written, may be NULL.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t uart_write_nonblocking(struct uart_desc *desc, const uint8_t *data,
+			       uint32_t bytes_number, uint32_t *bytes_done)
+{
+	int32_t ret;
+
+	ret = linux_uart_xfer(desc, (uint8_t *)data, bytes_number, 0, true);
+	if (ret < 0)
+		return ret;
+
+	if (bytes_done)
+		*bytes_done = ret;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read the data that is already available.
+ * @param desc - Instance of UART.
+ * @param data - Pointer to buffer containing data.
+ * @param bytes_number - Maximum number of bytes to read.
+ * @param bytes_done - Number of bytes read, may be NULL.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t uart_read_nonblocking(struct uart_desc *desc, uint8_t *data,
+			      uint32_t bytes_number, uint32_t *bytes_done)
+{
+	int32_t ret;
+
+	ret = linux_uart_xfer(desc, data, bytes_number, 0, false);
+	if (ret < 0)
+		return ret;
+
+	if (bytes_done)
+		*bytes_done = ret;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Write data to UART device, giving up after a timeout.
+ * @param desc - Instance of UART.
+ * @param data - Pointer to buffer containing data.
+ * @param bytes_number - Number of bytes to write.
+ * @param timeout_ms - Timeout for the whole transfer, in milliseconds.
+ * @return Number of bytes written, negative error code otherwise.
+ */
+int32_t linux_uart_write_timeout(struct uart_desc *desc, const uint8_t *data,
+				 uint32_t bytes_number, uint32_t timeout_ms)
+{
+	return linux_uart_xfer(desc, (uint8_t *)data, bytes_number,
+			       timeout_ms, true);
+}
+
+/**
+ * @brief Read data from UART device, giving up after a timeout.
+ * @param desc - Instance of UART.
+ * @param data - Pointer to buffer containing data.
+ * @param bytes_number - Number of bytes to read.
+ * @param timeout_ms - Timeout for the whole transfer, in milliseconds.
+ * @return Number of bytes read, negative error code otherwise.
+ */
+int32_t linux_uart_read_timeout(struct uart_desc *desc, uint8_t *data,
+				uint32_t bytes_number, uint32_t timeout_ms)
+{
+	return linux_uart_xfer(desc, data, bytes_number, timeout_ms, false);
+}
+
+/**
+ * @brief Get the file descriptor of the UART, so that it can be multiplexed
+ *        with poll()/select() by the caller.
+ * @param desc - Instance of UART.
+ * @return The file descriptor.
+ */
+int linux_uart_get_fd(struct uart_desc *desc)
+{
+	struct linux_uart_desc *linux_desc = desc->extra;
+
+	return linux_desc->fd;
+}
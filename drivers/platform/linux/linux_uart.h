@@ -39,6 +39,9 @@
 #ifndef LINUX_UART_H_
 #define LINUX_UART_H_
 
+#include <stdint.h>
+#include "uart.h"
+
 /**
  * @struct linux_uart_init_param
  * @brief Structure holding the initialization parameters for Linux platform
@@ -49,4 +52,15 @@ struct linux_uart_init_param {
 	const char *device_id;
 };
 
+/* Write data to UART, giving up after timeout_ms. */
+int32_t linux_uart_write_timeout(struct uart_desc *desc, const uint8_t *data,
+				 uint32_t bytes_number, uint32_t timeout_ms);
+
+/* Read data from UART, giving up after timeout_ms. */
+int32_t linux_uart_read_timeout(struct uart_desc *desc, uint8_t *data,
+				uint32_t bytes_number, uint32_t timeout_ms);
+
+/* Get the file descriptor of the UART. */
+int linux_uart_get_fd(struct uart_desc *desc);
+
 #endif // LINUX_UART_H_
@@ -0,0 +1,218 @@
+/***************************************************************************//**
+ *   @file   sim/sim.c
+ *   @brief  Simulated clock, MMIO map and bus accounting of the simulation platform.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "sim_model.h"
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+/** Simulated time, in nanoseconds */
+static uint64_t sim_now_ns;
+
+/** Models mapped in the MMIO space */
+static struct sim_model *sim_mmio_map;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get the simulated time.
+ * @return Time elapsed since start-up, in nanoseconds.
+ */
+uint64_t sim_time_ns(void)
+{
+	return sim_now_ns;
+}
+
+/**
+ * @brief Advance the simulated time. Delays, bus transfers and device
+ *        internal operations (conversions, calibrations) all move this clock,
+ *        so device models can resolve their state lazily on the next access.
+ * @param ns - Amount of time, in nanoseconds.
+ * @return None.
+ */
+void sim_advance_ns(uint64_t ns)
+{
+	sim_now_ns += ns;
+}
+
+/**
+ * @brief Account a bus transaction to a model.
+ * @param model - The model.
+ * @param bytes - Number of bytes moved on the bus.
+ * @param bus_ns - Modeled duration of the transaction, in nanoseconds.
+ * @return None.
+ */
+void sim_account(struct sim_model *model, uint32_t bytes, uint64_t bus_ns)
+{
+	if (model) {
+		model->stats.transactions++;
+		model->stats.bytes += bytes;
+		model->stats.bus_time_ns += bus_ns;
+	}
+
+	sim_advance_ns(bus_ns);
+}
+
+/**
+ * @brief Map a model in the MMIO space. Accesses done through axi_io_read()
+ *        and axi_io_write() in [base, base + size) are routed to the model.
+ * @param model - The model.
+ * @param base - Base address.
+ * @param size - Size of the window, in bytes.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_mmio_register(struct sim_model *model, uint32_t base,
+			  uint32_t size)
+{
+	struct sim_model *m;
+
+	if (!model || !size || (!model->mmio_read && !model->mmio_write))
+		return -EINVAL;
+
+	for (m = sim_mmio_map; m; m = m->next) {
+		if (m == model)
+			return -EEXIST;
+		if (base < m->base + m->size && m->base < base + size)
+			return -EBUSY;
+	}
+
+	model->base = base;
+	model->size = size;
+	model->next = sim_mmio_map;
+	sim_mmio_map = model;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Remove a model from the MMIO space.
+ * @param model - The model.
+ * @return SUCCESS in case of success, -ENOENT if the model is not mapped.
+ */
+int32_t sim_mmio_unregister(struct sim_model *model)
+{
+	struct sim_model **m;
+
+	for (m = &sim_mmio_map; *m; m = &(*m)->next) {
+		if (*m == model) {
+			*m = model->next;
+			model->next = NULL;
+			return SUCCESS;
+		}
+	}
+
+	return -ENOENT;
+}
+
+/**
+ * @brief Find the model that owns an MMIO address. The model found is moved
+ *        to the front of the map, since register accesses come in bursts.
+ * @param addr - The address.
+ * @return The model, NULL if the address is not mapped.
+ */
+struct sim_model *sim_mmio_find(uint32_t addr)
+{
+	struct sim_model **m;
+	struct sim_model *found;
+
+	for (m = &sim_mmio_map; *m; m = &(*m)->next) {
+		found = *m;
+		if (addr >= found->base && addr - found->base < found->size) {
+			*m = found->next;
+			found->next = sim_mmio_map;
+			sim_mmio_map = found;
+			return found;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Clear the statistics of a model.
+ * @param model - The model.
+ * @return None.
+ */
+void sim_stats_reset(struct sim_model *model)
+{
+	memset(&model->stats, 0, sizeof(model->stats));
+}
+
+/**
+ * @brief Print the statistics of a model.
+ * @param model - The model.
+ * @return None.
+ */
+void sim_stats_print(struct sim_model *model)
+{
+	printf("%s: %"PRIu64" transactions, %"PRIu64" bytes, %"PRIu64" ns bus time\n",
+	       model->name, model->stats.transactions, model->stats.bytes,
+	       model->stats.bus_time_ns);
+}
+
+/**
+ * @brief Free a model created by one of the sim_*_model_init() functions.
+ * @param model - The model.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_model_remove(struct sim_model *model)
+{
+	if (!model)
+		return -EINVAL;
+
+	sim_mmio_unregister(model);
+
+	if (model->remove)
+		model->remove(model);
+
+	free(model);
+
+	return SUCCESS;
+}
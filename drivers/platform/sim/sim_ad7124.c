@@ -0,0 +1,425 @@
+/***************************************************************************//**
+ *   @file   sim/sim_ad7124.c
+ *   @brief  Register-level model of the AD7124 SPI interface and conversion timing.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "sim_model.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SIM_AD7124_NUM_REGS		0x39
+#define SIM_AD7124_COMM_RD		(1 << 6)
+#define SIM_AD7124_COMM_RA(x)		((x) & 0x3F)
+
+#define SIM_AD7124_STATUS		0x00
+#define SIM_AD7124_ADC_CTRL		0x01
+#define SIM_AD7124_DATA			0x02
+#define SIM_AD7124_ID			0x05
+#define SIM_AD7124_ERROR_EN		0x07
+#define SIM_AD7124_CHANNEL_0		0x09
+#define SIM_AD7124_CONFIG_0		0x19
+#define SIM_AD7124_FILTER_0		0x21
+#define SIM_AD7124_OFFSET_0		0x29
+#define SIM_AD7124_GAIN_0		0x31
+
+#define SIM_AD7124_STATUS_RDY		(1 << 7)
+#define SIM_AD7124_CTRL_CONT_READ	(1 << 11)
+#define SIM_AD7124_CTRL_DATA_STATUS	(1 << 10)
+#define SIM_AD7124_CTRL_MODE(x)		(((x) >> 2) & 0xF)
+#define SIM_AD7124_MODE_CONTINUOUS	0
+#define SIM_AD7124_MODE_SINGLE		1
+#define SIM_AD7124_ERREN_CRC		(1 << 2)
+#define SIM_AD7124_CH_ENABLE		(1 << 15)
+#define SIM_AD7124_NUM_CHANNELS		16
+
+/** Read data command, exits continuous read mode */
+#define SIM_AD7124_CMD_READ_DATA	(SIM_AD7124_COMM_RD | SIM_AD7124_DATA)
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct sim_ad7124
+ * @brief AD7124 model state.
+ */
+struct sim_ad7124 {
+	/** Register values */
+	uint32_t regs[SIM_AD7124_NUM_REGS];
+	/** Power-on value of the ID register */
+	uint8_t device_id;
+	/** Duration of one conversion */
+	uint32_t conv_time_ns;
+	/** Simulated time of the last completed conversion */
+	uint64_t last_conv_ns;
+	/** Number of conversions completed since power-on */
+	uint32_t conv_count;
+	/** Channel of the last completed conversion */
+	uint8_t channel;
+	/** A conversion result is waiting to be read */
+	uint8_t ready;
+	/** Single conversion mode: stop after the next conversion */
+	uint8_t single;
+};
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+/** Register sizes, in bytes */
+static const uint8_t sim_ad7124_reg_size[SIM_AD7124_NUM_REGS] = {
+	1, 2, 3, 3, 2, 1, 3, 3, 1,
+	2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+	2, 2, 2, 2, 2, 2, 2, 2,
+	3, 3, 3, 3, 3, 3, 3, 3,
+	3, 3, 3, 3, 3, 3, 3, 3,
+	3, 3, 3, 3, 3, 3, 3, 3,
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief CRC-8 (x^8 + x^2 + x + 1) as used on the AD7124 SPI interface.
+ * @param buf - Data buffer.
+ * @param len - Number of bytes.
+ * @return The CRC.
+ */
+static uint8_t sim_ad7124_crc8(const uint8_t *buf, uint32_t len)
+{
+	uint8_t crc = 0;
+	uint8_t i;
+
+	while (len--) {
+		crc ^= *buf++;
+		for (i = 0; i < 8; i++)
+			crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+	}
+
+	return crc;
+}
+
+/**
+ * @brief Load the power-on register values.
+ * @param dev - The model state.
+ * @return None.
+ */
+static void sim_ad7124_reset(struct sim_ad7124 *dev)
+{
+	uint32_t i;
+
+	memset(dev->regs, 0, sizeof(dev->regs));
+	dev->regs[SIM_AD7124_STATUS] = SIM_AD7124_STATUS_RDY;
+	dev->regs[SIM_AD7124_ID] = dev->device_id;
+	dev->regs[SIM_AD7124_ERROR_EN] = 0x40;
+	dev->regs[SIM_AD7124_CHANNEL_0] = 0x8001;
+	for (i = 1; i < SIM_AD7124_NUM_CHANNELS; i++)
+		dev->regs[SIM_AD7124_CHANNEL_0 + i] = 0x0001;
+	for (i = 0; i < 8; i++) {
+		dev->regs[SIM_AD7124_CONFIG_0 + i] = 0x0860;
+		dev->regs[SIM_AD7124_FILTER_0 + i] = 0x060180;
+		dev->regs[SIM_AD7124_OFFSET_0 + i] = 0x800000;
+		dev->regs[SIM_AD7124_GAIN_0 + i] = 0x500000;
+	}
+	dev->last_conv_ns = sim_time_ns();
+	dev->channel = 0;
+	dev->ready = 0;
+	dev->single = 0;
+}
+
+/**
+ * @brief Next enabled channel after the given one.
+ * @param dev - The model state.
+ * @param ch - Current channel.
+ * @return The next enabled channel, ch if none is enabled.
+ */
+static uint8_t sim_ad7124_next_channel(struct sim_ad7124 *dev, uint8_t ch)
+{
+	uint8_t i, next;
+
+	for (i = 1; i <= SIM_AD7124_NUM_CHANNELS; i++) {
+		next = (ch + i) % SIM_AD7124_NUM_CHANNELS;
+		if (dev->regs[SIM_AD7124_CHANNEL_0 + next] & SIM_AD7124_CH_ENABLE)
+			return next;
+	}
+
+	return ch;
+}
+
+/**
+ * @brief Bring the conversion state up to the current simulated time. The
+ *        sequencer cycles over the enabled channels, producing a ramp per
+ *        channel so that lost or duplicated samples are visible.
+ * @param dev - The model state.
+ * @return None.
+ */
+static void sim_ad7124_update(struct sim_ad7124 *dev)
+{
+	uint32_t mode = SIM_AD7124_CTRL_MODE(dev->regs[SIM_AD7124_ADC_CTRL]);
+	uint64_t now = sim_time_ns();
+	uint64_t n;
+
+	if (mode != SIM_AD7124_MODE_CONTINUOUS && !dev->single) {
+		dev->last_conv_ns = now;
+		return;
+	}
+
+	n = (now - dev->last_conv_ns) / dev->conv_time_ns;
+	if (!n)
+		return;
+
+	if (dev->single)
+		n = 1;
+	dev->last_conv_ns += n * dev->conv_time_ns;
+	if (dev->single) {
+		dev->last_conv_ns = now;
+		dev->single = 0;
+	}
+
+	while (n--) {
+		dev->channel = sim_ad7124_next_channel(dev, dev->channel);
+		dev->conv_count++;
+	}
+
+	dev->regs[SIM_AD7124_DATA] = (0x800000 + (dev->channel << 16) +
+				      dev->conv_count) & 0xFFFFFF;
+	dev->ready = 1;
+}
+
+/**
+ * @brief Current value of the status register.
+ * @param dev - The model state.
+ * @return The status register.
+ */
+static uint8_t sim_ad7124_status(struct sim_ad7124 *dev)
+{
+	return (dev->ready ? 0 : SIM_AD7124_STATUS_RDY) | dev->channel;
+}
+
+/**
+ * @brief Shift out the data register, optionally followed by the status.
+ * @param dev - The model state.
+ * @param out - Output buffer.
+ * @return Number of bytes written to out.
+ */
+static uint32_t sim_ad7124_read_data(struct sim_ad7124 *dev, uint8_t *out)
+{
+	uint32_t data = dev->regs[SIM_AD7124_DATA];
+	uint32_t n = 0;
+
+	out[n++] = data >> 16;
+	out[n++] = data >> 8;
+	out[n++] = data;
+	if (dev->regs[SIM_AD7124_ADC_CTRL] & SIM_AD7124_CTRL_DATA_STATUS)
+		out[n++] = sim_ad7124_status(dev);
+	dev->ready = 0;
+
+	return n;
+}
+
+/**
+ * @brief Write a register and apply its side effects.
+ * @param dev - The model state.
+ * @param reg - The register address.
+ * @param val - The register value.
+ * @return None.
+ */
+static void sim_ad7124_reg_write(struct sim_ad7124 *dev, uint8_t reg,
+				 uint32_t val)
+{
+	switch (reg) {
+	case SIM_AD7124_STATUS:
+	case SIM_AD7124_DATA:
+	case SIM_AD7124_ID:
+		return;
+	case SIM_AD7124_ADC_CTRL:
+		dev->regs[reg] = val;
+		dev->last_conv_ns = sim_time_ns();
+		dev->ready = 0;
+		dev->single = (SIM_AD7124_CTRL_MODE(val) ==
+			       SIM_AD7124_MODE_SINGLE);
+		return;
+	default:
+		dev->regs[reg] = val;
+		return;
+	}
+}
+
+/**
+ * @brief SPI frame: communications byte, then register data MSB first,
+ *        followed by a CRC byte when SPI CRC checking is enabled. In
+ *        continuous read mode the data register is shifted out directly.
+ * @param model - The model.
+ * @param data - Full duplex buffer.
+ * @param len - Number of bytes.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_ad7124_spi_xfer(struct sim_model *model, uint8_t *data,
+				   uint32_t len)
+{
+	struct sim_ad7124 *dev = model->priv;
+	uint8_t out[8] = {0};
+	uint8_t comm, reg, size, i;
+	uint32_t n, val;
+	uint8_t crc_en;
+
+	if (!len)
+		return SUCCESS;
+
+	/* 64 consecutive ones reset the serial interface and the registers. */
+	for (n = 0; n < len && data[n] == 0xFF; n++)
+		;
+	if (n >= 8) {
+		sim_ad7124_reset(dev);
+		memset(data, 0, len);
+		return SUCCESS;
+	}
+
+	sim_ad7124_update(dev);
+	crc_en = !!(dev->regs[SIM_AD7124_ERROR_EN] & SIM_AD7124_ERREN_CRC);
+
+	if (dev->regs[SIM_AD7124_ADC_CTRL] & SIM_AD7124_CTRL_CONT_READ) {
+		if (data[0] == SIM_AD7124_CMD_READ_DATA && dev->ready)
+			dev->regs[SIM_AD7124_ADC_CTRL] &=
+				~SIM_AD7124_CTRL_CONT_READ;
+		n = sim_ad7124_read_data(dev, out);
+		if (crc_en) {
+			out[n] = sim_ad7124_crc8(out, n);
+			n++;
+		}
+		memset(data, 0, len);
+		memcpy(data, out, len < n ? len : n);
+		return SUCCESS;
+	}
+
+	comm = data[0];
+	reg = SIM_AD7124_COMM_RA(comm);
+	if (reg >= SIM_AD7124_NUM_REGS) {
+		memset(data, 0, len);
+		return SUCCESS;
+	}
+	size = sim_ad7124_reg_size[reg];
+
+	if (comm & SIM_AD7124_COMM_RD) {
+		out[0] = comm;
+		if (reg == SIM_AD7124_DATA) {
+			n = 1 + sim_ad7124_read_data(dev, &out[1]);
+		} else {
+			val = (reg == SIM_AD7124_STATUS) ?
+			      sim_ad7124_status(dev) : dev->regs[reg];
+			for (i = 0; i < size; i++)
+				out[1 + i] = val >> (8 * (size - 1 - i));
+			n = 1 + size;
+		}
+		if (crc_en) {
+			out[n] = sim_ad7124_crc8(out, n);
+			n++;
+		}
+		out[0] = 0;
+		memset(data, 0, len);
+		memcpy(data, out, len < n ? len : n);
+	} else {
+		if (len < 1u + size)
+			return -EINVAL;
+		val = 0;
+		for (i = 0; i < size; i++)
+			val = (val << 8) | data[1 + i];
+		sim_ad7124_reg_write(dev, reg, val);
+		memset(data, 0, len);
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the model state.
+ * @param model - The model.
+ * @return None.
+ */
+static void sim_ad7124_remove(struct sim_model *model)
+{
+	free(model->priv);
+}
+
+/**
+ * @brief Create an AD7124 model.
+ * @param model - The created model.
+ * @param device_id - Power-on value of the ID register.
+ * @param conv_time_ns - Duration of one conversion.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_ad7124_model_init(struct sim_model **model, uint8_t device_id,
+			      uint32_t conv_time_ns)
+{
+	struct sim_model *m;
+	struct sim_ad7124 *dev;
+
+	if (!conv_time_ns)
+		return -EINVAL;
+
+	m = calloc(1, sizeof(*m));
+	if (!m)
+		return -ENOMEM;
+
+	dev = calloc(1, sizeof(*dev));
+	if (!dev) {
+		free(m);
+		return -ENOMEM;
+	}
+
+	dev->device_id = device_id;
+	dev->conv_time_ns = conv_time_ns;
+	sim_ad7124_reset(dev);
+
+	m->name = "ad7124";
+	m->spi_xfer = sim_ad7124_spi_xfer;
+	m->remove = sim_ad7124_remove;
+	m->priv = dev;
+
+	*model = m;
+
+	return SUCCESS;
+}
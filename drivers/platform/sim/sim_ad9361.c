@@ -0,0 +1,272 @@
+/***************************************************************************//**
+ *   @file   sim/sim_ad9361.c
+ *   @brief  Register-level model of the AD9361 SPI interface.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "sim_model.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SIM_AD9361_NUM_REGS		0x400
+#define SIM_AD9361_WRITE		(1 << 15)
+#define SIM_AD9361_CNT(cmd)		((((cmd) >> 12) & 0x7) + 1)
+#define SIM_AD9361_ADDR(cmd)		((cmd) & 0x3FF)
+
+#define SIM_AD9361_REG_SPI_CONF		0x000
+#define SIM_AD9361_SOFT_RESET		0x81
+#define SIM_AD9361_REG_ENSM_CONFIG_1	0x014
+#define SIM_AD9361_FORCE_RX_ON		(1 << 6)
+#define SIM_AD9361_FORCE_TX_ON		(1 << 5)
+#define SIM_AD9361_FORCE_ALERT_STATE	(1 << 2)
+#define SIM_AD9361_TO_ALERT		(1 << 0)
+#define SIM_AD9361_REG_CALIBRATION_CTRL	0x016
+#define SIM_AD9361_REG_STATE		0x017
+#define SIM_AD9361_REG_PRODUCT_ID	0x037
+#define SIM_AD9361_REG_CH_1_OVERFLOW	0x05E
+#define SIM_AD9361_REG_RX_BBF_R2346	0x1E6
+#define SIM_AD9361_REG_RX_BBF_C3_MSB	0x1EB
+#define SIM_AD9361_REG_RX_BBF_C3_LSB	0x1EC
+#define SIM_AD9361_REG_RX_CAL_STATUS	0x244
+#define SIM_AD9361_REG_RX_VCO_LOCK	0x247
+#define SIM_AD9361_REG_TX_CAL_STATUS	0x284
+#define SIM_AD9361_REG_TX_VCO_LOCK	0x287
+
+#define SIM_AD9361_PRODUCT_ID		0x0A
+#define SIM_AD9361_ENSM_SLEEP		0x0
+#define SIM_AD9361_ENSM_ALERT		0x5
+#define SIM_AD9361_ENSM_TX		0x6
+#define SIM_AD9361_ENSM_RX		0x8
+#define SIM_AD9361_ENSM_FDD		0xA
+
+/** Time after which the calibration control bits self-clear */
+#define SIM_AD9361_CAL_NS		100000
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct sim_ad9361
+ * @brief AD9361 model state.
+ */
+struct sim_ad9361 {
+	/** Register file */
+	uint8_t regs[SIM_AD9361_NUM_REGS];
+	/** Simulated time at which the running calibration completes */
+	uint64_t cal_done_ns;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Load the power-on values of the registers polled by the driver.
+ * @param dev - The model state.
+ * @return None.
+ */
+static void sim_ad9361_reset(struct sim_ad9361 *dev)
+{
+	memset(dev->regs, 0, sizeof(dev->regs));
+	dev->regs[SIM_AD9361_REG_PRODUCT_ID] = SIM_AD9361_PRODUCT_ID;
+	dev->regs[SIM_AD9361_REG_STATE] = SIM_AD9361_ENSM_SLEEP;
+	/* RX baseband filter tune results, the ADC setup divides by them */
+	dev->regs[SIM_AD9361_REG_RX_BBF_R2346] = 0x30;
+	dev->regs[SIM_AD9361_REG_RX_BBF_C3_MSB] = 0x1A;
+	dev->regs[SIM_AD9361_REG_RX_BBF_C3_LSB] = 0x10;
+	dev->cal_done_ns = 0;
+}
+
+/**
+ * @brief Read a register, resolving the status bits from the model state.
+ * @param dev - The model state.
+ * @param reg - The register address.
+ * @return The register value.
+ */
+static uint8_t sim_ad9361_reg_read(struct sim_ad9361 *dev, uint32_t reg)
+{
+	switch (reg) {
+	case SIM_AD9361_REG_CALIBRATION_CTRL:
+		if (sim_time_ns() >= dev->cal_done_ns)
+			dev->regs[reg] = 0;
+		break;
+	case SIM_AD9361_REG_CH_1_OVERFLOW:
+		return dev->regs[reg] | (1 << 7);	/* BBPLL locked */
+	case SIM_AD9361_REG_RX_CAL_STATUS:
+	case SIM_AD9361_REG_TX_CAL_STATUS:
+		return dev->regs[reg] | (1 << 7);	/* CP cal valid */
+	case SIM_AD9361_REG_RX_VCO_LOCK:
+	case SIM_AD9361_REG_TX_VCO_LOCK:
+		return dev->regs[reg] | (1 << 1);	/* VCO locked */
+	default:
+		break;
+	}
+
+	return dev->regs[reg];
+}
+
+/**
+ * @brief Write a register and apply its side effects.
+ * @param dev - The model state.
+ * @param reg - The register address.
+ * @param val - The register value.
+ * @return None.
+ */
+static void sim_ad9361_reg_write(struct sim_ad9361 *dev, uint32_t reg,
+				 uint8_t val)
+{
+	switch (reg) {
+	case SIM_AD9361_REG_SPI_CONF:
+		if ((val & SIM_AD9361_SOFT_RESET) == SIM_AD9361_SOFT_RESET) {
+			sim_ad9361_reset(dev);
+			return;
+		}
+		break;
+	case SIM_AD9361_REG_PRODUCT_ID:
+	case SIM_AD9361_REG_STATE:
+		return;
+	case SIM_AD9361_REG_CALIBRATION_CTRL:
+		if (val)
+			dev->cal_done_ns = sim_time_ns() + SIM_AD9361_CAL_NS;
+		break;
+	case SIM_AD9361_REG_ENSM_CONFIG_1:
+		if (val & (SIM_AD9361_FORCE_ALERT_STATE | SIM_AD9361_TO_ALERT))
+			dev->regs[SIM_AD9361_REG_STATE] = SIM_AD9361_ENSM_ALERT;
+		else if ((val & SIM_AD9361_FORCE_RX_ON) &&
+			 (val & SIM_AD9361_FORCE_TX_ON))
+			dev->regs[SIM_AD9361_REG_STATE] = SIM_AD9361_ENSM_FDD;
+		else if (val & SIM_AD9361_FORCE_RX_ON)
+			dev->regs[SIM_AD9361_REG_STATE] = SIM_AD9361_ENSM_RX;
+		else if (val & SIM_AD9361_FORCE_TX_ON)
+			dev->regs[SIM_AD9361_REG_STATE] = SIM_AD9361_ENSM_TX;
+		break;
+	default:
+		break;
+	}
+
+	dev->regs[reg] = val;
+}
+
+/**
+ * @brief SPI frame: 16-bit instruction followed by up to 8 data bytes, the
+ *        register address decrementing after each byte.
+ * @param model - The model.
+ * @param data - Full duplex buffer.
+ * @param len - Number of bytes.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_ad9361_spi_xfer(struct sim_model *model, uint8_t *data,
+				   uint32_t len)
+{
+	struct sim_ad9361 *dev = model->priv;
+	uint32_t cmd, reg, cnt, i;
+
+	if (len < 3)
+		return -EINVAL;
+
+	cmd = (data[0] << 8) | data[1];
+	reg = SIM_AD9361_ADDR(cmd);
+	cnt = SIM_AD9361_CNT(cmd);
+	if (cnt > len - 2)
+		cnt = len - 2;
+
+	data[0] = 0;
+	data[1] = 0;
+	for (i = 0; i < cnt; i++) {
+		if (cmd & SIM_AD9361_WRITE) {
+			sim_ad9361_reg_write(dev, reg, data[2 + i]);
+			data[2 + i] = 0;
+		} else {
+			data[2 + i] = sim_ad9361_reg_read(dev, reg);
+		}
+		reg = (reg - 1) & (SIM_AD9361_NUM_REGS - 1);
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the model state.
+ * @param model - The model.
+ * @return None.
+ */
+static void sim_ad9361_remove(struct sim_model *model)
+{
+	free(model->priv);
+}
+
+/**
+ * @brief Create an AD9361 model. Calibrations complete after a fixed amount
+ *        of simulated time, PLLs always report lock and the ENSM follows
+ *        the forced state requests.
+ * @param model - The created model.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_ad9361_model_init(struct sim_model **model)
+{
+	struct sim_model *m;
+	struct sim_ad9361 *dev;
+
+	m = calloc(1, sizeof(*m));
+	if (!m)
+		return -ENOMEM;
+
+	dev = calloc(1, sizeof(*dev));
+	if (!dev) {
+		free(m);
+		return -ENOMEM;
+	}
+
+	sim_ad9361_reset(dev);
+
+	m->name = "ad9361";
+	m->spi_xfer = sim_ad9361_spi_xfer;
+	m->remove = sim_ad9361_remove;
+	m->priv = dev;
+
+	*model = m;
+
+	return SUCCESS;
+}
@@ -0,0 +1,379 @@
+/***************************************************************************//**
+ *   @file   sim/sim_adxl362.c
+ *   @brief  ADXL362 model for the simulation platform.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "sim_model.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SIM_ADXL362_NUM_REGS		0x2F
+#define SIM_ADXL362_CMD_WRITE_REG	0x0A
+#define SIM_ADXL362_CMD_READ_REG	0x0B
+#define SIM_ADXL362_CMD_READ_FIFO	0x0D
+
+#define SIM_ADXL362_DEVID_AD		0x00
+#define SIM_ADXL362_DEVID_MST		0x01
+#define SIM_ADXL362_PARTID		0x02
+#define SIM_ADXL362_REVID		0x03
+#define SIM_ADXL362_STATUS		0x0B
+#define SIM_ADXL362_FIFO_L		0x0C
+#define SIM_ADXL362_FIFO_H		0x0D
+#define SIM_ADXL362_XDATA_L		0x0E
+#define SIM_ADXL362_TEMP_H		0x15
+#define SIM_ADXL362_SOFT_RESET		0x1F
+#define SIM_ADXL362_FIFO_CTL		0x28
+#define SIM_ADXL362_FIFO_SAMPLES	0x29
+#define SIM_ADXL362_FILTER_CTL		0x2C
+#define SIM_ADXL362_POWER_CTL		0x2D
+
+#define SIM_ADXL362_STATUS_FIFO_RDY	(1 << 1)
+#define SIM_ADXL362_STATUS_FIFO_WM	(1 << 2)
+#define SIM_ADXL362_STATUS_FIFO_OVR	(1 << 3)
+#define SIM_ADXL362_FIFO_CTL_MODE(x)	((x) & 0x3)
+#define SIM_ADXL362_FIFO_CTL_TEMP	(1 << 2)
+#define SIM_ADXL362_FIFO_CTL_AH		(1 << 3)
+#define SIM_ADXL362_FILTER_CTL_ODR(x)	((x) & 0x7)
+#define SIM_ADXL362_POWER_CTL_MEASURE(x) ((x) & 0x3)
+#define SIM_ADXL362_MEASURE_ON		2
+#define SIM_ADXL362_FIFO_DISABLE	0
+#define SIM_ADXL362_RESET_KEY		0x52
+#define SIM_ADXL362_FIFO_DEPTH		512
+#define SIM_ADXL362_TAG_TEMP		3
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct sim_adxl362
+ * @brief ADXL362 model state.
+ */
+struct sim_adxl362 {
+	/** Register values */
+	uint8_t regs[SIM_ADXL362_NUM_REGS];
+	/** FIFO entries: axis tag in bits 15:14, sign extended 12-bit data */
+	uint16_t fifo[SIM_ADXL362_FIFO_DEPTH];
+	/** Index of the oldest FIFO entry */
+	uint16_t fifo_head;
+	/** Number of FIFO entries */
+	uint16_t fifo_count;
+	/** The FIFO dropped entries since STATUS was last read */
+	bool fifo_ovr;
+	/** Simulated time of the last sample */
+	uint64_t last_sample_ns;
+	/** Number of samples taken since power-on */
+	uint32_t sample_count;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Load the power-on register values and empty the FIFO.
+ * @param dev - The model state.
+ * @return None.
+ */
+static void sim_adxl362_reset(struct sim_adxl362 *dev)
+{
+	memset(dev->regs, 0, sizeof(dev->regs));
+	dev->regs[SIM_ADXL362_DEVID_AD] = 0xAD;
+	dev->regs[SIM_ADXL362_DEVID_MST] = 0x1D;
+	dev->regs[SIM_ADXL362_PARTID] = 0xF2;
+	dev->regs[SIM_ADXL362_REVID] = 0x01;
+	dev->regs[SIM_ADXL362_FIFO_SAMPLES] = 0x80;
+	dev->regs[SIM_ADXL362_FILTER_CTL] = 0x13;
+	dev->fifo_head = 0;
+	dev->fifo_count = 0;
+	dev->fifo_ovr = false;
+	dev->last_sample_ns = sim_time_ns();
+}
+
+/**
+ * @brief Take one sample: update the data registers and, unless disabled,
+ *        push x, y, z (and the temperature) to the FIFO. Each axis is a ramp
+ *        offset by its index so lost, duplicated or misaligned samples are
+ *        visible. In stream mode a full FIFO drops its oldest sample set.
+ * @param dev - The model state.
+ * @return None.
+ */
+static void sim_adxl362_sample(struct sim_adxl362 *dev)
+{
+	uint8_t fifo_ctl = dev->regs[SIM_ADXL362_FIFO_CTL];
+	uint8_t set_size;
+	uint16_t val;
+	uint8_t i;
+
+	set_size = (fifo_ctl & SIM_ADXL362_FIFO_CTL_TEMP) ? 4 : 3;
+	if (SIM_ADXL362_FIFO_CTL_MODE(fifo_ctl) != SIM_ADXL362_FIFO_DISABLE &&
+	    dev->fifo_count + set_size > SIM_ADXL362_FIFO_DEPTH) {
+		dev->fifo_head = (dev->fifo_head + set_size) %
+				 SIM_ADXL362_FIFO_DEPTH;
+		dev->fifo_count -= set_size;
+		dev->fifo_ovr = true;
+	}
+
+	for (i = 0; i < 4; i++) {
+		/* Sign extended 12-bit data */
+		val = (dev->sample_count + (i << 8)) & 0xFFF;
+		if (val & 0x800)
+			val |= 0xF000;
+		dev->regs[SIM_ADXL362_XDATA_L + 2 * i] = val;
+		dev->regs[SIM_ADXL362_XDATA_L + 2 * i + 1] = val >> 8;
+		if (SIM_ADXL362_FIFO_CTL_MODE(fifo_ctl) ==
+		    SIM_ADXL362_FIFO_DISABLE || i >= set_size)
+			continue;
+
+		dev->fifo[(dev->fifo_head + dev->fifo_count) %
+			  SIM_ADXL362_FIFO_DEPTH] = (val & 0x3FFF) | (i << 14);
+		dev->fifo_count++;
+	}
+	dev->sample_count++;
+}
+
+/**
+ * @brief Bring the sampling up to the current simulated time.
+ * @param dev - The model state.
+ * @return None.
+ */
+static void sim_adxl362_update(struct sim_adxl362 *dev)
+{
+	uint8_t odr;
+	uint64_t now = sim_time_ns();
+	uint64_t period_ns;
+	uint64_t n;
+
+	if (SIM_ADXL362_POWER_CTL_MEASURE(dev->regs[SIM_ADXL362_POWER_CTL]) !=
+	    SIM_ADXL362_MEASURE_ON) {
+		dev->last_sample_ns = now;
+		return;
+	}
+
+	/* 12.5 Hz doubling up to 400 Hz */
+	odr = SIM_ADXL362_FILTER_CTL_ODR(dev->regs[SIM_ADXL362_FILTER_CTL]);
+	period_ns = 80000000 >> (odr > 5 ? 5 : odr);
+	n = (now - dev->last_sample_ns) / period_ns;
+	dev->last_sample_ns += n * period_ns;
+
+	/* Older samples would only go through the FIFO */
+	if (n > SIM_ADXL362_FIFO_DEPTH) {
+		dev->sample_count += n - SIM_ADXL362_FIFO_DEPTH;
+		n = SIM_ADXL362_FIFO_DEPTH;
+	}
+	while (n--)
+		sim_adxl362_sample(dev);
+}
+
+/**
+ * @brief Value read from a register, with the read side effects.
+ * @param dev - The model state.
+ * @param reg - The register address.
+ * @return The register value.
+ */
+static uint8_t sim_adxl362_reg_read(struct sim_adxl362 *dev, uint8_t reg)
+{
+	uint16_t watermark;
+	uint8_t val;
+
+	switch (reg) {
+	case SIM_ADXL362_STATUS:
+		watermark = dev->regs[SIM_ADXL362_FIFO_SAMPLES];
+		if (dev->regs[SIM_ADXL362_FIFO_CTL] & SIM_ADXL362_FIFO_CTL_AH)
+			watermark |= 0x100;
+		val = dev->fifo_count ? SIM_ADXL362_STATUS_FIFO_RDY : 0;
+		if (dev->fifo_count >= watermark)
+			val |= SIM_ADXL362_STATUS_FIFO_WM;
+		if (dev->fifo_ovr)
+			val |= SIM_ADXL362_STATUS_FIFO_OVR;
+		dev->fifo_ovr = false;
+		return val;
+	case SIM_ADXL362_FIFO_L:
+		return dev->fifo_count & 0xFF;
+	case SIM_ADXL362_FIFO_H:
+		return (dev->fifo_count >> 8) & 0x3;
+	default:
+		return reg < SIM_ADXL362_NUM_REGS ? dev->regs[reg] : 0;
+	}
+}
+
+/**
+ * @brief Write a register and apply its side effects.
+ * @param dev - The model state.
+ * @param reg - The register address.
+ * @param val - The register value.
+ * @return None.
+ */
+static void sim_adxl362_reg_write(struct sim_adxl362 *dev, uint8_t reg,
+				  uint8_t val)
+{
+	/* Identification, status and data registers are read only */
+	if (reg >= SIM_ADXL362_NUM_REGS || reg <= SIM_ADXL362_TEMP_H)
+		return;
+
+	switch (reg) {
+	case SIM_ADXL362_SOFT_RESET:
+		if (val == SIM_ADXL362_RESET_KEY)
+			sim_adxl362_reset(dev);
+		return;
+	case SIM_ADXL362_FIFO_CTL:
+		dev->regs[reg] = val;
+		dev->fifo_head = 0;
+		dev->fifo_count = 0;
+		return;
+	case SIM_ADXL362_POWER_CTL:
+		dev->regs[reg] = val;
+		dev->last_sample_ns = sim_time_ns();
+		return;
+	default:
+		dev->regs[reg] = val;
+		return;
+	}
+}
+
+/**
+ * @brief SPI frame: write or read register command followed by the start
+ *        address and auto-incremented data, or read FIFO command followed by
+ *        the FIFO entries, LSB first.
+ * @param model - The model.
+ * @param data - Full duplex buffer.
+ * @param len - Number of bytes.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_adxl362_spi_xfer(struct sim_model *model, uint8_t *data,
+				    uint32_t len)
+{
+	struct sim_adxl362 *dev = model->priv;
+	uint16_t entry = 0;
+	uint8_t cmd, reg;
+	uint32_t i;
+
+	if (!len)
+		return SUCCESS;
+
+	sim_adxl362_update(dev);
+
+	cmd = data[0];
+	data[0] = 0;
+	if (cmd == SIM_ADXL362_CMD_READ_FIFO) {
+		for (i = 1; i < len; i++) {
+			if (i & 1) {
+				entry = 0;
+				if (dev->fifo_count) {
+					entry = dev->fifo[dev->fifo_head];
+					dev->fifo_head = (dev->fifo_head + 1) %
+							 SIM_ADXL362_FIFO_DEPTH;
+					dev->fifo_count--;
+				}
+				data[i] = entry;
+			} else {
+				data[i] = entry >> 8;
+			}
+		}
+		return SUCCESS;
+	}
+
+	if (len < 2 || (cmd != SIM_ADXL362_CMD_WRITE_REG &&
+			cmd != SIM_ADXL362_CMD_READ_REG)) {
+		memset(data, 0, len);
+		return SUCCESS;
+	}
+
+	reg = data[1];
+	data[1] = 0;
+	for (i = 2; i < len; i++) {
+		if (cmd == SIM_ADXL362_CMD_WRITE_REG) {
+			sim_adxl362_reg_write(dev, reg++, data[i]);
+			data[i] = 0;
+		} else {
+			data[i] = sim_adxl362_reg_read(dev, reg++);
+		}
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the model state.
+ * @param model - The model.
+ * @return None.
+ */
+static void sim_adxl362_remove(struct sim_model *model)
+{
+	free(model->priv);
+}
+
+/**
+ * @brief Create an ADXL362 model, sampling at the rate set in FILTER_CTL.
+ * @param model - The created model.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_adxl362_model_init(struct sim_model **model)
+{
+	struct sim_model *m;
+	struct sim_adxl362 *dev;
+
+	m = calloc(1, sizeof(*m));
+	if (!m)
+		return -ENOMEM;
+
+	dev = calloc(1, sizeof(*dev));
+	if (!dev) {
+		free(m);
+		return -ENOMEM;
+	}
+
+	sim_adxl362_reset(dev);
+
+	m->name = "adxl362";
+	m->spi_xfer = sim_adxl362_spi_xfer;
+	m->remove = sim_adxl362_remove;
+	m->priv = dev;
+
+	*model = m;
+
+	return SUCCESS;
+}
@@ -0,0 +1,383 @@
+/***************************************************************************//**
+ *   @file   sim/sim_adxl372.c
+ *   @brief  ADXL372 model for the simulation platform.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "sim_model.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SIM_ADXL372_NUM_REGS		0x43
+#define SIM_ADXL372_CMD_RD		(1 << 0)
+#define SIM_ADXL372_CMD_RA(x)		(((x) >> 1) & 0x7F)
+
+#define SIM_ADXL372_DEVID		0x00
+#define SIM_ADXL372_DEVID_MST		0x01
+#define SIM_ADXL372_PARTID		0x02
+#define SIM_ADXL372_REVID		0x03
+#define SIM_ADXL372_STATUS_1		0x04
+#define SIM_ADXL372_FIFO_ENTRIES_2	0x06
+#define SIM_ADXL372_FIFO_ENTRIES_1	0x07
+#define SIM_ADXL372_X_DATA_H		0x08
+#define SIM_ADXL372_Z_DATA_L		0x0D
+#define SIM_ADXL372_FIFO_SAMPLES	0x39
+#define SIM_ADXL372_FIFO_CTL		0x3A
+#define SIM_ADXL372_TIMING		0x3D
+#define SIM_ADXL372_POWER_CTL		0x3F
+#define SIM_ADXL372_RESET		0x41
+#define SIM_ADXL372_FIFO_DATA		0x42
+
+#define SIM_ADXL372_STATUS_FIFO_RDY	(1 << 1)
+#define SIM_ADXL372_STATUS_FIFO_FULL	(1 << 2)
+#define SIM_ADXL372_STATUS_FIFO_OVR	(1 << 3)
+#define SIM_ADXL372_FIFO_CTL_FORMAT(x)	(((x) >> 3) & 0x7)
+#define SIM_ADXL372_FIFO_CTL_MODE(x)	(((x) >> 1) & 0x3)
+#define SIM_ADXL372_FIFO_CTL_SAMPLES_8	(1 << 0)
+#define SIM_ADXL372_TIMING_ODR(x)	(((x) >> 5) & 0x7)
+#define SIM_ADXL372_POWER_CTL_MODE(x)	((x) & 0x3)
+#define SIM_ADXL372_MODE_FULL_BW	3
+#define SIM_ADXL372_FIFO_BYPASSED	0
+#define SIM_ADXL372_RESET_CODE		0x52
+#define SIM_ADXL372_FIFO_DEPTH		512
+#define SIM_ADXL372_NUM_AXES		3
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct sim_adxl372
+ * @brief ADXL372 model state.
+ */
+struct sim_adxl372 {
+	/** Register values */
+	uint8_t regs[SIM_ADXL372_NUM_REGS];
+	/** FIFO entries, as shifted out on FIFO_DATA */
+	uint16_t fifo[SIM_ADXL372_FIFO_DEPTH];
+	/** Index of the oldest FIFO entry */
+	uint16_t fifo_head;
+	/** Number of FIFO entries */
+	uint16_t fifo_count;
+	/** The FIFO dropped entries since STATUS_1 was last read */
+	bool fifo_ovr;
+	/** Simulated time of the last sample */
+	uint64_t last_sample_ns;
+	/** Number of samples taken since power-on */
+	uint32_t sample_count;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Load the power-on register values and empty the FIFO.
+ * @param dev - The model state.
+ * @return None.
+ */
+static void sim_adxl372_reset(struct sim_adxl372 *dev)
+{
+	memset(dev->regs, 0, sizeof(dev->regs));
+	dev->regs[SIM_ADXL372_DEVID] = 0xAD;
+	dev->regs[SIM_ADXL372_DEVID_MST] = 0x1D;
+	dev->regs[SIM_ADXL372_PARTID] = 0xFA;
+	dev->regs[SIM_ADXL372_REVID] = 0x03;
+	dev->regs[SIM_ADXL372_FIFO_SAMPLES] = 0x80;
+	dev->fifo_head = 0;
+	dev->fifo_count = 0;
+	dev->fifo_ovr = false;
+	dev->last_sample_ns = sim_time_ns();
+}
+
+/**
+ * @brief Axes stored in the FIFO by a FIFO format.
+ * @param format - FIFO_CTL format field.
+ * @return Mask of the axes, bit 0 for x.
+ */
+static uint8_t sim_adxl372_fifo_axes(uint8_t format)
+{
+	/* Formats 1 to 6 hold one bit per axis, 0 stands for x, y and z */
+	if (!format || format > 6)
+		return 0x7;
+
+	return format;
+}
+
+/**
+ * @brief Take one sample: update the data registers and, unless bypassed,
+ *        push the enabled axes to the FIFO. Each axis is a ramp offset by
+ *        its index so lost, duplicated or misaligned samples are visible. In
+ *        stream mode a full FIFO drops its oldest sample set.
+ * @param dev - The model state.
+ * @return None.
+ */
+static void sim_adxl372_sample(struct sim_adxl372 *dev)
+{
+	uint8_t fifo_ctl = dev->regs[SIM_ADXL372_FIFO_CTL];
+	uint8_t axes;
+	uint8_t set_size = 0;
+	bool first = true;
+	uint16_t val;
+	uint8_t i;
+
+	axes = sim_adxl372_fifo_axes(SIM_ADXL372_FIFO_CTL_FORMAT(fifo_ctl));
+	for (i = 0; i < SIM_ADXL372_NUM_AXES; i++)
+		if (axes & (1 << i))
+			set_size++;
+
+	if (SIM_ADXL372_FIFO_CTL_MODE(fifo_ctl) != SIM_ADXL372_FIFO_BYPASSED &&
+	    dev->fifo_count + set_size > SIM_ADXL372_FIFO_DEPTH) {
+		dev->fifo_head = (dev->fifo_head + set_size) %
+				 SIM_ADXL372_FIFO_DEPTH;
+		dev->fifo_count -= set_size;
+		dev->fifo_ovr = true;
+	}
+
+	for (i = 0; i < SIM_ADXL372_NUM_AXES; i++) {
+		val = (dev->sample_count + (i << 8)) & 0xFFF;
+		dev->regs[SIM_ADXL372_X_DATA_H + 2 * i] = val >> 4;
+		dev->regs[SIM_ADXL372_X_DATA_H + 2 * i + 1] = (val & 0xF) << 4;
+		if (SIM_ADXL372_FIFO_CTL_MODE(fifo_ctl) ==
+		    SIM_ADXL372_FIFO_BYPASSED || !(axes & (1 << i)))
+			continue;
+
+		/* 12-bit left justified, the first axis of a set marked */
+		dev->fifo[(dev->fifo_head + dev->fifo_count) %
+			  SIM_ADXL372_FIFO_DEPTH] = (val << 4) | first;
+		dev->fifo_count++;
+		first = false;
+	}
+	dev->sample_count++;
+}
+
+/**
+ * @brief Bring the sampling up to the current simulated time.
+ * @param dev - The model state.
+ * @return None.
+ */
+static void sim_adxl372_update(struct sim_adxl372 *dev)
+{
+	uint8_t odr = SIM_ADXL372_TIMING_ODR(dev->regs[SIM_ADXL372_TIMING]);
+	uint64_t now = sim_time_ns();
+	uint64_t period_ns;
+	uint64_t n;
+
+	if (SIM_ADXL372_POWER_CTL_MODE(dev->regs[SIM_ADXL372_POWER_CTL]) !=
+	    SIM_ADXL372_MODE_FULL_BW) {
+		dev->last_sample_ns = now;
+		return;
+	}
+
+	/* 400 Hz doubling up to 6400 Hz */
+	period_ns = 2500000 >> (odr > 4 ? 4 : odr);
+	n = (now - dev->last_sample_ns) / period_ns;
+	dev->last_sample_ns += n * period_ns;
+
+	/* Older samples would only go through the FIFO */
+	if (n > SIM_ADXL372_FIFO_DEPTH) {
+		dev->sample_count += n - SIM_ADXL372_FIFO_DEPTH;
+		n = SIM_ADXL372_FIFO_DEPTH;
+	}
+	while (n--)
+		sim_adxl372_sample(dev);
+}
+
+/**
+ * @brief Value read from a register, with the read side effects.
+ * @param dev - The model state.
+ * @param reg - The register address.
+ * @return The register value.
+ */
+static uint8_t sim_adxl372_reg_read(struct sim_adxl372 *dev, uint8_t reg)
+{
+	uint16_t watermark;
+	uint8_t val;
+
+	switch (reg) {
+	case SIM_ADXL372_STATUS_1:
+		watermark = dev->regs[SIM_ADXL372_FIFO_SAMPLES];
+		if (dev->regs[SIM_ADXL372_FIFO_CTL] &
+		    SIM_ADXL372_FIFO_CTL_SAMPLES_8)
+			watermark |= 0x100;
+		val = dev->fifo_count ? SIM_ADXL372_STATUS_FIFO_RDY : 0;
+		if (dev->fifo_count >= watermark)
+			val |= SIM_ADXL372_STATUS_FIFO_FULL;
+		if (dev->fifo_ovr)
+			val |= SIM_ADXL372_STATUS_FIFO_OVR;
+		dev->fifo_ovr = false;
+		return val;
+	case SIM_ADXL372_FIFO_ENTRIES_2:
+		return (dev->fifo_count >> 8) & 0x3;
+	case SIM_ADXL372_FIFO_ENTRIES_1:
+		return dev->fifo_count & 0xFF;
+	default:
+		return reg < SIM_ADXL372_NUM_REGS ? dev->regs[reg] : 0;
+	}
+}
+
+/**
+ * @brief Write a register and apply its side effects.
+ * @param dev - The model state.
+ * @param reg - The register address.
+ * @param val - The register value.
+ * @return None.
+ */
+static void sim_adxl372_reg_write(struct sim_adxl372 *dev, uint8_t reg,
+				  uint8_t val)
+{
+	/* Identification, status and data registers are read only */
+	if (reg >= SIM_ADXL372_NUM_REGS || reg <= SIM_ADXL372_Z_DATA_L)
+		return;
+
+	switch (reg) {
+	case SIM_ADXL372_RESET:
+		if (val == SIM_ADXL372_RESET_CODE)
+			sim_adxl372_reset(dev);
+		return;
+	case SIM_ADXL372_FIFO_CTL:
+		dev->regs[reg] = val;
+		dev->fifo_head = 0;
+		dev->fifo_count = 0;
+		return;
+	case SIM_ADXL372_POWER_CTL:
+		dev->regs[reg] = val;
+		dev->last_sample_ns = sim_time_ns();
+		return;
+	default:
+		dev->regs[reg] = val;
+		return;
+	}
+}
+
+/**
+ * @brief SPI frame: command byte (register address and read bit), then data.
+ *        Register accesses auto-increment, except on FIFO_DATA which shifts
+ *        out the FIFO entries MSB first.
+ * @param model - The model.
+ * @param data - Full duplex buffer.
+ * @param len - Number of bytes.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_adxl372_spi_xfer(struct sim_model *model, uint8_t *data,
+				    uint32_t len)
+{
+	struct sim_adxl372 *dev = model->priv;
+	uint8_t cmd, reg;
+	uint16_t entry = 0;
+	uint32_t i;
+
+	if (!len)
+		return SUCCESS;
+
+	sim_adxl372_update(dev);
+
+	cmd = data[0];
+	reg = SIM_ADXL372_CMD_RA(cmd);
+	data[0] = 0;
+	for (i = 1; i < len; i++) {
+		if (!(cmd & SIM_ADXL372_CMD_RD)) {
+			sim_adxl372_reg_write(dev, reg++, data[i]);
+			data[i] = 0;
+		} else if (reg != SIM_ADXL372_FIFO_DATA) {
+			data[i] = sim_adxl372_reg_read(dev, reg++);
+		} else if (i & 1) {
+			entry = 0;
+			if (dev->fifo_count) {
+				entry = dev->fifo[dev->fifo_head];
+				dev->fifo_head = (dev->fifo_head + 1) %
+						 SIM_ADXL372_FIFO_DEPTH;
+				dev->fifo_count--;
+			}
+			data[i] = entry >> 8;
+		} else {
+			data[i] = entry;
+		}
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the model state.
+ * @param model - The model.
+ * @return None.
+ */
+static void sim_adxl372_remove(struct sim_model *model)
+{
+	free(model->priv);
+}
+
+/**
+ * @brief Create an ADXL372 model, sampling at the rate set in TIMING.
+ * @param model - The created model.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_adxl372_model_init(struct sim_model **model)
+{
+	struct sim_model *m;
+	struct sim_adxl372 *dev;
+
+	m = calloc(1, sizeof(*m));
+	if (!m)
+		return -ENOMEM;
+
+	dev = calloc(1, sizeof(*dev));
+	if (!dev) {
+		free(m);
+		return -ENOMEM;
+	}
+
+	sim_adxl372_reset(dev);
+
+	m->name = "adxl372";
+	m->spi_xfer = sim_adxl372_spi_xfer;
+	m->remove = sim_adxl372_remove;
+	m->priv = dev;
+
+	*model = m;
+
+	return SUCCESS;
+}
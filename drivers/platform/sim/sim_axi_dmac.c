@@ -0,0 +1,302 @@
+/***************************************************************************//**
+ *   @file   sim/sim_axi_dmac.c
+ *   @brief  Register-level model of the AXI DMAC transfer queue and timing.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "sim_model.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SIM_AXI_DMAC_REG_VERSION	0x000
+#define SIM_AXI_DMAC_REG_IRQ_MASK	0x080
+#define SIM_AXI_DMAC_REG_IRQ_PENDING	0x084
+#define SIM_AXI_DMAC_IRQ_SOT		(1 << 0)
+#define SIM_AXI_DMAC_IRQ_EOT		(1 << 1)
+#define SIM_AXI_DMAC_REG_CTRL		0x400
+#define SIM_AXI_DMAC_CTRL_ENABLE	(1 << 0)
+#define SIM_AXI_DMAC_REG_TRANSFER_ID	0x404
+#define SIM_AXI_DMAC_REG_START		0x408
+#define SIM_AXI_DMAC_REG_FLAGS		0x40C
+#define SIM_AXI_DMAC_FLAG_CYCLIC	(1 << 0)
+#define SIM_AXI_DMAC_REG_X_LENGTH	0x418
+#define SIM_AXI_DMAC_REG_TRANSFER_DONE	0x428
+
+#define SIM_AXI_DMAC_SIZE		0x800
+#define SIM_AXI_DMAC_VERSION		0x00040262
+#define SIM_AXI_DMAC_MAX_LENGTH		0x00FFFFFF
+#define SIM_AXI_DMAC_NUM_IDS		4
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct sim_axi_dmac
+ * @brief AXI DMAC model state. Only the queueing and timing of the transfers
+ * is modeled, no data is moved.
+ */
+struct sim_axi_dmac {
+	/** Register file */
+	uint32_t regs[SIM_AXI_DMAC_SIZE / 4];
+	/** Throughput of the modeled data path */
+	uint32_t bytes_per_us;
+	/** A transfer is in flight */
+	uint8_t active;
+	/** ID of the transfer in flight */
+	uint8_t active_id;
+	/**
+	 * The transfer in flight is cyclic and only completes at the end of a
+	 * pass once another one is queued
+	 */
+	uint8_t active_cyclic;
+	/** Duration of one pass of the transfer in flight */
+	uint64_t active_pass_ns;
+	/** Simulated time at which the current pass completes */
+	uint64_t active_done_ns;
+	/** A transfer is queued behind the one in flight */
+	uint8_t queued;
+	/** Length of the queued transfer */
+	uint32_t queued_len;
+	/** Flags of the queued transfer */
+	uint32_t queued_flags;
+	/** ID assigned to the next submitted transfer */
+	uint8_t next_id;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Start a transfer.
+ * @param dev - The model state.
+ * @param len - Transfer length, in bytes.
+ * @param flags - Transfer flags.
+ * @param start_ns - Simulated time at which the transfer starts.
+ * @return None.
+ */
+static void sim_axi_dmac_start(struct sim_axi_dmac *dev, uint32_t len,
+			       uint32_t flags, uint64_t start_ns)
+{
+	dev->active = 1;
+	dev->active_id = dev->next_id;
+	dev->active_cyclic = !!(flags & SIM_AXI_DMAC_FLAG_CYCLIC);
+	dev->active_pass_ns = ((uint64_t)len * 1000 + dev->bytes_per_us - 1) /
+			      dev->bytes_per_us;
+	dev->active_done_ns = start_ns + dev->active_pass_ns;
+	dev->next_id = (dev->next_id + 1) % SIM_AXI_DMAC_NUM_IDS;
+	dev->regs[SIM_AXI_DMAC_REG_TRANSFER_DONE / 4] &= ~(1u << dev->active_id);
+	dev->regs[SIM_AXI_DMAC_REG_IRQ_PENDING / 4] |= SIM_AXI_DMAC_IRQ_SOT;
+}
+
+/**
+ * @brief Retire the transfers completed by the current simulated time and
+ *        promote the queued one.
+ * @param dev - The model state.
+ * @return None.
+ */
+static void sim_axi_dmac_update(struct sim_axi_dmac *dev)
+{
+	uint64_t now = sim_time_ns();
+	uint64_t done;
+
+	while (dev->active && now >= dev->active_done_ns) {
+		if (dev->active_cyclic && !dev->queued) {
+			dev->active_done_ns += ((now - dev->active_done_ns) /
+						dev->active_pass_ns + 1) *
+					       dev->active_pass_ns;
+			break;
+		}
+		done = dev->active_done_ns;
+		dev->active = 0;
+		dev->regs[SIM_AXI_DMAC_REG_TRANSFER_DONE / 4] |=
+			1u << dev->active_id;
+		dev->regs[SIM_AXI_DMAC_REG_IRQ_PENDING / 4] |=
+			SIM_AXI_DMAC_IRQ_EOT;
+		if (dev->queued) {
+			dev->queued = 0;
+			sim_axi_dmac_start(dev, dev->queued_len,
+					   dev->queued_flags, done);
+		}
+	}
+}
+
+/**
+ * @brief MMIO register read.
+ * @param model - The model.
+ * @param offset - Register offset.
+ * @param data - Register value.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_axi_dmac_read(struct sim_model *model, uint32_t offset,
+				 uint32_t *data)
+{
+	struct sim_axi_dmac *dev = model->priv;
+
+	sim_axi_dmac_update(dev);
+
+	switch (offset) {
+	case SIM_AXI_DMAC_REG_TRANSFER_ID:
+		*data = dev->next_id;
+		break;
+	case SIM_AXI_DMAC_REG_START:
+		*data = dev->queued;
+		break;
+	default:
+		*data = dev->regs[offset / 4];
+		break;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief MMIO register write.
+ * @param model - The model.
+ * @param offset - Register offset.
+ * @param data - Register value.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_axi_dmac_write(struct sim_model *model, uint32_t offset,
+				  uint32_t data)
+{
+	struct sim_axi_dmac *dev = model->priv;
+	uint32_t len;
+
+	sim_axi_dmac_update(dev);
+
+	switch (offset) {
+	case SIM_AXI_DMAC_REG_VERSION:
+	case SIM_AXI_DMAC_REG_TRANSFER_ID:
+	case SIM_AXI_DMAC_REG_TRANSFER_DONE:
+		break;
+	case SIM_AXI_DMAC_REG_IRQ_PENDING:
+		dev->regs[offset / 4] &= ~data;
+		break;
+	case SIM_AXI_DMAC_REG_CTRL:
+		dev->regs[offset / 4] = data;
+		if (!(data & SIM_AXI_DMAC_CTRL_ENABLE)) {
+			dev->active = 0;
+			dev->queued = 0;
+		}
+		break;
+	case SIM_AXI_DMAC_REG_X_LENGTH:
+		dev->regs[offset / 4] = data & SIM_AXI_DMAC_MAX_LENGTH;
+		break;
+	case SIM_AXI_DMAC_REG_START:
+		if (!(data & 1) || dev->queued ||
+		    !(dev->regs[SIM_AXI_DMAC_REG_CTRL / 4] &
+		      SIM_AXI_DMAC_CTRL_ENABLE))
+			break;
+		len = dev->regs[SIM_AXI_DMAC_REG_X_LENGTH / 4] + 1;
+		if (dev->active) {
+			dev->queued = 1;
+			dev->queued_len = len;
+			dev->queued_flags = dev->regs[SIM_AXI_DMAC_REG_FLAGS / 4];
+		} else {
+			sim_axi_dmac_start(dev, len,
+					   dev->regs[SIM_AXI_DMAC_REG_FLAGS / 4],
+					   sim_time_ns());
+		}
+		break;
+	default:
+		dev->regs[offset / 4] = data;
+		break;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the model state.
+ * @param model - The model.
+ * @return None.
+ */
+static void sim_axi_dmac_remove(struct sim_model *model)
+{
+	free(model->priv);
+}
+
+/**
+ * @brief Create an AXI DMAC model. Map it with sim_mmio_register() at the
+ *        base address passed to axi_dmac_init().
+ * @param model - The created model.
+ * @param bytes_per_us - Throughput of the modeled data path.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_axi_dmac_model_init(struct sim_model **model,
+				uint32_t bytes_per_us)
+{
+	struct sim_model *m;
+	struct sim_axi_dmac *dev;
+
+	if (!bytes_per_us)
+		return -EINVAL;
+
+	m = calloc(1, sizeof(*m));
+	if (!m)
+		return -ENOMEM;
+
+	dev = calloc(1, sizeof(*dev));
+	if (!dev) {
+		free(m);
+		return -ENOMEM;
+	}
+
+	dev->bytes_per_us = bytes_per_us;
+	dev->regs[SIM_AXI_DMAC_REG_VERSION / 4] = SIM_AXI_DMAC_VERSION;
+
+	m->name = "axi_dmac";
+	m->mmio_read = sim_axi_dmac_read;
+	m->mmio_write = sim_axi_dmac_write;
+	m->remove = sim_axi_dmac_remove;
+	m->size = SIM_AXI_DMAC_SIZE;
+	m->mmio_access_ns = 100;
+	m->priv = dev;
+
+	*model = m;
+
+	return SUCCESS;
+}
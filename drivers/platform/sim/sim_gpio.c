@@ -0,0 +1,222 @@
+/***************************************************************************//**
+ *   @file   sim/sim_gpio.c
+ *   @brief  Implementation of the simulation platform GPIO driver.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include "error.h"
+#include "gpio.h"
+#include "sim_gpio.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct sim_gpio_desc
+ * @brief Simulation platform specific GPIO descriptor. The line is not
+ * connected to any model, it only keeps its state.
+ */
+struct sim_gpio_desc {
+	/** GPIO_OUT or GPIO_IN */
+	uint8_t direction;
+	/** Last value driven or read */
+	uint8_t value;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Obtain the GPIO decriptor.
+ * @param desc - The GPIO descriptor.
+ * @param param - GPIO initialization parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_gpio_get(struct gpio_desc **desc,
+			    const struct gpio_init_param *param)
+{
+	struct gpio_desc *descriptor;
+	struct sim_gpio_desc *extra;
+
+	if (!desc || !param)
+		return -EINVAL;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	extra = calloc(1, sizeof(*extra));
+	if (!extra) {
+		free(descriptor);
+		return -ENOMEM;
+	}
+
+	extra->direction = GPIO_IN;
+	descriptor->number = param->number;
+	descriptor->extra = extra;
+
+	*desc = descriptor;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the value of an optional GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param param - GPIO initialization parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_gpio_get_optional(struct gpio_desc **desc,
+				     const struct gpio_init_param *param)
+{
+	if (!param || param->number == -1) {
+		*desc = NULL;
+		return SUCCESS;
+	}
+
+	return sim_gpio_get(desc, param);
+}
+
+/**
+ * @brief Free the resources allocated by gpio_get().
+ * @param desc - The GPIO descriptor.
+ * @return SUCCESS in case of success.
+ */
+static int32_t sim_gpio_remove(struct gpio_desc *desc)
+{
+	if (desc)
+		free(desc->extra);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Enable the input direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @return SUCCESS in case of success.
+ */
+static int32_t sim_gpio_direction_input(struct gpio_desc *desc)
+{
+	struct sim_gpio_desc *extra = desc->extra;
+
+	extra->direction = GPIO_IN;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Enable the output direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ * @return SUCCESS in case of success.
+ */
+static int32_t sim_gpio_direction_output(struct gpio_desc *desc,
+		uint8_t value)
+{
+	struct sim_gpio_desc *extra = desc->extra;
+
+	extra->direction = GPIO_OUT;
+	extra->value = value;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the direction of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param direction - The direction.
+ * @return SUCCESS in case of success.
+ */
+static int32_t sim_gpio_get_direction(struct gpio_desc *desc,
+				      uint8_t *direction)
+{
+	struct sim_gpio_desc *extra = desc->extra;
+
+	*direction = extra->direction;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set the value of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ * @return SUCCESS in case of success.
+ */
+static int32_t sim_gpio_set_value(struct gpio_desc *desc, uint8_t value)
+{
+	struct sim_gpio_desc *extra = desc->extra;
+
+	extra->value = value;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the value of the specified GPIO.
+ * @param desc - The GPIO descriptor.
+ * @param value - The value.
+ * @return SUCCESS in case of success.
+ */
+static int32_t sim_gpio_get_value(struct gpio_desc *desc, uint8_t *value)
+{
+	struct sim_gpio_desc *extra = desc->extra;
+
+	*value = extra->value;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Simulation platform specific GPIO platform ops structure
+ */
+const struct gpio_platform_ops sim_gpio_platform_ops = {
+	.gpio_ops_get = &sim_gpio_get,
+	.gpio_ops_get_optional = &sim_gpio_get_optional,
+	.gpio_ops_remove = &sim_gpio_remove,
+	.gpio_ops_direction_input = &sim_gpio_direction_input,
+	.gpio_ops_direction_output = &sim_gpio_direction_output,
+	.gpio_ops_get_direction = &sim_gpio_get_direction,
+	.gpio_ops_set_value = &sim_gpio_set_value,
+	.gpio_ops_get_value = &sim_gpio_get_value
+};
@@ -0,0 +1,290 @@
+/***************************************************************************//**
+ *   @file   sim/sim_irq.c
+ *   @brief  Implementation of the simulation platform interrupt controller.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "util.h"
+#include "sim_irq.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct sim_irq_line
+ * @brief State of one simulated interrupt line.
+ */
+struct sim_irq_line {
+	/** Registered callback */
+	struct callback_desc	callback;
+	/** Set when the line is enabled */
+	bool			enabled;
+};
+
+/**
+ * @struct sim_irq_ctrl
+ * @brief Simulation platform specific interrupt controller descriptor. The
+ * lines are not connected to any model, the bench raises them.
+ */
+struct sim_irq_ctrl {
+	/** Set by irq_global_enable() */
+	bool			global_enabled;
+	/** Interrupt lines */
+	struct sim_irq_line	lines[SIM_IRQ_NB_LINES];
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Initialize the interrupt controller. Interrupts are globally enabled.
+ * @param desc - The controller descriptor.
+ * @param param - The structure that contains the controller parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t irq_ctrl_init(struct irq_ctrl_desc **desc,
+		      const struct irq_init_param *param)
+{
+	struct irq_ctrl_desc	*descriptor;
+	struct sim_irq_ctrl	*ctrl;
+
+	if (!desc || !param)
+		return -EINVAL;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	ctrl = calloc(1, sizeof(*ctrl));
+	if (!ctrl) {
+		free(descriptor);
+		return -ENOMEM;
+	}
+
+	ctrl->global_enabled = true;
+	descriptor->irq_ctrl_id = param->irq_ctrl_id;
+	descriptor->extra = ctrl;
+	*desc = descriptor;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by irq_ctrl_init().
+ * @param desc - The controller descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t irq_ctrl_remove(struct irq_ctrl_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	free(desc->extra);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Register a callback on a line. The line stays disabled.
+ * @param desc - The controller descriptor.
+ * @param irq_id - Line number.
+ * @param callback_desc - Callback.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t irq_register_callback(struct irq_ctrl_desc *desc, uint32_t irq_id,
+			      struct callback_desc *callback_desc)
+{
+	struct sim_irq_ctrl *ctrl;
+
+	if (!desc || irq_id >= SIM_IRQ_NB_LINES)
+		return -EINVAL;
+
+	if (!callback_desc)
+		return irq_unregister(desc, irq_id);
+
+	ctrl = desc->extra;
+	ctrl->lines[irq_id].callback = *callback_desc;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Disable a line and remove its callback.
+ * @param desc - The controller descriptor.
+ * @param irq_id - Line number.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t irq_unregister(struct irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct sim_irq_ctrl *ctrl;
+
+	if (!desc || irq_id >= SIM_IRQ_NB_LINES)
+		return -EINVAL;
+
+	ctrl = desc->extra;
+	memset(&ctrl->lines[irq_id], 0, sizeof(ctrl->lines[irq_id]));
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Let the enabled lines call their callbacks.
+ * @param desc - The controller descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t irq_global_enable(struct irq_ctrl_desc *desc)
+{
+	struct sim_irq_ctrl *ctrl;
+
+	if (!desc)
+		return -EINVAL;
+
+	ctrl = desc->extra;
+	ctrl->global_enabled = true;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Mask all the lines.
+ * @param desc - The controller descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t irq_global_disable(struct irq_ctrl_desc *desc)
+{
+	struct sim_irq_ctrl *ctrl;
+
+	if (!desc)
+		return -EINVAL;
+
+	ctrl = desc->extra;
+	ctrl->global_enabled = false;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Not supported, the lines are raised by sim_irq_fire().
+ * @param desc - The controller descriptor.
+ * @param irq_id - Line number.
+ * @param trig - Trigger level.
+ * @return -ENOSYS.
+ */
+int32_t irq_trigger_level_set(struct irq_ctrl_desc *desc, uint32_t irq_id,
+			      enum irq_trig_level trig)
+{
+	UNUSED_PARAM(desc);
+	UNUSED_PARAM(irq_id);
+	UNUSED_PARAM(trig);
+
+	return -ENOSYS;
+}
+
+/**
+ * @brief Enable a line.
+ * @param desc - The controller descriptor.
+ * @param irq_id - Line number.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t irq_enable(struct irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct sim_irq_ctrl *ctrl;
+
+	if (!desc || irq_id >= SIM_IRQ_NB_LINES)
+		return -EINVAL;
+
+	ctrl = desc->extra;
+	ctrl->lines[irq_id].enabled = true;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Disable a line.
+ * @param desc - The controller descriptor.
+ * @param irq_id - Line number.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t irq_disable(struct irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct sim_irq_ctrl *ctrl;
+
+	if (!desc || irq_id >= SIM_IRQ_NB_LINES)
+		return -EINVAL;
+
+	ctrl = desc->extra;
+	ctrl->lines[irq_id].enabled = false;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Raise a line. The callback runs in the caller context, as it would
+ * on an interrupt taken between two instructions of the caller.
+ * @param desc - The controller descriptor.
+ * @param irq_id - Line number.
+ * @return SUCCESS in case of success, -EINVAL for a bad line, -ENODEV if the
+ * line is masked or has no callback.
+ */
+int32_t sim_irq_fire(struct irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct sim_irq_ctrl	*ctrl;
+	struct callback_desc	callback;
+
+	if (!desc || irq_id >= SIM_IRQ_NB_LINES)
+		return -EINVAL;
+
+	ctrl = desc->extra;
+	if (!ctrl->global_enabled || !ctrl->lines[irq_id].enabled ||
+	    !ctrl->lines[irq_id].callback.callback)
+		return -ENODEV;
+
+	/* A copy, so the callback may unregister its own line */
+	callback = ctrl->lines[irq_id].callback;
+	callback.callback(callback.ctx, irq_id, NULL);
+
+	return SUCCESS;
+}
@@ -0,0 +1,151 @@
+/*******************************************************************************
+ *   @file   sim/sim_model.h
+ *   @brief  Register-level device model interface of the simulation platform.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef SIM_MODEL_H_
+#define SIM_MODEL_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct sim_stats
+ * @brief Bus traffic accounted to a device model.
+ */
+struct sim_stats {
+	/** Number of bus transactions (SPI frames, I2C transfers, MMIO accesses) */
+	uint64_t	transactions;
+	/** Number of bytes moved on the bus */
+	uint64_t	bytes;
+	/** Modeled bus time, in nanoseconds */
+	uint64_t	bus_time_ns;
+};
+
+/**
+ * @struct sim_model
+ * @brief A simulated device. A model implements the hooks of the buses it is
+ * attached to and leaves the others NULL.
+ */
+struct sim_model {
+	/** Model name, used when printing statistics */
+	const char	*name;
+	/** Full duplex SPI frame (CS asserted for the whole buffer) */
+	int32_t		(*spi_xfer)(struct sim_model *model, uint8_t *data,
+				    uint32_t len);
+	/** I2C write transfer */
+	int32_t		(*i2c_write)(struct sim_model *model,
+				     const uint8_t *data, uint32_t len,
+				     uint8_t stop);
+	/** I2C read transfer */
+	int32_t		(*i2c_read)(struct sim_model *model, uint8_t *data,
+				    uint32_t len, uint8_t stop);
+	/** 32-bit memory mapped register read */
+	int32_t		(*mmio_read)(struct sim_model *model, uint32_t offset,
+				     uint32_t *data);
+	/** 32-bit memory mapped register write */
+	int32_t		(*mmio_write)(struct sim_model *model, uint32_t offset,
+				      uint32_t data);
+	/** Free the model private data */
+	void		(*remove)(struct sim_model *model);
+	/** Base address of the MMIO window (as passed to axi_io_read/write) */
+	uint32_t	base;
+	/** Size of the MMIO window, in bytes */
+	uint32_t	size;
+	/** Fixed cost of a bus transaction (CS setup, address phase, ...) */
+	uint32_t	xfer_overhead_ns;
+	/** Cost of one MMIO access */
+	uint32_t	mmio_access_ns;
+	/** Traffic statistics */
+	struct sim_stats stats;
+	/** Model private data */
+	void		*priv;
+	/** Next model in the MMIO map */
+	struct sim_model *next;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Get the simulated time, in nanoseconds. */
+uint64_t sim_time_ns(void);
+
+/* Advance the simulated time. */
+void sim_advance_ns(uint64_t ns);
+
+/* Account a bus transaction to a model and advance the simulated time. */
+void sim_account(struct sim_model *model, uint32_t bytes, uint64_t bus_ns);
+
+/* Map a model in the MMIO space used by axi_io_read/axi_io_write. */
+int32_t sim_mmio_register(struct sim_model *model, uint32_t base,
+			  uint32_t size);
+
+/* Remove a model from the MMIO space. */
+int32_t sim_mmio_unregister(struct sim_model *model);
+
+/* Find the model that owns an MMIO address. */
+struct sim_model *sim_mmio_find(uint32_t addr);
+
+/* Clear the statistics of a model. */
+void sim_stats_reset(struct sim_model *model);
+
+/* Print the statistics of a model. */
+void sim_stats_print(struct sim_model *model);
+
+/* Free a model created by one of the sim_*_model_init() functions. */
+int32_t sim_model_remove(struct sim_model *model);
+
+/* Device models. */
+int32_t sim_ad9361_model_init(struct sim_model **model);
+int32_t sim_ad7124_model_init(struct sim_model **model, uint8_t device_id,
+			      uint32_t conv_time_ns);
+int32_t sim_axi_dmac_model_init(struct sim_model **model,
+				uint32_t bytes_per_us);
+int32_t sim_spi_engine_model_init(struct sim_model **model,
+				  struct sim_model *slave,
+				  uint32_t data_width);
+int32_t sim_sd_model_init(struct sim_model **model, uint32_t size_mb);
+int32_t sim_adxl372_model_init(struct sim_model **model);
+int32_t sim_adxl362_model_init(struct sim_model **model);
+
+#endif // SIM_MODEL_H_
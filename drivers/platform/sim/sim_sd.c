@@ -0,0 +1,387 @@
+/***************************************************************************//**
+ *   @file   sim/sim_sd.c
+ *   @brief  Model of an SDHC card in SPI mode.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "sim_model.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SIM_SD_BLOCK_LEN		512
+#define SIM_SD_CMD_LEN			6
+/* Bytes the card holds the bus busy after a block is written */
+#define SIM_SD_BUSY_LEN			4
+/* R1 of CMD17/CMD18, then a gap byte, the token, the block and its CRC */
+#define SIM_SD_OUT_LEN			(2 + SIM_SD_BLOCK_LEN + 4)
+
+#define SIM_SD_R1_READY			0x00
+#define SIM_SD_R1_IDLE			0x01
+#define SIM_SD_R1_ILLEGAL		0x04
+
+#define SIM_SD_TOKEN_1_BLOCK		0xFE
+#define SIM_SD_TOKEN_N_BLOCK		0xFC
+#define SIM_SD_TOKEN_STOP		0xFD
+#define SIM_SD_DATA_ACCEPTED		0x05
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum sim_sd_state
+ * @brief What the card expects from the next byte sent by the host.
+ */
+enum sim_sd_state {
+	/** A command */
+	SIM_SD_CMD,
+	/** The start token of a CMD24/CMD25 data block */
+	SIM_SD_WRITE_TOKEN,
+	/** Data block and CRC */
+	SIM_SD_WRITE_DATA,
+};
+
+/**
+ * @struct sim_sd
+ * @brief SD card model state.
+ */
+struct sim_sd {
+	/** Card memory */
+	uint8_t *mem;
+	/** Number of blocks */
+	uint32_t nb_blocks;
+	/** Current state */
+	enum sim_sd_state state;
+	/** Command being received */
+	uint8_t cmd[SIM_SD_CMD_LEN];
+	/** Number of bytes of cmd received */
+	uint32_t cmd_len;
+	/** Set after CMD55, the next command is an application command */
+	uint8_t app_cmd;
+	/** Set once ACMD41 took the card out of the idle state */
+	uint8_t ready;
+	/** Block of the open CMD17/CMD18/CMD24/CMD25 */
+	uint32_t block;
+	/** CMD18 is open, blocks are sent until CMD12 */
+	uint8_t read_multi;
+	/** CMD25 is open, blocks are received until the stop token */
+	uint8_t write_multi;
+	/** Bytes of the data block received */
+	uint32_t data_len;
+	/** Bytes to be shifted out */
+	uint8_t out[SIM_SD_OUT_LEN];
+	/** Index of the next byte of out */
+	uint32_t out_idx;
+	/** Number of valid bytes in out */
+	uint32_t out_len;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Queue bytes to be shifted out after the ones already queued.
+ * @param dev - The model state.
+ * @param data - The bytes.
+ * @param len - Number of bytes.
+ * @return None.
+ */
+static void sim_sd_queue(struct sim_sd *dev, const uint8_t *data, uint32_t len)
+{
+	if (dev->out_idx == dev->out_len)
+		dev->out_idx = dev->out_len = 0;
+	if (dev->out_len + len > SIM_SD_OUT_LEN)
+		len = SIM_SD_OUT_LEN - dev->out_len;
+	memcpy(dev->out + dev->out_len, data, len);
+	dev->out_len += len;
+}
+
+/**
+ * @brief Queue a data block read from the memory, preceded by a gap byte.
+ * @param dev - The model state.
+ * @return None.
+ */
+static void sim_sd_queue_block(struct sim_sd *dev)
+{
+	uint8_t hdr[2] = {0xFF, SIM_SD_TOKEN_1_BLOCK};
+	uint8_t crc[2] = {0xFF, 0xFF};
+
+	sim_sd_queue(dev, hdr, sizeof(hdr));
+	sim_sd_queue(dev, dev->mem + (uint64_t)dev->block * SIM_SD_BLOCK_LEN,
+		     SIM_SD_BLOCK_LEN);
+	sim_sd_queue(dev, crc, sizeof(crc));
+	dev->block++;
+}
+
+/**
+ * @brief Execute a received command and queue its response after one fill
+ *        byte.
+ * @param dev - The model state.
+ * @return None.
+ */
+static void sim_sd_command(struct sim_sd *dev)
+{
+	/* Fill byte, then R1 and the rest of R3/R7 */
+	uint8_t resp[6] = {0xFF, SIM_SD_R1_READY, 0, 0, 0, 0};
+	uint8_t idx = dev->cmd[0] & 0x3F;
+	uint32_t arg = ((uint32_t)dev->cmd[1] << 24) | (dev->cmd[2] << 16) |
+		       (dev->cmd[3] << 8) | dev->cmd[4];
+	uint8_t app_cmd = dev->app_cmd;
+	uint32_t len = 2;
+	uint8_t csd[16] = {0};
+
+	dev->app_cmd = 0;
+	dev->read_multi = 0;
+	dev->out_idx = dev->out_len = 0;
+	if (!dev->ready)
+		resp[1] = SIM_SD_R1_IDLE;
+
+	if (app_cmd && idx == 41) {
+		dev->ready = 1;
+		resp[1] = SIM_SD_R1_READY;
+		sim_sd_queue(dev, resp, len);
+		return;
+	}
+
+	switch (idx) {
+	case 0:
+		dev->ready = 0;
+		resp[1] = SIM_SD_R1_IDLE;
+		break;
+	case 8:
+		/* Voltage accepted, check pattern echoed */
+		resp[4] = arg >> 8;
+		resp[5] = arg;
+		len = 6;
+		break;
+	case 55:
+		dev->app_cmd = 1;
+		break;
+	case 58:
+		/* Powered up, high capacity */
+		resp[2] = 0xC0;
+		resp[3] = 0xFF;
+		resp[4] = 0x80;
+		len = 6;
+		break;
+	case 9:
+		/* CSD version 2.0, C_SIZE in units of 512 KiB - 1 */
+		csd[0] = 0x40;
+		csd[7] = ((dev->nb_blocks / 1024 - 1) >> 16) & 0x3F;
+		csd[8] = (dev->nb_blocks / 1024 - 1) >> 8;
+		csd[9] = dev->nb_blocks / 1024 - 1;
+		sim_sd_queue(dev, resp, len);
+		resp[0] = 0xFF;
+		resp[1] = SIM_SD_TOKEN_1_BLOCK;
+		sim_sd_queue(dev, resp, 2);
+		sim_sd_queue(dev, csd, sizeof(csd));
+		resp[0] = resp[1] = 0xFF;
+		sim_sd_queue(dev, resp, 2);
+		return;
+	case 12:
+		/* Stuff byte, then R1 */
+		resp[0] = resp[1] = 0xFF;
+		resp[2] = SIM_SD_R1_READY;
+		len = 3;
+		break;
+	case 17:
+	case 18:
+	case 24:
+	case 25:
+		if (arg >= dev->nb_blocks) {
+			resp[1] |= SIM_SD_R1_ILLEGAL;
+			break;
+		}
+		dev->block = arg;
+		sim_sd_queue(dev, resp, len);
+		if (idx == 17 || idx == 18) {
+			dev->read_multi = (idx == 18);
+			sim_sd_queue_block(dev);
+		} else {
+			dev->write_multi = (idx == 25);
+			dev->state = SIM_SD_WRITE_TOKEN;
+		}
+		return;
+	default:
+		resp[1] |= SIM_SD_R1_ILLEGAL;
+		break;
+	}
+
+	sim_sd_queue(dev, resp, len);
+}
+
+/**
+ * @brief Take one byte sent by the host.
+ * @param dev - The model state.
+ * @param in - The byte.
+ * @return None.
+ */
+static void sim_sd_receive(struct sim_sd *dev, uint8_t in)
+{
+	uint8_t resp[1 + SIM_SD_BUSY_LEN] = {SIM_SD_DATA_ACCEPTED};
+	uint8_t busy[SIM_SD_BUSY_LEN] = {0};
+
+	switch (dev->state) {
+	case SIM_SD_CMD:
+		/* A command starts with 01 on the first two bits */
+		if (!dev->cmd_len && (in & 0xC0) != 0x40)
+			return;
+		dev->cmd[dev->cmd_len++] = in;
+		if (dev->cmd_len == SIM_SD_CMD_LEN) {
+			dev->cmd_len = 0;
+			sim_sd_command(dev);
+		}
+		return;
+	case SIM_SD_WRITE_TOKEN:
+		if (in == SIM_SD_TOKEN_STOP && dev->write_multi) {
+			dev->write_multi = 0;
+			dev->state = SIM_SD_CMD;
+			sim_sd_queue(dev, busy, sizeof(busy));
+		} else if (in == SIM_SD_TOKEN_1_BLOCK ||
+			   in == SIM_SD_TOKEN_N_BLOCK) {
+			dev->data_len = 0;
+			dev->state = SIM_SD_WRITE_DATA;
+		}
+		return;
+	case SIM_SD_WRITE_DATA:
+		if (dev->data_len < SIM_SD_BLOCK_LEN && dev->block < dev->nb_blocks)
+			dev->mem[(uint64_t)dev->block * SIM_SD_BLOCK_LEN +
+				 dev->data_len] = in;
+		/* The block is followed by two CRC bytes */
+		if (++dev->data_len < SIM_SD_BLOCK_LEN + 2)
+			return;
+		dev->block++;
+		sim_sd_queue(dev, resp, sizeof(resp));
+		dev->state = (dev->write_multi && dev->block < dev->nb_blocks) ?
+			     SIM_SD_WRITE_TOKEN : SIM_SD_CMD;
+		return;
+	}
+}
+
+/**
+ * @brief SPI frame: every byte sent by the host is answered with the next
+ *        queued byte, or 0xFF when the card has nothing to send.
+ * @param model - The model.
+ * @param data - Full duplex buffer.
+ * @param len - Number of bytes.
+ * @return SUCCESS.
+ */
+static int32_t sim_sd_spi_xfer(struct sim_model *model, uint8_t *data,
+			       uint32_t len)
+{
+	struct sim_sd *dev = model->priv;
+	uint8_t in;
+	uint32_t i;
+
+	for (i = 0; i < len; i++) {
+		in = data[i];
+		if (dev->out_idx == dev->out_len && dev->read_multi &&
+		    dev->block < dev->nb_blocks)
+			sim_sd_queue_block(dev);
+		data[i] = (dev->out_idx < dev->out_len) ?
+			  dev->out[dev->out_idx++] : 0xFF;
+		sim_sd_receive(dev, in);
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the model state.
+ * @param model - The model.
+ * @return None.
+ */
+static void sim_sd_remove(struct sim_model *model)
+{
+	struct sim_sd *dev = model->priv;
+
+	free(dev->mem);
+	free(dev);
+}
+
+/**
+ * @brief Create an SD card model. The memory is erased to 0xFF.
+ * @param model - The created model.
+ * @param size_mb - Card size in MiB.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_sd_model_init(struct sim_model **model, uint32_t size_mb)
+{
+	struct sim_model *m;
+	struct sim_sd *dev;
+
+	if (!model || !size_mb)
+		return -EINVAL;
+
+	m = calloc(1, sizeof(*m));
+	if (!m)
+		return -ENOMEM;
+
+	dev = calloc(1, sizeof(*dev));
+	if (!dev)
+		goto error_model;
+
+	dev->nb_blocks = size_mb * 2048;
+	dev->mem = malloc((uint64_t)dev->nb_blocks * SIM_SD_BLOCK_LEN);
+	if (!dev->mem)
+		goto error_dev;
+	memset(dev->mem, 0xFF, (uint64_t)dev->nb_blocks * SIM_SD_BLOCK_LEN);
+
+	m->name = "sd";
+	m->spi_xfer = sim_sd_spi_xfer;
+	m->remove = sim_sd_remove;
+	m->priv = dev;
+
+	*model = m;
+
+	return SUCCESS;
+
+error_dev:
+	free(dev);
+error_model:
+	free(m);
+
+	return -ENOMEM;
+}
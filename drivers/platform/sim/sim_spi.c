@@ -0,0 +1,210 @@
+/***************************************************************************//**
+ *   @file   sim/sim_spi.c
+ *   @brief  Implementation of the simulation platform SPI driver.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "spi.h"
+#include "sim_spi.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Clock used when the descriptor does not specify one */
+#define SIM_SPI_DEFAULT_HZ	1000000
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Run one CS-asserted frame through the model and account its cost.
+ * @param desc - The SPI descriptor.
+ * @param data - Full duplex buffer.
+ * @param len - Number of bytes.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_spi_frame(struct spi_desc *desc, uint8_t *data,
+			     uint32_t len)
+{
+	struct sim_model *model = desc->extra;
+	uint32_t hz = desc->max_speed_hz ? desc->max_speed_hz :
+		      SIM_SPI_DEFAULT_HZ;
+	uint64_t bus_ns;
+
+	if (!model->spi_xfer)
+		return -ENODEV;
+
+	bus_ns = model->xfer_overhead_ns +
+		 ((uint64_t)len * 8 * 1000000000ull + hz - 1) / hz;
+	sim_account(model, len, bus_ns);
+
+	return model->spi_xfer(model, data, len);
+}
+
+/**
+ * @brief Initialize the SPI communication peripheral.
+ * @param desc - The SPI descriptor.
+ * @param param - The structure that contains the SPI parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_spi_init(struct spi_desc **desc,
+			    const struct spi_init_param *param)
+{
+	struct sim_spi_init_param *sim_init;
+	struct spi_desc *descriptor;
+
+	if (!desc || !param || !param->extra)
+		return -EINVAL;
+
+	sim_init = param->extra;
+	if (!sim_init->model)
+		return -EINVAL;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	descriptor->max_speed_hz = param->max_speed_hz;
+	descriptor->chip_select = param->chip_select;
+	descriptor->mode = param->mode;
+	descriptor->bit_order = param->bit_order;
+	descriptor->extra = sim_init->model;
+
+	*desc = descriptor;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Write and read data to/from the simulated device.
+ * @param desc - The SPI descriptor.
+ * @param data - The buffer with the transmitted/received data.
+ * @param bytes_number - Number of bytes to write/read.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_spi_write_and_read(struct spi_desc *desc, uint8_t *data,
+				      uint16_t bytes_number)
+{
+	return sim_spi_frame(desc, data, bytes_number);
+}
+
+/**
+ * @brief Execute a list of message segments. Consecutive segments without
+ *        cs_change reach the model as a single frame, like on the wire. The
+ *        delays of a frame are accounted once the frame is done, since the
+ *        model sees the frame as a whole.
+ * @param desc - The SPI descriptor.
+ * @param msgs - Array of segments.
+ * @param len - Number of segments.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_spi_transfer(struct spi_desc *desc, struct spi_msg *msgs,
+				uint32_t len)
+{
+	uint32_t first, last, i, size, off;
+	uint64_t delay_ns;
+	uint8_t *buff;
+	int32_t ret = SUCCESS;
+
+	for (first = 0; first < len && ret == SUCCESS; first = last + 1) {
+		size = 0;
+		delay_ns = 0;
+		for (last = first; last < len; last++) {
+			size += msgs[last].bytes_number;
+			delay_ns += (uint64_t)msgs[last].delay_us * 1000;
+			if (msgs[last].cs_change)
+				break;
+		}
+		if (last == len)
+			last--;
+
+		buff = calloc(size ? size : 1, 1);
+		if (!buff)
+			return -ENOMEM;
+
+		for (i = first, off = 0; i <= last; i++) {
+			if (msgs[i].tx_buff)
+				memcpy(buff + off, msgs[i].tx_buff,
+				       msgs[i].bytes_number);
+			off += msgs[i].bytes_number;
+		}
+
+		ret = sim_spi_frame(desc, buff, size);
+
+		for (i = first, off = 0; i <= last; i++) {
+			if (msgs[i].rx_buff)
+				memcpy(msgs[i].rx_buff, buff + off,
+				       msgs[i].bytes_number);
+			off += msgs[i].bytes_number;
+		}
+		free(buff);
+
+		if (delay_ns)
+			sim_advance_ns(delay_ns);
+	}
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by spi_init().
+ * @param desc - The SPI descriptor.
+ * @return SUCCESS in case of success.
+ */
+static int32_t sim_spi_remove(struct spi_desc *desc)
+{
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Simulation platform specific SPI platform ops structure
+ */
+const struct spi_platform_ops sim_spi_platform_ops = {
+	.spi_ops_init = &sim_spi_init,
+	.spi_ops_write_and_read = &sim_spi_write_and_read,
+	.spi_ops_transfer = &sim_spi_transfer,
+	.spi_ops_remove = &sim_spi_remove
+};
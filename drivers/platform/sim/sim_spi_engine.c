@@ -0,0 +1,481 @@
+/***************************************************************************//**
+ *   @file   sim/sim_spi_engine.c
+ *   @brief  Register-level model of the SPI Engine command interpreter.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "sim_model.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SIM_SPI_ENGINE_REG_VERSION		0x00
+#define SIM_SPI_ENGINE_REG_DATA_WIDTH		0x0C
+#define SIM_SPI_ENGINE_REG_RESET		0x40
+#define SIM_SPI_ENGINE_REG_SYNC_ID		0xC0
+#define SIM_SPI_ENGINE_REG_CMD_FIFO_ROOM	0xD0
+#define SIM_SPI_ENGINE_REG_SDO_FIFO_ROOM	0xD4
+#define SIM_SPI_ENGINE_REG_SDI_FIFO_LEVEL	0xD8
+#define SIM_SPI_ENGINE_REG_CMD_FIFO		0xE0
+#define SIM_SPI_ENGINE_REG_SDO_DATA_FIFO	0xE4
+#define SIM_SPI_ENGINE_REG_SDI_DATA_FIFO	0xE8
+#define SIM_SPI_ENGINE_REG_SDI_PEEK		0xEC
+#define SIM_SPI_ENGINE_REG_OFFLOAD_CTRL		0x100
+#define SIM_SPI_ENGINE_REG_OFFLOAD_STATUS	0x104
+#define SIM_SPI_ENGINE_REG_OFFLOAD_RESET	0x108
+#define SIM_SPI_ENGINE_REG_OFFLOAD_CMD_MEM	0x110
+#define SIM_SPI_ENGINE_REG_OFFLOAD_SDO_MEM	0x114
+
+#define SIM_SPI_ENGINE_INST(cmd)		(((cmd) >> 12) & 0x3)
+#define SIM_SPI_ENGINE_ARG1(cmd)		(((cmd) >> 8) & 0x3)
+#define SIM_SPI_ENGINE_ARG2(cmd)		((cmd) & 0xFF)
+#define SIM_SPI_ENGINE_INST_TRANSFER		0x0
+#define SIM_SPI_ENGINE_INST_ASSERT		0x1
+#define SIM_SPI_ENGINE_INST_CONFIG		0x2
+#define SIM_SPI_ENGINE_INST_MISC		0x3
+#define SIM_SPI_ENGINE_TRANSFER_W		0x1
+#define SIM_SPI_ENGINE_TRANSFER_R		0x2
+#define SIM_SPI_ENGINE_CONFIG_CLK_DIV		0x0
+#define SIM_SPI_ENGINE_CONFIG_XFER_LEN		0x2
+#define SIM_SPI_ENGINE_MISC_SYNC		0x0
+
+#define SIM_SPI_ENGINE_SIZE			0x200
+#define SIM_SPI_ENGINE_VERSION			0x00010071
+#define SIM_SPI_ENGINE_REF_CLK_HZ		100000000
+#define SIM_SPI_ENGINE_FIFO_DEPTH		256
+#define SIM_SPI_ENGINE_OFFLOAD_DEPTH		32
+#define SIM_SPI_ENGINE_MAX_FRAME		1024
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct sim_fifo
+ * @brief Word FIFO of the engine.
+ */
+struct sim_fifo {
+	uint32_t data[SIM_SPI_ENGINE_FIFO_DEPTH];
+	uint32_t head;
+	uint32_t len;
+};
+
+/**
+ * @struct sim_spi_engine
+ * @brief SPI Engine model state.
+ */
+struct sim_spi_engine {
+	/** Device model connected to the engine */
+	struct sim_model *slave;
+	/** Synthesized data width */
+	uint32_t max_data_width;
+	/** Current transfer word width */
+	uint32_t data_width;
+	/** Current clock divider */
+	uint32_t clk_div;
+	/** Last SYNC ID executed */
+	uint32_t sync_id;
+	/** Command FIFO */
+	struct sim_fifo cmd;
+	/** SDO FIFO */
+	struct sim_fifo sdo;
+	/** SDI FIFO */
+	struct sim_fifo sdi;
+	/** Chip select is asserted */
+	uint8_t cs_active;
+	/** Bytes shifted during the current chip select assertion */
+	uint8_t frame[SIM_SPI_ENGINE_MAX_FRAME];
+	/** Number of bytes in frame */
+	uint32_t frame_len;
+	/** Word width and direction of each word in the frame */
+	uint8_t frame_word_bytes[SIM_SPI_ENGINE_MAX_FRAME];
+	uint8_t frame_word_read[SIM_SPI_ENGINE_MAX_FRAME];
+	/** Number of words in the frame */
+	uint32_t frame_words;
+	/** Offload command memory */
+	uint32_t offload_cmd[SIM_SPI_ENGINE_OFFLOAD_DEPTH];
+	uint32_t offload_cmd_len;
+	/** Offload SDO memory */
+	uint32_t offload_sdo[SIM_SPI_ENGINE_OFFLOAD_DEPTH];
+	uint32_t offload_sdo_len;
+	/** Offload enable */
+	uint32_t offload_ctrl;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Push a word in a FIFO.
+ * @param f - The FIFO.
+ * @param val - The word.
+ * @return SUCCESS in case of success, -ENOSPC if the FIFO is full.
+ */
+static int32_t sim_fifo_push(struct sim_fifo *f, uint32_t val)
+{
+	if (f->len == SIM_SPI_ENGINE_FIFO_DEPTH)
+		return -ENOSPC;
+
+	f->data[(f->head + f->len++) % SIM_SPI_ENGINE_FIFO_DEPTH] = val;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the oldest word of a FIFO without removing it.
+ * @param f - The FIFO.
+ * @return The word, 0 if the FIFO is empty.
+ */
+static uint32_t sim_fifo_peek(struct sim_fifo *f)
+{
+	return f->len ? f->data[f->head] : 0;
+}
+
+/**
+ * @brief Remove the oldest word of a FIFO.
+ * @param f - The FIFO.
+ * @return The word, 0 if the FIFO is empty.
+ */
+static uint32_t sim_fifo_pop(struct sim_fifo *f)
+{
+	uint32_t val = sim_fifo_peek(f);
+
+	if (f->len) {
+		f->head = (f->head + 1) % SIM_SPI_ENGINE_FIFO_DEPTH;
+		f->len--;
+	}
+
+	return val;
+}
+
+/**
+ * @brief Hand the bytes shifted during a chip select assertion to the slave
+ *        model and push the words it returned in the SDI FIFO.
+ * @param dev - The model state.
+ * @return None.
+ */
+static void sim_spi_engine_end_frame(struct sim_spi_engine *dev)
+{
+	uint32_t sclk = SIM_SPI_ENGINE_REF_CLK_HZ / (2 * (dev->clk_div + 1));
+	uint32_t i, j, off, word;
+
+	if (dev->frame_len && dev->slave && dev->slave->spi_xfer) {
+		sim_account(dev->slave, dev->frame_len,
+			    dev->slave->xfer_overhead_ns +
+			    ((uint64_t)dev->frame_len * 8 * 1000000000ull +
+			     sclk - 1) / sclk);
+		dev->slave->spi_xfer(dev->slave, dev->frame, dev->frame_len);
+	}
+
+	for (i = 0, off = 0; i < dev->frame_words; i++) {
+		word = 0;
+		for (j = 0; j < dev->frame_word_bytes[i]; j++)
+			word = (word << 8) | dev->frame[off++];
+		if (dev->frame_word_read[i])
+			sim_fifo_push(&dev->sdi, word);
+	}
+
+	dev->frame_len = 0;
+	dev->frame_words = 0;
+}
+
+/**
+ * @brief Execute one TRANSFER command. SDO words are shifted MSB first.
+ * @param dev - The model state.
+ * @param rw - Direction flags.
+ * @param n - Number of words.
+ * @return None.
+ */
+static void sim_spi_engine_transfer(struct sim_spi_engine *dev, uint8_t rw,
+				    uint32_t n)
+{
+	uint32_t bytes = (dev->data_width + 7) / 8;
+	uint32_t word, j;
+
+	while (n--) {
+		word = (rw & SIM_SPI_ENGINE_TRANSFER_W) ?
+		       sim_fifo_pop(&dev->sdo) : 0;
+		if (dev->frame_len + bytes > SIM_SPI_ENGINE_MAX_FRAME ||
+		    dev->frame_words == SIM_SPI_ENGINE_MAX_FRAME)
+			sim_spi_engine_end_frame(dev);
+		for (j = 0; j < bytes; j++)
+			dev->frame[dev->frame_len++] =
+				word >> (8 * (bytes - 1 - j));
+		dev->frame_word_bytes[dev->frame_words] = bytes;
+		dev->frame_word_read[dev->frame_words] =
+			!!(rw & SIM_SPI_ENGINE_TRANSFER_R);
+		dev->frame_words++;
+	}
+
+	/* A transfer without chip select asserted still clocks the bus. */
+	if (!dev->cs_active)
+		sim_spi_engine_end_frame(dev);
+}
+
+/**
+ * @brief Run the command FIFO. A transfer waiting for SDO data stalls the
+ *        interpreter, like on hardware.
+ * @param dev - The model state.
+ * @return None.
+ */
+static void sim_spi_engine_run(struct sim_spi_engine *dev)
+{
+	uint32_t cmd, n;
+	uint8_t rw;
+
+	while (dev->cmd.len) {
+		cmd = sim_fifo_peek(&dev->cmd);
+
+		switch (SIM_SPI_ENGINE_INST(cmd)) {
+		case SIM_SPI_ENGINE_INST_TRANSFER:
+			rw = SIM_SPI_ENGINE_ARG1(cmd);
+			n = SIM_SPI_ENGINE_ARG2(cmd) + 1;
+			if ((rw & SIM_SPI_ENGINE_TRANSFER_W) && dev->sdo.len < n)
+				return;
+			sim_spi_engine_transfer(dev, rw, n);
+			break;
+		case SIM_SPI_ENGINE_INST_ASSERT:
+			if (SIM_SPI_ENGINE_ARG2(cmd) == 0xFF) {
+				if (dev->cs_active)
+					sim_spi_engine_end_frame(dev);
+				dev->cs_active = 0;
+			} else {
+				dev->cs_active = 1;
+			}
+			break;
+		case SIM_SPI_ENGINE_INST_CONFIG:
+			if (SIM_SPI_ENGINE_ARG1(cmd) ==
+			    SIM_SPI_ENGINE_CONFIG_CLK_DIV)
+				dev->clk_div = SIM_SPI_ENGINE_ARG2(cmd);
+			else if (SIM_SPI_ENGINE_ARG1(cmd) ==
+				 SIM_SPI_ENGINE_CONFIG_XFER_LEN)
+				dev->data_width = SIM_SPI_ENGINE_ARG2(cmd);
+			break;
+		case SIM_SPI_ENGINE_INST_MISC:
+			if (SIM_SPI_ENGINE_ARG1(cmd) == SIM_SPI_ENGINE_MISC_SYNC)
+				dev->sync_id = SIM_SPI_ENGINE_ARG2(cmd);
+			else
+				sim_advance_ns((uint64_t)(SIM_SPI_ENGINE_ARG2(cmd) + 1) *
+					       (dev->clk_div + 1) * 2 *
+					       1000000000ull /
+					       SIM_SPI_ENGINE_REF_CLK_HZ);
+			break;
+		}
+
+		sim_fifo_pop(&dev->cmd);
+	}
+}
+
+/**
+ * @brief Reset the engine state.
+ * @param dev - The model state.
+ * @return None.
+ */
+static void sim_spi_engine_reset(struct sim_spi_engine *dev)
+{
+	memset(&dev->cmd, 0, sizeof(dev->cmd));
+	memset(&dev->sdo, 0, sizeof(dev->sdo));
+	memset(&dev->sdi, 0, sizeof(dev->sdi));
+	dev->data_width = dev->max_data_width;
+	dev->cs_active = 0;
+	dev->frame_len = 0;
+	dev->frame_words = 0;
+}
+
+/**
+ * @brief MMIO register read.
+ * @param model - The model.
+ * @param offset - Register offset.
+ * @param data - Register value.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_spi_engine_read(struct sim_model *model, uint32_t offset,
+				   uint32_t *data)
+{
+	struct sim_spi_engine *dev = model->priv;
+
+	sim_spi_engine_run(dev);
+
+	switch (offset) {
+	case SIM_SPI_ENGINE_REG_VERSION:
+		*data = SIM_SPI_ENGINE_VERSION;
+		break;
+	case SIM_SPI_ENGINE_REG_DATA_WIDTH:
+		*data = dev->max_data_width;
+		break;
+	case SIM_SPI_ENGINE_REG_SYNC_ID:
+		*data = dev->sync_id;
+		break;
+	case SIM_SPI_ENGINE_REG_CMD_FIFO_ROOM:
+		*data = SIM_SPI_ENGINE_FIFO_DEPTH - dev->cmd.len;
+		break;
+	case SIM_SPI_ENGINE_REG_SDO_FIFO_ROOM:
+		*data = SIM_SPI_ENGINE_FIFO_DEPTH - dev->sdo.len;
+		break;
+	case SIM_SPI_ENGINE_REG_SDI_FIFO_LEVEL:
+		*data = dev->sdi.len;
+		break;
+	case SIM_SPI_ENGINE_REG_SDI_DATA_FIFO:
+		*data = sim_fifo_pop(&dev->sdi);
+		break;
+	case SIM_SPI_ENGINE_REG_SDI_PEEK:
+		*data = sim_fifo_peek(&dev->sdi);
+		break;
+	case SIM_SPI_ENGINE_REG_OFFLOAD_CTRL:
+		*data = dev->offload_ctrl;
+		break;
+	case SIM_SPI_ENGINE_REG_OFFLOAD_STATUS:
+		*data = dev->offload_ctrl & 1;
+		break;
+	default:
+		*data = 0;
+		break;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief MMIO register write. Commands are executed lazily, on the next
+ *        register read, so the whole message is interpreted at once.
+ * @param model - The model.
+ * @param offset - Register offset.
+ * @param data - Register value.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_spi_engine_write(struct sim_model *model, uint32_t offset,
+				    uint32_t data)
+{
+	struct sim_spi_engine *dev = model->priv;
+
+	switch (offset) {
+	case SIM_SPI_ENGINE_REG_RESET:
+		if (data & 1)
+			sim_spi_engine_reset(dev);
+		break;
+	case SIM_SPI_ENGINE_REG_CMD_FIFO:
+		return sim_fifo_push(&dev->cmd, data);
+	case SIM_SPI_ENGINE_REG_SDO_DATA_FIFO:
+		return sim_fifo_push(&dev->sdo, data);
+	case SIM_SPI_ENGINE_REG_OFFLOAD_CTRL:
+		dev->offload_ctrl = data;
+		break;
+	case SIM_SPI_ENGINE_REG_OFFLOAD_RESET:
+		if (data & 1) {
+			dev->offload_cmd_len = 0;
+			dev->offload_sdo_len = 0;
+		}
+		break;
+	case SIM_SPI_ENGINE_REG_OFFLOAD_CMD_MEM:
+		if (dev->offload_cmd_len == SIM_SPI_ENGINE_OFFLOAD_DEPTH)
+			return -ENOSPC;
+		dev->offload_cmd[dev->offload_cmd_len++] = data;
+		break;
+	case SIM_SPI_ENGINE_REG_OFFLOAD_SDO_MEM:
+		if (dev->offload_sdo_len == SIM_SPI_ENGINE_OFFLOAD_DEPTH)
+			return -ENOSPC;
+		dev->offload_sdo[dev->offload_sdo_len++] = data;
+		break;
+	default:
+		break;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the model state.
+ * @param model - The model.
+ * @return None.
+ */
+static void sim_spi_engine_remove(struct sim_model *model)
+{
+	free(model->priv);
+}
+
+/**
+ * @brief Create a SPI Engine model. Frames delimited by the ASSERT commands
+ *        are forwarded to the slave model; the offload memories are stored
+ *        but the offload trigger is not modeled.
+ * @param model - The created model.
+ * @param slave - Device model connected to the engine.
+ * @param data_width - Synthesized data width, in bits.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_spi_engine_model_init(struct sim_model **model,
+				  struct sim_model *slave,
+				  uint32_t data_width)
+{
+	struct sim_model *m;
+	struct sim_spi_engine *dev;
+
+	if (!data_width || data_width > 32 || data_width % 8)
+		return -EINVAL;
+
+	m = calloc(1, sizeof(*m));
+	if (!m)
+		return -ENOMEM;
+
+	dev = calloc(1, sizeof(*dev));
+	if (!dev) {
+		free(m);
+		return -ENOMEM;
+	}
+
+	dev->slave = slave;
+	dev->max_data_width = data_width;
+	sim_spi_engine_reset(dev);
+
+	m->name = "spi_engine";
+	m->mmio_read = sim_spi_engine_read;
+	m->mmio_write = sim_spi_engine_write;
+	m->remove = sim_spi_engine_remove;
+	m->size = SIM_SPI_ENGINE_SIZE;
+	m->mmio_access_ns = 100;
+	m->priv = dev;
+
+	*model = m;
+
+	return SUCCESS;
+}
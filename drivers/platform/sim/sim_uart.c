@@ -0,0 +1,268 @@
+/***************************************************************************//**
+ *   @file   sim/sim_uart.c
+ *   @brief  Implementation of the simulation platform UART.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "util.h"
+#include "sim_model.h"
+#include "sim_uart.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Start, 8 data and stop bits */
+#define SIM_UART_BITS_PER_BYTE	10
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct sim_uart_desc
+ * @brief Simulation platform specific UART descriptor. TX is captured in a
+ * buffer the bench reads back, nothing is connected to RX.
+ */
+struct sim_uart_desc {
+	/** Transmitted bytes */
+	uint8_t		*tx;
+	/** Size of tx */
+	uint32_t	tx_size;
+	/** Number of bytes in tx */
+	uint32_t	tx_len;
+	/** Bytes dropped because tx was full */
+	uint32_t	errors;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Nothing is connected to RX.
+ * @param desc - The UART descriptor.
+ * @param data - Unused.
+ * @param bytes_number - Unused.
+ * @return -ENODATA.
+ */
+int32_t uart_read(struct uart_desc *desc, uint8_t *data, uint32_t bytes_number)
+{
+	UNUSED_PARAM(data);
+	UNUSED_PARAM(bytes_number);
+
+	if (!desc)
+		return -EINVAL;
+
+	return -ENODATA;
+}
+
+/**
+ * @brief Transmit data. Simulated time advances by the time the bytes take on
+ *	  the line.
+ * @param desc - The UART descriptor.
+ * @param data - Data to transmit.
+ * @param bytes_number - Number of bytes.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t uart_write(struct uart_desc *desc, const uint8_t *data,
+		   uint32_t bytes_number)
+{
+	struct sim_uart_desc	*uart;
+	uint32_t		n;
+
+	if (!desc || !data || !desc->baud_rate)
+		return -EINVAL;
+
+	uart = desc->extra;
+	n = min_t(uint32_t, bytes_number, uart->tx_size - uart->tx_len);
+	memcpy(uart->tx + uart->tx_len, data, n);
+	uart->tx_len += n;
+	uart->errors += bytes_number - n;
+
+	sim_advance_ns((uint64_t)bytes_number * SIM_UART_BITS_PER_BYTE *
+		       1000000000 / desc->baud_rate);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Nothing is connected to RX.
+ * @param desc - The UART descriptor.
+ * @param data - Unused.
+ * @param bytes_number - Unused.
+ * @param bytes_done - Unused.
+ * @return -ENODATA.
+ */
+int32_t uart_read_nonblocking(struct uart_desc *desc, uint8_t *data,
+			      uint32_t bytes_number, uint32_t *bytes_done)
+{
+	UNUSED_PARAM(bytes_done);
+
+	return uart_read(desc, data, bytes_number);
+}
+
+/**
+ * @brief Transmit data, see uart_write().
+ * @param desc - The UART descriptor.
+ * @param data - Data to transmit.
+ * @param bytes_number - Number of bytes.
+ * @param bytes_done - Number of bytes transmitted, may be NULL.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t uart_write_nonblocking(struct uart_desc *desc, const uint8_t *data,
+			       uint32_t bytes_number, uint32_t *bytes_done)
+{
+	int32_t ret;
+
+	ret = uart_write(desc, data, bytes_number);
+	if (ret < 0)
+		return ret;
+
+	if (bytes_done)
+		*bytes_done = bytes_number;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Initialize the UART.
+ * @param desc - The UART descriptor.
+ * @param param - The structure that contains the UART parameters, extra
+ *		  points to a struct sim_uart_init_param.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
+{
+	struct sim_uart_init_param	*sim_param;
+	struct uart_desc		*descriptor;
+	struct sim_uart_desc		*uart;
+
+	if (!desc || !param || !param->extra || !param->baud_rate)
+		return -EINVAL;
+
+	sim_param = param->extra;
+
+	descriptor = calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	uart = calloc(1, sizeof(*uart));
+	if (!uart)
+		goto error_desc;
+
+	uart->tx = calloc(sim_param->tx_size ? sim_param->tx_size : 1, 1);
+	if (!uart->tx)
+		goto error_uart;
+	uart->tx_size = sim_param->tx_size;
+
+	descriptor->device_id = param->device_id;
+	descriptor->baud_rate = param->baud_rate;
+	descriptor->extra = uart;
+	*desc = descriptor;
+
+	return SUCCESS;
+
+error_uart:
+	free(uart);
+error_desc:
+	free(descriptor);
+
+	return -ENOMEM;
+}
+
+/**
+ * @brief Free the resources allocated by uart_init().
+ * @param desc - The UART descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t uart_remove(struct uart_desc *desc)
+{
+	struct sim_uart_desc *uart;
+
+	if (!desc)
+		return -EINVAL;
+
+	uart = desc->extra;
+	free(uart->tx);
+	free(uart);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Number of transmitted bytes that did not fit in the capture buffer.
+ * @param desc - The UART descriptor.
+ * @return The number of dropped bytes.
+ */
+uint32_t uart_get_errors(struct uart_desc *desc)
+{
+	struct sim_uart_desc *uart;
+
+	if (!desc)
+		return 0;
+
+	uart = desc->extra;
+
+	return uart->errors;
+}
+
+/**
+ * @brief Move the transmitted bytes out of the UART, oldest first.
+ * @param desc - The UART descriptor.
+ * @param data - Where to copy the bytes.
+ * @param size - Size of data.
+ * @return Number of bytes copied.
+ */
+uint32_t sim_uart_tx(struct uart_desc *desc, uint8_t *data, uint32_t size)
+{
+	struct sim_uart_desc	*uart = desc->extra;
+	uint32_t		n;
+
+	n = min_t(uint32_t, size, uart->tx_len);
+	memcpy(data, uart->tx, n);
+	memmove(uart->tx, uart->tx + n, uart->tx_len - n);
+	uart->tx_len -= n;
+
+	return n;
+}
@@ -75,8 +75,9 @@ static int32_t uart_fifo_insert(struct uart_desc *desc)
 		ret = irq_disable(irq_desc, xil_uart_desc->irq_id);
 		if (ret < 0)
 			return ret;
-		ret = fifo_insert(&xil_uart_desc->fifo, xil_uart_desc->buff,
-				  xil_uart_desc->bytes_received);
+		ret = fifo_insert_pool(&xil_uart_desc->fifo, xil_uart_desc->buff,
+				       xil_uart_desc->bytes_received,
+				       xil_uart_desc->fifo_pool);
 		if (ret < 0)
 			return ret;
 		xil_uart_desc->bytes_received = 0;
@@ -132,7 +133,8 @@ static int32_t uart_read_byte(struct uart_desc *desc, uint8_t *data)
 
 		if (xil_uart_desc->fifo->len - xil_uart_desc->fifo_read_offset <= 0) {
 			xil_uart_desc->fifo_read_offset = 0;
-			xil_uart_desc->fifo = fifo_remove(xil_uart_desc->fifo);
+			xil_uart_desc->fifo = fifo_remove_pool(xil_uart_desc->fifo,
+							       xil_uart_desc->fifo_pool);
 		}
 #endif // XUARTPS_H
 		break;
@@ -363,9 +365,17 @@ int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
 	switch(xil_uart_desc->type) {
 	case UART_PS:
 #ifdef XUARTPS_H
+		if (xil_uart_init_param->fifo_pool_size) {
+			status = pool_init(&xil_uart_desc->fifo_pool,
+					   sizeof(struct fifo_element) + UART_BUFF_LENGTH,
+					   xil_uart_init_param->fifo_pool_size);
+			if (status < 0)
+				goto error_free_xil_uart_desc;
+		}
+
 		xil_uart_desc->instance = calloc(1, sizeof(XUartPs));
 		if (!(xil_uart_desc->instance))
-			goto error_free_xil_uart_desc;
+			goto error_free_pool;
 		/*
 		 * Initialize the UART driver so that it's ready to use
 		 * Look up the configuration in the config table, then initialize it.
@@ -437,6 +447,11 @@ int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
 
 error_free_instance:
 	free(xil_uart_desc->instance);
+#ifdef XUARTPS_H
+error_free_pool:
+	if (xil_uart_desc->fifo_pool)
+		pool_remove(xil_uart_desc->fifo_pool);
+#endif // XUARTPS_H
 error_free_xil_uart_desc:
 	free(xil_uart_desc);
 error_free_descriptor:
@@ -453,6 +468,14 @@ error_free_descriptor:
 int32_t uart_remove(struct uart_desc *desc)
 {
 	struct xil_uart_desc *xil_uart_desc = desc->extra;
+
+#ifdef XUARTPS_H
+	while (xil_uart_desc->fifo)
+		xil_uart_desc->fifo = fifo_remove_pool(xil_uart_desc->fifo,
+						       xil_uart_desc->fifo_pool);
+	if (xil_uart_desc->fifo_pool)
+		pool_remove(xil_uart_desc->fifo_pool);
+#endif // XUARTPS_H
 	free(xil_uart_desc->instance);
 	free(xil_uart_desc);
 	free(desc);
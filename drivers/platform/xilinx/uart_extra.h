@@ -77,6 +77,11 @@ struct xil_uart_init_param {
 	uint32_t			irq_id;
 	/** Interrupt Request Descriptor */
 	struct irq_ctrl_desc *irq_desc;
+	/**
+	 * Number of preallocated receive FIFO elements, 0 to use the heap.
+	 * Only used by UART_PS.
+	 */
+	uint32_t			fifo_pool_size;
 };
 
 /**
@@ -92,6 +97,8 @@ struct xil_uart_desc {
 	struct irq_ctrl_desc *irq_desc;
 	/** FIFO */
 	struct fifo_element	*fifo;
+	/** Preallocated FIFO elements, NULL if allocated from the heap */
+	struct pool			*fifo_pool;
 	/** FIFO read offset */
 	uint32_t 			fifo_read_offset;
 	/** UART Buffer */
@@ -697,14 +697,11 @@ int32_t ad9361_spi_readm(struct spi_desc *spi, uint32_t reg,
 {
 	int32_t ret = 0;
 	uint16_t cmd;
-	uint8_t *rbuffer;
+	uint8_t rbuffer[MAX_MBYTE_SPI + 2];
 	if (num > MAX_MBYTE_SPI)
 		return -EINVAL;
 
 	cmd = AD_READ | AD_CNT(num) | AD_ADDR(reg);
-	rbuffer = malloc(num + 2);
-	if(!rbuffer)
-		return -ENOMEM;
 	rbuffer[0] = cmd >> 8;
 	rbuffer[1] = cmd & 0xFF;
 	ret = spi_write_and_read(spi, &rbuffer[0], 2 + num);
@@ -714,7 +711,6 @@ int32_t ad9361_spi_readm(struct spi_desc *spi, uint32_t reg,
 	else
 		memcpy(rbuf, &rbuffer[2], num);
 
-	free(rbuffer);
 #ifdef _DEBUG
 	{
 		int32_t i;
@@ -5709,6 +5705,116 @@ int32_t ad9361_update_rf_bandwidth(struct ad9361_rf_phy *phy,
 	return 0;
 }
 
+/*
+ * Registers making up a bandwidth profile: the BBPLL words, the clock chain
+ * dividers and filter enables, the interface delays and the results of the
+ * bandwidth dependent calibrations. The BBPLL range must stay first, it is
+ * skipped when the BBPLL rate does not change.
+ */
+static const struct {
+	uint16_t reg;
+	uint8_t cnt;
+} ad9361_profile_regs[] = {
+	{REG_FRACT_BB_FREQ_WORD_1, 6},	/* BBPLL words, scaler, CP current */
+	{REG_TX_ENABLE_FILTER_CTRL, 2},	/* HB and FIR enables */
+	{REG_RX_CLOCK_DATA_DELAY, 2},	/* Digital interface delays */
+	{REG_BBPLL, 1},			/* ADC and DAC dividers */
+	{REG_TX1_OUT_1_PHASE_CORR, 16},	/* TX quadrature calibration */
+	{REG_TX_BBF_R1, 11},		/* TX BB filter tune */
+	{REG_CONFIG0, 3},		/* TX secondary filter */
+	{REG_TX_BBF_TUNE_DIVIDER, 2},
+	{REG_RX_MIX_GM_CONFIG, 1},
+	{REG_RX_MIX_LO_CM, 1},
+	{REG_RX_TIA_CONFIG, 5},		/* RX TIA */
+	{REG_RX1_BBF_R1A, 20},		/* RX BB filter tune */
+	{REG_RX_BBF_TUNE_DIVIDE, 5},
+	{0x200, 40},			/* ADC setup */
+};
+
+/**
+ * Read the register image of the current bandwidth profile.
+ * @param phy The AD9361 state structure.
+ * @param image Buffer of AD9361_PROFILE_IMAGE_SIZE bytes.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_profile_image_read(struct ad9361_rf_phy *phy, uint8_t *image)
+{
+	uint8_t buf[MAX_MBYTE_SPI];
+	uint32_t i, j, reg, end, n;
+	int32_t ret;
+
+	for (i = 0; i < ARRAY_SIZE(ad9361_profile_regs); i++) {
+		reg = ad9361_profile_regs[i].reg;
+		end = reg + ad9361_profile_regs[i].cnt;
+		while (reg < end) {
+			/* Multi-byte accesses count down from the given address */
+			n = min_t(uint32_t, end - reg, MAX_MBYTE_SPI);
+			ret = ad9361_spi_readm(phy->spi, reg + n - 1, buf, n);
+			if (ret < 0)
+				return ret;
+			for (j = 0; j < n; j++)
+				*image++ = buf[n - 1 - j];
+			reg += n;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Write a register image read with ad9361_profile_image_read().
+ * The ENSM must be in the ALERT state.
+ * @param phy The AD9361 state structure.
+ * @param image Buffer of AD9361_PROFILE_IMAGE_SIZE bytes.
+ * @param bbpll_relock Set true, if the BBPLL rate changes.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_profile_image_write(struct ad9361_rf_phy *phy,
+				   const uint8_t *image, bool bbpll_relock)
+{
+	uint8_t buf[MAX_MBYTE_SPI];
+	uint32_t i, j, reg, end, n;
+	int32_t ret;
+
+	for (i = 0; i < ARRAY_SIZE(ad9361_profile_regs); i++) {
+		reg = ad9361_profile_regs[i].reg;
+		end = reg + ad9361_profile_regs[i].cnt;
+		if (i == 0 && !bbpll_relock) {
+			image += ad9361_profile_regs[i].cnt;
+			continue;
+		}
+		while (reg < end) {
+			n = min_t(uint32_t, end - reg, MAX_MBYTE_SPI);
+			for (j = 0; j < n; j++)
+				buf[n - 1 - j] = *image++;
+			ret = ad9361_spi_writem(phy->spi, reg + n - 1, buf, n);
+			if (ret < 0)
+				return ret;
+			reg += n;
+		}
+
+		if (i == 0) {
+			/* Same sequence as ad9361_bbpll_set_rate() */
+			ad9361_spi_write(phy->spi, REG_SDM_CTRL_1,
+					 INIT_BB_FO_CAL | BBPLL_RESET_BAR);
+			ad9361_spi_write(phy->spi, REG_SDM_CTRL_1, BBPLL_RESET_BAR);
+			ad9361_spi_write(phy->spi, REG_VCO_PROGRAM_1, 0x86);
+			ad9361_spi_write(phy->spi, REG_VCO_PROGRAM_2, 0x01);
+			ad9361_spi_write(phy->spi, REG_VCO_PROGRAM_2, 0x05);
+			ret = ad9361_check_cal_done(phy, REG_CH_1_OVERFLOW,
+						    BBPLL_LOCK, 1);
+			if (ret < 0)
+				return ret;
+		}
+	}
+
+	/* Parents come first, refresh the cached rates in enum order */
+	for (i = BBPLL_CLK; i <= TX_SAMPL_CLK; i++)
+		phy->clks[i]->rate = clk_get_rate(phy, phy->ref_clk_scale[i]);
+
+	return ad9361_bb_clk_change_handler(phy);
+}
+
 /**
  * Verify the FIR filter coefficients.
  * @param phy The AD9361 state structure.
@@ -3319,6 +3319,18 @@ enum dig_tune_flags {
 	RESTORE_DEFAULT = 32,
 };
 
+#define AD9361_DIG_TUNE_CACHE_SIZE	8
+
+struct ad9361_dig_tune_result {
+	uint32_t	rate;			/* RX sampling rate in Hz */
+	uint8_t		mode;			/* LVDS, 2R2T and FIR enable bits */
+	uint8_t		rx_clk_data_delay;	/* REG_RX_CLOCK_DATA_DELAY */
+	uint8_t		tx_clk_data_delay;	/* REG_TX_CLOCK_DATA_DELAY */
+};
+
+/* Bytes captured by ad9361_profile_image_read() */
+#define AD9361_PROFILE_IMAGE_SIZE	115
+
 enum ad9361_bist_mode {
 	BIST_DISABLE,
 	BIST_INJ_TX,
@@ -3416,6 +3428,9 @@ struct ad9361_rf_phy {
 	uint32_t				bist_tone_level_dB;
 	uint32_t				bist_tone_mask;
 	bool			bbpll_initialized;
+	struct ad9361_dig_tune_result	dig_tune_cache[AD9361_DIG_TUNE_CACHE_SIZE];
+	uint8_t			dig_tune_cache_cnt;
+	uint8_t			dig_tune_cache_next;
 };
 
 struct refclk_scale {
@@ -3550,6 +3565,9 @@ int32_t ad9361_dig_interface_timing_analysis(struct ad9361_rf_phy *phy,
 		char *buf, int32_t buflen);
 int32_t ad9361_dig_tune(struct ad9361_rf_phy *phy, uint32_t max_freq,
 			enum dig_tune_flags flags);
+int32_t ad9361_profile_image_read(struct ad9361_rf_phy *phy, uint8_t *image);
+int32_t ad9361_profile_image_write(struct ad9361_rf_phy *phy,
+				   const uint8_t *image, bool bbpll_relock);
 int32_t ad9361_en_dis_tx(struct ad9361_rf_phy *phy, uint32_t tx_if,
 			 uint32_t enable);
 int32_t ad9361_en_dis_rx(struct ad9361_rf_phy *phy, uint32_t rx_if,
@@ -543,6 +543,10 @@ int32_t ad9361_init (struct ad9361_rf_phy **ad9361_phy,
 	phy->ad9361_rfpll_ext_round_rate = init_param->ad9361_rfpll_ext_round_rate;
 	phy->ad9361_rfpll_ext_set_rate = init_param->ad9361_rfpll_ext_set_rate;
 
+	if (init_param->dig_tune_cache)
+		ad9361_set_dig_tune_cache(phy, init_param->dig_tune_cache,
+					  init_param->dig_tune_cache_cnt);
+
 	ret = ad9361_register_clocks(phy);
 	if (ret < 0)
 		goto out;
@@ -2213,3 +2217,173 @@ int32_t ad9361_get_temperature(struct ad9361_rf_phy *phy,
 
 	return 0;
 }
+
+/**
+ * Get the cached digital interface tuning results.
+ *
+ * The results can be saved in non-volatile memory and passed to the next
+ * ad9361_init() in AD9361_InitParam.dig_tune_cache, so the interface timing
+ * is only checked instead of being searched again.
+ * @param phy The AD9361 current state structure.
+ * @param results Buffer of AD9361_DIG_TUNE_CACHE_SIZE entries.
+ * @param count Number of entries stored in results.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_get_dig_tune_cache(struct ad9361_rf_phy *phy,
+				  struct ad9361_dig_tune_result *results,
+				  uint8_t *count)
+{
+	if (!results || !count)
+		return -EINVAL;
+
+	memcpy(results, phy->dig_tune_cache,
+	       phy->dig_tune_cache_cnt * sizeof(*results));
+	*count = phy->dig_tune_cache_cnt;
+
+	return 0;
+}
+
+/**
+ * Set the cached digital interface tuning results.
+ * @param phy The AD9361 current state structure.
+ * @param results Results saved with ad9361_get_dig_tune_cache().
+ * @param count Number of entries in results. Only the first
+ * 		AD9361_DIG_TUNE_CACHE_SIZE are used.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_set_dig_tune_cache(struct ad9361_rf_phy *phy,
+				  const struct ad9361_dig_tune_result *results,
+				  uint8_t count)
+{
+	if (!results && count)
+		return -EINVAL;
+
+	if (count > AD9361_DIG_TUNE_CACHE_SIZE)
+		count = AD9361_DIG_TUNE_CACHE_SIZE;
+
+	if (count)
+		memcpy(phy->dig_tune_cache, results, count * sizeof(*results));
+	phy->dig_tune_cache_cnt = count;
+	phy->dig_tune_cache_next = count % AD9361_DIG_TUNE_CACHE_SIZE;
+
+	return 0;
+}
+
+/**
+ * Save the current sampling rate, FIR and bandwidth setup as a profile.
+ *
+ * The profile holds the FIR coefficients and a register image with the
+ * results of the clock chain, BBPLL and bandwidth calibrations, so switching
+ * back to it does not redo the math and calibrations. It has no pointers and
+ * can be stored as is. Calibration results drift with temperature, save the
+ * profiles again if it changes significantly.
+ * @param phy The AD9361 current state structure.
+ * @param profile The profile to fill.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_save_profile(struct ad9361_rf_phy *phy,
+			    AD9361_Profile *profile)
+{
+	int32_t ret;
+
+	if (!profile)
+		return -EINVAL;
+
+	memset(profile, 0, sizeof(*profile));
+
+	profile->rx_fir_en = !phy->bypass_rx_fir;
+	if (profile->rx_fir_en) {
+		ret = ad9361_get_rx_fir_config(phy, RX1, &profile->rx_fir);
+		if (ret < 0)
+			return ret;
+		profile->rx_fir.rx = 3;
+	}
+
+	profile->tx_fir_en = !phy->bypass_tx_fir;
+	if (profile->tx_fir_en) {
+		ret = ad9361_get_tx_fir_config(phy, TX1, &profile->tx_fir);
+		if (ret < 0)
+			return ret;
+		profile->tx_fir.tx = 3;
+	}
+
+	memcpy(profile->rx_path_clks, phy->current_rx_path_clks,
+	       sizeof(profile->rx_path_clks));
+	memcpy(profile->tx_path_clks, phy->current_tx_path_clks,
+	       sizeof(profile->tx_path_clks));
+	profile->rx_rf_bandwidth = phy->current_rx_bw_Hz;
+	profile->tx_rf_bandwidth = phy->current_tx_bw_Hz;
+
+	return ad9361_profile_image_read(phy, profile->image);
+}
+
+/**
+ * Apply a profile saved with ad9361_save_profile().
+ * @param phy The AD9361 current state structure.
+ * @param profile The profile.
+ * @return 0 in case of success, negative error code otherwise.
+ *
+ * Note: This function will/may affect the data path.
+ */
+int32_t ad9361_apply_profile(struct ad9361_rf_phy *phy,
+			     const AD9361_Profile *profile)
+{
+	bool bypass_rx_fir, bypass_tx_fir;
+	bool bbpll_relock;
+	int32_t ret;
+
+	if (!profile)
+		return -EINVAL;
+
+	/* The FIR load handles the ENSM state on its own */
+	if (profile->rx_fir_en) {
+		ret = ad9361_set_rx_fir_config(phy, profile->rx_fir);
+		if (ret < 0)
+			return ret;
+	}
+
+	if (profile->tx_fir_en) {
+		ret = ad9361_set_tx_fir_config(phy, profile->tx_fir);
+		if (ret < 0)
+			return ret;
+	}
+
+	ret = ad9361_tracking_control(phy, false, false, false);
+	if (ret < 0)
+		return ret;
+
+	ad9361_ensm_force_state(phy, ENSM_STATE_ALERT);
+
+	bypass_rx_fir = phy->bypass_rx_fir;
+	bypass_tx_fir = phy->bypass_tx_fir;
+	phy->bypass_rx_fir = !profile->rx_fir_en;
+	phy->bypass_tx_fir = !profile->tx_fir_en;
+
+	bbpll_relock = profile->rx_path_clks[BBPLL_FREQ] !=
+		       phy->current_rx_path_clks[BBPLL_FREQ];
+	ret = ad9361_profile_image_write(phy, profile->image, bbpll_relock);
+	if (ret < 0) {
+		phy->bypass_rx_fir = bypass_rx_fir;
+		phy->bypass_tx_fir = bypass_tx_fir;
+		ad9361_tracking_control(phy, phy->bbdc_track_en,
+					phy->rfdc_track_en, phy->quad_track_en);
+		ad9361_ensm_restore_prev_state(phy);
+		return ret;
+	}
+
+	memcpy(phy->current_rx_path_clks, profile->rx_path_clks,
+	       sizeof(phy->current_rx_path_clks));
+	memcpy(phy->current_tx_path_clks, profile->tx_path_clks,
+	       sizeof(phy->current_tx_path_clks));
+	phy->current_rx_bw_Hz = profile->rx_rf_bandwidth;
+	phy->current_tx_bw_Hz = profile->tx_rf_bandwidth;
+
+	ret = ad9361_tracking_control(phy, phy->bbdc_track_en,
+				      phy->rfdc_track_en, phy->quad_track_en);
+	if (ret < 0)
+		return ret;
+
+	ad9361_ensm_restore_prev_state(phy);
+
+	return 0;
+}
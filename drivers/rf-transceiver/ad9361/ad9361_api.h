@@ -297,6 +297,9 @@ typedef struct {
 	struct axi_adc_init	*rx_adc_init;
 	struct axi_dac_init	*tx_dac_init;
 #endif
+	/* Digital interface tuning results to replay, see ad9361_get_dig_tune_cache() */
+	struct ad9361_dig_tune_result	*dig_tune_cache;
+	uint8_t		dig_tune_cache_cnt;
 } AD9361_InitParam;
 
 typedef struct {
@@ -319,6 +322,19 @@ typedef struct {
 	uint32_t	tx_bandwidth;
 } AD9361_TXFIRConfig;
 
+/* Precomputed bandwidth profile, see ad9361_save_profile() */
+typedef struct {
+	AD9361_RXFIRConfig	rx_fir;
+	AD9361_TXFIRConfig	tx_fir;
+	uint8_t		rx_fir_en;
+	uint8_t		tx_fir_en;
+	uint32_t	rx_path_clks[6];
+	uint32_t	tx_path_clks[6];
+	uint32_t	rx_rf_bandwidth;
+	uint32_t	tx_rf_bandwidth;
+	uint8_t		image[AD9361_PROFILE_IMAGE_SIZE];
+} AD9361_Profile;
+
 enum ad9361_ensm_mode {
 	ENSM_MODE_TX,
 	ENSM_MODE_RX,
@@ -554,4 +570,18 @@ int32_t ad9361_do_dcxo_tune_fine(struct ad9361_rf_phy *phy,
 /* Get the temperature. */
 int32_t ad9361_get_temperature(struct ad9361_rf_phy *phy,
 			       int32_t *temp);
+/* Get the cached digital interface tuning results. */
+int32_t ad9361_get_dig_tune_cache(struct ad9361_rf_phy *phy,
+				  struct ad9361_dig_tune_result *results,
+				  uint8_t *count);
+/* Set the cached digital interface tuning results. */
+int32_t ad9361_set_dig_tune_cache(struct ad9361_rf_phy *phy,
+				  const struct ad9361_dig_tune_result *results,
+				  uint8_t count);
+/* Save the current sampling rate, FIR and bandwidth setup as a profile. */
+int32_t ad9361_save_profile(struct ad9361_rf_phy *phy,
+			    AD9361_Profile *profile);
+/* Apply a profile saved with ad9361_save_profile(). */
+int32_t ad9361_apply_profile(struct ad9361_rf_phy *phy,
+			     const AD9361_Profile *profile);
 #endif
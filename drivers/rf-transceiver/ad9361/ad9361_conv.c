@@ -60,6 +60,9 @@
 #define PCORE_VERSION_MINOR(version)	((version >> 8) & 0xff)
 #define PCORE_VERSION_LETTER(version)	(version & 0xff)
 
+/* Step of the first pass of the delay search, must divide 15 */
+#define DIG_TUNE_COARSE_STEP	3
+
 /**
  * Get the number of PHY channels.
  * @return The number of PHY channels.
@@ -347,29 +350,133 @@ int32_t ad9361_dig_interface_timing_analysis(struct ad9361_rf_phy *phy,
 	return len;
 }
 
+/**
+ * Check one point of a digital tune row.
+ * @param phy The AD9361 state structure.
+ * @param tx Set if TX.
+ * @param row 0: clock delay = 0, data delay = pos;
+ * 	      1: clock delay = 15, data delay = 15 - pos.
+ * @param pos Position in the row.
+ * @param first Set for the first point of the row, cleared on return.
+ * @return 0 if the PN check passed, 1 otherwise.
+ */
+static uint8_t ad9361_dig_tune_point(struct ad9361_rf_phy *phy, bool tx,
+				     uint32_t row, uint32_t pos, bool *first)
+{
+	ad9361_set_intf_delay(phy, tx, row ? 15 : 0, row ? 15 - pos : pos,
+			      *first);
+	*first = false;
+
+	return ad9361_check_pn(phy, tx, 4);
+}
+
+/**
+ * Digital tune row search.
+ *
+ * The row is sampled every DIG_TUNE_COARSE_STEP positions first. The edges
+ * of the widest passing window are then found with a binary search between
+ * the coarse points, which assumes a single window per row like the one
+ * produced by the interface timing. If no coarse point passes, the whole
+ * row is checked.
+ * @param phy The AD9361 state structure.
+ * @param tx Set if TX.
+ * @param row Row to search, see ad9361_dig_tune_point().
+ * @param field Result for each of the 16 positions, 0 if passing.
+ * @return None.
+ */
+static void ad9361_dig_tune_row(struct ad9361_rf_phy *phy, bool tx,
+				uint32_t row, uint8_t *field)
+{
+	const uint32_t nb = 15 / DIG_TUNE_COARSE_STEP + 1;
+	uint32_t start, cnt, left, right, lo, hi, mid, k;
+	uint8_t coarse[16];
+	bool first = true;
+
+	for (k = 0; k < nb; k++)
+		coarse[k] = ad9361_dig_tune_point(phy, tx, row,
+						  k * DIG_TUNE_COARSE_STEP,
+						  &first);
+
+	cnt = ad9361_find_opt(coarse, nb, &start);
+	if (!cnt) {
+		for (k = 0; k < 16; k++)
+			field[k] = ad9361_dig_tune_point(phy, tx, row, k,
+							 &first);
+		return;
+	}
+
+	left = start * DIG_TUNE_COARSE_STEP;
+	if (start) {
+		lo = left - DIG_TUNE_COARSE_STEP;
+		hi = left;
+		while (hi - lo > 1) {
+			mid = (lo + hi) / 2;
+			if (ad9361_dig_tune_point(phy, tx, row, mid, &first))
+				lo = mid;
+			else
+				hi = mid;
+		}
+		left = hi;
+	}
+
+	right = (start + cnt - 1) * DIG_TUNE_COARSE_STEP;
+	if (start + cnt < nb) {
+		lo = right;
+		hi = right + DIG_TUNE_COARSE_STEP;
+		while (hi - lo > 1) {
+			mid = (lo + hi) / 2;
+			if (ad9361_dig_tune_point(phy, tx, row, mid, &first))
+				hi = mid;
+			else
+				lo = mid;
+		}
+		right = lo;
+	}
+
+	for (k = 0; k < 16; k++)
+		field[k] = (k < left || k > right);
+}
+
 /**
  * Digital tune delay.
+ *
+ * A cached delay is applied and checked first. Without it, or if the check
+ * fails, the delays are searched: with the fast row search for the current
+ * rate, or exhaustively over the test rates when max_freq is set.
  * @param phy The AD9361 state structure.
  * @param max_freq Maximum frequency.
  * @param flags Flags: BE_VERBOSE, BE_MOREVERBOSE, DO_IDELAY, DO_ODELAY.
  * @param tx Set if TX.
+ * @param cached Clock/data delay register value to try, negative if none.
  * @return 0 in case of success, negative error code otherwise.
  */
 static int32_t ad9361_dig_tune_delay(struct ad9361_rf_phy *phy,
-		uint32_t max_freq, enum dig_tune_flags flags, bool tx)
+		uint32_t max_freq, enum dig_tune_flags flags, bool tx,
+		int32_t cached)
 {
 	static const uint32_t rates[3] = {25000000U, 40000000U, 61440000U};
 	uint32_t s0, s1, c0, c1;
 	uint32_t i, j, r;
 	bool half_data_rate;
+	bool fast = !max_freq;
 	uint8_t field[2][16];
 
+	if (cached >= 0) {
+		ad9361_set_intf_delay(phy, tx, (cached >> 4) & 0xF,
+				      cached & 0xF, true);
+		if (!ad9361_check_pn(phy, tx, 4))
+			return 0;
+		dev_dbg(&phy->spi->dev, "%s: cached %s delay failed", __func__,
+			tx ? "TX" : "RX");
+	}
+
 	if (((phy->pdata->port_ctrl.pp_conf[2] & LVDS_MODE) ||
 	    !phy->pdata->rx2tx2))
 	    half_data_rate = false;
 	else
 	    half_data_rate = true;
 
+retry:
 	memset(field, 0, 32);
 	for (r = 0; r < (max_freq ? ARRAY_SIZE(rates) : 1); r++) {
 		if (max_freq)
@@ -377,6 +484,10 @@ static int32_t ad9361_dig_tune_delay(struct ad9361_rf_phy *phy,
 				half_data_rate ? rates[r] / 2 : rates[r]);
 
 		for (i = 0; i < 2; i++) {
+			if (fast) {
+				ad9361_dig_tune_row(phy, tx, i, field[i]);
+				continue;
+			}
 			for (j = 0; j < 16; j++) {
 				/*
 				 * i == 0: clock delay = 0, data delay from 0 to 15
@@ -413,6 +524,12 @@ static int32_t ad9361_dig_tune_delay(struct ad9361_rf_phy *phy,
 	else
 		ad9361_set_intf_delay(phy, tx, 0, s0 + c0 / 2, true);
 
+	/* The fast search interpolates the window, confirm the setting */
+	if (fast && ad9361_check_pn(phy, tx, 4)) {
+		fast = false;
+		goto retry;
+	}
+
 	return 0;
 }
 
@@ -421,10 +538,11 @@ static int32_t ad9361_dig_tune_delay(struct ad9361_rf_phy *phy,
  * @param phy The AD9361 state structure.
  * @param max_freq Maximum frequency.
  * @param flags Flags: BE_VERBOSE, BE_MOREVERBOSE, DO_IDELAY, DO_ODELAY.
+ * @param cached Cached RX clock/data delay, negative if none.
  * @return 0 in case of success, negative error code otherwise.
  */
 static int32_t ad9361_dig_tune_rx(struct ad9361_rf_phy *phy, uint32_t max_freq,
-			      enum dig_tune_flags flags)
+			      enum dig_tune_flags flags, int32_t cached)
 {
 	struct axi_adc *rx_adc = phy->rx_adc;
 	int32_t ret;
@@ -432,7 +550,7 @@ static int32_t ad9361_dig_tune_rx(struct ad9361_rf_phy *phy, uint32_t max_freq,
 	ad9361_bist_loopback(phy, 0);
 	ad9361_bist_prbs(phy, BIST_INJ_RX);
 
-	ret = ad9361_dig_tune_delay(phy, max_freq, flags, false);
+	ret = ad9361_dig_tune_delay(phy, max_freq, flags, false, cached);
 	if (flags & DO_IDELAY)
 		ad9361_dig_tune_iodelay(phy, false);
 
@@ -447,10 +565,11 @@ static int32_t ad9361_dig_tune_rx(struct ad9361_rf_phy *phy, uint32_t max_freq,
  * @param phy The AD9361 state structure.
  * @param max_freq Maximum frequency.
  * @param flags Flags: BE_VERBOSE, BE_MOREVERBOSE, DO_IDELAY, DO_ODELAY.
+ * @param cached Cached TX clock/data delay, negative if none.
  * @return 0 in case of success, negative error code otherwise.
  */
 static int32_t ad9361_dig_tune_tx(struct ad9361_rf_phy *phy, uint32_t max_freq,
-			      enum dig_tune_flags flags)
+			      enum dig_tune_flags flags, int32_t cached)
 {
 	struct axiadc_converter *conv = phy->adc_conv;
 	struct axi_adc *rx_adc = phy->rx_adc;
@@ -491,7 +610,7 @@ static int32_t ad9361_dig_tune_tx(struct ad9361_rf_phy *phy, uint32_t max_freq,
 		axi_adc_write(rx_adc, 0x4048, tmp);
 	}
 
-	ret = ad9361_dig_tune_delay(phy, max_freq, flags, true);
+	ret = ad9361_dig_tune_delay(phy, max_freq, flags, true, cached);
 	if (flags & DO_ODELAY)
 		ad9361_dig_tune_iodelay(phy, true);
 
@@ -514,8 +633,79 @@ static int32_t ad9361_dig_tune_tx(struct ad9361_rf_phy *phy, uint32_t max_freq,
 	return ret;
 }
 
+/**
+ * Digital tune cache key for the current interface mode.
+ * @param phy The AD9361 state structure.
+ * @return The interface mode.
+ */
+static uint8_t ad9361_dig_tune_mode(struct ad9361_rf_phy *phy)
+{
+	uint8_t mode = 0;
+
+	if (phy->pdata->port_ctrl.pp_conf[2] & LVDS_MODE)
+		mode |= 1;
+	if (phy->pdata->rx2tx2)
+		mode |= 2;
+	/* The FIR filters change the interface timing */
+	if (!(phy->bypass_tx_fir && phy->bypass_rx_fir))
+		mode |= 4;
+
+	return mode;
+}
+
+/**
+ * Find the digital tune result for the current rate and interface mode.
+ * @param phy The AD9361 state structure.
+ * @return The cached result or NULL if not found.
+ */
+static struct ad9361_dig_tune_result *ad9361_dig_tune_cache_find(
+	struct ad9361_rf_phy *phy)
+{
+	uint32_t rate = phy->current_rx_path_clks[RX_SAMPL_FREQ];
+	uint8_t mode = ad9361_dig_tune_mode(phy);
+	uint32_t i;
+
+	for (i = 0; i < phy->dig_tune_cache_cnt; i++)
+		if (phy->dig_tune_cache[i].rate == rate &&
+		    phy->dig_tune_cache[i].mode == mode)
+			return &phy->dig_tune_cache[i];
+
+	return NULL;
+}
+
+/**
+ * Store the digital tune result for the current rate and interface mode.
+ * When the cache is full the oldest entry is replaced.
+ * @param phy The AD9361 state structure.
+ * @param rx_delay RX clock/data delay.
+ * @param tx_delay TX clock/data delay.
+ * @return None.
+ */
+static void ad9361_dig_tune_cache_store(struct ad9361_rf_phy *phy,
+					uint8_t rx_delay, uint8_t tx_delay)
+{
+	struct ad9361_dig_tune_result *entry;
+
+	entry = ad9361_dig_tune_cache_find(phy);
+	if (!entry) {
+		entry = &phy->dig_tune_cache[phy->dig_tune_cache_next];
+		phy->dig_tune_cache_next = (phy->dig_tune_cache_next + 1) %
+					   AD9361_DIG_TUNE_CACHE_SIZE;
+		if (phy->dig_tune_cache_cnt < AD9361_DIG_TUNE_CACHE_SIZE)
+			phy->dig_tune_cache_cnt++;
+		entry->rate = phy->current_rx_path_clks[RX_SAMPL_FREQ];
+		entry->mode = ad9361_dig_tune_mode(phy);
+	}
+
+	entry->rx_clk_data_delay = rx_delay;
+	entry->tx_clk_data_delay = tx_delay;
+}
+
 /**
  * Digital tune.
+ *
+ * Results for the current rate are cached per interface mode, so switching
+ * back to a known rate only checks the cached delays.
  * @param phy The AD9361 state structure.
  * @param max_freq Maximum frequency.
  * @param flags Flags: BE_VERBOSE, BE_MOREVERBOSE, DO_IDELAY, DO_ODELAY.
@@ -526,7 +716,9 @@ int32_t ad9361_dig_tune(struct ad9361_rf_phy *phy, uint32_t max_freq,
 {
 	struct axiadc_converter *conv = phy->adc_conv;
 	struct axi_adc *rx_adc = phy->rx_adc;
+	struct ad9361_dig_tune_result *cached = NULL;
 	uint32_t loopback, bist, ensm_state;
+	uint8_t rx_delay, tx_delay;
 	bool restore = false;
 	int32_t ret = 0;
 
@@ -558,9 +750,14 @@ int32_t ad9361_dig_tune(struct ad9361_rf_phy *phy, uint32_t max_freq,
 		if (flags & DO_ODELAY)
 			ad9361_midscale_iodelay(phy, true);
 
-		ret = ad9361_dig_tune_rx(phy, max_freq, flags);
+		if (!max_freq && !(flags & (DO_IDELAY | DO_ODELAY)))
+			cached = ad9361_dig_tune_cache_find(phy);
+
+		ret = ad9361_dig_tune_rx(phy, max_freq, flags,
+					 cached ? cached->rx_clk_data_delay : -1);
 		if (ret == 0 && !phy->pdata->dig_interface_tune_skipmode)
-			ret = ad9361_dig_tune_tx(phy, max_freq, flags);
+			ret = ad9361_dig_tune_tx(phy, max_freq, flags,
+						 cached ? cached->tx_clk_data_delay : -1);
 
 		ad9361_bist_loopback(phy, loopback);
 		ad9361_spi_write(phy->spi, REG_BIST_CONFIG, bist);
@@ -577,11 +774,15 @@ int32_t ad9361_dig_tune(struct ad9361_rf_phy *phy, uint32_t max_freq,
 				phy->pdata->port_ctrl.rx_clk_data_delay);
 		ad9361_spi_write(phy->spi, REG_TX_CLOCK_DATA_DELAY,
 				phy->pdata->port_ctrl.tx_clk_data_delay);
-	} else if (!(flags & SKIP_STORE_RESULT)) {
-		phy->pdata->port_ctrl.rx_clk_data_delay =
-			ad9361_spi_read(phy->spi, REG_RX_CLOCK_DATA_DELAY);
-		phy->pdata->port_ctrl.tx_clk_data_delay =
-			ad9361_spi_read(phy->spi, REG_TX_CLOCK_DATA_DELAY);
+	} else {
+		rx_delay = ad9361_spi_read(phy->spi, REG_RX_CLOCK_DATA_DELAY);
+		tx_delay = ad9361_spi_read(phy->spi, REG_TX_CLOCK_DATA_DELAY);
+		if (!max_freq)
+			ad9361_dig_tune_cache_store(phy, rx_delay, tx_delay);
+		if (!(flags & SKIP_STORE_RESULT)) {
+			phy->pdata->port_ctrl.rx_clk_data_delay = rx_delay;
+			phy->pdata->port_ctrl.tx_clk_data_delay = tx_delay;
+		}
 	}
 
 	if (!phy->pdata->fdd)
@@ -58,7 +58,8 @@
 #define ACMD(x)				(CMD(x) | BIT_APPLICATION_CMD)
 
 #define CMD0_RETRY_NUMBER		(5u)
-#define WAIT_RESP_TIMEOUT		(1000u) //1000ms
+#define WAIT_RESP_TIMEOUT_US		(1000000u) //1000ms
+#define POLL_MAX_BACKOFF_US		(64u)
 
 #define R1_READY_STATE			(0x00u)
 #define R1_IDLE_STATE			(0x01u)
@@ -92,30 +93,68 @@
 /******************************************************************************/
 
 /**
- * Read SD card bytes until one is different from 0xFF
+ * Clock bursts of 0xFF to the SD card until it sends a byte different from
+ * idle. The bytes following it in the burst are kept for read_bytes().
+ * Polling starts back to back and backs off up to POLL_MAX_BACKOFF_US
+ * between bursts, the timeout accounts for both the bursts and the delays.
  * @param sd_desc	- Instance of the SD card
- * @param data_out	- The read bytes is wrote here
+ * @param idle		- Value sent by the SD card while it is not ready
+ * @param data_out	- The first byte different from idle is wrote here
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
-static int32_t wait_for_response(struct sd_desc *sd_desc, uint8_t *data_out)
+static int32_t poll_card(struct sd_desc *sd_desc, uint8_t idle,
+			 uint8_t *data_out)
 {
-	uint32_t	not_timeout;
-	int32_t		ret;
+	uint32_t	elapsed_us;
+	uint32_t	burst_us;
+	uint32_t	backoff_us;
 
-	ret = FAILURE;
-	not_timeout = WAIT_RESP_TIMEOUT;
-	do {
-		if (SUCCESS != spi_write_and_read(sd_desc->spi_desc,
-						  data_out, 1))
-			break;
-		if (*data_out != 0xFF) {
-			ret = SUCCESS;
-			break;
+	burst_us = 1;
+	if (sd_desc->spi_desc->max_speed_hz)
+		burst_us += (POLL_BURST_LEN * 8000000u) /
+			    sd_desc->spi_desc->max_speed_hz;
+
+	elapsed_us = 0;
+	backoff_us = 0;
+	while (true) {
+		while (sd_desc->poll_idx < sd_desc->poll_len) {
+			*data_out = sd_desc->poll_buff[sd_desc->poll_idx++];
+			if (*data_out != idle)
+				return SUCCESS;
 		}
-		mdelay(1);
-	} while (not_timeout--);
 
-	return ret;
+		if (elapsed_us >= WAIT_RESP_TIMEOUT_US)
+			return FAILURE;
+		if (backoff_us)
+			udelay(backoff_us);
+
+		memset(sd_desc->poll_buff, 0xFF, POLL_BURST_LEN);
+		sd_desc->poll_idx = 0;
+		sd_desc->poll_len = 0;
+		if (SUCCESS != spi_write_and_read(sd_desc->spi_desc,
+						  sd_desc->poll_buff,
+						  POLL_BURST_LEN))
+			return FAILURE;
+		sd_desc->poll_len = POLL_BURST_LEN;
+
+		elapsed_us += burst_us + backoff_us;
+		if (!backoff_us)
+			backoff_us = 1;
+		else if (backoff_us < POLL_MAX_BACKOFF_US)
+			backoff_us <<= 1;
+	}
+}
+
+/**
+ * Read SD card bytes until one is different from 0xFF
+ * @param sd_desc	- Instance of the SD card
+ * @param data_out	- The read bytes is wrote here
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static inline int32_t wait_for_response(struct sd_desc *sd_desc,
+					uint8_t *data_out)
+{
+	return poll_card(sd_desc, 0xFF, data_out);
 }
 
 /**
@@ -123,26 +162,46 @@ static int32_t wait_for_response(struct sd_desc *sd_desc, uint8_t *data_out)
  * @param sd_desc - Instance of the SD card
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
-static int32_t wait_until_not_busy(struct sd_desc *sd_desc)
+static inline int32_t wait_until_not_busy(struct sd_desc *sd_desc)
 {
-	uint32_t	not_timeout;
-	int32_t		ret;
 	uint8_t		data;
 
-	ret = FAILURE;
-	not_timeout = WAIT_RESP_TIMEOUT;
-	do {
-		data = 0xFF;
-		if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, &data, 1))
-			break;
-		if (data != 0x00) {
-			ret = SUCCESS;
-			break;
-		}
-		mdelay(1);
-	} while (not_timeout--);
+	return poll_card(sd_desc, 0x00, &data);
+}
 
-	return ret;
+/**
+ * Read bytes from the SD card, starting with the ones left by the last
+ * polling burst
+ * @param sd_desc	- Instance of the SD card
+ * @param data		- Where the bytes will be read
+ * @param len		- Number of bytes to read
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t read_bytes(struct sd_desc *sd_desc, uint8_t *data, uint32_t len)
+{
+	uint32_t	left;
+
+	left = sd_desc->poll_len - sd_desc->poll_idx;
+	if (left > len)
+		left = len;
+	memcpy(data, sd_desc->poll_buff + sd_desc->poll_idx, left);
+	sd_desc->poll_idx += left;
+	if (left == len)
+		return SUCCESS;
+
+	memset(data + left, 0xFF, len - left);
+	return spi_write_and_read(sd_desc->spi_desc, data + left, len - left);
+}
+
+/**
+ * Drop the bytes left by the last polling burst. Called before sending
+ * anything, when they can only be fill bytes.
+ * @param sd_desc	- Instance of the SD card
+ */
+static inline void drop_polled_bytes(struct sd_desc *sd_desc)
+{
+	sd_desc->poll_idx = 0;
+	sd_desc->poll_len = 0;
 }
 
 /**
@@ -182,6 +241,7 @@ static int32_t send_command(struct sd_desc *sd_desc, struct cmd_desc *cmd_desc)
 	}
 
 	/* Prepare command in buffer */
+	drop_polled_bytes(sd_desc);
 	memset((uint8_t *)sd_desc->buff, 0xFF, CMD_LEN);
 	sd_desc->buff[1] = cmd_desc->cmd & (~BIT_APPLICATION_CMD);	/* Set cmd */
 	sd_desc->buff[2] = (cmd_desc->arg >> 24) & 0xff;		/* Set argument */
@@ -197,30 +257,37 @@ static int32_t send_command(struct sd_desc *sd_desc, struct cmd_desc *cmd_desc)
 	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, CMD_LEN))
 		return FAILURE;
 
+	/* Skip the stuff byte sent after CMD12 */
+	if (cmd_desc->cmd == CMD(12) &&
+	    SUCCESS != read_bytes(sd_desc, cmd_desc->response, 1))
+		return FAILURE;
+
 	/* Read response */
 	if (SUCCESS != wait_for_response(sd_desc, cmd_desc->response))
 		return FAILURE;
-	if (cmd_desc->response_len - 1 > 0) {
-		memset(cmd_desc->response + 1, 0xFF, cmd_desc->response_len - 1);
-		if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, cmd_desc->response + 1,
-						  cmd_desc->response_len - 1))
+	if (cmd_desc->response_len - 1 > 0)
+		if (SUCCESS != read_bytes(sd_desc, cmd_desc->response + 1,
+					  cmd_desc->response_len - 1))
 			return FAILURE;
-	}
 
 	return SUCCESS;
 }
 
 /**
- * Send one block of data to the SD card
+ * Send one block of data to the SD card. The data is sent from a copy, so
+ * the caller's buffer is left untouched.
  * @param sd_desc	- Instance of the SD card
  * @param data		- Data to be written
  * @param nb_of_blocks	- Number of blocks written in the executing command
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
-static int32_t write_block(struct sd_desc *sd_desc, uint8_t *data,
+static int32_t write_block(struct sd_desc *sd_desc, const uint8_t *data,
 			   uint32_t nb_of_blocks)
 {
+	uint32_t	i;
+
 	/* Send start block token */
+	drop_polled_bytes(sd_desc);
 	sd_desc->buff[0] = START_N_BLOCK_TOKEN;
 	if (nb_of_blocks == 1)
 		sd_desc->buff[0] = START_1_BLOCK_TOKEN;
@@ -228,8 +295,13 @@ static int32_t write_block(struct sd_desc *sd_desc, uint8_t *data,
 		return FAILURE;
 
 	/* Send data with CRC */
-	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, data, DATA_BLOCK_LEN))
-		return FAILURE;
+	for (i = 0; i < DATA_BLOCK_LEN; i += WRITE_CHUNK_LEN) {
+		memcpy(sd_desc->write_buff, data + i, WRITE_CHUNK_LEN);
+		if (SUCCESS != spi_write_and_read(sd_desc->spi_desc,
+						  sd_desc->write_buff,
+						  WRITE_CHUNK_LEN))
+			return FAILURE;
+	}
 	*((uint16_t *)sd_desc->buff) = 0xFFFF;
 	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, CRC_LEN))
 		return FAILURE;
@@ -295,19 +367,55 @@ static int32_t read_block(struct sd_desc *sd_desc, uint8_t *data)
 		return FAILURE;
 	}
 
-	/* Read data block */
-	memset(data, 0xff, DATA_BLOCK_LEN);
-	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, data, DATA_BLOCK_LEN))
+	/* Read data block, it may have started in the polling burst */
+	if (SUCCESS != read_bytes(sd_desc, data, DATA_BLOCK_LEN))
 		return FAILURE;
 
 	/* Read crc*/
-	*((uint16_t *)sd_desc->buff) = 0xFFFF;
-	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, CRC_LEN))
+	if (SUCCESS != read_bytes(sd_desc, sd_desc->buff, CRC_LEN))
 		return FAILURE;
 
 	return SUCCESS;
 }
 
+/**
+ * End a multi-block read with CMD12
+ * @param sd_desc	- Instance of the SD card
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t stop_read(struct sd_desc *sd_desc)
+{
+	struct cmd_desc	cmd_desc;
+
+	cmd_desc.cmd = CMD(12);
+	cmd_desc.arg = STUFF_ARG;
+	cmd_desc.response_len = R1_LEN;
+	if (SUCCESS != send_command(sd_desc, &cmd_desc))
+		return FAILURE;
+	if(cmd_desc.response[0] != R1_READY_STATE) {
+		DEBUG_MSG("Failed to send stop transmission command\n");
+		return FAILURE;
+	}
+
+	return wait_until_not_busy(sd_desc);
+}
+
+/**
+ * End a multi-block write with the stop transmission token
+ * @param sd_desc	- Instance of the SD card
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t stop_write(struct sd_desc *sd_desc)
+{
+	drop_polled_bytes(sd_desc);
+	sd_desc->buff[0] = STOP_TRANSMISSION_TOKEN;
+	sd_desc->buff[1] = 0xFF;
+	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, 2))
+		return FAILURE;
+
+	return wait_until_not_busy(sd_desc);
+}
+
 /**
  * Prepare and write data block by block
  * @param sd_desc	- Instance of the SD card
@@ -422,7 +530,8 @@ int32_t sd_read(struct sd_desc *sd_desc,
 	/* Initial checks */
 	if (data == NULL || address > sd_desc->memory_size ||
 	    len > sd_desc->memory_size ||
-	    address + len > sd_desc->memory_size)
+	    address + len > sd_desc->memory_size ||
+	    sd_desc->stream != SD_STREAM_NONE)
 		return FAILURE;
 
 	/* Send read command */
@@ -441,17 +550,8 @@ int32_t sd_read(struct sd_desc *sd_desc,
 		return FAILURE;
 
 	/* Send stop transmission command */
-	if (get_nb_of_blocks(address, len) != 1) {
-		cmd_desc.cmd = CMD(12);
-		cmd_desc.arg = STUFF_ARG;
-		cmd_desc.response_len = R1_LEN;
-		if (SUCCESS != send_command(sd_desc, &cmd_desc))
-			return FAILURE;
-		if(cmd_desc.response[0] != R1_READY_STATE) {
-			DEBUG_MSG("Failed to send stop transmission command\n");
-			return FAILURE;
-		}
-	}
+	if (get_nb_of_blocks(address, len) != 1)
+		return stop_read(sd_desc);
 
 	return SUCCESS;
 }
@@ -474,7 +574,8 @@ int32_t sd_write(struct sd_desc *sd_desc, uint8_t *data, uint64_t address,
 
 	/* Initial checks */
 	if (data == NULL || address > sd_desc->memory_size ||
-	    len > sd_desc->memory_size || address + len > sd_desc->memory_size)
+	    len > sd_desc->memory_size || address + len > sd_desc->memory_size ||
+	    sd_desc->stream != SD_STREAM_NONE)
 		return FAILURE;
 
 	/* Read first and last block in memory if needed to be updated with user data and then written back                                                                        */
@@ -507,18 +608,128 @@ int32_t sd_write(struct sd_desc *sd_desc, uint8_t *data, uint64_t address,
 		return FAILURE;
 
 	/* Send stop transmission token */
-	if (get_nb_of_blocks(address, len) != 1) {
-		sd_desc->buff[0] = STOP_TRANSMISSION_TOKEN;
-		sd_desc->buff[1] = 0xFF;
-		if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, 2))
+	if (get_nb_of_blocks(address, len) != 1)
+		return stop_write(sd_desc);
+
+	return SUCCESS;
+}
+
+/**
+ * Open a multi-block command, CMD18 to read or CMD25 to write, that stays
+ * open across sd_stream_pull() or sd_stream_push() calls until
+ * sd_stream_stop(). sd_read() and sd_write() fail while it is open.
+ * @param sd_desc	- Instance of the SD card
+ * @param dir		- SD_STREAM_READ or SD_STREAM_WRITE
+ * @param address	- Address in memory of the first block, block aligned
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sd_stream_begin(struct sd_desc *sd_desc, enum sd_stream_dir dir,
+			uint64_t address)
+{
+	struct cmd_desc	cmd_desc;
+
+	/* Initial checks */
+	if (!sd_desc || sd_desc->stream != SD_STREAM_NONE ||
+	    (address & MASK_ADDR_IN_BLOCK) != 0 ||
+	    address >= sd_desc->memory_size)
+		return FAILURE;
+
+	if (dir == SD_STREAM_READ)
+		cmd_desc.cmd = CMD(18);
+	else if (dir == SD_STREAM_WRITE)
+		cmd_desc.cmd = CMD(25);
+	else
+		return FAILURE;
+	cmd_desc.arg = address >> DATA_BLOCK_BITS;
+	cmd_desc.response_len = R1_LEN;
+	if (SUCCESS != send_command(sd_desc, &cmd_desc))
+		return FAILURE;
+	if (cmd_desc.response[0] != R1_READY_STATE) {
+		DEBUG_MSG("Failed to open multi-block command\n");
+		return FAILURE;
+	}
+
+	sd_desc->stream = dir;
+	sd_desc->stream_addr = address;
+
+	return SUCCESS;
+}
+
+/**
+ * Read blocks from the open CMD18
+ * @param sd_desc	- Instance of the SD card
+ * @param data		- Where data will be read, nb_blocks * DATA_BLOCK_LEN
+ * @param nb_blocks	- Number of blocks to read
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sd_stream_pull(struct sd_desc *sd_desc, uint8_t *data,
+		       uint32_t nb_blocks)
+{
+	/* Initial checks */
+	if (!sd_desc || !data || sd_desc->stream != SD_STREAM_READ ||
+	    sd_desc->stream_addr + ((uint64_t)nb_blocks << DATA_BLOCK_BITS) >
+	    sd_desc->memory_size)
+		return FAILURE;
+
+	while (nb_blocks--) {
+		if (SUCCESS != read_block(sd_desc, data))
 			return FAILURE;
-		if (SUCCESS != wait_until_not_busy(sd_desc))
+		data += DATA_BLOCK_LEN;
+		sd_desc->stream_addr += DATA_BLOCK_LEN;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * Write blocks to the open CMD25
+ * @param sd_desc	- Instance of the SD card
+ * @param data		- Data to write, nb_blocks * DATA_BLOCK_LEN
+ * @param nb_blocks	- Number of blocks to write
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sd_stream_push(struct sd_desc *sd_desc, uint8_t *data,
+		       uint32_t nb_blocks)
+{
+	/* Initial checks */
+	if (!sd_desc || !data || sd_desc->stream != SD_STREAM_WRITE ||
+	    sd_desc->stream_addr + ((uint64_t)nb_blocks << DATA_BLOCK_BITS) >
+	    sd_desc->memory_size)
+		return FAILURE;
+
+	while (nb_blocks--) {
+		/* Any count but 1 selects the multi-block start token */
+		if (SUCCESS != write_block(sd_desc, data, 0))
 			return FAILURE;
+		data += DATA_BLOCK_LEN;
+		sd_desc->stream_addr += DATA_BLOCK_LEN;
 	}
 
 	return SUCCESS;
 }
 
+/**
+ * Close the multi-block command opened by sd_stream_begin()
+ * @param sd_desc	- Instance of the SD card
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sd_stream_stop(struct sd_desc *sd_desc)
+{
+	enum sd_stream_dir	dir;
+
+	if (!sd_desc)
+		return FAILURE;
+
+	dir = sd_desc->stream;
+	sd_desc->stream = SD_STREAM_NONE;
+	if (dir == SD_STREAM_READ)
+		return stop_read(sd_desc);
+	if (dir == SD_STREAM_WRITE)
+		return stop_write(sd_desc);
+
+	return SUCCESS;
+}
+
 /**
  * Initialize an instance of SD card and stores it to the parameter desc
  * @param sd_desc	- Pointer where to store the instance of the SD
@@ -611,9 +822,7 @@ int32_t sd_init(struct sd_desc **sd_desc, const struct sd_init_param *param)
 		DEBUG_MSG("Failed to read CSD register\n");
 		goto failure;
 	}
-	memset(local_desc->buff, 0xFF, CSD_LEN);
-	if (SUCCESS != spi_write_and_read(local_desc->spi_desc,
-					  local_desc->buff, CSD_LEN))
+	if (SUCCESS != read_bytes(local_desc, local_desc->buff, CSD_LEN))
 		goto failure;
 
 	/* Get c_size from CSD */
@@ -641,6 +850,7 @@ int32_t sd_remove(struct sd_desc *desc)
 	if (desc == NULL)
 		return FAILURE;
 
+	sd_stream_stop(desc);
 	free(desc);
 	return SUCCESS;
 }
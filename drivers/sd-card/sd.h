@@ -66,6 +66,9 @@
 
 #define DATA_BLOCK_LEN			(512u)
 #define MAX_RESPONSE_LEN		(18u)
+#define POLL_BURST_LEN			(16u)
+/* Data block bytes copied to the descriptor per SPI transfer when writing */
+#define WRITE_CHUNK_LEN			(64u)
 
 #ifdef SD_DEBUG
 #include <stdio.h>
@@ -78,6 +81,19 @@
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+/**
+ * @enum sd_stream_dir
+ * @brief Direction of an open multi-block command
+ */
+enum sd_stream_dir {
+	/** No multi-block command open */
+	SD_STREAM_NONE,
+	/** CMD18 open, blocks are pulled with sd_stream_pull() */
+	SD_STREAM_READ,
+	/** CMD25 open, blocks are pushed with sd_stream_push() */
+	SD_STREAM_WRITE
+};
+
 /**
  * @struct sd_init_param
  * @brief Configuration structure sent in the function sd_init
@@ -100,6 +116,18 @@ struct sd_desc {
 	uint8_t		high_capacity;
 	/** Buffer used for the driver implementation */
 	uint8_t		buff[18];
+	/** Data block chunk being sent, the SPI transfers are in place */
+	uint8_t		write_buff[WRITE_CHUNK_LEN];
+	/** Bytes read by the last polling burst */
+	uint8_t		poll_buff[POLL_BURST_LEN];
+	/** Index of the first byte of poll_buff not consumed yet */
+	uint8_t		poll_idx;
+	/** Number of valid bytes in poll_buff */
+	uint8_t		poll_len;
+	/** Open multi-block command */
+	enum sd_stream_dir	stream;
+	/** Address of the next block of the open multi-block command */
+	uint64_t	stream_addr;
 };
 
 /**
@@ -132,6 +160,16 @@ int32_t sd_write(struct sd_desc *desc,
 		 uint8_t *data,
 		 uint64_t address,
 		 uint64_t len);
+int32_t sd_stream_begin(struct sd_desc *desc,
+			enum sd_stream_dir dir,
+			uint64_t address);
+int32_t sd_stream_pull(struct sd_desc *desc,
+		       uint8_t *data,
+		       uint32_t nb_blocks);
+int32_t sd_stream_push(struct sd_desc *desc,
+		       uint8_t *data,
+		       uint32_t nb_blocks);
+int32_t sd_stream_stop(struct sd_desc *desc);
 
 #endif /* __SD_H__ */
 
@@ -40,7 +40,9 @@
 #include <inttypes.h>
 #include "spi.h"
 #include <stdlib.h>
+#include <string.h>
 #include "error.h"
+#include "delay.h"
 
 /**
  * @brief Initialize the SPI communication peripheral.
@@ -58,6 +60,9 @@ int32_t spi_init(struct spi_desc **desc,
 		return FAILURE;
 
 	(*desc)->platform_ops = param->platform_ops;
+	(*desc)->msg_queue = NULL;
+	(*desc)->msg_queue_len = 0;
+	(*desc)->msg_queue_size = 0;
 
 	return SUCCESS;
 }
@@ -69,6 +74,8 @@ int32_t spi_init(struct spi_desc **desc,
  */
 int32_t spi_remove(struct spi_desc *desc)
 {
+	free(desc->msg_queue);
+
 	return desc->platform_ops->spi_ops_remove(desc);
 }
 
@@ -85,3 +92,161 @@ int32_t spi_write_and_read(struct spi_desc *desc,
 {
 	return desc->platform_ops->spi_ops_write_and_read(desc, data, bytes_number);
 }
+
+/**
+ * @brief Transfer a group of segments that share one CS assertion through
+ *        spi_write_and_read().
+ * @param desc - The SPI descriptor.
+ * @param msgs - The segments.
+ * @param len - Number of segments.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t spi_transfer_frame(struct spi_desc *desc,
+				  struct spi_msg *msgs,
+				  uint32_t len)
+{
+	uint32_t total = 0;
+	uint32_t offset;
+	uint8_t *buff;
+	int32_t ret;
+	uint32_t i;
+
+	for (i = 0; i < len; i++)
+		total += msgs[i].bytes_number;
+
+	if (total > UINT16_MAX)
+		return -EINVAL;
+
+	/* Single in-place segment, no bounce buffer needed. */
+	if (len == 1 && msgs[0].tx_buff && msgs[0].tx_buff == msgs[0].rx_buff)
+		return spi_write_and_read(desc, msgs[0].tx_buff, total);
+
+	buff = (uint8_t *)malloc(total);
+	if (!buff)
+		return -ENOMEM;
+
+	for (i = 0, offset = 0; i < len; offset += msgs[i++].bytes_number) {
+		if (msgs[i].tx_buff)
+			memcpy(buff + offset, msgs[i].tx_buff, msgs[i].bytes_number);
+		else
+			memset(buff + offset, 0, msgs[i].bytes_number);
+	}
+
+	ret = spi_write_and_read(desc, buff, total);
+	if (ret == SUCCESS)
+		for (i = 0, offset = 0; i < len; offset += msgs[i++].bytes_number)
+			if (msgs[i].rx_buff)
+				memcpy(msgs[i].rx_buff, buff + offset,
+				       msgs[i].bytes_number);
+
+	free(buff);
+
+	return ret;
+}
+
+/**
+ * @brief Transfer a list of message segments.
+ *
+ * Platforms that implement spi_ops_transfer submit the whole list at once.
+ * Otherwise the segments between two cs_change points are merged into one
+ * spi_write_and_read() call, so CS stays asserted across them. Per-segment
+ * delays are honored only at cs_change points and after the last segment in
+ * that case.
+ * @param desc - The SPI descriptor.
+ * @param msgs - The segments to transfer.
+ * @param len - Number of segments.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t spi_transfer(struct spi_desc *desc,
+		     struct spi_msg *msgs,
+		     uint32_t len)
+{
+	uint32_t first = 0;
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc || (!msgs && len))
+		return -EINVAL;
+
+	if (desc->platform_ops->spi_ops_transfer)
+		return desc->platform_ops->spi_ops_transfer(desc, msgs, len);
+
+	for (i = 0; i < len; i++) {
+		if (!msgs[i].cs_change && i != len - 1)
+			continue;
+
+		ret = spi_transfer_frame(desc, &msgs[first], i - first + 1);
+		if (ret != SUCCESS)
+			return ret;
+
+		if (msgs[i].delay_us)
+			udelay(msgs[i].delay_us);
+
+		first = i + 1;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Append a segment to the message queue of the descriptor.
+ *
+ * The buffers of the segment must stay valid until spi_msg_queue_submit().
+ * @param desc - The SPI descriptor.
+ * @param msg - The segment to append.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t spi_msg_queue_add(struct spi_desc *desc,
+			  const struct spi_msg *msg)
+{
+	struct spi_msg *queue;
+	uint32_t size;
+
+	if (!desc || !msg)
+		return -EINVAL;
+
+	if (desc->msg_queue_len == desc->msg_queue_size) {
+		size = desc->msg_queue_size ? desc->msg_queue_size * 2 : 8;
+		queue = (struct spi_msg *)realloc(desc->msg_queue,
+						  size * sizeof(*queue));
+		if (!queue)
+			return -ENOMEM;
+
+		desc->msg_queue = queue;
+		desc->msg_queue_size = size;
+	}
+
+	desc->msg_queue[desc->msg_queue_len++] = *msg;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Transfer all the queued segments as one message and empty the queue.
+ * @param desc - The SPI descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t spi_msg_queue_submit(struct spi_desc *desc)
+{
+	int32_t ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (!desc->msg_queue_len)
+		return SUCCESS;
+
+	ret = spi_transfer(desc, desc->msg_queue, desc->msg_queue_len);
+	desc->msg_queue_len = 0;
+
+	return ret;
+}
+
+/**
+ * @brief Drop the queued segments without transferring them.
+ * @param desc - The SPI descriptor.
+ */
+void spi_msg_queue_reset(struct spi_desc *desc)
+{
+	desc->msg_queue_len = 0;
+}
@@ -47,6 +47,7 @@
 #include <stdlib.h>
 #include "error.h"
 #include "util.h"
+#include "unpack.h"
 #include "iio.h"
 #include "iio_ad713x.h"
 #include "spi_engine.h"
@@ -103,36 +104,23 @@ ssize_t iio_ad713x_read_dev(void *iio_inst, char *pbuf, size_t offset,
 			    size_t bytes_count, uint32_t ch_mask)
 {
 	struct iio_ad713x *iio_713x_inst;
-	uint32_t i, j = 0, current_ch = 0, offload_data;
-	uint16_t *pbuf16;
 	size_t samples;
 
 	if (!iio_inst)
 		return FAILURE;
 
 	iio_713x_inst = (struct iio_ad713x *)iio_inst;
-	pbuf16 = (uint16_t*)pbuf;
 	samples = (bytes_count * iio_713x_inst->dev_descriptor.num_ch) / hweight8(
 			  ch_mask);
-	samples /= 2; /* because of uint16_t *pbuf16 = (uint16_t*)pbuf; */
+	samples /= 2; /* because pbuf holds uint16_t samples */
 	offset = (offset * iio_713x_inst->dev_descriptor.num_ch) / hweight8(ch_mask);
 
-	for (i = 0; i < samples; i++) {
-		if (ch_mask & BIT(current_ch)) {
-			offload_data = *(uint32_t*)(iio_713x_inst->spi_engine_offload_message->rx_addr +
-						    offset + i * 4);
-			offload_data <<= 1;
-			offload_data &= 0xffffff00;
-			offload_data >>= 8;
-			pbuf16[j] = offload_data;
-			j++;
-		}
-
-		if (current_ch < (uint8_t)(iio_713x_inst->dev_descriptor.num_ch - 1))
-			current_ch++;
-		else
-			current_ch = 0;
-	}
+	/* Store bits 22:7 of the offload words of the enabled channels */
+	unpack_select_u32_u16((uint16_t *)pbuf,
+			      (uint32_t *)(iio_713x_inst->spi_engine_offload_message->rx_addr +
+					   offset),
+			      samples, iio_713x_inst->dev_descriptor.num_ch,
+			      ch_mask, 7);
 
 	return bytes_count;
 }
@@ -0,0 +1,268 @@
+/***************************************************************************//**
+ *   @file   iio_adas1000.c
+ *   @brief  Implementation of ADAS1000 iio.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "error.h"
+#include "util.h"
+#include "iio_adas1000.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static ssize_t iio_adas1000_get_counter(void *device, char *buf, size_t len,
+					const struct iio_ch_info *channel,
+					intptr_t priv)
+{
+	struct iio_adas1000_desc *desc = device;
+
+	if (priv)
+		return snprintf(buf, len, "%"PRIu32,
+				desc->dev->stream->crc_errors);
+
+	return snprintf(buf, len, "%"PRIu32, desc->dev->stream->frames_dropped);
+}
+
+static struct iio_attribute iio_adas1000_attrs[] = {
+	{
+		.name = "frames_dropped",
+		.show = iio_adas1000_get_counter,
+		.priv = 0,
+	},
+	{
+		.name = "crc_errors",
+		.show = iio_adas1000_get_counter,
+		.priv = 1,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+static struct scan_type iio_adas1000_scan_type = {
+	.sign = 's',
+	.realbits = 24,
+	.storagebits = 32,
+	.shift = 0,
+	.is_big_endian = false
+};
+
+#define IIO_ADAS1000_CHANNEL(_idx) {			\
+	.ch_type = IIO_VOLTAGE,				\
+	.channel = _idx,				\
+	.scan_index = _idx,				\
+	.scan_type = &iio_adas1000_scan_type,		\
+	.ch_out = false,				\
+	.indexed = true,				\
+}
+
+/* LA/Lead I, LL/Lead II, RA/Lead III, V1, V2 */
+static struct iio_channel iio_adas1000_channels[] = {
+	IIO_ADAS1000_CHANNEL(0),
+	IIO_ADAS1000_CHANNEL(1),
+	IIO_ADAS1000_CHANNEL(2),
+	IIO_ADAS1000_CHANNEL(3),
+	IIO_ADAS1000_CHANNEL(4),
+};
+
+/**
+ * @brief Start the frames read sequence.
+ * @param device - iio_adas1000 descriptor.
+ * @param mask - Active channels.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t iio_adas1000_prepare_transfer(void *device, uint32_t mask)
+{
+	struct iio_adas1000_desc *desc = device;
+
+	desc->mask = mask & GENMASK(ADAS1000_NUM_LEADS - 1, 0);
+	if (!desc->mask)
+		return -EINVAL;
+
+	return adas1000_stream_start(desc->dev);
+}
+
+/**
+ * @brief Stop the frames read sequence.
+ * @param device - iio_adas1000 descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t iio_adas1000_end_transfer(void *device)
+{
+	struct iio_adas1000_desc *desc = device;
+
+	return adas1000_stream_stop(desc->dev);
+}
+
+/**
+ * @brief Read samples of the active channels, interleaved.
+ * @param device - iio_adas1000 descriptor.
+ * @param buff - Where to store the samples.
+ * @param nb_samples - Number of samples per channel.
+ * @return Number of samples read or negative error code.
+ */
+static int32_t iio_adas1000_read_dev(void *device, void *buff,
+				     uint32_t nb_samples)
+{
+	struct iio_adas1000_desc	*desc = device;
+	int32_t				*data = buff;
+	uint32_t			chunk;
+	uint32_t			done;
+	uint32_t			lead;
+	uint32_t			i;
+	int32_t				ret;
+
+	for (done = 0; done < nb_samples; done += chunk) {
+		chunk = min_t(uint32_t, nb_samples - done, desc->nb_frames);
+		ret = adas1000_stream_read_frames(desc->dev, desc->frames,
+						  chunk);
+		if (ret < 0)
+			return ret;
+
+		for (i = 0; i < chunk; i++)
+			for (lead = 0; lead < ADAS1000_NUM_LEADS; lead++)
+				if (desc->mask & BIT(lead))
+					*data++ = desc->frames[i].lead[lead];
+	}
+
+	return nb_samples;
+}
+
+static int32_t iio_adas1000_reg_read(void *device, uint32_t reg, uint32_t *val)
+{
+	struct iio_adas1000_desc *desc = device;
+
+	return adas1000_read(desc->dev, reg, val);
+}
+
+static int32_t iio_adas1000_reg_write(void *device, uint32_t reg, uint32_t val)
+{
+	struct iio_adas1000_desc *desc = device;
+
+	return adas1000_write(desc->dev, reg, val);
+}
+
+/**
+ * @brief Get iio device descriptor.
+ * @param desc - Descriptor.
+ * @param dev_descriptor - iio device descriptor.
+ */
+void iio_adas1000_get_dev_descriptor(struct iio_adas1000_desc *desc,
+				     struct iio_device **dev_descriptor)
+{
+	*dev_descriptor = &desc->dev_descriptor;
+}
+
+/**
+ * @brief Init for frame streaming of an ADAS1000 device.
+ * @param desc - Descriptor.
+ * @param param - Configuration structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_adas1000_init(struct iio_adas1000_desc **desc,
+			  struct iio_adas1000_init_param *param)
+{
+	struct adas1000_stream_init_param	stream_param;
+	struct iio_adas1000_desc		*iio_adas1000;
+	int32_t					ret;
+
+	if (!desc || !param || !param->dev || !param->frames_per_xfer)
+		return -EINVAL;
+
+	iio_adas1000 = (struct iio_adas1000_desc *)calloc(1,
+			sizeof(*iio_adas1000));
+	if (!iio_adas1000)
+		return -ENOMEM;
+
+	iio_adas1000->dev = param->dev;
+	iio_adas1000->nb_frames = param->frames_per_xfer;
+	iio_adas1000->frames = calloc(param->frames_per_xfer,
+				      sizeof(*iio_adas1000->frames));
+	if (!iio_adas1000->frames) {
+		ret = -ENOMEM;
+		goto error_desc;
+	}
+
+	stream_param.frames_per_xfer = param->frames_per_xfer;
+	stream_param.ring_frames = param->ring_frames;
+	ret = adas1000_stream_init(param->dev, &stream_param);
+	if (ret < 0)
+		goto error_frames;
+
+	iio_adas1000->dev_descriptor.num_ch = ARRAY_SIZE(iio_adas1000_channels);
+	iio_adas1000->dev_descriptor.channels = iio_adas1000_channels;
+	iio_adas1000->dev_descriptor.attributes = iio_adas1000_attrs;
+	iio_adas1000->dev_descriptor.prepare_transfer =
+		iio_adas1000_prepare_transfer;
+	iio_adas1000->dev_descriptor.end_transfer = iio_adas1000_end_transfer;
+	iio_adas1000->dev_descriptor.read_dev = iio_adas1000_read_dev;
+	iio_adas1000->dev_descriptor.debug_reg_read = iio_adas1000_reg_read;
+	iio_adas1000->dev_descriptor.debug_reg_write = iio_adas1000_reg_write;
+
+	*desc = iio_adas1000;
+
+	return SUCCESS;
+
+error_frames:
+	free(iio_adas1000->frames);
+error_desc:
+	free(iio_adas1000);
+
+	return ret;
+}
+
+/**
+ * @brief Release resources.
+ * @param desc - Descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_adas1000_remove(struct iio_adas1000_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	adas1000_stream_remove(desc->dev);
+	free(desc->frames);
+	free(desc);
+
+	return SUCCESS;
+}
@@ -0,0 +1,96 @@
+/***************************************************************************//**
+ *   @file   iio_adas1000.h
+ *   @brief  Header file of ADAS1000 iio.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef IIO_ADAS1000_H_
+#define IIO_ADAS1000_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "iio_types.h"
+#include "adas1000.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct iio_adas1000_init_param
+ * @brief iio_adas1000 configuration.
+ */
+struct iio_adas1000_init_param {
+	/** ADAS1000 device, already initialized */
+	struct adas1000_dev	*dev;
+	/** Number of frames read with a single SPI transfer */
+	uint32_t		frames_per_xfer;
+	/** Number of decoded frames buffered between reads */
+	uint32_t		ring_frames;
+};
+
+/**
+ * @struct iio_adas1000_desc
+ * @brief iio_adas1000 descriptor.
+ */
+struct iio_adas1000_desc {
+	/** iio device descriptor */
+	struct iio_device	dev_descriptor;
+	/** ADAS1000 device */
+	struct adas1000_dev	*dev;
+	/** Decoded frames, frames_per_xfer of them */
+	struct adas1000_frame	*frames;
+	/** Number of frames in frames */
+	uint32_t		nb_frames;
+	/** Active channels */
+	uint32_t		mask;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Init function. */
+int32_t iio_adas1000_init(struct iio_adas1000_desc **desc,
+			  struct iio_adas1000_init_param *param);
+/* Get desciptor. */
+void iio_adas1000_get_dev_descriptor(struct iio_adas1000_desc *desc,
+				     struct iio_device **dev_descriptor);
+/* Free the resources allocated by iio_adas1000_init(). */
+int32_t iio_adas1000_remove(struct iio_adas1000_desc *desc);
+
+#endif /* IIO_ADAS1000_H_ */
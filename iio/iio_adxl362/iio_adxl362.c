@@ -0,0 +1,371 @@
+/***************************************************************************//**
+ *   @file   iio_adxl362.c
+ *   @brief  Implementation of ADXL362 iio.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "util.h"
+#include "iio_adxl362.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* x, y and z are always stored in the FIFO */
+#define IIO_ADXL362_FIFO_SET_SIZE	3
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static ssize_t iio_adxl362_get_raw(void *device, char *buf, size_t len,
+				   const struct iio_ch_info *channel,
+				   intptr_t priv)
+{
+	struct iio_adxl362_desc	*desc = device;
+	int16_t			data[3];
+
+	adxl362_get_xyz(desc->dev, &data[0], &data[1], &data[2]);
+
+	return snprintf(buf, len, "%d", data[channel->ch_num]);
+}
+
+static ssize_t iio_adxl362_get_scale(void *device, char *buf, size_t len,
+				     const struct iio_ch_info *channel,
+				     intptr_t priv)
+{
+	struct iio_adxl362_desc *desc = device;
+
+	/* 1 mg/LSB at +/-2 g, doubling with the range. 1 mg = 0.00980665 m/s^2 */
+	return snprintf(buf, len, "0.%08"PRIu32,
+			(uint32_t)980665 * (desc->dev->selected_range / 2));
+}
+
+static ssize_t iio_adxl362_get_overruns(void *device, char *buf, size_t len,
+					const struct iio_ch_info *channel,
+					intptr_t priv)
+{
+	struct iio_adxl362_desc *desc = device;
+
+	if (priv)
+		return snprintf(buf, len, "%"PRIu32, desc->trig->overruns);
+
+	return snprintf(buf, len, "%"PRIu32, desc->dev->fifo_overruns);
+}
+
+static struct iio_attribute iio_adxl362_ch_attrs[] = {
+	{
+		.name = "raw",
+		.show = iio_adxl362_get_raw,
+	},
+	{
+		.name = "scale",
+		.show = iio_adxl362_get_scale,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+static struct iio_attribute iio_adxl362_attrs[] = {
+	{
+		.name = "fifo_overruns",
+		.show = iio_adxl362_get_overruns,
+		.priv = 0,
+	},
+	{
+		.name = "buffer_overruns",
+		.show = iio_adxl362_get_overruns,
+		.priv = 1,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+static struct scan_type iio_adxl362_scan_type = {
+	.sign = 's',
+	.realbits = 12,
+	.storagebits = 16,
+	.shift = 0,
+	.is_big_endian = false
+};
+
+#define IIO_ADXL362_CHANNEL(_axis, _idx) {		\
+	.ch_type = IIO_ACCEL,				\
+	.modified = 1,					\
+	.channel2 = _axis,				\
+	.scan_index = _idx,				\
+	.scan_type = &iio_adxl362_scan_type,		\
+	.attributes = iio_adxl362_ch_attrs,		\
+	.ch_out = false,				\
+}
+
+static struct iio_channel iio_adxl362_channels[] = {
+	IIO_ADXL362_CHANNEL(IIO_MOD_X, 0),
+	IIO_ADXL362_CHANNEL(IIO_MOD_Y, 1),
+	IIO_ADXL362_CHANNEL(IIO_MOD_Z, 2),
+};
+
+/**
+ * @brief Read the FIFO down to the watermark and keep the active axes. Used as
+ * trigger read_block on the INT1 watermark interrupt.
+ * @param device - iio_adxl362 descriptor.
+ * @param scans - Where to store the sample sets.
+ * @param stride - Distance between two sample sets, in bytes.
+ * @return Number of sample sets read or negative error code.
+ */
+static int32_t iio_adxl362_read_block(void *device, void *scans,
+				      uint32_t stride)
+{
+	struct iio_adxl362_desc	*desc = device;
+	int16_t			*src = desc->fifo_buf;
+	int16_t			*dst;
+	uint16_t		nb_sets;
+	uint16_t		i;
+	uint8_t			axis;
+	int32_t			ret;
+
+	ret = adxl362_fifo_stream_service(desc->dev, desc->fifo_buf, &nb_sets);
+	if (ret < 0)
+		return ret;
+
+	for (i = 0; i < nb_sets; i++) {
+		dst = (int16_t *)((uint8_t *)scans + i * stride);
+		for (axis = 0; axis < IIO_ADXL362_FIFO_SET_SIZE; axis++)
+			if (desc->ch_mask & BIT(axis))
+				*dst++ = src[axis];
+		src += IIO_ADXL362_FIFO_SET_SIZE;
+	}
+
+	return nb_sets;
+}
+
+/**
+ * @brief Start streaming the active channels through the FIFO.
+ * @param device - iio_adxl362 descriptor.
+ * @param mask - Active channels.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t iio_adxl362_prepare_transfer(void *device, uint32_t mask)
+{
+	struct iio_adxl362_desc	*desc = device;
+	uint8_t			intmap;
+	int32_t			ret;
+
+	mask &= 0x7;
+	if (!mask)
+		return -EINVAL;
+	desc->ch_mask = mask;
+
+	adxl362_set_power_mode(desc->dev, 0);
+	adxl362_fifo_setup(desc->dev, ADXL362_FIFO_STREAM, desc->watermark, 0);
+	adxl362_get_register_value(desc->dev, &intmap, ADXL362_REG_INTMAP1, 1);
+	adxl362_set_register_value(desc->dev,
+				   intmap | ADXL362_INTMAP1_FIFO_WATERMARK,
+				   ADXL362_REG_INTMAP1, 1);
+
+	desc->dev->fifo_overruns = 0;
+	ret = iio_trigger_enable(desc->trig);
+	if (ret < 0)
+		return ret;
+
+	adxl362_set_power_mode(desc->dev, 1);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Stop streaming. Samples already in the ring can still be read.
+ * @param device - iio_adxl362 descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t iio_adxl362_end_transfer(void *device)
+{
+	struct iio_adxl362_desc	*desc = device;
+	int32_t			ret;
+
+	if (!desc->trig->enabled)
+		return SUCCESS;
+
+	ret = iio_trigger_disable(desc->trig);
+	if (ret < 0)
+		return ret;
+
+	adxl362_set_power_mode(desc->dev, 0);
+	adxl362_fifo_setup(desc->dev, ADXL362_FIFO_DISABLE, desc->watermark, 0);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read sample sets from the ring. Blocks until they are available.
+ * @param device - iio_adxl362 descriptor.
+ * @param buff - Where to store the samples.
+ * @param nb_samples - Number of sample sets.
+ * @return Number of sample sets read or negative error code.
+ */
+static int32_t iio_adxl362_read_dev(void *device, void *buff,
+				    uint32_t nb_samples)
+{
+	struct iio_adxl362_desc *desc = device;
+
+	return iio_trigger_read(desc->trig, buff,
+				hweight8(desc->ch_mask) * sizeof(int16_t),
+				nb_samples, NULL);
+}
+
+static int32_t iio_adxl362_reg_read(void *device, uint32_t reg, uint32_t *val)
+{
+	struct iio_adxl362_desc	*desc = device;
+	uint8_t			data;
+
+	adxl362_get_register_value(desc->dev, &data, reg, 1);
+	*val = data;
+
+	return SUCCESS;
+}
+
+static int32_t iio_adxl362_reg_write(void *device, uint32_t reg, uint32_t val)
+{
+	struct iio_adxl362_desc *desc = device;
+
+	adxl362_set_register_value(desc->dev, val, reg, 1);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get iio device descriptor.
+ * @param desc - Descriptor.
+ * @param dev_descriptor - iio device descriptor.
+ */
+void iio_adxl362_get_dev_descriptor(struct iio_adxl362_desc *desc,
+				    struct iio_device **dev_descriptor)
+{
+	*dev_descriptor = &desc->dev_descriptor;
+}
+
+/**
+ * @brief Init for FIFO watermark streaming of an ADXL362 device.
+ * @param desc - Descriptor.
+ * @param param - Configuration structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_adxl362_init(struct iio_adxl362_desc **desc,
+			 struct iio_adxl362_init_param *param)
+{
+	struct iio_adxl362_desc		*iio_adxl362;
+	struct iio_trigger_init_param	trig_param;
+	int32_t				ret;
+
+	if (!desc || !param || !param->dev || !param->irq_ctrl ||
+	    param->watermark < IIO_ADXL362_FIFO_SET_SIZE ||
+	    param->watermark > ADXL362_FIFO_MAX_ENTRIES ||
+	    param->ring_sets < param->watermark / IIO_ADXL362_FIFO_SET_SIZE)
+		return -EINVAL;
+
+	iio_adxl362 = (struct iio_adxl362_desc *)calloc(1, sizeof(*iio_adxl362));
+	if (!iio_adxl362)
+		return -ENOMEM;
+
+	iio_adxl362->dev = param->dev;
+	iio_adxl362->watermark = param->watermark;
+	iio_adxl362->ch_mask = 0x7;
+
+	iio_adxl362->fifo_buf = calloc(param->watermark + 1, sizeof(int16_t));
+	if (!iio_adxl362->fifo_buf) {
+		ret = -ENOMEM;
+		goto error_desc;
+	}
+
+	memset(&trig_param, 0, sizeof(trig_param));
+	trig_param.irq_ctrl = param->irq_ctrl;
+	trig_param.irq_id = param->irq_id;
+	trig_param.irq_config = param->irq_config;
+	trig_param.dev = iio_adxl362;
+	trig_param.read_block = iio_adxl362_read_block;
+	trig_param.block_scans = param->watermark / IIO_ADXL362_FIFO_SET_SIZE;
+	trig_param.scan_size = IIO_ADXL362_FIFO_SET_SIZE * sizeof(int16_t);
+	trig_param.nb_scans = param->ring_sets;
+	trig_param.get_time_ns = param->get_time_ns;
+	ret = iio_trigger_init(&iio_adxl362->trig, &trig_param);
+	if (ret < 0)
+		goto error_buf;
+
+	iio_adxl362->dev_descriptor.num_ch = ARRAY_SIZE(iio_adxl362_channels);
+	iio_adxl362->dev_descriptor.channels = iio_adxl362_channels;
+	iio_adxl362->dev_descriptor.attributes = iio_adxl362_attrs;
+	iio_adxl362->dev_descriptor.prepare_transfer =
+		iio_adxl362_prepare_transfer;
+	iio_adxl362->dev_descriptor.end_transfer = iio_adxl362_end_transfer;
+	iio_adxl362->dev_descriptor.read_dev = iio_adxl362_read_dev;
+	iio_adxl362->dev_descriptor.debug_reg_read = iio_adxl362_reg_read;
+	iio_adxl362->dev_descriptor.debug_reg_write = iio_adxl362_reg_write;
+
+	*desc = iio_adxl362;
+
+	return SUCCESS;
+
+error_buf:
+	free(iio_adxl362->fifo_buf);
+error_desc:
+	free(iio_adxl362);
+
+	return ret;
+}
+
+/**
+ * @brief Release resources.
+ * @param desc - Descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_adxl362_remove(struct iio_adxl362_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	iio_adxl362_end_transfer(desc);
+	iio_trigger_remove(desc->trig);
+	free(desc->fifo_buf);
+	free(desc);
+
+	return SUCCESS;
+}
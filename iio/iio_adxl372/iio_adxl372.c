@@ -0,0 +1,375 @@
+/***************************************************************************//**
+ *   @file   iio_adxl372.c
+ *   @brief  Implementation of ADXL372 iio.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "util.h"
+#include "iio_adxl372.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static ssize_t iio_adxl372_get_raw(void *device, char *buf, size_t len,
+				   const struct iio_ch_info *channel,
+				   intptr_t priv)
+{
+	struct iio_adxl372_desc		*desc = device;
+	struct adxl372_xyz_accel_data	data;
+	uint16_t			raw;
+	int32_t				ret;
+
+	ret = adxl372_get_accel_data(desc->dev, &data);
+	if (ret < 0)
+		return ret;
+
+	if (channel->ch_num == 0)
+		raw = data.x;
+	else if (channel->ch_num == 1)
+		raw = data.y;
+	else
+		raw = data.z;
+
+	/* Sign extend the 12-bit sample */
+	return snprintf(buf, len, "%d", (int16_t)(raw << 4) >> 4);
+}
+
+static ssize_t iio_adxl372_get_scale(void *device, char *buf, size_t len,
+				     const struct iio_ch_info *channel,
+				     intptr_t priv)
+{
+	/* 100 mg/LSB = 0.980665 m/s^2 */
+	return snprintf(buf, len, "0.980665");
+}
+
+static ssize_t iio_adxl372_get_overruns(void *device, char *buf, size_t len,
+					const struct iio_ch_info *channel,
+					intptr_t priv)
+{
+	struct iio_adxl372_desc *desc = device;
+
+	if (priv)
+		return snprintf(buf, len, "%"PRIu32, desc->trig->overruns);
+
+	return snprintf(buf, len, "%"PRIu32, desc->dev->fifo_overruns);
+}
+
+static struct iio_attribute iio_adxl372_ch_attrs[] = {
+	{
+		.name = "raw",
+		.show = iio_adxl372_get_raw,
+	},
+	{
+		.name = "scale",
+		.show = iio_adxl372_get_scale,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+static struct iio_attribute iio_adxl372_attrs[] = {
+	{
+		.name = "fifo_overruns",
+		.show = iio_adxl372_get_overruns,
+		.priv = 0,
+	},
+	{
+		.name = "buffer_overruns",
+		.show = iio_adxl372_get_overruns,
+		.priv = 1,
+	},
+	END_ATTRIBUTES_ARRAY
+};
+
+static struct scan_type iio_adxl372_scan_type = {
+	.sign = 's',
+	.realbits = 12,
+	.storagebits = 16,
+	.shift = 0,
+	.is_big_endian = false
+};
+
+#define IIO_ADXL372_CHANNEL(_axis, _idx) {		\
+	.ch_type = IIO_ACCEL,				\
+	.modified = 1,					\
+	.channel2 = _axis,				\
+	.scan_index = _idx,				\
+	.scan_type = &iio_adxl372_scan_type,		\
+	.attributes = iio_adxl372_ch_attrs,		\
+	.ch_out = false,				\
+}
+
+static struct iio_channel iio_adxl372_channels[] = {
+	IIO_ADXL372_CHANNEL(IIO_MOD_X, 0),
+	IIO_ADXL372_CHANNEL(IIO_MOD_Y, 1),
+	IIO_ADXL372_CHANNEL(IIO_MOD_Z, 2),
+};
+
+/**
+ * @brief Read the FIFO down to the watermark. Used as trigger read_block on
+ * the INT1 watermark interrupt.
+ * @param device - iio_adxl372 descriptor.
+ * @param scans - Where to store the decoded sample sets.
+ * @param stride - Distance between two sample sets, in bytes.
+ * @return Number of sample sets read or negative error code.
+ */
+static int32_t iio_adxl372_read_block(void *device, void *scans,
+				      uint32_t stride)
+{
+	struct iio_adxl372_desc	*desc = device;
+	uint8_t			*dst = scans;
+	uint16_t		nb_sets;
+	uint16_t		i;
+	int32_t			ret;
+
+	ret = adxl372_fifo_stream_service(desc->dev, desc->fifo_buf, &nb_sets);
+	if (ret < 0)
+		return ret;
+
+	for (i = 0; i < nb_sets; i++)
+		memcpy(dst + i * stride, &desc->fifo_buf[i * desc->set_size],
+		       desc->set_size * sizeof(int16_t));
+
+	return nb_sets;
+}
+
+/**
+ * @brief Start streaming the active channels through the FIFO.
+ * @param device - iio_adxl372 descriptor.
+ * @param mask - Active channels.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t iio_adxl372_prepare_transfer(void *device, uint32_t mask)
+{
+	struct iio_adxl372_desc		*desc = device;
+	enum adxl372_fifo_format	format;
+	int32_t				ret;
+
+	mask &= 0x7;
+	if (!mask)
+		return -EINVAL;
+
+	/* FIFO formats with one bit per axis, except for x, y and z together */
+	format = (mask == 0x7) ? ADXL372_XYZ_FIFO :
+		 (enum adxl372_fifo_format)mask;
+	desc->set_size = hweight8(mask);
+
+	ret = adxl372_configure_fifo(desc->dev, ADXL372_FIFO_STREAMED, format,
+				     desc->watermark);
+	if (ret < 0)
+		return ret;
+
+	ret = adxl372_write_mask(desc->dev, ADXL372_INT1_MAP,
+				 ADXL372_INT1_MAP_FIFO_FULL_MSK,
+				 ADXL372_INT1_MAP_FIFO_FULL_MODE(1));
+	if (ret < 0)
+		return ret;
+
+	desc->dev->fifo_overruns = 0;
+	ret = iio_trigger_enable(desc->trig);
+	if (ret < 0)
+		return ret;
+
+	ret = adxl372_set_op_mode(desc->dev, ADXL372_FULL_BW_MEASUREMENT);
+	if (ret < 0) {
+		iio_trigger_disable(desc->trig);
+		return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Stop streaming. Samples already in the ring can still be read.
+ * @param device - iio_adxl372 descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t iio_adxl372_end_transfer(void *device)
+{
+	struct iio_adxl372_desc	*desc = device;
+	int32_t			ret;
+
+	if (!desc->trig->enabled)
+		return SUCCESS;
+
+	ret = iio_trigger_disable(desc->trig);
+	if (ret < 0)
+		return ret;
+
+	return adxl372_set_op_mode(desc->dev, ADXL372_STANDBY);
+}
+
+/**
+ * @brief Read sample sets from the ring. Blocks until they are available.
+ * @param device - iio_adxl372 descriptor.
+ * @param buff - Where to store the samples.
+ * @param nb_samples - Number of sample sets.
+ * @return Number of sample sets read or negative error code.
+ */
+static int32_t iio_adxl372_read_dev(void *device, void *buff,
+				    uint32_t nb_samples)
+{
+	struct iio_adxl372_desc *desc = device;
+
+	return iio_trigger_read(desc->trig, buff,
+				desc->set_size * sizeof(int16_t), nb_samples,
+				NULL);
+}
+
+static int32_t iio_adxl372_reg_read(void *device, uint32_t reg, uint32_t *val)
+{
+	struct iio_adxl372_desc	*desc = device;
+	uint8_t			data;
+	int32_t			ret;
+
+	ret = adxl372_read_reg(desc->dev, reg, &data);
+	*val = data;
+
+	return ret;
+}
+
+static int32_t iio_adxl372_reg_write(void *device, uint32_t reg, uint32_t val)
+{
+	struct iio_adxl372_desc *desc = device;
+
+	return adxl372_write_reg(desc->dev, reg, val);
+}
+
+/**
+ * @brief Get iio device descriptor.
+ * @param desc - Descriptor.
+ * @param dev_descriptor - iio device descriptor.
+ */
+void iio_adxl372_get_dev_descriptor(struct iio_adxl372_desc *desc,
+				    struct iio_device **dev_descriptor)
+{
+	*dev_descriptor = &desc->dev_descriptor;
+}
+
+/**
+ * @brief Init for FIFO watermark streaming of an ADXL372 device.
+ * @param desc - Descriptor.
+ * @param param - Configuration structure.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_adxl372_init(struct iio_adxl372_desc **desc,
+			 struct iio_adxl372_init_param *param)
+{
+	struct iio_adxl372_desc		*iio_adxl372;
+	struct iio_trigger_init_param	trig_param;
+	int32_t				ret;
+
+	if (!desc || !param || !param->dev || !param->irq_ctrl ||
+	    !param->watermark || param->watermark > ADXL372_FIFO_MAX_ENTRIES ||
+	    param->ring_sets < param->watermark)
+		return -EINVAL;
+
+	iio_adxl372 = (struct iio_adxl372_desc *)calloc(1, sizeof(*iio_adxl372));
+	if (!iio_adxl372)
+		return -ENOMEM;
+
+	iio_adxl372->dev = param->dev;
+	iio_adxl372->watermark = param->watermark;
+	iio_adxl372->set_size = 3;
+
+	iio_adxl372->fifo_buf = calloc(param->watermark + 1, sizeof(int16_t));
+	if (!iio_adxl372->fifo_buf) {
+		ret = -ENOMEM;
+		goto error_desc;
+	}
+
+	memset(&trig_param, 0, sizeof(trig_param));
+	trig_param.irq_ctrl = param->irq_ctrl;
+	trig_param.irq_id = param->irq_id;
+	trig_param.irq_config = param->irq_config;
+	trig_param.dev = iio_adxl372;
+	trig_param.read_block = iio_adxl372_read_block;
+	/* A watermark of single axis entries is the largest block */
+	trig_param.block_scans = param->watermark;
+	trig_param.scan_size = 3 * sizeof(int16_t);
+	trig_param.nb_scans = param->ring_sets;
+	trig_param.get_time_ns = param->get_time_ns;
+	ret = iio_trigger_init(&iio_adxl372->trig, &trig_param);
+	if (ret < 0)
+		goto error_buf;
+
+	iio_adxl372->dev_descriptor.num_ch = ARRAY_SIZE(iio_adxl372_channels);
+	iio_adxl372->dev_descriptor.channels = iio_adxl372_channels;
+	iio_adxl372->dev_descriptor.attributes = iio_adxl372_attrs;
+	iio_adxl372->dev_descriptor.prepare_transfer =
+		iio_adxl372_prepare_transfer;
+	iio_adxl372->dev_descriptor.end_transfer = iio_adxl372_end_transfer;
+	iio_adxl372->dev_descriptor.read_dev = iio_adxl372_read_dev;
+	iio_adxl372->dev_descriptor.debug_reg_read = iio_adxl372_reg_read;
+	iio_adxl372->dev_descriptor.debug_reg_write = iio_adxl372_reg_write;
+
+	*desc = iio_adxl372;
+
+	return SUCCESS;
+
+error_buf:
+	free(iio_adxl372->fifo_buf);
+error_desc:
+	free(iio_adxl372);
+
+	return ret;
+}
+
+/**
+ * @brief Release resources.
+ * @param desc - Descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_adxl372_remove(struct iio_adxl372_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	iio_adxl372_end_transfer(desc);
+	iio_trigger_remove(desc->trig);
+	free(desc->fifo_buf);
+	free(desc);
+
+	return SUCCESS;
+}
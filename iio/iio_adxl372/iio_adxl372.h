@@ -0,0 +1,108 @@
+/***************************************************************************//**
+ *   @file   iio_adxl372.h
+ *   @brief  Header file of ADXL372 iio.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef IIO_ADXL372_H_
+#define IIO_ADXL372_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "iio_types.h"
+#include "iio_trigger.h"
+#include "adxl372.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct iio_adxl372_init_param
+ * @brief iio_adxl372 configuration.
+ */
+struct iio_adxl372_init_param {
+	/** ADXL372 device, already initialized */
+	struct adxl372_dev	*dev;
+	/** Interrupt controller INT1 is connected to */
+	struct irq_ctrl_desc	*irq_ctrl;
+	/** Interrupt of the INT1 pin */
+	uint32_t		irq_id;
+	/** Platform specific interrupt configuration (rising edge) */
+	void			*irq_config;
+	/** FIFO watermark, in entries (up to 512) */
+	uint16_t		watermark;
+	/** Number of sample sets buffered between reads, at least watermark */
+	uint32_t		ring_sets;
+	/** Monotonic time source in nanoseconds, may be NULL */
+	uint64_t		(*get_time_ns)(void);
+};
+
+/**
+ * @struct iio_adxl372_desc
+ * @brief iio_adxl372 descriptor.
+ */
+struct iio_adxl372_desc {
+	/** iio device descriptor */
+	struct iio_device	dev_descriptor;
+	/** ADXL372 device */
+	struct adxl372_dev	*dev;
+	/** Trigger on the INT1 watermark interrupt, owns the ring */
+	struct iio_trigger_desc	*trig;
+	/** FIFO watermark, in entries */
+	uint16_t		watermark;
+	/** Burst read buffer, watermark + 1 entries */
+	int16_t			*fifo_buf;
+	/** Number of axes of a sample set */
+	uint8_t			set_size;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Init function. */
+int32_t iio_adxl372_init(struct iio_adxl372_desc **desc,
+			 struct iio_adxl372_init_param *param);
+/* Get desciptor. */
+void iio_adxl372_get_dev_descriptor(struct iio_adxl372_desc *desc,
+				    struct iio_device **dev_descriptor);
+/* Free the resources allocated by iio_adxl372_init(). */
+int32_t iio_adxl372_remove(struct iio_adxl372_desc *desc);
+
+#endif /* IIO_ADXL372_H_ */
@@ -42,6 +42,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "adxrs290.h"
+#include "iio_trigger.h"
 #include "util.h"
 #include "error.h"
 
@@ -180,6 +181,56 @@ int32_t adxrs290_update_active_channels(void *device, uint32_t mask)
 
 	adxrs290_set_active_channels(dev, mask);
 
+	if (dev->trigger)
+		return iio_trigger_enable(dev->trigger);
+
+	return SUCCESS;
+}
+
+int32_t adxrs290_end_transfer(void *device)
+{
+	struct adxrs290_dev *dev = device;
+
+	if (dev->trigger)
+		return iio_trigger_disable(dev->trigger);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read one burst of the active channels. Used as trigger read_scan.
+ * @param device - Device handler.
+ * @param scan - Where to store the scan.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adxrs290_trigger_read_scan(void *device, void *scan)
+{
+	uint8_t ch_cnt;
+
+	return adxrs290_get_burst_data(device, scan, &ch_cnt);
+}
+
+/**
+ * @brief Feed the IIO buffer from a trigger instead of polling the data
+ * ready pin. The trigger must be initialized with
+ * adxrs290_trigger_read_scan() and a scan_size of ADXRS290_CHANNEL_COUNT
+ * samples.
+ * @param dev - Device handler.
+ * @param trigger - Trigger descriptor, NULL to go back to polling.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t adxrs290_iio_set_trigger(struct adxrs290_dev *dev,
+				 struct iio_trigger_desc *trigger)
+{
+	if (!dev)
+		return -EINVAL;
+
+	if (trigger &&
+	    trigger->scan_size < ADXRS290_CHANNEL_COUNT * sizeof(int16_t))
+		return -EINVAL;
+
+	dev->trigger = trigger;
+
 	return SUCCESS;
 }
 
@@ -192,6 +243,11 @@ int32_t adxrs290_read_samples(void *device, uint16_t *buff, uint32_t nb_samples)
 	uint8_t			ch_cnt;
 	bool			rdy;
 
+	if (dev->trigger)
+		return iio_trigger_read(dev->trigger, buff,
+					hweight8(dev->ch_mask) *
+					sizeof(int16_t), nb_samples, NULL);
+
 	offset = 0;
 	for (i = 0; i < nb_samples; i++) {
 		/* Stop until data is available.
@@ -41,6 +41,8 @@
 #define IIO_ADXRS290_H
 
 #include "iio_types.h"
+#include "iio_trigger.h"
+#include "adxrs290.h"
 
 ssize_t get_adxrs290_iio_ch_raw(void *device, char *buf, size_t len,
 				const struct iio_ch_info *channel, intptr_t priv);
@@ -55,6 +57,10 @@ ssize_t set_adxrs290_iio_ch_lpf(void *device, char *buf, size_t len,
 ssize_t get_adxrs290_iio_ch_lpf(void *device, char *buf, size_t len,
 				const struct iio_ch_info *channel, intptr_t priv);
 int32_t adxrs290_update_active_channels(void *dev, uint32_t mask);
+int32_t adxrs290_end_transfer(void *device);
+int32_t adxrs290_trigger_read_scan(void *device, void *scan);
+int32_t adxrs290_iio_set_trigger(struct adxrs290_dev *dev,
+				 struct iio_trigger_desc *trigger);
 int32_t	adxrs290_read_samples(void *device, uint16_t *buff,
 			      uint32_t nb_samples);
 
@@ -148,7 +154,7 @@ struct iio_device adxrs290_iio_descriptor = {
 	.debug_attributes = NULL,
 	.buffer_attributes = NULL,
 	.prepare_transfer = adxrs290_update_active_channels,
-	.end_transfer = NULL,
+	.end_transfer = adxrs290_end_transfer,
 	.read_dev = (int32_t (*)())adxrs290_read_samples,
 	.debug_reg_read = (int32_t (*)())adxrs290_reg_read,
 	.debug_reg_write = (int32_t (*)())adxrs290_reg_write,
@@ -46,6 +46,7 @@
 #include <inttypes.h>
 #include <stdlib.h>
 #include "error.h"
+#include "delay.h"
 #include "iio.h"
 #include "iio_axi_dac.h"
 
@@ -54,6 +55,8 @@
 /******************************************************************************/
 
 #define STORAGE_BITS 16
+/* A buffer swap completes within one pass of the waveform played */
+#define WAVE_SWAP_TIMEOUT_MS 1000
 
 /**
  * @brief get_dds_calibscale().
@@ -486,8 +489,51 @@ int32_t iio_axi_dac_prepare_transfer(void *dev, uint32_t mask)
 	return SUCCESS;
 }
 
+/**
+ * @brief Write a chunk of the next waveform in the buffer not being played.
+ * @param dev - Instance of the iio_axi_dac
+ * @param pbuf - Samples to write
+ * @param offset - Offset of the chunk in the waveform
+ * @param bytes_count - Number of bytes to write
+ * @param ch_mask - Mask of the active channels
+ * @return bytes_count in case of success or negative value otherwise.
+ */
+static ssize_t iio_axi_dac_write_wave(void *dev, char *pbuf, size_t offset,
+				      size_t bytes_count, uint32_t ch_mask)
+{
+	struct iio_axi_dac_desc *iio_dac;
+	uint32_t timeout = 0;
+	bool swapped;
+
+	if (!dev)
+		return FAILURE;
+
+	iio_dac = (struct iio_axi_dac_desc *)dev;
+	if (offset + bytes_count > iio_dac->wave_buff_size)
+		return -ENOMEM;
+
+	/* The fill buffer may still be played until the last swap is done */
+	if (!offset) {
+		axi_dmac_is_repeat_swapped(iio_dac->dmac, &swapped);
+		while (!swapped) {
+			if (timeout++ == WAVE_SWAP_TIMEOUT_MS)
+				return -ETIMEDOUT;
+			mdelay(1);
+			axi_dmac_is_repeat_swapped(iio_dac->dmac, &swapped);
+		}
+	}
+
+	memcpy((char *)iio_dac->wave_buff[iio_dac->fill_idx] + offset, pbuf,
+	       bytes_count);
+
+	return bytes_count;
+}
+
 /**
  * @brief Update active channels
+ *
+ * When waveform buffers are used, the waveform written by
+ * iio_axi_dac_write_wave() is played and buff is not used.
  * @param dev - Instance of the iio_axi_dac
  * @param buff - Buffer where to read samples
  * @param nb_samples - Number of samples
@@ -497,6 +543,7 @@ int32_t iio_axi_dac_write_data(void *dev, void *buff, uint32_t nb_samples)
 {
 	struct iio_axi_dac_desc *iio_dac;
 	ssize_t bytes;
+	int32_t ret;
 
 	if (!dev)
 		return FAILURE;
@@ -504,12 +551,28 @@ int32_t iio_axi_dac_write_data(void *dev, void *buff, uint32_t nb_samples)
 	iio_dac = (struct iio_axi_dac_desc *)dev;
 	bytes = nb_samples * hweight8(iio_dac->mask) * (STORAGE_BITS / 8);
 
+	if (iio_dac->wave_buff[0]) {
+		if (bytes > iio_dac->wave_buff_size)
+			return -ENOMEM;
+		buff = iio_dac->wave_buff[iio_dac->fill_idx];
+	}
+
 	if(iio_dac->dcache_flush_range)
-		iio_dac->dcache_flush_range((uint32_t)buff, bytes);
+		iio_dac->dcache_flush_range((uintptr_t)buff, bytes);
 
-	iio_dac->dmac->flags = DMA_CYCLIC;
+	if (!iio_dac->wave_buff[0]) {
+		iio_dac->dmac->flags = DMA_CYCLIC;
 
-	return axi_dmac_transfer(iio_dac->dmac, (uint32_t)buff, bytes);
+		return axi_dmac_transfer(iio_dac->dmac, (uintptr_t)buff, bytes);
+	}
+
+	ret = axi_dmac_transfer_repeat(iio_dac->dmac, (uintptr_t)buff, bytes);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	iio_dac->fill_idx ^= 1;
+
+	return SUCCESS;
 }
 
 enum ch_type {
@@ -610,6 +673,8 @@ static int32_t iio_axi_dac_create_device_descriptor(
 	}
 	iio_device->prepare_transfer = iio_axi_dac_prepare_transfer;
 	iio_device->write_dev = iio_axi_dac_write_data;
+	if (desc->wave_buff[0])
+		iio_device->write_data = iio_axi_dac_write_wave;
 
 	return SUCCESS;
 
@@ -659,6 +724,11 @@ int32_t iio_axi_dac_init(struct iio_axi_dac_desc **desc,
 	iio_axi_dac_inst->dac = init->tx_dac;
 	iio_axi_dac_inst->dmac = init->tx_dmac;
 	iio_axi_dac_inst->dcache_flush_range = init->dcache_flush_range;
+	if (init->wave_buff[0] && init->wave_buff[1]) {
+		iio_axi_dac_inst->wave_buff[0] = init->wave_buff[0];
+		iio_axi_dac_inst->wave_buff[1] = init->wave_buff[1];
+		iio_axi_dac_inst->wave_buff_size = init->wave_buff_size;
+	}
 
 	status = iio_axi_dac_create_device_descriptor(iio_axi_dac_inst,
 			&iio_axi_dac_inst->dev_descriptor);
@@ -64,6 +64,12 @@ struct iio_axi_dac_desc {
 	uint32_t mask;
 	/** flush contents of instruction and/or data cache */
 	void (*dcache_flush_range)(uint32_t address, uint32_t bytes_count);
+	/** Waveform buffers played alternately, NULL if not used */
+	void *wave_buff[2];
+	/** Size in bytes of each waveform buffer */
+	uint32_t wave_buff_size;
+	/** Index of the waveform buffer filled by the next write */
+	uint8_t fill_idx;
 	/** iio device descriptor */
 	struct iio_device dev_descriptor;
 	/** Channel names */
@@ -81,6 +87,16 @@ struct iio_axi_dac_init_param {
 	struct axi_dmac *tx_dmac;
 	/** Function pointer to flush the data cache for the given address range */
 	void (*dcache_flush_range)(uint32_t address, uint32_t bytes_count);
+	/**
+	 * Optional pair of waveform buffers. If both are set, a new waveform
+	 * is written in the buffer not being played and replaces the current
+	 * one at the end of its cycle, without stopping the DMA. If NULL, the
+	 * write buffer is played cyclically and the DMA is restarted for
+	 * every new waveform.
+	 */
+	void *wave_buff[2];
+	/** Size in bytes of each waveform buffer */
+	uint32_t wave_buff_size;
 };
 
 /******************************************************************************/
@@ -0,0 +1,163 @@
+/***************************************************************************//**
+ *   @file   clk_plan.h
+ *   @brief  Header file of the multi-chip clock plan solver.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef CLK_PLAN_H_
+#define CLK_PLAN_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define CLK_PLAN_MAX_OUTPUTS	16
+#define CLK_PLAN_MAX_PARAMS	3
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct clk_plan_setting
+ * @brief Solved divider settings of one clock output. The meaning of the
+ * parameters is private to the driver that solved them.
+ */
+struct clk_plan_setting {
+	/** Driver specific divider values */
+	uint32_t	param[CLK_PLAN_MAX_PARAMS];
+	/** Rate actually produced by the divider values */
+	uint64_t	rate;
+};
+
+/**
+ * @struct clk_plan_output
+ * @brief One clock output that is part of the plan.
+ */
+struct clk_plan_output {
+	/** Clock chip device structure */
+	void		*dev;
+	/** Output channel of the clock chip */
+	uint32_t	chan;
+	/** Compute the divider settings for the requested rate */
+	int32_t (*solve)(void *dev, uint32_t chan, uint64_t rate,
+			 struct clk_plan_setting *setting);
+	/** Program precomputed divider settings */
+	int32_t (*apply)(void *dev, uint32_t chan,
+			 const struct clk_plan_setting *setting);
+};
+
+/**
+ * @struct clk_plan
+ * @brief A solved divider plan for all the outputs.
+ */
+struct clk_plan {
+	/** Reference rate the plan was solved for */
+	uint64_t		ref_rate;
+	/** Requested rate of each output */
+	uint64_t		req_rate[CLK_PLAN_MAX_OUTPUTS];
+	/** Solved settings of each output */
+	struct clk_plan_setting	setting[CLK_PLAN_MAX_OUTPUTS];
+	/** Last use stamp, used for replacement */
+	uint32_t		stamp;
+	/** Entry holds a solved plan */
+	bool			valid;
+};
+
+/**
+ * @struct clk_plan_init_param
+ * @brief Clock plan cache initialization parameters.
+ */
+struct clk_plan_init_param {
+	/** Clock outputs handled by the plan, in programming order */
+	const struct clk_plan_output	*outputs;
+	/** Number of clock outputs */
+	uint32_t			num_outputs;
+	/** Number of plans that are kept cached */
+	uint32_t			num_plans;
+};
+
+/**
+ * @struct clk_plan_desc
+ * @brief Clock plan cache descriptor.
+ */
+struct clk_plan_desc {
+	/** Clock outputs handled by the plan */
+	const struct clk_plan_output	*outputs;
+	/** Number of clock outputs */
+	uint32_t			num_outputs;
+	/** Cached plans */
+	struct clk_plan			*plans;
+	/** Number of cached plans */
+	uint32_t			num_plans;
+	/** Use counter */
+	uint32_t			stamp;
+	/** Number of lookups served from the cache */
+	uint32_t			hits;
+	/** Number of lookups that required solving */
+	uint32_t			misses;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Allocate a clock plan cache. */
+int32_t clk_plan_init(struct clk_plan_desc **desc,
+		      const struct clk_plan_init_param *param);
+
+/* Free the resources allocated by clk_plan_init(). */
+int32_t clk_plan_remove(struct clk_plan_desc *desc);
+
+/* Look up or compute the plan for a set of output rates. */
+int32_t clk_plan_solve(struct clk_plan_desc *desc, uint64_t ref_rate,
+		       const uint64_t *rates, struct clk_plan **plan);
+
+/* Program all the clock outputs from a solved plan. */
+int32_t clk_plan_apply(struct clk_plan_desc *desc,
+		       const struct clk_plan *plan);
+
+/* Solve (or look up) and program a set of output rates. */
+int32_t clk_plan_set_rates(struct clk_plan_desc *desc, uint64_t ref_rate,
+			   const uint64_t *rates);
+
+/* Drop all cached plans. */
+void clk_plan_flush(struct clk_plan_desc *desc);
+
+#endif // CLK_PLAN_H_
@@ -44,6 +44,7 @@
 /******************************************************************************/
 
 #include <stdint.h>
+#include "pool.h"
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -72,4 +73,12 @@ int32_t fifo_insert(struct fifo_element **p_fifo, char *buff, uint32_t len);
 /* Remove fifo head. */
 struct fifo_element *fifo_remove(struct fifo_element *p_fifo);
 
+/* Insert element to fifo tail, allocated from a pool when it fits. */
+int32_t fifo_insert_pool(struct fifo_element **p_fifo, char *buff,
+			 uint32_t len, struct pool *pool);
+
+/* Remove fifo head inserted with fifo_insert_pool(). */
+struct fifo_element *fifo_remove_pool(struct fifo_element *p_fifo,
+				      struct pool *pool);
+
 #endif /* FIFO_H_ */
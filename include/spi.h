@@ -90,6 +90,23 @@ typedef enum spi_bit_order {
  */
 struct spi_platform_ops ;
 
+/**
+ * @struct spi_msg
+ * @brief One segment of a multi-segment SPI message.
+ */
+struct spi_msg {
+	/** Buffer with the data to send. If NULL, 0x00 is sent. */
+	uint8_t		*tx_buff;
+	/** Buffer for the received data. If NULL, it is discarded. */
+	uint8_t		*rx_buff;
+	/** Number of bytes to transfer */
+	uint32_t	bytes_number;
+	/** Deassert CS after this segment, before the next one */
+	uint8_t		cs_change;
+	/** Delay in microseconds after this segment */
+	uint32_t	delay_us;
+};
+
 /**
  * @struct spi_init_param
  * @brief Structure holding the parameters for SPI initialization
@@ -124,6 +141,12 @@ typedef struct spi_desc {
 	const struct spi_platform_ops *platform_ops;
 	/**  SPI extra parameters (device specific) */
 	void		*extra;
+	/** Message segments queued by spi_msg_queue_add() */
+	struct spi_msg	*msg_queue;
+	/** Number of queued segments */
+	uint32_t	msg_queue_len;
+	/** Number of segments the queue can hold before growing */
+	uint32_t	msg_queue_size;
 } spi_desc;
 
 /**
@@ -136,6 +159,8 @@ struct spi_platform_ops {
 	int32_t (*spi_ops_init)(struct spi_desc **, const struct spi_init_param *);
 	/** SPI write/read function pointer */
 	int32_t (*spi_ops_write_and_read)(struct spi_desc *, uint8_t *, uint16_t);
+	/** Multi-segment transfer function pointer (optional) */
+	int32_t (*spi_ops_transfer)(struct spi_desc *, struct spi_msg *, uint32_t);
 	/** SPI remove function pointer */
 	int32_t (*spi_ops_remove)(struct spi_desc *);
 };
@@ -156,4 +181,19 @@ int32_t spi_write_and_read(struct spi_desc *desc,
 			   uint8_t *data,
 			   uint16_t bytes_number);
 
+/* Transfer a list of message segments. */
+int32_t spi_transfer(struct spi_desc *desc,
+		     struct spi_msg *msgs,
+		     uint32_t len);
+
+/* Append a segment to the message queue of the descriptor. */
+int32_t spi_msg_queue_add(struct spi_desc *desc,
+			  const struct spi_msg *msg);
+
+/* Transfer all the queued segments as one message and empty the queue. */
+int32_t spi_msg_queue_submit(struct spi_desc *desc);
+
+/* Drop the queued segments without transferring them. */
+void spi_msg_queue_reset(struct spi_desc *desc);
+
 #endif // SPI_H_
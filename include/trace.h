@@ -0,0 +1,165 @@
+/***************************************************************************//**
+ *   @file   trace.h
+ *   @brief  Binary event tracing into per-core ring buffers.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+#ifndef TRACE_H
+#define TRACE_H
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/*
+ * Trace points cost nothing unless the build defines TRACE_ENABLE, in which
+ * case util/trace.c must be built too. Unlike pr_debug() they only store the
+ * event id, a timestamp and up to TRACE_MAX_ARGS words, so they can be left
+ * in interrupt handlers and DMA completion paths.
+ */
+#ifdef TRACE_ENABLE
+#define trace_event0(id)	trace_record(id, 0, 0, 0, 0, 0)
+#define trace_event1(id, a0)	trace_record(id, 1, a0, 0, 0, 0)
+#define trace_event2(id, a0, a1) \
+	trace_record(id, 2, a0, a1, 0, 0)
+#define trace_event3(id, a0, a1, a2) \
+	trace_record(id, 3, a0, a1, a2, 0)
+#define trace_event4(id, a0, a1, a2, a3) \
+	trace_record(id, 4, a0, a1, a2, a3)
+#else
+#define trace_event0(id)			do { } while (0)
+#define trace_event1(id, a0)			do { } while (0)
+#define trace_event2(id, a0, a1)		do { } while (0)
+#define trace_event3(id, a0, a1, a2)		do { } while (0)
+#define trace_event4(id, a0, a1, a2, a3)	do { } while (0)
+#endif
+
+#define TRACE_MAX_ARGS		4
+
+/* Number of rings, one for each core writing events */
+#ifndef TRACE_NB_CORES
+#define TRACE_NB_CORES		1
+#endif
+
+/* Index of the ring of the calling core, overridden on multi-core builds */
+#ifndef TRACE_CORE_ID
+#define TRACE_CORE_ID()		0
+#endif
+
+/* Start of each frame written by trace_drain() */
+#define TRACE_FRAME_SYNC	0x5254
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum trace_id
+ * @brief Ids of the trace points in the library. Applications should number
+ * their own events from TRACE_ID_USER. Keep tools/scripts/trace_decode.py in
+ * sync when adding ids here.
+ */
+enum trace_id {
+	/** Events were overwritten before being read, arg0: count */
+	TRACE_ID_LOST,
+	/** AXI DMAC interrupt, arg0: pending flags, arg1: base address */
+	TRACE_ID_AXI_DMAC_IRQ,
+	/** SPI engine transfer, arg0: bytes, arg1: chip select */
+	TRACE_ID_SPI_ENGINE_XFER,
+	/** ADXL372 FIFO serviced, arg0: status1, arg1: entries read */
+	TRACE_ID_ADXL372_FIFO,
+	/** First id free for applications */
+	TRACE_ID_USER = 0x100,
+};
+
+/**
+ * @struct trace_event
+ * @brief Trace event as stored in the ring
+ */
+struct trace_event {
+	/** Ring index + 1 once the event is complete, 0 while it is written */
+	uint32_t	seq;
+	/** Value of the timestamp source when the event was recorded */
+	uint32_t	timestamp;
+	/** Event id, see \ref trace_id */
+	uint16_t	id;
+	/** Number of valid words in args */
+	uint8_t		nb_args;
+	/** Core that recorded the event */
+	uint8_t		core;
+	/** Event arguments */
+	uint32_t	args[TRACE_MAX_ARGS];
+};
+
+/**
+ * @struct trace_init_param
+ * @brief Trace initialization parameters
+ */
+struct trace_init_param {
+	/** Events in each ring, must be a power of 2 */
+	uint32_t	nb_events;
+	/**
+	 * Free running counter used for timestamps, for example a timer or
+	 * cycle counter read. Timestamps are 0 if NULL.
+	 */
+	uint32_t	(*timestamp)(void);
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+struct uart_desc;
+
+int32_t trace_init(const struct trace_init_param *param);
+void trace_remove(void);
+
+void trace_record(uint16_t id, uint8_t nb_args, uint32_t a0, uint32_t a1,
+		  uint32_t a2, uint32_t a3);
+
+int32_t trace_read(uint8_t core, struct trace_event *events, uint32_t max,
+		   uint32_t *nb_events, uint32_t *nb_lost);
+int32_t trace_drain(int32_t (*write)(void *ctx, const uint8_t *data,
+				     uint32_t len), void *ctx);
+int32_t trace_uart_drain(struct uart_desc *uart);
+
+#endif
@@ -144,11 +144,11 @@ int32_t uart_write(struct uart_desc *desc, const uint8_t *data,
 
 /* Read data from UART. Non blocking function */
 int32_t uart_read_nonblocking(struct uart_desc *desc, uint8_t *data,
-			      uint32_t bytes_number);
+			      uint32_t bytes_number, uint32_t *bytes_done);
 
 /* Write data to UART. Non blocking function*/
 int32_t uart_write_nonblocking(struct uart_desc *desc, const uint8_t *data,
-			       uint32_t bytes_number);
+			       uint32_t bytes_number, uint32_t *bytes_done);
 
 /* Initialize the UART communication peripheral. */
 int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param);
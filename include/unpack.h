@@ -0,0 +1,113 @@
+/***************************************************************************//**
+ *   @file   unpack.h
+ *   @brief  Unpack and deinterleave kernels for ADC sample formats.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef UNPACK_H
+#define UNPACK_H
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/*
+ * NEON and SSE2 paths are used when the compiler targets them. Define
+ * UNPACK_NO_SIMD to build the portable C path only.
+ */
+#if !defined(UNPACK_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define UNPACK_NEON
+#elif !defined(UNPACK_NO_SIMD) && defined(__SSE2__)
+#define UNPACK_SSE2
+#endif
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/*
+ * Packed formats are MSB first bit streams with the samples back to back, as
+ * clocked out by most SPI ADCs. Fast paths exist for 12, 16, 18, 20, 24 and
+ * 26 bits, any width from 1 to 32 bits is accepted.
+ */
+
+/* Unpack samples of bits width to zero-extended 32-bit values. */
+int32_t unpack_u32(uint32_t *dst, const uint8_t *src, uint32_t nb_samples,
+		   uint8_t bits);
+
+/* Unpack samples of bits width to sign-extended 32-bit values. */
+int32_t unpack_s32(int32_t *dst, const uint8_t *src, uint32_t nb_samples,
+		   uint8_t bits);
+
+/* Unpack samples of up to 16 bits to sign-extended 16-bit values. */
+int32_t unpack_s16(int16_t *dst, const uint8_t *src, uint32_t nb_samples,
+		   uint8_t bits);
+
+/*
+ * Left-justified formats hold one sample in the bits MSBs of each big endian
+ * 16-bit word, the LSBs carrying flags or zeros.
+ */
+
+/* Unpack left-justified samples to zero-extended 16-bit values. */
+int32_t unpack_ljust16_u16(uint16_t *dst, const uint8_t *src,
+			   uint32_t nb_samples, uint8_t bits);
+
+/* Unpack left-justified samples to sign-extended 16-bit values. */
+int32_t unpack_ljust16_s16(int16_t *dst, const uint8_t *src,
+			   uint32_t nb_samples, uint8_t bits);
+
+/*
+ * Keep the channels set in ch_mask out of interleaved 32-bit words, stored as
+ * (word >> shift) truncated to 16 bits. Returns the number of stored values.
+ */
+uint32_t unpack_select_u32_u16(uint16_t *dst, const uint32_t *src,
+			       uint32_t nb_words, uint8_t nb_channels,
+			       uint32_t ch_mask, uint8_t shift);
+
+/* Split interleaved 16-bit scans into one array per channel. */
+void deinterleave_u16(uint16_t **dst, const uint16_t *src,
+		      uint8_t nb_channels, uint32_t nb_scans);
+
+/* Split interleaved 32-bit scans into one array per channel. */
+void deinterleave_u32(uint32_t **dst, const uint32_t *src,
+		      uint8_t nb_channels, uint32_t nb_scans);
+
+#endif // UNPACK_H
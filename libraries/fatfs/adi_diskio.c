@@ -57,9 +57,52 @@
 #define DEV_USB		2	/* Example: Map USB MSD to physical drive 2 */
 
 #define ERASE_SECTOR_SIZE	1u
+
+/* Number of sectors held by the write-back cache */
+#ifndef DISKIO_CACHE_WAYS
+#define DISKIO_CACHE_WAYS	8u
+#endif
+
+/* Size of the RAM disk, allocated by disk_initialize() */
+#ifndef RAM_DISK_SECTORS
+#define RAM_DISK_SECTORS	256u
+#endif
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct cache_way
+ * @brief Sector held by the write-back cache
+ */
+struct cache_way {
+	/** Sector data */
+	uint8_t		buff[DATA_BLOCK_LEN] __attribute__ ((aligned));
+	/** Sector number */
+	LBA_t		sector;
+	/** Value of cache_clock at the last access, for LRU replacement */
+	uint32_t	age;
+	/** Physical drive of the sector */
+	BYTE		pdrv;
+	/** Set if the way holds a sector */
+	bool		valid;
+	/** Set if the sector was not written to the drive yet */
+	bool		dirty;
+};
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
 uint8_t			sd_init_var = false;
 extern struct sd_desc	*sd_desc;
 
+static uint8_t		*ram_disk;
+
+static struct cache_way	cache[DISKIO_CACHE_WAYS];
+static uint32_t		cache_clock;
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
@@ -68,6 +111,147 @@ DSTATUS SD_disk_status();
 DSTATUS SD_disk_initialize();
 DRESULT SD_disk_read(BYTE *buff, LBA_t sector, UINT count);
 DRESULT SD_disk_write(BYTE *buff, LBA_t sector, UINT count);
+DRESULT SD_disk_write_ways(struct cache_way **ways, UINT count);
+DSTATUS RAM_disk_status();
+DSTATUS RAM_disk_initialize();
+DRESULT RAM_disk_read(BYTE *buff, LBA_t sector, UINT count);
+DRESULT RAM_disk_write(const BYTE *buff, LBA_t sector, UINT count);
+
+/*-----------------------------------------------------------------------*/
+/* Write-back sector cache                                               */
+/*-----------------------------------------------------------------------*/
+
+static DRESULT raw_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count)
+{
+	switch (pdrv) {
+	case DEV_SD :
+		return SD_disk_read(buff, sector, count);
+	case DEV_RAM :
+		return RAM_disk_read(buff, sector, count);
+	}
+	return RES_NOTRDY;
+}
+
+static DRESULT raw_write(BYTE pdrv, const BYTE *buff, LBA_t sector,
+			 UINT count)
+{
+	switch (pdrv) {
+	case DEV_SD :
+		return SD_disk_write((BYTE *)buff, sector, count);
+	case DEV_RAM :
+		return RAM_disk_write(buff, sector, count);
+	}
+	return RES_NOTRDY;
+}
+
+/* Write cache ways holding consecutive sectors, with one command if possible */
+static DRESULT raw_write_ways(BYTE pdrv, struct cache_way **ways, UINT count)
+{
+	DRESULT	res;
+	UINT	i;
+
+	if (pdrv == DEV_SD)
+		return SD_disk_write_ways(ways, count);
+
+	for (i = 0; i < count; i++) {
+		res = raw_write(pdrv, ways[i]->buff, ways[i]->sector, 1);
+		if (res != RES_OK)
+			return res;
+	}
+
+	return RES_OK;
+}
+
+static struct cache_way *cache_find(BYTE pdrv, LBA_t sector, bool dirty)
+{
+	UINT i;
+
+	for (i = 0; i < DISKIO_CACHE_WAYS; i++)
+		if (cache[i].valid && cache[i].pdrv == pdrv &&
+		    cache[i].sector == sector && (!dirty || cache[i].dirty))
+			return &cache[i];
+
+	return NULL;
+}
+
+/* Write all dirty sectors of a drive, coalescing consecutive ones */
+static DRESULT cache_flush(BYTE pdrv)
+{
+	struct cache_way	*run[DISKIO_CACHE_WAYS];
+	struct cache_way	*way;
+	DRESULT			res;
+	UINT			nb;
+	UINT			i;
+
+	while (true) {
+		/* Lowest dirty sector starts the next run */
+		run[0] = NULL;
+		for (i = 0; i < DISKIO_CACHE_WAYS; i++)
+			if (cache[i].valid && cache[i].dirty &&
+			    cache[i].pdrv == pdrv &&
+			    (!run[0] || cache[i].sector < run[0]->sector))
+				run[0] = &cache[i];
+		if (!run[0])
+			return RES_OK;
+
+		nb = 1;
+		while (nb < DISKIO_CACHE_WAYS) {
+			way = cache_find(pdrv, run[nb - 1]->sector + 1, true);
+			if (!way)
+				break;
+			run[nb++] = way;
+		}
+
+		res = raw_write_ways(pdrv, run, nb);
+		if (res != RES_OK)
+			return res;
+
+		for (i = 0; i < nb; i++)
+			run[i]->dirty = false;
+	}
+}
+
+/* Get a free way, writing back the cache if the LRU one is dirty */
+static struct cache_way *cache_alloc(BYTE pdrv, LBA_t sector)
+{
+	struct cache_way	*way;
+	UINT			i;
+
+	way = &cache[0];
+	for (i = 0; i < DISKIO_CACHE_WAYS; i++) {
+		if (!cache[i].valid) {
+			way = &cache[i];
+			break;
+		}
+		if (cache[i].age < way->age)
+			way = &cache[i];
+	}
+
+	if (way->valid && way->dirty)
+		if (cache_flush(way->pdrv) != RES_OK)
+			return NULL;
+
+	way->pdrv = pdrv;
+	way->sector = sector;
+	way->valid = true;
+	way->dirty = false;
+
+	return way;
+}
+
+/* Drop the cached copies of sectors about to be written directly */
+static void cache_invalidate(BYTE pdrv, LBA_t sector, UINT count)
+{
+	UINT i;
+
+	for (i = 0; i < DISKIO_CACHE_WAYS; i++)
+		if (cache[i].valid && cache[i].pdrv == pdrv &&
+		    cache[i].sector >= sector &&
+		    cache[i].sector < sector + count) {
+			cache[i].valid = false;
+			cache[i].dirty = false;
+		}
+}
 
 /*-----------------------------------------------------------------------*/
 /* Get Drive Status                                                      */
@@ -80,7 +264,7 @@ DSTATUS disk_status (
 	case DEV_SD :
 		return SD_disk_status();;
 	case DEV_RAM :
-		return STA_NODISK;
+		return RAM_disk_status();
 	case DEV_USB :
 		return STA_NODISK;
 	default:
@@ -100,7 +284,7 @@ DSTATUS disk_initialize (
 	case DEV_SD :
 		return SD_disk_initialize();
 	case DEV_RAM :
-		return STA_NODISK;
+		return RAM_disk_initialize();
 	case DEV_USB :
 		return STA_NODISK;
 	}
@@ -117,16 +301,37 @@ DRESULT disk_read (
 	LBA_t sector,		/* Start sector in LBA */
 	UINT count)		/* Number of sectors to read */
 {
+	struct cache_way	*way;
+	DRESULT			res;
+	UINT			i;
+	UINT			j;
+
+	if (pdrv != DEV_SD && pdrv != DEV_RAM)
+		return (pdrv == DEV_USB) ? RES_NOTRDY : RES_PARERR;
+
+	/* Cached sectors are copied, runs of the others read at once */
+	i = 0;
+	while (i < count) {
+		way = cache_find(pdrv, sector + i, false);
+		if (way) {
+			way->age = ++cache_clock;
+			memcpy(buff + i * DATA_BLOCK_LEN, way->buff,
+			       DATA_BLOCK_LEN);
+			i++;
+			continue;
+		}
 
-	switch (pdrv) {
-	case DEV_SD :
-		return SD_disk_read(buff, sector, count);
-	case DEV_RAM :
-		return RES_NOTRDY;
-	case DEV_USB :
-		return RES_NOTRDY;
+		for (j = i + 1; j < count; j++)
+			if (cache_find(pdrv, sector + j, false))
+				break;
+		res = raw_read(pdrv, buff + i * DATA_BLOCK_LEN, sector + i,
+			       j - i);
+		if (res != RES_OK)
+			return res;
+		i = j;
 	}
-	return RES_PARERR;
+
+	return RES_OK;
 }
 
 /*-----------------------------------------------------------------------*/
@@ -142,16 +347,33 @@ DRESULT disk_write (
 	UINT count		/* Number of sectors to write */
 )
 {
-	switch (pdrv) {
-	case DEV_SD:
-		return SD_disk_write(buff, sector, count);
-	case DEV_RAM :
-		return RES_NOTRDY;
-	case DEV_USB :
+	struct cache_way	*way;
+	UINT			i;
+
+	if (pdrv != DEV_SD && pdrv != DEV_RAM)
+		return (pdrv == DEV_USB) ? RES_NOTRDY : RES_PARERR;
+	if (disk_status(pdrv) & STA_NOINIT)
 		return RES_NOTRDY;
+
+	/* Writes as large as the cache go straight to the drive */
+	if (count >= DISKIO_CACHE_WAYS) {
+		cache_invalidate(pdrv, sector, count);
+		return raw_write(pdrv, buff, sector, count);
 	}
 
-	return RES_PARERR;
+	for (i = 0; i < count; i++) {
+		way = cache_find(pdrv, sector + i, false);
+		if (!way)
+			way = cache_alloc(pdrv, sector + i);
+		if (!way)
+			return RES_ERROR;
+
+		memcpy(way->buff, buff + i * DATA_BLOCK_LEN, DATA_BLOCK_LEN);
+		way->dirty = true;
+		way->age = ++cache_clock;
+	}
+
+	return RES_OK;
 }
 
 #endif
@@ -168,7 +390,7 @@ DRESULT disk_ioctl (
 	switch(pdrv) {
 	case DEV_SD:
 		switch (cmd){
-		case CTRL_SYNC: return RES_OK;
+		case CTRL_SYNC: return cache_flush(pdrv);
 		case GET_SECTOR_COUNT:
 			*(LBA_t *)buff = sd_desc->memory_size / DATA_BLOCK_LEN;
 			return RES_OK;
@@ -186,7 +408,20 @@ DRESULT disk_ioctl (
 		}
 		return RES_PARERR;
 	case DEV_RAM:
-		return RES_NOTRDY;
+		switch (cmd){
+		case CTRL_SYNC: return cache_flush(pdrv);
+		case GET_SECTOR_COUNT:
+			*(LBA_t *)buff = RAM_DISK_SECTORS;
+			return RES_OK;
+		case GET_SECTOR_SIZE:
+			*(WORD *)buff = DATA_BLOCK_LEN;
+			return RES_OK;
+		case GET_BLOCK_SIZE:
+			*(DWORD *)buff = ERASE_SECTOR_SIZE;
+			return RES_OK;
+		default: return RES_OK;
+		}
+		return RES_PARERR;
 	case DEV_USB:
 		return RES_NOTRDY;
 	}
@@ -230,4 +465,65 @@ DRESULT SD_disk_write(BYTE *buff, LBA_t sector, UINT count)
 	return RES_OK;
 }
 
+/* Write consecutive cached sectors with a single CMD25 */
+DRESULT SD_disk_write_ways(struct cache_way **ways, UINT count)
+{
+	UINT	i;
+
+	if (count == 1)
+		return SD_disk_write(ways[0]->buff, ways[0]->sector, 1);
+
+	if (!sd_init_var)
+		return RES_NOTRDY;
+	if (SUCCESS != sd_stream_begin(sd_desc, SD_STREAM_WRITE,
+				       (uint64_t)ways[0]->sector * 512))
+		return RES_ERROR;
+	for (i = 0; i < count; i++)
+		if (SUCCESS != sd_stream_push(sd_desc, ways[i]->buff, 1))
+			break;
+	if (SUCCESS != sd_stream_stop(sd_desc) || i != count)
+		return RES_ERROR;
+
+	return RES_OK;
+}
+
+DSTATUS RAM_disk_status()
+{
+	if (ram_disk)
+		return 0;
+	return STA_NOINIT;
+}
+
+DSTATUS RAM_disk_initialize()
+{
+	if (!ram_disk)
+		ram_disk = calloc(RAM_DISK_SECTORS, DATA_BLOCK_LEN);
+	if (!ram_disk)
+		return STA_NOINIT;
 
+	return 0;
+}
+
+DRESULT RAM_disk_read(BYTE *buff, LBA_t sector, UINT count)
+{
+	if (!ram_disk)
+		return RES_NOTRDY;
+	if (sector >= RAM_DISK_SECTORS || count > RAM_DISK_SECTORS - sector)
+		return RES_PARERR;
+	memcpy(buff, ram_disk + (size_t)sector * DATA_BLOCK_LEN,
+	       (size_t)count * DATA_BLOCK_LEN);
+
+	return RES_OK;
+}
+
+DRESULT RAM_disk_write(const BYTE *buff, LBA_t sector, UINT count)
+{
+	if (!ram_disk)
+		return RES_NOTRDY;
+	if (sector >= RAM_DISK_SECTORS || count > RAM_DISK_SECTORS - sector)
+		return RES_PARERR;
+	memcpy(ram_disk + (size_t)sector * DATA_BLOCK_LEN, buff,
+	       (size_t)count * DATA_BLOCK_LEN);
+
+	return RES_OK;
+}
@@ -298,6 +298,8 @@ static char *get_channel_id(enum iio_chan_type type)
 		return "anglvel";
 	case IIO_TEMP:
 		return "temp";
+	case IIO_ACCEL:
+		return "accel";
 	default:
 		return "";
 	}
@@ -0,0 +1,133 @@
+/***************************************************************************//**
+ *   @file   iio_trace.c
+ *   @brief  Drain of the event trace through an IIO attribute.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include "iio_trace.h"
+#include "trace.h"
+#include "error.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Longest line: timestamp, core, id and TRACE_MAX_ARGS hex words */
+#define IIO_TRACE_LINE_MAX	(24 + 11 * TRACE_MAX_ARGS)
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Format an event as a text line.
+ * @param buf - Where to write the line, IIO_TRACE_LINE_MAX bytes available.
+ * @param ev - The event.
+ * @return Length of the line.
+ */
+static ssize_t iio_trace_line(char *buf, const struct trace_event *ev)
+{
+	ssize_t	len;
+	uint8_t	i;
+
+	len = snprintf(buf, IIO_TRACE_LINE_MAX, "%"PRIu32" %u 0x%x",
+		       ev->timestamp, ev->core, ev->id);
+	for (i = 0; i < ev->nb_args && i < TRACE_MAX_ARGS; i++)
+		len += snprintf(buf + len, IIO_TRACE_LINE_MAX - len,
+				" 0x%"PRIx32, ev->args[i]);
+	buf[len++] = '\n';
+
+	return len;
+}
+
+/**
+ * @brief Drain the trace rings as text, one event per line.
+ *
+ * Each line holds the timestamp, the core, the event id and the arguments of
+ * an event. Lost events are reported as a TRACE_ID_LOST event. Only the
+ * events that fit in buf are read, the others stay in the rings for the next
+ * read of the attribute. Add IIO_TRACE_ATTRIBUTE to the attributes of a
+ * device to use it.
+ * @param device - Unused.
+ * @param buf - Where to write the lines.
+ * @param len - Size of buf.
+ * @param channel - Unused.
+ * @param priv - Unused.
+ * @return Number of bytes written, 0 if there is no event, negative error
+ *	   code if tracing is not initialized.
+ */
+ssize_t iio_trace_show(void *device, char *buf, size_t len,
+		       const struct iio_ch_info *channel, intptr_t priv)
+{
+	struct trace_event	lost_ev = { .id = TRACE_ID_LOST, .nb_args = 1 };
+	struct trace_event	ev;
+	uint32_t		core;
+	uint32_t		lost;
+	uint32_t		n;
+	ssize_t			pos = 0;
+	int32_t			ret;
+
+	for (core = 0; core < TRACE_NB_CORES; core++) {
+		/* Room for a lost report and an event */
+		while (len - pos >= 2 * IIO_TRACE_LINE_MAX) {
+			ret = trace_read(core, &ev, 1, &n, &lost);
+			if (ret < 0)
+				return pos ? pos : ret;
+
+			if (lost) {
+				lost_ev.core = core;
+				lost_ev.args[0] = lost;
+				lost_ev.timestamp = n ? ev.timestamp : 0;
+				pos += iio_trace_line(buf + pos, &lost_ev);
+			}
+			if (!n)
+				break;
+
+			pos += iio_trace_line(buf + pos, &ev);
+		}
+	}
+
+	/* Keep the text NUL terminated when there is room for it */
+	if ((size_t)pos < len)
+		buf[pos] = '\0';
+
+	return pos;
+}
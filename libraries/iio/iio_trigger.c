@@ -0,0 +1,405 @@
+/***************************************************************************//**
+ *   @file   iio_trigger.c
+ *   @brief  Implementation of the IIO trigger.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "iio_trigger.h"
+#include "error.h"
+#include "util.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Initialize an IIO trigger.
+ *
+ * Each interrupt of the trigger source reads one scan from the device and
+ * pushes it, together with a timestamp, to a ring of nb_scans records. The
+ * IIO read_dev callback of the device then only has to drain the ring.
+ * @param desc - Where to store the trigger descriptor.
+ * @param param - Initialization parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_trigger_init(struct iio_trigger_desc **desc,
+			 const struct iio_trigger_init_param *param)
+{
+	struct iio_trigger_desc	*trig;
+	int32_t			ret;
+
+	if (!desc || !param || !param->irq_ctrl || !param->scan_size ||
+	    !param->nb_scans)
+		return -EINVAL;
+
+	/* Either one scan per interrupt or blocks of at most a ring */
+	if (!param->read_scan == !param->read_block ||
+	    (param->read_block && (!param->block_scans ||
+				   param->block_scans > param->nb_scans)))
+		return -EINVAL;
+
+	trig = (struct iio_trigger_desc *)calloc(1, sizeof(*trig));
+	if (!trig)
+		return -ENOMEM;
+
+	trig->irq_ctrl = param->irq_ctrl;
+	trig->irq_id = param->irq_id;
+	trig->dev = param->dev;
+	trig->read_scan = param->read_scan;
+	trig->read_block = param->read_block;
+	trig->block_scans = param->read_block ? param->block_scans : 1;
+	trig->nb_scans = param->nb_scans;
+	trig->get_time_ns = param->get_time_ns;
+	trig->scan_size = param->scan_size;
+	/* Keep the timestamps of the records 8 bytes aligned */
+	trig->record_size = sizeof(uint64_t) +
+			    (((param->scan_size + 7) / 8) * 8);
+
+	trig->callback.callback = iio_trigger_handler;
+	trig->callback.ctx = trig;
+	trig->callback.config = param->irq_config;
+
+	trig->irq_record = calloc(trig->block_scans + 1, trig->record_size);
+	if (!trig->irq_record) {
+		ret = -ENOMEM;
+		goto error_trig;
+	}
+	trig->read_record = trig->irq_record +
+			    trig->block_scans * trig->record_size;
+
+	/*
+	 * The ring only ever holds whole records, so an overrun resynchronizes
+	 * the reader on a record boundary.
+	 */
+	ret = cb_init(&trig->ring, trig->record_size * param->nb_scans);
+	if (IS_ERR_VALUE(ret))
+		goto error_record;
+
+	*desc = trig;
+
+	return SUCCESS;
+
+error_record:
+	free(trig->irq_record);
+error_trig:
+	free(trig);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by iio_trigger_init().
+ * @param desc - Trigger descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_trigger_remove(struct iio_trigger_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	if (desc->enabled)
+		iio_trigger_disable(desc);
+
+	cb_remove(desc->ring);
+	free(desc->irq_record);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Flush the ring and start acquiring scans on interrupt.
+ * @param desc - Trigger descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_trigger_enable(struct iio_trigger_desc *desc)
+{
+	uint32_t	size;
+	int32_t		ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (desc->enabled)
+		return SUCCESS;
+
+	/* Drop the scans left over from a previous capture */
+	cb_size(desc->ring, &size);
+	while (size >= desc->record_size) {
+		cb_read(desc->ring, desc->read_record, desc->record_size);
+		size -= desc->record_size;
+	}
+
+	desc->nb_acquired = 0;
+	desc->overruns = 0;
+	desc->errors = 0;
+
+	ret = irq_register_callback(desc->irq_ctrl, desc->irq_id,
+				    &desc->callback);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	desc->enabled = true;
+	ret = irq_enable(desc->irq_ctrl, desc->irq_id);
+	if (IS_ERR_VALUE(ret)) {
+		desc->enabled = false;
+		irq_unregister(desc->irq_ctrl, desc->irq_id);
+		return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Stop acquiring scans. Scans already in the ring can still be read.
+ * @param desc - Trigger descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_trigger_disable(struct iio_trigger_desc *desc)
+{
+	int32_t ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (!desc->enabled)
+		return SUCCESS;
+
+	ret = irq_disable(desc->irq_ctrl, desc->irq_id);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	desc->enabled = false;
+
+	return irq_unregister(desc->irq_ctrl, desc->irq_id);
+}
+
+/**
+ * @brief Move the scans buffered by the device to the ring.
+ *
+ * Sources such as FIFO watermarks stay asserted until the device buffer is
+ * drained, so read_block is called again until it returns no scan, or until
+ * a ring worth of scans was read. The scans read on one interrupt share its
+ * timestamp.
+ * @param desc - Trigger descriptor.
+ * @param timestamp - Time of the interrupt.
+ */
+static void iio_trigger_read_block(struct iio_trigger_desc *desc,
+				   uint64_t timestamp)
+{
+	uint64_t	stamp;
+	uint32_t	total;
+	uint32_t	nb;
+	uint32_t	i;
+	int32_t		ret;
+
+	total = 0;
+	do {
+		ret = desc->read_block(desc->dev,
+				       desc->irq_record + sizeof(uint64_t),
+				       desc->record_size);
+		if (IS_ERR_VALUE(ret)) {
+			desc->errors++;
+			return;
+		}
+
+		nb = min_t(uint32_t, ret, desc->block_scans);
+		for (i = 0; i < nb; i++) {
+			stamp = desc->get_time_ns ? timestamp :
+				desc->nb_acquired;
+			memcpy(desc->irq_record + i * desc->record_size, &stamp,
+			       sizeof(stamp));
+			desc->nb_acquired++;
+		}
+
+		/* The records are contiguous, push the block at once */
+		if (nb)
+			cb_write(desc->ring, desc->irq_record,
+				 nb * desc->record_size);
+		total += nb;
+	} while (nb && total < desc->nb_scans);
+}
+
+/**
+ * @brief Acquire one scan, or a block of them, and push it to the ring.
+ *
+ * Registered as the interrupt callback of the trigger source. It can also be
+ * called directly by sources that are not interrupt driven.
+ * @param ctx - Trigger descriptor.
+ * @param event - Unused.
+ * @param extra - Unused.
+ */
+void iio_trigger_handler(void *ctx, uint32_t event, void *extra)
+{
+	struct iio_trigger_desc	*desc = ctx;
+	uint64_t		timestamp;
+	int32_t			ret;
+
+	if (!desc || !desc->enabled)
+		return;
+
+	/* Stamp the scan as close to the interrupt as possible */
+	if (desc->get_time_ns)
+		timestamp = desc->get_time_ns();
+	else
+		timestamp = desc->nb_acquired;
+
+	if (desc->read_block) {
+		iio_trigger_read_block(desc, timestamp);
+		return;
+	}
+
+	ret = desc->read_scan(desc->dev, desc->irq_record + sizeof(uint64_t));
+	if (ret == -EAGAIN)
+		return;
+	if (IS_ERR_VALUE(ret)) {
+		desc->errors++;
+		return;
+	}
+
+	memcpy(desc->irq_record, &timestamp, sizeof(timestamp));
+	cb_write(desc->ring, desc->irq_record, desc->record_size);
+	desc->nb_acquired++;
+}
+
+/**
+ * @brief Start assembling scans of the given channels. Drops the partial scan,
+ *	  if any.
+ * @param seq - Scan assembly state.
+ * @param mask - Channels of a scan, one bit per channel.
+ * @param sample_size - Size of one sample, in bytes.
+ */
+void iio_trigger_seq_reset(struct iio_trigger_seq *seq, uint32_t mask,
+			   uint32_t sample_size)
+{
+	seq->mask = mask;
+	seq->fill = 0;
+	seq->sample_size = sample_size;
+}
+
+/**
+ * @brief Store the sample of a channel in the scan being assembled, at the
+ *	  slot given by the rank of the channel in the mask.
+ *
+ * Meant to be called from read_scan. A scan is complete once every channel of
+ * the mask has a sample. A channel that already has one means the sequence
+ * wrapped around over a lost conversion: the partial scan is dropped and
+ * assembly restarts with this sample, so the channels of a scan never mix
+ * samples of two sequence cycles.
+ * @param seq - Scan assembly state.
+ * @param scan - Scan being assembled, same buffer on every call.
+ * @param ch - Channel of the sample.
+ * @param sample - Sample, seq->sample_size bytes.
+ * @return SUCCESS once the scan is complete, -EAGAIN while it is not, -EIO if
+ *	   a partial scan was dropped.
+ */
+int32_t iio_trigger_seq_add(struct iio_trigger_seq *seq, void *scan,
+			    uint8_t ch, const void *sample)
+{
+	uint32_t	below;
+	uint32_t	slot;
+	uint32_t	bit;
+	bool		dropped;
+
+	if (ch >= 32)
+		return -EAGAIN;
+
+	bit = (uint32_t)1 << ch;
+	if (!(seq->mask & bit))
+		return -EAGAIN;
+
+	below = seq->mask & (bit - 1);
+	dropped = seq->fill & ~below;
+	if (dropped)
+		seq->fill = 0;
+
+	slot = hweight8(below & 0xFF) + hweight8((below >> 8) & 0xFF) +
+	       hweight8((below >> 16) & 0xFF) + hweight8(below >> 24);
+	memcpy((uint8_t *)scan + slot * seq->sample_size, sample,
+	       seq->sample_size);
+
+	seq->fill |= bit;
+	if (seq->fill != seq->mask)
+		return dropped ? -EIO : -EAGAIN;
+
+	seq->fill = 0;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Drain scans from the ring. Blocks until nb_scans are available.
+ * @param desc - Trigger descriptor.
+ * @param buff - Where to store the scans, packed back to back.
+ * @param scan_bytes - Number of bytes to copy from each scan.
+ * @param nb_scans - Number of scans to read.
+ * @param timestamps - Where to store the timestamp of each scan. May be NULL.
+ * @return Number of scans read in case of success, negative error code
+ * otherwise. Scans lost to an overrun are counted in desc->overruns.
+ */
+int32_t iio_trigger_read(struct iio_trigger_desc *desc, void *buff,
+			 uint32_t scan_bytes, uint32_t nb_scans,
+			 uint64_t *timestamps)
+{
+	uint8_t		*dst = buff;
+	uint32_t	i;
+	int32_t		ret;
+
+	if (!desc || !buff || scan_bytes > desc->scan_size)
+		return -EINVAL;
+
+	for (i = 0; i < nb_scans; i++) {
+		ret = cb_read(desc->ring, desc->read_record,
+			      desc->record_size);
+		if (ret == -EOVERRUN)
+			desc->overruns++;
+		else if (IS_ERR_VALUE(ret))
+			return ret;
+
+		if (timestamps)
+			memcpy(&timestamps[i], desc->read_record,
+			       sizeof(uint64_t));
+		memcpy(dst, desc->read_record + sizeof(uint64_t), scan_bytes);
+		dst += scan_bytes;
+	}
+
+	return nb_scans;
+}
@@ -0,0 +1,195 @@
+/***************************************************************************//**
+ *   @file   iio_trigger.h
+ *   @brief  Header file of the IIO trigger.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef IIO_TRIGGER_H_
+#define IIO_TRIGGER_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "irq.h"
+#include "circular_buffer.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct iio_trigger_init_param
+ * @brief IIO trigger initialization parameters.
+ */
+struct iio_trigger_init_param {
+	/** Interrupt controller the trigger source is connected to */
+	struct irq_ctrl_desc	*irq_ctrl;
+	/** Interrupt of the trigger source (data ready GPIO, timer...) */
+	uint32_t		irq_id;
+	/** Platform specific interrupt configuration */
+	void			*irq_config;
+	/** Device instance passed to read_scan */
+	void			*dev;
+	/**
+	 * Read one scan from the device. Called from interrupt context.
+	 * Sources that convert one channel per interrupt fill the scan over
+	 * several calls, returning -EAGAIN until it is complete.
+	 * @param dev - Same as \ref iio_trigger_init_param.dev
+	 * @param scan - Where to store the scan, scan_size bytes available.
+	 *		 Kept between calls.
+	 * @return SUCCESS once the scan is complete, -EAGAIN while it is not,
+	 *	   other negative error code otherwise.
+	 */
+	int32_t			(*read_scan)(void *dev, void *scan);
+	/**
+	 * Read the scans buffered by the device, for sources such as FIFO
+	 * watermark interrupts. Used instead of read_scan. Called from
+	 * interrupt context, again until it returns 0.
+	 * @param dev - Same as \ref iio_trigger_init_param.dev
+	 * @param scans - Where to store the first scan. Scans are stride
+	 *		  bytes apart and up to block_scans can be stored.
+	 * @param stride - Distance between two scans, in bytes
+	 * @return Number of scans read, negative error code otherwise.
+	 */
+	int32_t			(*read_block)(void *dev, void *scans,
+					      uint32_t stride);
+	/** Maximum number of scans returned by one read_block call */
+	uint32_t		block_scans;
+	/** Maximum size of a scan, in bytes */
+	uint32_t		scan_size;
+	/** Number of scans the ring can hold */
+	uint32_t		nb_scans;
+	/**
+	 * Monotonic time source in nanoseconds. If NULL, scans are stamped
+	 * with their sequence number.
+	 */
+	uint64_t		(*get_time_ns)(void);
+};
+
+/**
+ * @struct iio_trigger_desc
+ * @brief IIO trigger descriptor.
+ */
+struct iio_trigger_desc {
+	/** Interrupt controller the trigger source is connected to */
+	struct irq_ctrl_desc	*irq_ctrl;
+	/** Interrupt of the trigger source */
+	uint32_t		irq_id;
+	/** Callback registered on the interrupt */
+	struct callback_desc	callback;
+	/** Device instance passed to read_scan */
+	void			*dev;
+	/** Read one scan from the device */
+	int32_t			(*read_scan)(void *dev, void *scan);
+	/** Read the scans buffered by the device */
+	int32_t			(*read_block)(void *dev, void *scans,
+					      uint32_t stride);
+	/** Maximum number of scans returned by one read_block call */
+	uint32_t		block_scans;
+	/** Number of scans the ring can hold */
+	uint32_t		nb_scans;
+	/** Monotonic time source */
+	uint64_t		(*get_time_ns)(void);
+	/** Maximum size of a scan, in bytes */
+	uint32_t		scan_size;
+	/** Size of a ring record: timestamp followed by the scan */
+	uint32_t		record_size;
+	/** Ring holding the acquired records */
+	struct circular_buffer	*ring;
+	/** Records being filled in interrupt context, block_scans of them */
+	uint8_t			*irq_record;
+	/** Record being drained by the reader */
+	uint8_t			*read_record;
+	/** Number of scans acquired since the trigger was enabled */
+	volatile uint32_t	nb_acquired;
+	/** Number of times the reader lost scans because the ring was full */
+	volatile uint32_t	overruns;
+	/** Number of scans read_scan failed to acquire */
+	volatile uint32_t	errors;
+	/** Set while the interrupt is enabled */
+	bool			enabled;
+};
+
+/**
+ * @struct iio_trigger_seq
+ * @brief Scan assembly for sources that convert one channel per interrupt,
+ *	  such as sigma-delta ADCs cycling through a channel sequence.
+ */
+struct iio_trigger_seq {
+	/** Channels of a scan, one bit per channel */
+	uint32_t		mask;
+	/** Channels of the scan being assembled that already have a sample */
+	uint32_t		fill;
+	/** Size of one sample, in bytes */
+	uint32_t		sample_size;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize an IIO trigger. */
+int32_t iio_trigger_init(struct iio_trigger_desc **desc,
+			 const struct iio_trigger_init_param *param);
+
+/* Free the resources allocated by iio_trigger_init(). */
+int32_t iio_trigger_remove(struct iio_trigger_desc *desc);
+
+/* Flush the ring and start acquiring scans on interrupt. */
+int32_t iio_trigger_enable(struct iio_trigger_desc *desc);
+
+/* Stop acquiring scans. */
+int32_t iio_trigger_disable(struct iio_trigger_desc *desc);
+
+/* Acquire one scan, or a block of them, and push it to the ring. */
+void iio_trigger_handler(void *ctx, uint32_t event, void *extra);
+
+/* Start assembling scans of the given channels. */
+void iio_trigger_seq_reset(struct iio_trigger_seq *seq, uint32_t mask,
+			   uint32_t sample_size);
+
+/* Store the sample of a channel in the scan being assembled. */
+int32_t iio_trigger_seq_add(struct iio_trigger_seq *seq, void *scan,
+			    uint8_t ch, const void *sample);
+
+/* Drain scans and, optionally, their timestamps from the ring. */
+int32_t iio_trigger_read(struct iio_trigger_desc *desc, void *buff,
+			 uint32_t scan_bytes, uint32_t nb_scans,
+			 uint64_t *timestamps);
+
+#endif /* IIO_TRIGGER_H_ */
@@ -45,7 +45,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
-#include "tinyiiod.h"
+#include <sys/types.h>
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -61,6 +61,7 @@ enum iio_chan_type {
 	IIO_ALTVOLTAGE,
 	IIO_ANGL_VEL,
 	IIO_TEMP,
+	IIO_ACCEL,
 	/* All new types must be added before this field */
 	IIO_LAST_TYPE
 };
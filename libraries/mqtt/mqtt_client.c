@@ -46,51 +46,437 @@
 #include "mqtt_client.h"
 #include "MQTTClient.h"
 #include "error.h"
+#include "util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Size of PUBACK, PUBREC, PUBREL and PUBCOMP packets */
+#define MQTT_ACK_LEN	4
+/* DUP flag of the fixed header */
+#define MQTT_DUP_FLAG	0x08
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+/* State of a message from the publish queue */
+enum mqtt_slot_state {
+	/* Serialized, waiting to be sent */
+	MQTT_SLOT_QUEUED,
+	/* QoS1 or QoS2 sent, waiting for PUBACK or PUBREC */
+	MQTT_SLOT_WAIT_ACK,
+	/* QoS2 PUBREC received, PUBREL waiting to be sent */
+	MQTT_SLOT_REL_QUEUED,
+	/* QoS2 PUBREL sent, waiting for PUBCOMP */
+	MQTT_SLOT_WAIT_COMP,
+	/* Finished, slot can be reused */
+	MQTT_SLOT_DONE
+};
+
+/* Message from the publish queue */
+struct mqtt_pub_slot {
+	/* Serialized publish packet */
+	uint8_t			*packet;
+	/* Length of the serialized packet */
+	uint32_t		len;
+	/* Packet identifier. Not used for QoS0 */
+	uint16_t		packet_id;
+	/* QoS of the message */
+	enum mqtt_qos		qos;
+	/* Current state */
+	enum mqtt_slot_state	state;
+};
+
 struct mqtt_desc {
 	MQTTClient		mqtt_client[1];
 	Network			network;
+	/* Handler and context from the init param */
+	void			(*message_handler)(struct mqtt_message_data *);
+	void			*handler_ctx;
+	/* Publish queue. Messages are kept in order from queue_head */
+	struct mqtt_pub_slot	*slots;
+	uint8_t			*queue_buff;
+	uint32_t		queue_len;
+	uint32_t		queue_head;
+	uint32_t		queue_count;
+	uint32_t		publish_max_len;
+	/* Maximum and current number of unacknowledged QoS1/QoS2 messages */
+	uint32_t		window;
+	uint32_t		inflight;
 };
 
 /******************************************************************************/
 /**************************** Global Variables ********************************/
 /******************************************************************************/
 
-/* TODO: After initial commit, modify MQTT to support context to enable handler
- * for multiple clients */
-static void (*app_handler)(struct mqtt_message_data *);
+/*
+ * The paho message handler has no context parameter. The client calling into
+ * paho is saved here so the message can be routed to its handler.
+ */
+static struct mqtt_desc *mqtt_active_desc;
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
-/* Callback used in MQTT subscribe */
-static void mqtt_default_message_handler(MessageData *msg)
+/* Call the handler of desc with a received message */
+static void mqtt_deliver(struct mqtt_desc *desc, MQTTLenString *topic,
+			 void *payload, uint32_t len, enum mqtt_qos qos,
+			 bool retained)
 {
 	struct mqtt_message_data	data;
-	MQTTLenString			*topic;
 
-	data.message.len = (uint32_t)msg->message->payloadlen;
-	data.message.payload = (uint8_t *)msg->message->payload;
-	data.message.qos = (enum mqtt_qos)msg->message->qos;
-	data.message.retained = (bool)msg->message->retained;
+	if (!desc || !desc->message_handler)
+		return ;
+
+	data.message.len = len;
+	data.message.payload = (uint8_t *)payload;
+	data.message.qos = qos;
+	data.message.retained = retained;
+	data.ctx = desc->handler_ctx;
 
-	topic = &msg->topicName->lenstring;
 	data.topic = (uint8_t *)malloc(topic->len + 1);
 	if (!data.topic)
 		return ;
 	memcpy(data.topic, topic->data, topic->len);
 	data.topic[topic->len] = '\0';
 
-	app_handler(&data);
+	desc->message_handler(&data);
 
 	free(data.topic);
 }
 
+/* Callback used in MQTT subscribe */
+static void mqtt_default_message_handler(MessageData *msg)
+{
+	mqtt_deliver(mqtt_active_desc, &msg->topicName->lenstring,
+		     msg->message->payload,
+		     (uint32_t)msg->message->payloadlen,
+		     (enum mqtt_qos)msg->message->qos,
+		     (bool)msg->message->retained);
+}
+
+/* Same packet identifier sequence as the one used by paho */
+static uint16_t mqtt_next_packet_id(struct mqtt_desc *desc)
+{
+	MQTTClient *c = desc->mqtt_client;
+
+	c->next_packetid = (c->next_packetid == MAX_PACKET_ID) ? 1 :
+			   c->next_packetid + 1;
+
+	return (uint16_t)c->next_packetid;
+}
+
+/*
+ * Send a whole packet within the command timeout. If the packet could only be
+ * sent in part or the socket failed, the stream is out of sync with the broker
+ * and the session is marked as disconnected. The queued messages are sent
+ * again by \ref mqtt_connect.
+ */
+static int32_t mqtt_write(struct mqtt_desc *desc, uint8_t *buff, uint32_t len)
+{
+	MQTTClient	*c = desc->mqtt_client;
+	Timer		timer;
+	uint32_t	sent;
+	int		rc;
+
+	TimerCountdownMS(&timer, c->command_timeout_ms);
+	sent = 0;
+	rc = 0;
+	while (sent < len && !TimerIsExpired(&timer)) {
+		rc = c->ipstack->mqttwrite(c->ipstack, buff + sent, len - sent,
+					   TimerLeftMS(&timer));
+		if (IS_ERR_VALUE(rc))
+			break;
+		sent += rc;
+	}
+	if (sent < len) {
+		if (sent || IS_ERR_VALUE(rc)) {
+			c->isconnected = 0;
+			c->ping_outstanding = 0;
+		}
+
+		return IS_ERR_VALUE(rc) ? rc : -ETIMEDOUT;
+	}
+
+	TimerCountdown(&c->last_sent, c->keepAliveInterval);
+
+	return SUCCESS;
+}
+
+/* Send PUBACK, PUBREC, PUBREL or PUBCOMP */
+static int32_t mqtt_send_ack(struct mqtt_desc *desc, uint8_t type,
+			     uint16_t packet_id)
+{
+	uint8_t	buff[MQTT_ACK_LEN];
+	int	len;
+
+	len = MQTTSerialize_ack(buff, sizeof(buff), type, 0, packet_id);
+	if (len <= 0)
+		return FAILURE;
+
+	return mqtt_write(desc, buff, len);
+}
+
+/* Get the slot at position idx from the queue head */
+static struct mqtt_pub_slot *mqtt_queue_slot(struct mqtt_desc *desc,
+		uint32_t idx)
+{
+	return &desc->slots[(desc->queue_head + idx) % desc->queue_len];
+}
+
+/* Find the queued message waiting for an acknowledge of packet_id */
+static struct mqtt_pub_slot *mqtt_queue_find(struct mqtt_desc *desc,
+		uint16_t packet_id)
+{
+	struct mqtt_pub_slot	*slot;
+	uint32_t		i;
+
+	for (i = 0; i < desc->queue_count; i++) {
+		slot = mqtt_queue_slot(desc, i);
+		if (slot->qos != MQTT_QOS0 && slot->packet_id == packet_id &&
+		    slot->state != MQTT_SLOT_DONE)
+			return slot;
+	}
+
+	return NULL;
+}
+
+/*
+ * Send the queued packets in order. QoS1 and QoS2 publishes are sent as long
+ * as the in-flight window allows it, without waiting for the acknowledges of
+ * the previous ones. When the window is full, the publishes waiting for it
+ * are skipped but the QoS0 publishes and the pending PUBRELs behind them are
+ * still sent, since these do not take a window entry.
+ */
+static int32_t mqtt_queue_send(struct mqtt_desc *desc)
+{
+	struct mqtt_pub_slot	*slot;
+	uint32_t		i;
+	int32_t			ret;
+
+	if (!desc->mqtt_client->isconnected)
+		return SUCCESS;
+
+	for (i = 0; i < desc->queue_count; i++) {
+		slot = mqtt_queue_slot(desc, i);
+		if (slot->state == MQTT_SLOT_QUEUED) {
+			if (slot->qos != MQTT_QOS0 &&
+			    desc->inflight >= desc->window)
+				continue;
+			ret = mqtt_write(desc, slot->packet, slot->len);
+			if (IS_ERR_VALUE(ret))
+				return ret;
+			if (slot->qos == MQTT_QOS0) {
+				slot->state = MQTT_SLOT_DONE;
+			} else {
+				slot->state = MQTT_SLOT_WAIT_ACK;
+				desc->inflight++;
+			}
+		} else if (slot->state == MQTT_SLOT_REL_QUEUED) {
+			ret = mqtt_send_ack(desc, PUBREL, slot->packet_id);
+			if (IS_ERR_VALUE(ret))
+				return ret;
+			slot->state = MQTT_SLOT_WAIT_COMP;
+		}
+	}
+
+	/* Release the finished messages from the head of the queue */
+	while (desc->queue_count &&
+	       desc->slots[desc->queue_head].state == MQTT_SLOT_DONE) {
+		desc->queue_head = (desc->queue_head + 1) % desc->queue_len;
+		desc->queue_count--;
+	}
+
+	return SUCCESS;
+}
+
+/*
+ * After a reconnect, the messages not acknowledged are sent again. Publishes
+ * are sent with the DUP flag set, QoS2 messages that got PUBREC continue with
+ * PUBREL.
+ */
+static void mqtt_queue_rewind(struct mqtt_desc *desc)
+{
+	struct mqtt_pub_slot	*slot;
+	uint32_t		i;
+
+	for (i = 0; i < desc->queue_count; i++) {
+		slot = mqtt_queue_slot(desc, i);
+		if (slot->state == MQTT_SLOT_WAIT_ACK) {
+			slot->packet[0] |= MQTT_DUP_FLAG;
+			slot->state = MQTT_SLOT_QUEUED;
+			desc->inflight--;
+		} else if (slot->state == MQTT_SLOT_WAIT_COMP) {
+			slot->state = MQTT_SLOT_REL_QUEUED;
+		}
+	}
+}
+
+/*
+ * Read a packet in the read buffer of the client.
+ * Returns the packet type, 0 if nothing was received until the timer expired
+ * or a negative error code.
+ */
+static int32_t mqtt_read_packet(struct mqtt_desc *desc, Timer *timer)
+{
+	MQTTClient	*c = desc->mqtt_client;
+	MQTTHeader	header;
+	uint32_t	rem_len;
+	uint32_t	mult;
+	uint32_t	len;
+	int		rc;
+
+	rc = c->ipstack->mqttread(c->ipstack, c->readbuf, 1,
+				  TimerLeftMS(timer));
+	if (rc != 1)
+		return IS_ERR_VALUE(rc) ? rc : 0;
+
+	/* The rest of the packet is already on its way, use command timeout */
+	len = 1;
+	rem_len = 0;
+	mult = 1;
+	do {
+		if (len >= 5 || len >= c->readbuf_size)
+			return -EBADMSG;
+		rc = c->ipstack->mqttread(c->ipstack, &c->readbuf[len], 1,
+					  c->command_timeout_ms);
+		if (rc != 1)
+			return IS_ERR_VALUE(rc) ? rc : -ETIMEDOUT;
+		rem_len += (c->readbuf[len] & 0x7F) * mult;
+		mult <<= 7;
+	} while (c->readbuf[len++] & 0x80);
+
+	if (len + rem_len > c->readbuf_size)
+		return -ENOMEM;
+
+	if (rem_len) {
+		rc = c->ipstack->mqttread(c->ipstack, &c->readbuf[len],
+					  rem_len, c->command_timeout_ms);
+		if (rc != (int)rem_len)
+			return IS_ERR_VALUE(rc) ? rc : -ETIMEDOUT;
+	}
+
+	TimerCountdown(&c->last_received, c->keepAliveInterval);
+	header.byte = c->readbuf[0];
+
+	return header.bits.type;
+}
+
+/* Handle a packet received by mqtt_read_packet */
+static int32_t mqtt_handle_packet(struct mqtt_desc *desc, uint8_t type)
+{
+	MQTTClient		*c = desc->mqtt_client;
+	struct mqtt_pub_slot	*slot;
+	MQTTString		topic;
+	uint8_t			*payload;
+	uint8_t			dup;
+	uint8_t			retained;
+	uint8_t			ack_type;
+	uint16_t		packet_id;
+	int			payload_len;
+	int			qos;
+
+	switch (type) {
+	case PUBLISH:
+		if (MQTTDeserialize_publish(&dup, &qos, &retained, &packet_id,
+					    &topic, &payload, &payload_len,
+					    c->readbuf, c->readbuf_size) != 1)
+			return -EBADMSG;
+		mqtt_deliver(desc, &topic.lenstring, payload, payload_len,
+			     (enum mqtt_qos)qos, retained);
+		if (qos == QOS1)
+			return mqtt_send_ack(desc, PUBACK, packet_id);
+		if (qos == QOS2)
+			return mqtt_send_ack(desc, PUBREC, packet_id);
+		break;
+	case PUBREL:
+	case PUBACK:
+	case PUBREC:
+	case PUBCOMP:
+		if (MQTTDeserialize_ack(&ack_type, &dup, &packet_id,
+					c->readbuf, c->readbuf_size) != 1)
+			return -EBADMSG;
+		if (type == PUBREL)
+			return mqtt_send_ack(desc, PUBCOMP, packet_id);
+
+		slot = mqtt_queue_find(desc, packet_id);
+		if (!slot)
+			break;
+		if (type == PUBREC && slot->state == MQTT_SLOT_WAIT_ACK) {
+			slot->state = MQTT_SLOT_REL_QUEUED;
+		} else if ((type == PUBACK &&
+			    slot->state == MQTT_SLOT_WAIT_ACK) ||
+			   (type == PUBCOMP &&
+			    slot->state == MQTT_SLOT_WAIT_COMP)) {
+			slot->state = MQTT_SLOT_DONE;
+			desc->inflight--;
+		}
+		break;
+	case PINGRESP:
+		c->ping_outstanding = 0;
+		break;
+	default:
+		break;
+	}
+
+	return SUCCESS;
+}
+
+/* Send PINGREQ when the keep alive interval expires, like paho does */
+static int32_t mqtt_keepalive(struct mqtt_desc *desc)
+{
+	MQTTClient	*c = desc->mqtt_client;
+	int32_t		ret;
+	int		len;
+
+	if (!c->keepAliveInterval)
+		return SUCCESS;
+
+	if (!TimerIsExpired(&c->last_sent) &&
+	    !TimerIsExpired(&c->last_received))
+		return SUCCESS;
+
+	/* PINGRESP not received in keep alive interval */
+	if (c->ping_outstanding)
+		return -ETIMEDOUT;
+
+	len = MQTTSerialize_pingreq(c->buf, c->buf_size);
+	if (len <= 0)
+		return FAILURE;
+
+	ret = mqtt_write(desc, c->buf, len);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	c->ping_outstanding = 1;
+
+	return SUCCESS;
+}
+
+/* Send queued packets and process at most one incoming packet */
+static int32_t mqtt_cycle(struct mqtt_desc *desc, Timer *timer)
+{
+	int32_t ret;
+
+	ret = mqtt_queue_send(desc);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	ret = mqtt_read_packet(desc, timer);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+	if (ret) {
+		ret = mqtt_handle_packet(desc, ret);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	return mqtt_keepalive(desc);
+}
+
 /**
  * @brief Initialize the MQTT client
  * @param desc - Address where to store the MQTT client reference
@@ -103,26 +489,49 @@ int32_t mqtt_init(struct mqtt_desc **desc,
 		  struct mqtt_init_param *param)
 {
 	struct mqtt_desc	*ldesc;
+	uint32_t		i;
 	int32_t			ret;
 
 	if (!desc || !param)
 		return FAILURE;
 
+	if (param->publish_queue_len && !param->publish_max_len)
+		return FAILURE;
+
 	ldesc = (struct mqtt_desc *)calloc(1, sizeof(*ldesc));
 	if (!ldesc)
 		return FAILURE;
 
-	ret = mqtt_timer_init(param->timer_id, param->extra_timer_init_param);
-	if (IS_ERR_VALUE(ret)) {
-		free(ldesc);
-		return FAILURE;
+	if (param->publish_queue_len) {
+		ldesc->slots = (struct mqtt_pub_slot *)calloc(
+				       param->publish_queue_len,
+				       sizeof(*ldesc->slots));
+		ldesc->queue_buff = (uint8_t *)calloc(param->publish_queue_len,
+						      param->publish_max_len);
+		if (!ldesc->slots || !ldesc->queue_buff)
+			goto error;
+
+		for (i = 0; i < param->publish_queue_len; i++)
+			ldesc->slots[i].packet = ldesc->queue_buff +
+						 i * param->publish_max_len;
+		ldesc->queue_len = param->publish_queue_len;
+		ldesc->publish_max_len = param->publish_max_len;
+		ldesc->window = param->publish_window ?
+				min(param->publish_window,
+				    param->publish_queue_len) :
+				param->publish_queue_len;
 	}
 
+	ret = mqtt_timer_init(param->timer_id, param->extra_timer_init_param);
+	if (IS_ERR_VALUE(ret))
+		goto error;
+
 	ldesc->network.sock = param->sock;
 	ldesc->network.mqttread = mqtt_noos_read;
 	ldesc->network.mqttwrite = mqtt_noos_write;
 
-	app_handler = param->message_handler;
+	ldesc->message_handler = param->message_handler;
+	ldesc->handler_ctx = param->handler_ctx;
 
 	MQTTClientInit(ldesc->mqtt_client, &ldesc->network,
 		       (unsigned int)param->command_timeout_ms,
@@ -134,6 +543,12 @@ int32_t mqtt_init(struct mqtt_desc **desc,
 	*desc = ldesc;
 
 	return SUCCESS;
+error:
+	free(ldesc->queue_buff);
+	free(ldesc->slots);
+	free(ldesc);
+
+	return FAILURE;
 }
 
 /**
@@ -148,6 +563,11 @@ int32_t mqtt_remove(struct mqtt_desc *desc)
 	if (!desc)
 		return FAILURE;
 
+	if (mqtt_active_desc == desc)
+		mqtt_active_desc = NULL;
+
+	free(desc->queue_buff);
+	free(desc->slots);
 	free(desc);
 	mqtt_timer_remove();
 
@@ -156,6 +576,9 @@ int32_t mqtt_remove(struct mqtt_desc *desc)
 
 /**
  * @brief Send connect to MQTT broker
+ *
+ * Messages from the publish queue which were not acknowledged before the
+ * connection was lost are sent again once the connection is accepted.
  * @param desc - Reference to MQTT client
  * @param conf - Connect options
  * @param result_optional - Address to store the result for the connect command.
@@ -181,17 +604,23 @@ int32_t mqtt_connect(struct mqtt_desc *desc,
 	data.password.cstring = (char *)conf->password;
 	data.keepAliveInterval = (unsigned short)conf->keep_alive_ms;
 
+	mqtt_active_desc = desc;
 	ret = MQTTConnectWithResults(desc->mqtt_client, &data, &res);
 	if (result_optional) {
 		result_optional->rc = res.rc;
 		result_optional->session_present = res.sessionPresent;
 	}
 
+	if (ret == SUCCESS)
+		mqtt_queue_rewind(desc);
+
 	return ret;
 }
 
 /**
  * @brief Send disconnect to MQTT broker
+ *
+ * The publish queue is flushed first, within the command timeout.
  * @param desc - Reference to MQTT client
  * @return
  *  - \ref SUCCESS : On success
@@ -202,11 +631,17 @@ int32_t mqtt_disconnect(struct mqtt_desc *desc)
 	if (!desc)
 		return FAILURE;
 
+	mqtt_flush(desc, desc->mqtt_client->command_timeout_ms);
+	mqtt_active_desc = desc;
+
 	return MQTTDisconnect(desc->mqtt_client);
 }
 
 /**
  * @brief Send publish to MQTT broker
+ *
+ * The call blocks until the message is acknowledged by the broker. Messages
+ * queued with \ref mqtt_publish_async are flushed first to keep the order.
  * @param desc - Reference to MQTT client
  * @param topic - Topic pattern which can include wildcards
  * @param msg - Message to send
@@ -217,6 +652,8 @@ int32_t mqtt_disconnect(struct mqtt_desc *desc)
 int32_t mqtt_publish(struct mqtt_desc *desc, const int8_t* topic,
 		     const struct mqtt_message* msg)
 {
+	int32_t	ret;
+
 	if (!desc || !msg)
 		return FAILURE;
 
@@ -227,9 +664,106 @@ int32_t mqtt_publish(struct mqtt_desc *desc, const int8_t* topic,
 	message.qos = (enum QoS)msg->qos;
 	message.retained = (unsigned char)msg->retained;
 
+	ret = mqtt_flush(desc, desc->mqtt_client->command_timeout_ms);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	mqtt_active_desc = desc;
+
 	return MQTTPublish(desc->mqtt_client, (char *)topic, &message);
 }
 
+/**
+ * @brief Queue a publish without waiting for the broker
+ *
+ * The message is serialized in the publish queue and sent right away if the
+ * in-flight window allows it. QoS1 and QoS2 messages stay in the queue until
+ * acknowledged; the acknowledges are processed by \ref mqtt_yield and
+ * \ref mqtt_flush. Send errors are also reported by these calls.
+ * @param desc - Reference to MQTT client
+ * @param topic - Topic to publish on
+ * @param msg - Message to send. It is copied so it can be reused after return.
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EAGAIN : The queue is full. Call \ref mqtt_yield and try again
+ *  - Negative error code otherwise
+ */
+int32_t mqtt_publish_async(struct mqtt_desc *desc, const int8_t* topic,
+			   const struct mqtt_message* msg)
+{
+	struct mqtt_pub_slot	*slot;
+	MQTTString		topic_str = MQTTString_initializer;
+	uint16_t		packet_id;
+	int			len;
+
+	if (!desc || !topic || !msg || !desc->slots)
+		return -EINVAL;
+
+	if (desc->queue_count == desc->queue_len) {
+		mqtt_queue_send(desc);
+		if (desc->queue_count == desc->queue_len)
+			return -EAGAIN;
+	}
+
+	packet_id = 0;
+	if (msg->qos != MQTT_QOS0)
+		packet_id = mqtt_next_packet_id(desc);
+
+	slot = mqtt_queue_slot(desc, desc->queue_count);
+	topic_str.cstring = (char *)topic;
+	len = MQTTSerialize_publish(slot->packet, desc->publish_max_len, 0,
+				    (int)msg->qos, (unsigned char)msg->retained,
+				    packet_id, topic_str, msg->payload,
+				    (int)msg->len);
+	if (len <= 0)
+		return -ENOMEM;
+
+	slot->len = len;
+	slot->packet_id = packet_id;
+	slot->qos = msg->qos;
+	slot->state = MQTT_SLOT_QUEUED;
+	desc->queue_count++;
+
+	mqtt_queue_send(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Wait for the queued publishes to be acknowledged
+ *
+ * Incoming messages are delivered to the handler meanwhile.
+ * @param desc - Reference to MQTT client
+ * @param timeout_ms - Maximum time to wait
+ * @return
+ *  - \ref SUCCESS : The publish queue is empty
+ *  - -ETIMEDOUT : Messages still in the queue after timeout_ms
+ *  - Negative error code otherwise
+ */
+int32_t mqtt_flush(struct mqtt_desc *desc, uint32_t timeout_ms)
+{
+	Timer	timer;
+	int32_t	ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (!desc->queue_count)
+		return SUCCESS;
+
+	if (!desc->mqtt_client->isconnected)
+		return -ENOTCONN;
+
+	TimerCountdownMS(&timer, timeout_ms);
+	do {
+		ret = mqtt_cycle(desc, &timer);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	} while (desc->queue_count && !TimerIsExpired(&timer));
+
+	return desc->queue_count ? -ETIMEDOUT : SUCCESS;
+}
+
 /**
  * @brief Send subscribe to MQTT broker
  * @param desc - Reference to MQTT client
@@ -250,6 +784,11 @@ int32_t mqtt_subscribe(struct mqtt_desc *desc, const int8_t *topic,
 	if (!desc)
 		return FAILURE;
 
+	ret = mqtt_flush(desc, desc->mqtt_client->command_timeout_ms);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	mqtt_active_desc = desc;
 	ret = MQTTSubscribeWithResults(desc->mqtt_client, (char *)topic,
 				       (enum QoS)qos,
 				       mqtt_default_message_handler,
@@ -270,9 +809,17 @@ int32_t mqtt_subscribe(struct mqtt_desc *desc, const int8_t *topic,
  */
 int32_t mqtt_unsubscribe(struct mqtt_desc *desc, const int8_t* topic)
 {
+	int32_t	ret;
+
 	if (!desc)
 		return FAILURE;
 
+	ret = mqtt_flush(desc, desc->mqtt_client->command_timeout_ms);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	mqtt_active_desc = desc;
+
 	return MQTTUnsubscribe(desc->mqtt_client, (char *)topic);
 }
 
@@ -282,7 +829,9 @@ int32_t mqtt_unsubscribe(struct mqtt_desc *desc, const int8_t* topic)
  * A call to this API must be made within the
  * \ref mqtt_connect_config.keep_alive_ms interval to keep the MQTT connection
  * alive. \n
- * Yield can be called if no other MQTT operation is needed.
+ * Yield can be called if no other MQTT operation is needed. \n
+ * Queued publishes are sent and their acknowledges processed meanwhile. With
+ * a timeout of 0 only what is already available on the socket is handled.
  * @param desc - Reference to MQTT client
  * @param timeout_ms - Time for yield to be executed
  * @return
@@ -291,5 +840,22 @@ int32_t mqtt_unsubscribe(struct mqtt_desc *desc, const int8_t* topic)
  */
 int32_t mqtt_yield(struct mqtt_desc *desc, uint32_t timeout_ms)
 {
-	return MQTTYield(desc->mqtt_client, timeout_ms);
+	Timer	timer;
+	int32_t	ret;
+
+	if (!desc)
+		return FAILURE;
+
+	mqtt_active_desc = desc;
+	if (!desc->slots)
+		return MQTTYield(desc->mqtt_client, timeout_ms);
+
+	TimerCountdownMS(&timer, timeout_ms);
+	do {
+		ret = mqtt_cycle(desc, &timer);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	} while (!TimerIsExpired(&timer));
+
+	return SUCCESS;
 }
@@ -92,6 +92,8 @@
  * 		.len = strlen("Hello World\n")
  * 	};
  * 	mqtt_publish(mqtt, "my_publish", &msg);
+ * 	//Or, with publish_queue_len set, queue it and go on
+ * 	mqtt_publish_async(mqtt, "my_publish", &msg);
  * 	//Subscribe
  * 	mqtt_subscribe(mqtt, "my_subscribe", MQTT_QOS0, NULL);
  * 	while (true)
@@ -201,6 +203,8 @@ struct mqtt_message_data {
 	struct mqtt_message	message;
 	/** Topic */
 	uint8_t			*topic;
+	/** \ref mqtt_init_param.handler_ctx of the receiving client */
+	void			*ctx;
 };
 
 /**
@@ -232,6 +236,20 @@ struct mqtt_init_param {
 	 * @param Message received from the broker.
 	 */
 	void			(*message_handler)(struct mqtt_message_data *);
+	/** Context passed to message_handler in \ref mqtt_message_data.ctx */
+	void			*handler_ctx;
+	/**
+	 * Number of messages \ref mqtt_publish_async can queue. If 0, only
+	 * the blocking \ref mqtt_publish is available.
+	 */
+	uint32_t		publish_queue_len;
+	/** Maximum size of a publish packet: topic, payload and 7 bytes */
+	uint32_t		publish_max_len;
+	/**
+	 * Maximum number of QoS1 and QoS2 messages waiting to be acknowledged
+	 * by the broker. If 0, publish_queue_len is used.
+	 */
+	uint32_t		publish_window;
 };
 
 /**
@@ -267,5 +285,10 @@ int32_t mqtt_subscribe(struct mqtt_desc *desc, const int8_t *topic,
 int32_t mqtt_unsubscribe(struct mqtt_desc *desc, const int8_t* topic);
 /* Allow messages to be received */
 int32_t mqtt_yield(struct mqtt_desc *desc, uint32_t timeout_ms);
+/* Queue a publish without waiting for the broker */
+int32_t mqtt_publish_async(struct mqtt_desc *desc, const int8_t* topic,
+			   const struct mqtt_message* msg);
+/* Wait for the queued publishes to be acknowledged */
+int32_t mqtt_flush(struct mqtt_desc *desc, uint32_t timeout_ms);
 
 #endif
@@ -46,7 +46,6 @@
 #include "timer.h"
 #include "error.h"
 #include "util.h"
-#include "delay.h"
 #include "error.h"
 
 /******************************************************************************/
@@ -147,33 +146,37 @@ char TimerIsExpired(Timer* t)
 	return false;
 }
 
-/* Implementation of mqtt_noos_read used by MQTTClient.c */
+/*
+ * Implementation of mqtt_noos_read used by MQTTClient.c
+ * The socket is polled until the data is available or the timeout expires,
+ * without sleeping in between. A timeout of 0 checks the socket once.
+ */
 int mqtt_noos_read(Network* net, unsigned char* buff, int len, int timeout)
 {
-	uint32_t	sent;
+	Timer		timer;
+	uint32_t	recv;
 	int32_t		rc;
 
 	if (!len)
 		return 0;
 
-	sent = 0;
+	TimerCountdownMS(&timer, timeout);
+	recv = 0;
 	do {
- 		rc = socket_recv(net->sock, (void *)(buff + sent),
-				(uint32_t)(len - sent));
- 		if (rc != -EAGAIN) { //If data available or error
- 			if (IS_ERR_VALUE(rc))
- 				return rc;
-				 
- 			sent += rc;
- 			if (sent >= len)
- 				return sent;
- 		}
-
-		mdelay(1);
-	} while (--timeout);
-
-	/* 0 bytes have been read */
-	return 0;
+		rc = socket_recv(net->sock, (void *)(buff + recv),
+				 (uint32_t)(len - recv));
+		if (rc != -EAGAIN) { //If data available or error
+			if (IS_ERR_VALUE(rc))
+				return rc;
+
+			recv += rc;
+			if (recv >= len)
+				return recv;
+		}
+	} while (!TimerIsExpired(&timer));
+
+	/* Number of bytes read before the timeout */
+	return recv;
 }
 
 /* Implementation of mqtt_noos_write used by MQTTClient.c */
@@ -91,6 +91,13 @@ int32_t mqtt_timer_init(uint32_t timer_id, void *extra_init_param);
 /* Uninit porting file */
 void mqtt_timer_remove();
 
+/* Timer functions used by MQTTClient.c */
+void TimerInit(Timer* t);
+void TimerCountdownMS(Timer* t, unsigned int ms);
+void TimerCountdown(Timer* t, unsigned int seconds);
+int TimerLeftMS(Timer* t);
+char TimerIsExpired(Timer* t);
+
 /* Function to be linked to Network.mqttread */
 int mqtt_noos_read(Network*, unsigned char*, int, int);
 /* Function to be linked to Network.mqttwrite */
@@ -92,6 +92,33 @@
  */
 #define MAX_CONTENT_LEN 2500
 
+/*
+ * Keep the session of the last connection and offer it, by session id or
+ * session ticket, when the socket connects again. A resumed handshake skips
+ * the certificate verification and the ECDHE key exchange.
+ */
+#define ENABLE_SESSION_RESUMPTION
+
+/*
+ * Generate the TLS random numbers with a CTR_DRBG seeded from the hardware
+ * TRNG, instead of reading every random byte from the TRNG.
+ */
+#define ENABLE_CTR_DRBG
+
+/*
+ * Elliptic curve multiplication speed/memory trade-offs.
+ * ECP_WINDOW_SIZE: 2 to 6. Larger windows are faster and use more RAM.
+ * ECP_FIXED_POINT_OPTIM: 1 to keep precomputed multiples of the curve
+ * generator, faster ECDHE at the cost of RAM per curve. 0 to disable.
+ * ENABLE_ECP_NIST_OPTIM: fast modular reduction for the NIST curves, at the
+ * cost of code size.
+ * When not defined, ENABLE_MEMORY_OPTIMIZATIONS selects a window of 2 and
+ * otherwise the mbedtls defaults are used.
+ */
+//#define ECP_WINDOW_SIZE		4
+//#define ECP_FIXED_POINT_OPTIM		1
+//#define ENABLE_ECP_NIST_OPTIM
+
 /*
  * ENABLE_MEMORY_OPTIMIZATIONS should be defined in the case memory
  * is not enough. This could happen is using both a secure connection with
@@ -150,10 +177,32 @@
 #ifdef ENABLE_MEMORY_OPTIMIZATIONS
 
 #define MBEDTLS_AES_ROM_TABLES
+#ifndef ECP_WINDOW_SIZE
 #define MBEDTLS_ECP_WINDOW_SIZE 2
+#endif
 
 #endif /* ENABLE_MEMORY_OPTIMIZATIONS */
 
+#ifdef ECP_WINDOW_SIZE
+#define MBEDTLS_ECP_WINDOW_SIZE		ECP_WINDOW_SIZE
+#endif
+
+#ifdef ECP_FIXED_POINT_OPTIM
+#define MBEDTLS_ECP_FIXED_POINT_OPTIM	ECP_FIXED_POINT_OPTIM
+#endif
+
+#ifdef ENABLE_ECP_NIST_OPTIM
+#define MBEDTLS_ECP_NIST_OPTIM
+#endif
+
+#ifdef ENABLE_SESSION_RESUMPTION
+#define MBEDTLS_SSL_SESSION_TICKETS
+#endif
+
+#ifdef ENABLE_CTR_DRBG
+#define MBEDTLS_CTR_DRBG_C
+#endif
+
 #ifdef ENABLE_PEM_CERT
 
 #define MBEDTLS_BASE64_C
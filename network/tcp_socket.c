@@ -43,14 +43,19 @@
 /******************************************************************************/
 
 #include <stdlib.h>
+#include <string.h>
 #include "error.h"
 #include "tcp_socket.h"
 #include "util.h"
+#include "pool.h"
 
 #ifndef DISABLE_SECURE_SOCKET
 #include "mbedtls/ssl.h"
 #include "noos_mbedtls_config.h"
 #include "trng.h"
+#ifdef ENABLE_CTR_DRBG
+#include "mbedtls/ctr_drbg.h"
+#endif /* ENABLE_CTR_DRBG */
 #endif /* DISABLE_SECURE_SOCKET */
 
 /******************************************************************************/
@@ -69,6 +74,9 @@
 #define DEFAULT_CONNECTION_BUFFER_SIZE 16384
 #endif /* MAX_CONTENT_LEN */
 
+/* Personalization string mixed in the CTR_DRBG seed */
+#define CTR_DRBG_PERS	"no-OS tcp_socket"
+
 #endif /* DISABLE_SECURE_SOCKET */
 
 /******************************************************************************/
@@ -83,6 +91,16 @@
 struct secure_socket_desc {
 	/** True random number generator reference */
 	struct trng_desc	*trng;
+#ifdef ENABLE_CTR_DRBG
+	/** Random number generator seeded once from trng */
+	mbedtls_ctr_drbg_context	ctr_drbg;
+#endif /* ENABLE_CTR_DRBG */
+#ifdef ENABLE_SESSION_RESUMPTION
+	/** Session of the last successful handshake */
+	mbedtls_ssl_session	session;
+	/** Set if session can be offered on the next connect */
+	bool			session_valid;
+#endif /* ENABLE_SESSION_RESUMPTION */
 	/* Mbed structures */
 	/** CA certificate */
 	mbedtls_x509_crt	cacert;
@@ -103,6 +121,10 @@ struct tcp_socket_desc {
 	uint32_t			id;
 	/* Reference to the network interface */
 	struct network_interface	*net;
+	/* Pool of the descriptors returned by socket_accept(), if any */
+	struct pool			*client_pool;
+	/* Pool this descriptor was taken from, NULL if it is on the heap */
+	struct pool			*pool;
 #ifndef DISABLE_SECURE_SOCKET
 	/* Reference to secure descriptor */
 	struct secure_socket_desc	*secure;
@@ -134,9 +156,27 @@ static int tls_net_send(struct tcp_socket_desc *sock, unsigned char *buff,
 	return sock->net->socket_send(sock->net->net, sock->id, buff, len);
 }
 
+#ifdef ENABLE_CTR_DRBG
+/* Entropy source of the CTR_DRBG */
+static int tls_trng_entropy(void *trng, unsigned char *buff, size_t len)
+{
+	if (IS_ERR_VALUE(trng_fill_buffer(trng, buff, len)))
+		return MBEDTLS_ERR_CTR_DRBG_ENTROPY_SOURCE_FAILED;
+
+	return 0;
+}
+#endif /* ENABLE_CTR_DRBG */
+
 /* Remove secure descriptor*/
 static void stcp_socket_remove(struct secure_socket_desc *desc)
 {
+	mbedtls_ssl_free(&desc->ssl);
+#ifdef ENABLE_SESSION_RESUMPTION
+	mbedtls_ssl_session_free(&desc->session);
+#endif /* ENABLE_SESSION_RESUMPTION */
+#ifdef ENABLE_CTR_DRBG
+	mbedtls_ctr_drbg_free(&desc->ctr_drbg);
+#endif /* ENABLE_CTR_DRBG */
 	mbedtls_pk_free(&desc->pkey);
 	mbedtls_x509_crt_free(&desc->clicert);
 	mbedtls_x509_crt_free(&desc->cacert);
@@ -163,6 +203,13 @@ static int32_t stcp_socket_init(struct secure_socket_desc **desc,
 		return FAILURE;
 
 	/* Initialize structures */
+	mbedtls_ssl_init(&ldesc->ssl);
+#ifdef ENABLE_SESSION_RESUMPTION
+	mbedtls_ssl_session_init(&ldesc->session);
+#endif /* ENABLE_SESSION_RESUMPTION */
+#ifdef ENABLE_CTR_DRBG
+	mbedtls_ctr_drbg_init(&ldesc->ctr_drbg);
+#endif /* ENABLE_CTR_DRBG */
 	mbedtls_ssl_config_init(&ldesc->conf);
 	mbedtls_x509_crt_init(&ldesc->cacert);
 	mbedtls_x509_crt_init(&ldesc->clicert);
@@ -230,10 +277,27 @@ static int32_t stcp_socket_init(struct secure_socket_desc **desc,
 	}
 
 	/* Config Random number generator */
+#ifdef ENABLE_CTR_DRBG
+	ret = mbedtls_ctr_drbg_seed(&ldesc->ctr_drbg, tls_trng_entropy,
+				    ldesc->trng,
+				    (const unsigned char *)CTR_DRBG_PERS,
+				    sizeof(CTR_DRBG_PERS) - 1);
+	if (IS_ERR_VALUE(ret))
+		goto exit;
+
+	mbedtls_ssl_conf_rng(&ldesc->conf, mbedtls_ctr_drbg_random,
+			     &ldesc->ctr_drbg);
+#else
 	mbedtls_ssl_conf_rng(&ldesc->conf,
 			     (int (*)(void *, unsigned char *, size_t))
 			     trng_fill_buffer,
 			     (void *)ldesc->trng);
+#endif /* ENABLE_CTR_DRBG */
+
+#ifdef ENABLE_SESSION_RESUMPTION
+	mbedtls_ssl_conf_session_tickets(&ldesc->conf,
+					 MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif /* ENABLE_SESSION_RESUMPTION */
 
 	/* Set the resulting protocol configuration */
 	ret = mbedtls_ssl_setup(&ldesc->ssl, &ldesc->conf);
@@ -256,6 +320,47 @@ exit:
 }
 #endif /* DISABLE_SECURE_SOCKET */
 
+#ifndef DISABLE_SECURE_SOCKET
+/*
+ * Run the TLS handshake of a new connection. The session of the previous
+ * connection is offered to the server, so a reconnect can skip the key
+ * exchange if the server still knows the session id or accepts the ticket.
+ */
+static int32_t stcp_socket_handshake(struct secure_socket_desc *desc)
+{
+	int32_t ret;
+
+	/* Clear the state left by a previous connection */
+	ret = mbedtls_ssl_session_reset(&desc->ssl);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+#ifdef ENABLE_SESSION_RESUMPTION
+	if (desc->session_valid) {
+		ret = mbedtls_ssl_set_session(&desc->ssl, &desc->session);
+		if (IS_ERR_VALUE(ret))
+			desc->session_valid = false;
+	}
+#endif /* ENABLE_SESSION_RESUMPTION */
+
+	do {
+		ret = mbedtls_ssl_handshake(&desc->ssl);
+	} while (ret == MBEDTLS_ERR_SSL_WANT_READ);
+
+#ifdef ENABLE_SESSION_RESUMPTION
+	desc->session_valid = false;
+	if (!IS_ERR_VALUE(ret) &&
+	    !mbedtls_ssl_get_session(&desc->ssl, &desc->session))
+		desc->session_valid = true;
+#endif /* ENABLE_SESSION_RESUMPTION */
+
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	return SUCCESS;
+}
+#endif /* DISABLE_SECURE_SOCKET */
+
 /**
  * @brief Allocate resources and initializes the socket descriptor
  * @param desc - Address where to store the socket descriptor
@@ -285,9 +390,20 @@ int32_t socket_init(struct tcp_socket_desc **desc,
 	else
 		buff_size = DEFAULT_CONNECTION_BUFFER_SIZE;
 
+	if (param->client_pool_size) {
+		ret = pool_init(&ldesc->client_pool, sizeof(*ldesc),
+				param->client_pool_size);
+		if (IS_ERR_VALUE(ret)) {
+			free(ldesc);
+			return ret;
+		}
+	}
+
 	ret = ldesc->net->socket_open(ldesc->net->net, &ldesc->id, PROTOCOL_TCP,
 				      buff_size);
 	if (IS_ERR_VALUE(ret)) {
+		if (ldesc->client_pool)
+			pool_remove(ldesc->client_pool);
 		free(ldesc);
 		return ret;
 	}
@@ -300,6 +416,8 @@ int32_t socket_init(struct tcp_socket_desc **desc,
 				       param->secure_init_param);
 	if (IS_ERR_VALUE(ret)) {
 		ldesc->net->socket_close(ldesc->net->net, ldesc->id);
+		if (ldesc->client_pool)
+			pool_remove(ldesc->client_pool);
 		free(ldesc);
 		return ret;
 	}
@@ -311,7 +429,8 @@ int32_t socket_init(struct tcp_socket_desc **desc,
 }
 
 /**
- * @brief Deallocate resources from the socket descriptor
+ * @brief Deallocate resources from the socket descriptor. Clients returned by
+ * socket_accept() must be removed before the socket that accepted them.
  * @param desc - Socket descriptor
  * @return
  *  - \ref SUCCESS : On success
@@ -332,7 +451,10 @@ int32_t socket_remove(struct tcp_socket_desc *desc)
 	ret = desc->net->socket_close(desc->net->net, desc->id);
 	if (IS_ERR_VALUE(ret))
 		return ret;
-	free(desc);
+	if (desc->client_pool)
+		pool_remove(desc->client_pool);
+	if (pool_free(desc->pool, desc))
+		free(desc);
 
 	return SUCCESS;
 }
@@ -352,13 +474,8 @@ int32_t socket_connect(struct tcp_socket_desc *desc,
 		return ret;
 
 #ifndef DISABLE_SECURE_SOCKET
-	if (desc->secure) {
-		do {
-			ret = mbedtls_ssl_handshake(&desc->secure->ssl);
-		} while (ret == MBEDTLS_ERR_SSL_WANT_READ);
-		if (IS_ERR_VALUE(ret))
-			return ret;
-	}
+	if (desc->secure)
+		return stcp_socket_handshake(desc->secure);
 #endif /* DISABLE_SECURE_SOCKET */
 
 	return SUCCESS;
@@ -443,6 +560,7 @@ int32_t socket_listen(struct tcp_socket_desc *desc, uint32_t back_log)
 int32_t socket_accept(struct tcp_socket_desc *desc,
 		      struct tcp_socket_desc **new_client)
 {
+	struct tcp_socket_desc	*client;
 	uint32_t		new_cli_id;
 	int32_t			ret;
 
@@ -455,13 +573,21 @@ int32_t socket_accept(struct tcp_socket_desc *desc,
 	if (IS_ERR_VALUE(ret))
 		return ret;
 
-	*new_client = (typeof(*new_client))calloc(1, sizeof(**new_client));
-	if (!*new_client) {
-		desc->net->socket_close(desc->net->net, desc->id);
-		return -ENOMEM;
+	/* Fall back to the heap if all the pooled descriptors are in use */
+	client = (typeof(client))pool_alloc(desc->client_pool);
+	if (client) {
+		memset(client, 0, sizeof(*client));
+		client->pool = desc->client_pool;
+	} else {
+		client = (typeof(client))calloc(1, sizeof(*client));
+		if (!client) {
+			desc->net->socket_close(desc->net->net, new_cli_id);
+			return -ENOMEM;
+		}
 	}
-	(*new_client)->net = desc->net;
-	(*new_client)->id = new_cli_id;
+	client->net = desc->net;
+	client->id = new_cli_id;
+	*new_client = client;
 
 	return SUCCESS;
 }
@@ -118,6 +118,11 @@ struct tcp_socket_init_param {
 	 */
 	struct secure_init_param	*secure_init_param;
 #endif /* DISABLE_SECURE_SOCKET */
+	/**
+	 * Number of descriptors kept for the clients returned by
+	 * socket_accept(). If set to 0, they are allocated from the heap.
+	 */
+	uint32_t			client_pool_size;
 };
 
 /******************************************************************************/
@@ -404,7 +404,7 @@ static inline void start_conn_read(struct at_desc *desc, bool is_new_message)
 	if (IS_ERR_VALUE(ret))
 		goto dummy_read;
 
-	uart_read_nonblocking(desc->uart_desc, buff, available_len);
+	uart_read_nonblocking(desc->uart_desc, buff, available_len, NULL);
 	conn->to_read -= available_len;
 
 	return ;
@@ -412,7 +412,7 @@ dummy_read:
 	/* Data from uart is discarded because an error occured or
 	 * there is no buffer available
 	 */
-	uart_read_nonblocking(desc->uart_desc, &desc->read_ch, 1);
+	uart_read_nonblocking(desc->uart_desc, &desc->read_ch, 1, NULL);
 	conn->to_read -= 1;
 }
 
@@ -473,7 +473,7 @@ static void at_callback(struct at_desc *desc, uint32_t event, uint8_t *data)
 		break;
 	}
 	/* Submit buffer to read the next char */
-	uart_read_nonblocking(desc->uart_desc, &desc->read_ch, 1);
+	uart_read_nonblocking(desc->uart_desc, &desc->read_ch, 1, NULL);
 }
 
 /* Wait the response for the last command for MODULE_TIMEOUT milliseconds */
@@ -938,7 +938,7 @@ int32_t at_init(struct at_desc **desc, const struct at_init_param *param)
 		goto free_irq;
 
 	/* The read will be handled by the callback */
-	uart_read_nonblocking(ldesc->uart_desc, &ldesc->read_ch, 1);
+	uart_read_nonblocking(ldesc->uart_desc, &ldesc->read_ch, 1, NULL);
 
 	/* Link buffer structure with static buffers */
 	ldesc->result.buff = ldesc->buffers.result_buff;
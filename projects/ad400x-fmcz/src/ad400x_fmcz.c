@@ -92,7 +92,13 @@ int main()
 		msg.tx_addr = 0xA000000;
 		msg.commands_data = commands_data;
 
-		ret = spi_engine_offload_transfer(dev->spi_desc, msg, AD400x_EVB_SAMPLE_NO);
+		/* Load the message once, each capture only re-arms the DMA */
+		ret = spi_engine_offload_load(dev->spi_desc, &msg);
+		if (ret != SUCCESS)
+			return ret;
+
+		ret = spi_engine_offload_arm(dev->spi_desc, msg.tx_addr, msg.rx_addr,
+					     AD400x_EVB_SAMPLE_NO);
 		if (ret != SUCCESS)
 			return ret;
 
@@ -109,6 +115,8 @@ int main()
 		}
 	}
 
+	ad400x_remove(dev);
+
 	print("Success\n\r");
 
 	Xil_DCacheDisable();
@@ -5,11 +5,13 @@ SRC_DIRS += $(NO-OS)/iio/iio_app
 
 # Add to SRCS source files to be build in the project
 SRCS += $(NO-OS)/drivers/adc/ad7124/ad7124.c \
-	$(NO-OS)/drivers/adc/ad7124/iio_ad7124.c
+	$(NO-OS)/drivers/adc/ad7124/iio_ad7124.c \
+	$(NO-OS)/libraries/iio/iio_trigger.c
 
 # Add to INCS inlcude files to be build in the porject
 INCS += $(NO-OS)/drivers/adc/ad7124/ad7124.h \
-	$(NO-OS)/drivers/adc/ad7124/iio_ad7124.h
+	$(NO-OS)/drivers/adc/ad7124/iio_ad7124.h \
+	$(NO-OS)/libraries/iio/iio_trigger.h
 
 SRC_DIRS += $(PLATFORM_DRIVERS)
 SRC_DIRS += $(NO-OS)/util
@@ -144,6 +144,8 @@ int main(void)
 
 	pr_info("Capture done. \n");
 
+	ad7616_remove(dev);
+
 	Xil_DCacheDisable();
 	Xil_ICacheDisable();
 
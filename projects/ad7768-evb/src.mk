@@ -12,11 +12,13 @@
 # Add to SRCS source files to be build in the project
 SRCS += $(PROJECT)/src/ad7768_evb.c
 SRCS += $(NO-OS)/util/fifo.c
+SRCS += $(NO-OS)/util/pool.c
 SRCS += $(NO-OS)/util/util.c
 SRCS += $(NO-OS)/util/list.c
 
 # Add to INCS inlcude files to be build in the porject
 INCS += $(INCLUDE)/error.h
+INCS += $(INCLUDE)/trace.h
 INCS += $(INCLUDE)/gpio.h
 INCS += $(INCLUDE)/delay.h
 INCS += $(INCLUDE)/util.h
@@ -28,6 +30,7 @@ INCS += $(INCLUDE)/list.h
 INCS += $(INCLUDE)/uart.h
 INCS += $(INCLUDE)/irq.h
 INCS += $(INCLUDE)/fifo.h
+INCS += $(INCLUDE)/pool.h
 INCS += $(PROJECT)/src/parameters.h
 
 # Add to SRC_DIRS directories to be used in the build. All .c and .h files from
@@ -45,6 +45,7 @@ SRCS += $(PROJECT)/src/app_iio.c					\
 	$(PLATFORM_DRIVERS)/irq.c					\
 	$(NO-OS)/util/list.c						\
 	$(NO-OS)/util/fifo.c						\
+	$(NO-OS)/util/pool.c						\
 	$(NO-OS)/iio/iio_axi_adc/iio_axi_adc.c				\
 	$(NO-OS)/iio/iio_axi_dac/iio_axi_dac.c
 endif
@@ -86,9 +87,11 @@ INCS +=	$(PROJECT)/src/app_clock.h					\
 	$(INCLUDE)/clk.h						\
 	$(INCLUDE)/delay.h						\
 	$(INCLUDE)/error.h						\
+	$(INCLUDE)/trace.h						\
 	$(INCLUDE)/gpio.h						\
 	$(INCLUDE)/spi.h						\
-	$(INCLUDE)/util.h
+	$(INCLUDE)/util.h						\
+	$(INCLUDE)/clk_plan.h
 ifeq (y,$(strip $(QUAD_MXFE)))
 INCS += $(DRIVERS)/frequency/adf4371/adf4371.h
 endif
@@ -99,6 +102,7 @@ INCS += $(PROJECT)/src/app_iio.h					\
 	$(PLATFORM_DRIVERS)/irq_extra.h					\
 	$(PLATFORM_DRIVERS)/uart_extra.h				\
 	$(INCLUDE)/fifo.h						\
+	$(INCLUDE)/pool.h						\
 	$(INCLUDE)/list.h						\
 	$(NO-OS)/iio/iio_axi_adc/iio_axi_adc.h				\
 	$(NO-OS)/iio/iio_axi_dac/iio_axi_dac.h
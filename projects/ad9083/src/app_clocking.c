@@ -65,6 +65,9 @@
 #define ADC_SYSREF_CLK	12
 #define ADC_REF_CLK	13
 
+/* All the outputs are solved before any of them is programmed */
+#define APP_CLOCKING_NUM_PLANS	1
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
@@ -90,6 +93,16 @@ int32_t app_clocking_init(struct app_clocking **app,
 	struct ad9528_channel_spec ad9528_channels[14];
 	struct ad9528_init_param ad9528_param;
 	struct ad9528_platform_data ad9528_pdata;
+	static const uint32_t plan_chan[APP_CLOCKING_NUM_OUTPUTS] = {
+		FPGA_GLBL_CLK, FPGA_REF_CLK, ADC_REF_CLK,
+		FPGA_SYSREF_CLK, ADC_SYSREF_CLK
+	};
+	struct clk_plan_init_param plan_param = {
+		.num_outputs = APP_CLOCKING_NUM_OUTPUTS,
+		.num_plans = APP_CLOCKING_NUM_PLANS
+	};
+	uint64_t rates[APP_CLOCKING_NUM_OUTPUTS];
+	uint8_t i;
 
 	app_clocking = (struct app_clocking *)calloc(1, sizeof(*app_clocking));
 	if (!app_clocking)
@@ -203,20 +216,6 @@ int32_t app_clocking_init(struct app_clocking **app,
 	dev_ref_clk = ad9528_clk_round_rate(app_clocking->clkchip_device, ADC_REF_CLK,
 					    clk_hz[0]);
 
-	ret = ad9528_clk_set_rate(app_clocking->clkchip_device, FPGA_GLBL_CLK,
-				  fpga_glb_clk);
-	if(ret < 0)
-		goto error_1;
-
-	ret = ad9528_clk_set_rate(app_clocking->clkchip_device, FPGA_REF_CLK,
-				  fpga_ref_clk);
-	if(ret < 0)
-		goto error_1;
-	ret = ad9528_clk_set_rate(app_clocking->clkchip_device, ADC_REF_CLK,
-				  dev_ref_clk);
-	if(ret < 0)
-		goto error_1;
-
 	for (n = 64; n > 0; n--) {
 		sys_ref_rate = ad9528_clk_round_rate(app_clocking->clkchip_device,
 						     FPGA_SYSREF_CLK, init_param->lmfc_rate_hz / n);
@@ -232,19 +231,35 @@ int32_t app_clocking_init(struct app_clocking **app,
 		}
 	}
 
-	ret = ad9528_clk_set_rate(app_clocking->clkchip_device, FPGA_SYSREF_CLK,
-				  sys_ref_rate);
+	for (i = 0; i < APP_CLOCKING_NUM_OUTPUTS; i++) {
+		app_clocking->plan_outputs[i].dev = app_clocking->clkchip_device;
+		app_clocking->plan_outputs[i].chan = plan_chan[i];
+		app_clocking->plan_outputs[i].solve = ad9528_clk_plan_solve;
+		app_clocking->plan_outputs[i].apply = ad9528_clk_plan_apply;
+	}
+	plan_param.outputs = app_clocking->plan_outputs;
+
+	ret = clk_plan_init(&app_clocking->clk_plan, &plan_param);
 	if(ret < 0)
 		goto error_1;
 
-	ret = ad9528_clk_set_rate(app_clocking->clkchip_device, ADC_SYSREF_CLK,
-				  sys_ref_rate);
+	rates[0] = fpga_glb_clk;
+	rates[1] = fpga_ref_clk;
+	rates[2] = dev_ref_clk;
+	rates[3] = sys_ref_rate;
+	rates[4] = sys_ref_rate;
+
+	ret = clk_plan_set_rates(app_clocking->clk_plan, ad9528_pdata.vcxo_freq,
+				 rates);
 	if(ret < 0)
-		goto error_1;
+		goto error_2;
+
 	*app = app_clocking;
 
 	return SUCCESS;
 
+error_2:
+	clk_plan_remove(app_clocking->clk_plan);
 error_1:
 	ad9528_remove(app_clocking->clkchip_device);
 error_0:
@@ -265,6 +280,8 @@ int32_t app_clocking_remove(struct app_clocking *app)
 	if (!app)
 		return FAILURE;
 
+	clk_plan_remove(app->clk_plan);
+
 	ret = ad9528_remove(app->clkchip_device);
 	if (ret < 0)
 		return ret;
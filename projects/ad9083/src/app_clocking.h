@@ -41,6 +41,10 @@
 
 #include <stdint.h>
 #include "ad9528.h"
+#include "clk_plan.h"
+
+/* Clock chip outputs set through the clock plan */
+#define APP_CLOCKING_NUM_OUTPUTS	5
 
 /**
  * @struct app_clocking_init
@@ -60,6 +64,10 @@ struct app_clocking_init {
 struct app_clocking {
 	/* Structure holding a clock device descriptor */
 	struct ad9528_dev *clkchip_device;
+	/* Clock outputs set through the clock plan */
+	struct clk_plan_output plan_outputs[APP_CLOCKING_NUM_OUTPUTS];
+	/* Cached divider plans */
+	struct clk_plan_desc *clk_plan;
 };
 
 /* @brief Application clocking setup. */
@@ -831,6 +831,11 @@ int main(void)
 		.tx_dac = ad9361_phy->tx_dac,
 		.tx_dmac = tx_dmac,
 		.dcache_flush_range = (void (*)(uint32_t, uint32_t))Xil_DCacheFlushRange,
+		.wave_buff = {
+			(void *)DAC_DDR_BASEADDR,
+			(void *)(DAC_DDR_BASEADDR + DAC_WAVE_BUFF_SIZE)
+		},
+		.wave_buff_size = DAC_WAVE_BUFF_SIZE,
 	};
 
 	status = iio_axi_dac_init(&iio_axi_dac_desc, &iio_axi_dac_init_par);
@@ -77,6 +77,8 @@
 #else
 #define CF_AD9361_TX_DMA_BASEADDR	XPAR_AXI_AD9361_DAC_DMA_BASEADDR
 #endif
+/* Two waveform buffers of this size are played from DAC_DDR_BASEADDR */
+#define DAC_WAVE_BUFF_SIZE			0x1000000
 #ifdef _XPARAMETERS_PS_H_
 #define ADC_DDR_BASEADDR			XPAR_DDR_MEM_BASEADDR + 0x800000
 #define DAC_DDR_BASEADDR			XPAR_DDR_MEM_BASEADDR + 0xA000000
@@ -41,6 +41,7 @@ INCS +=	$(INCLUDE)/spi.h \
 	$(INCLUDE)/gpio.h \
 	$(PLATFORM_DRIVERS)/gpio_extra.h \
 	$(INCLUDE)/error.h \
+	$(INCLUDE)/trace.h \
 	$(INCLUDE)/delay.h \
 	$(INCLUDE)/util.h \
 	$(INCLUDE)/print_log.h \
@@ -60,6 +61,7 @@ SRCS += $(PROJECT)/src/app/app_iio.c \
 	$(PLATFORM_DRIVERS)/irq.c \
 	$(NO-OS)/util/list.c \
 	$(NO-OS)/util/fifo.c \
+	$(NO-OS)/util/pool.c						\
 	$(NO-OS)/iio/iio_axi_adc/iio_axi_adc.c \
 	$(NO-OS)/iio/iio_axi_dac/iio_axi_dac.c
 INCS += $(PROJECT)/src/app/app_iio.h \
@@ -68,6 +70,7 @@ INCS += $(PROJECT)/src/app/app_iio.h \
 	$(PLATFORM_DRIVERS)/irq_extra.h \
 	$(PLATFORM_DRIVERS)/uart_extra.h \
 	$(INCLUDE)/fifo.h \
+	$(INCLUDE)/pool.h						\
 	$(INCLUDE)/list.h \
 	$(NO-OS)/iio/iio_axi_adc/iio_axi_adc.h \
 	$(NO-OS)/iio/iio_axi_dac/iio_axi_dac.h
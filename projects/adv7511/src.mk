@@ -55,8 +55,10 @@ INCS +=	$(INCLUDE)/axi_io.h						\
 	$(INCLUDE)/spi.h						\
 	$(INCLUDE)/gpio.h						\
 	$(INCLUDE)/error.h						\
+	$(INCLUDE)/trace.h						\
 	$(INCLUDE)/delay.h						\
 	$(INCLUDE)/util.h	\
+	$(INCLUDE)/clk_plan.h						\
 	$(INCLUDE)/list.h	\
 	$(INCLUDE)/i2c.h	\
 	$(INCLUDE)/irq.h	\
@@ -17,12 +17,10 @@ endif
 ifeq (y,$(strip $(ENABLE_IIO_NETWORK)))
 DISABLE_SECURE_SOCKET ?= y
 SRC_DIRS += $(NO-OS)/network
-SRCS	 += $(NO-OS)/util/circular_buffer.c
 SRCS	 += $(PLATFORM_DRIVERS)/delay.c
 SRCS	 += $(PLATFORM_DRIVERS)/timer.c
 INCS	 += $(INCLUDE)/delay.h
 INCS	 += $(INCLUDE)/timer.h
-INCS	 += $(INCLUDE)/circular_buffer.h
 INCS	 += $(PLATFORM_DRIVERS)/timer_extra.h
 endif
 
@@ -34,10 +32,16 @@ SRCS += $(PLATFORM_DRIVERS)/uart.c					\
 	$(PLATFORM_DRIVERS)/gpio.c					\
 	$(PLATFORM_DRIVERS)/spi.c					\
 	$(NO-OS)/util/list.c						\
+	$(NO-OS)/util/circular_buffer.c					\
+	$(NO-OS)/libraries/iio/iio_trigger.c				\
 	$(NO-OS)/util/fifo.c						\
+	$(NO-OS)/util/pool.c						\
 	$(NO-OS)/util/util.c						\
 
 INCS += $(INCLUDE)/fifo.h					\
+	$(INCLUDE)/pool.h						\
+	$(INCLUDE)/circular_buffer.h					\
+	$(NO-OS)/libraries/iio/iio_trigger.h				\
 	$(INCLUDE)/irq.h						\
 	$(INCLUDE)/uart.h						\
 	$(INCLUDE)/list.h						\
@@ -49,6 +49,7 @@
 #include "parameters.h"
 #include "error.h"
 #include "iio.h"
+#include "iio_trigger.h"
 #include "irq.h"
 #include "irq_extra.h"
 #include "uart.h"
@@ -117,6 +118,9 @@ int main(void)
 	/* IRQ instance. */
 	struct irq_ctrl_desc *irq_desc;
 
+	/* Data ready trigger. */
+	struct iio_trigger_desc *trigger;
+
 #ifdef USE_TCP_SOCKET
 	struct tcp_socket_init_param	socket_param;
 	struct wifi_init_param		wifi_param;
@@ -232,6 +236,25 @@ int main(void)
 	if (status < 0)
 		return status;
 
+	struct iio_trigger_init_param trigger_param = {
+		.irq_ctrl = irq_desc,
+		.irq_id = GYRO_SYNC_IRQ_ID,
+		.irq_config = GYRO_SYNC_IRQ_CONF,
+		.dev = adxrs290_device,
+		.read_scan = adxrs290_trigger_read_scan,
+		.scan_size = ADXRS290_CHANNEL_COUNT * sizeof(int16_t),
+		.nb_scans = GYRO_TRIGGER_SCANS,
+		.get_time_ns = NULL
+	};
+
+	status = iio_trigger_init(&trigger, &trigger_param);
+	if (status < 0)
+		return status;
+
+	status = adxrs290_iio_set_trigger(adxrs290_device, trigger);
+	if (status < 0)
+		return status;
+
 	struct iio_data_buffer rd_buf = {
 		.buff = (void *)GYRO_DDR_BASEADDR,
 		.size = MAX_SIZE_BASE_ADDR
@@ -57,9 +57,15 @@
 #define INTC_DEVICE_ID	0
 #define UART_IRQ_ID		ADUCM_UART_INT_ID
 #define UART_BAUDRATE	115200
+/* Data ready (sync) pin P1.0 is the SYS_WAKE2 external interrupt */
+#define GYRO_SYNC_IRQ_ID	ADUCM_EXTERNAL_INT2_ID
+#define GYRO_SYNC_IRQ_CONF	((void *)IRQ_RISING_EDGE)
 
 #endif //ADUCM_PLATFORM
 
+/* Number of scans buffered by the data ready trigger */
+#define GYRO_TRIGGER_SCANS	256
+
 #ifdef USE_TCP_SOCKET
 #define WIFI_SSID	"RouterSSID"
 #define WIFI_PWD	"******"
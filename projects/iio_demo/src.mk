@@ -4,6 +4,7 @@ SRC_DIRS += $(NO-OS)/iio/iio_app
 
 SRCS +=	$(NO-OS)/util/list.c					\
 	$(NO-OS)/util/fifo.c						\
+	$(NO-OS)/util/pool.c						\
 	$(NO-OS)/util/util.c
 
 #drivers
@@ -13,6 +14,7 @@ SRCS += $(DRIVERS)/adc/adc_demo/adc_demo.c				\
 	$(DRIVERS)/dac/dac_demo/dac_demo.c
 
 INCS += $(INCLUDE)/fifo.h					\
+	$(INCLUDE)/pool.h						\
 	$(INCLUDE)/uart.h						\
 	$(INCLUDE)/list.h						\
 	$(INCLUDE)/util.h						\
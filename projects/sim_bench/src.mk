@@ -0,0 +1,101 @@
+# See No-OS/tool/scripts/src_model.mk for variable description
+SRCS += $(PROJECT)/src/main.c						\
+	$(PROJECT)/src/bench_ad7124.c					\
+	$(PROJECT)/src/bench_ad9361.c					\
+	$(PROJECT)/src/bench_axi_dmac.c					\
+	$(PROJECT)/src/bench_sd.c					\
+	$(PROJECT)/src/bench_unpack.c					\
+	$(PROJECT)/src/bench_pool.c					\
+	$(PROJECT)/src/bench_adxl.c					\
+	$(PROJECT)/src/bench_trace.c
+
+SRCS += $(NO-OS)/util/util.c						\
+	$(NO-OS)/util/pool.c						\
+	$(NO-OS)/util/unpack.c						\
+	$(NO-OS)/util/fifo.c						\
+	$(NO-OS)/util/circular_buffer.c					\
+	$(NO-OS)/util/trace.c						\
+	$(NO-OS)/libraries/iio/iio_trace.c				\
+	$(NO-OS)/libraries/iio/iio_trigger.c				\
+	$(NO-OS)/iio/iio_adxl372/iio_adxl372.c				\
+	$(NO-OS)/iio/iio_adxl362/iio_adxl362.c				\
+	$(DRIVERS)/spi/spi.c						\
+	$(DRIVERS)/gpio/gpio.c						\
+	$(DRIVERS)/i2c/i2c.c						\
+	$(DRIVERS)/adc/ad7124/ad7124.c					\
+	$(DRIVERS)/adc/ad7124/ad7124_regs.c				\
+	$(DRIVERS)/adc/ad7124/iio_ad7124.c				\
+	$(DRIVERS)/rf-transceiver/ad9361/ad9361_api.c			\
+	$(DRIVERS)/rf-transceiver/ad9361/ad9361.c			\
+	$(DRIVERS)/rf-transceiver/ad9361/ad9361_conv.c			\
+	$(DRIVERS)/rf-transceiver/ad9361/ad9361_util.c			\
+	$(DRIVERS)/axi_core/axi_adc_core/axi_adc_core.c			\
+	$(DRIVERS)/axi_core/axi_dac_core/axi_dac_core.c			\
+	$(DRIVERS)/axi_core/axi_dmac/axi_dmac.c				\
+	$(DRIVERS)/axi_core/spi_engine/spi_engine.c			\
+	$(DRIVERS)/sd-card/sd.c						\
+	$(DRIVERS)/accel/adxl372/adxl372.c				\
+	$(DRIVERS)/accel/adxl372/adxl372_spi.c				\
+	$(DRIVERS)/accel/adxl372/adxl372_i2c.c				\
+	$(DRIVERS)/accel/adxl362/adxl362.c
+
+SRCS += $(PLATFORM_DRIVERS)/sim.c					\
+	$(PLATFORM_DRIVERS)/sim_delay.c					\
+	$(PLATFORM_DRIVERS)/sim_spi.c					\
+	$(PLATFORM_DRIVERS)/sim_gpio.c					\
+	$(PLATFORM_DRIVERS)/sim_irq.c					\
+	$(PLATFORM_DRIVERS)/sim_uart.c					\
+	$(PLATFORM_DRIVERS)/axi_io.c					\
+	$(PLATFORM_DRIVERS)/sim_ad7124.c				\
+	$(PLATFORM_DRIVERS)/sim_ad9361.c				\
+	$(PLATFORM_DRIVERS)/sim_axi_dmac.c				\
+	$(PLATFORM_DRIVERS)/sim_spi_engine.c				\
+	$(PLATFORM_DRIVERS)/sim_sd.c					\
+	$(PLATFORM_DRIVERS)/sim_adxl372.c				\
+	$(PLATFORM_DRIVERS)/sim_adxl362.c
+
+INCS += $(PROJECT)/src/sim_bench.h					\
+	$(PROJECT)/src/app_config.h
+
+INCS += $(INCLUDE)/error.h						\
+	$(INCLUDE)/util.h						\
+	$(INCLUDE)/pool.h						\
+	$(INCLUDE)/unpack.h						\
+	$(INCLUDE)/fifo.h						\
+	$(INCLUDE)/spi.h						\
+	$(INCLUDE)/gpio.h						\
+	$(INCLUDE)/i2c.h						\
+	$(INCLUDE)/irq.h						\
+	$(INCLUDE)/uart.h						\
+	$(INCLUDE)/circular_buffer.h					\
+	$(INCLUDE)/delay.h						\
+	$(INCLUDE)/axi_io.h						\
+	$(INCLUDE)/trace.h						\
+	$(DRIVERS)/adc/ad7124/ad7124.h					\
+	$(DRIVERS)/adc/ad7124/ad7124_regs.h				\
+	$(DRIVERS)/adc/ad7124/iio_ad7124.h				\
+	$(DRIVERS)/rf-transceiver/ad9361/common.h			\
+	$(DRIVERS)/rf-transceiver/ad9361/ad9361.h			\
+	$(DRIVERS)/rf-transceiver/ad9361/ad9361_util.h			\
+	$(DRIVERS)/rf-transceiver/ad9361/ad9361_api.h			\
+	$(DRIVERS)/axi_core/axi_adc_core/axi_adc_core.h			\
+	$(DRIVERS)/axi_core/axi_dac_core/axi_dac_core.h			\
+	$(DRIVERS)/axi_core/axi_dmac/axi_dmac.h				\
+	$(DRIVERS)/axi_core/spi_engine/spi_engine.h			\
+	$(DRIVERS)/axi_core/spi_engine/spi_engine_private.h		\
+	$(DRIVERS)/sd-card/sd.h						\
+	$(DRIVERS)/accel/adxl372/adxl372.h				\
+	$(DRIVERS)/accel/adxl362/adxl362.h				\
+	$(NO-OS)/libraries/iio/iio.h					\
+	$(NO-OS)/libraries/iio/iio_types.h				\
+	$(NO-OS)/libraries/iio/iio_trigger.h				\
+	$(NO-OS)/libraries/iio/iio_trace.h				\
+	$(NO-OS)/iio/iio_adxl372/iio_adxl372.h				\
+	$(NO-OS)/iio/iio_adxl362/iio_adxl362.h				\
+	$(NO-OS)/drivers/platform/xilinx/spi_extra.h
+
+INCS += $(PLATFORM_DRIVERS)/sim_model.h					\
+	$(PLATFORM_DRIVERS)/sim_spi.h					\
+	$(PLATFORM_DRIVERS)/sim_gpio.h					\
+	$(PLATFORM_DRIVERS)/sim_irq.h					\
+	$(PLATFORM_DRIVERS)/sim_uart.h
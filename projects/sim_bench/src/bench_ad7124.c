@@ -0,0 +1,411 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench_ad7124.c
+ *   @brief  Benchmark of the AD7124 driver over the sim SPI and SPI Engine.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include "error.h"
+#include "util.h"
+#include "spi.h"
+#include "ad7124.h"
+#include "ad7124_regs.h"
+#include "iio_ad7124.h"
+#include "spi_engine.h"
+#include "sim_model.h"
+#include "sim_spi.h"
+#include "sim_irq.h"
+#include "sim_bench.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SIM_BENCH_DEVICE_ID	0x14
+/* Fastest output data rate, 19.2 kSPS */
+#define SIM_BENCH_CONV_NS	52083
+#define SIM_BENCH_SAMPLES	1000
+#define SIM_BENCH_SPI_HZ	5000000
+/* Channels streamed through the DOUT/RDY interrupt */
+#define SIM_BENCH_STREAM_MASK	0x0F
+#define SIM_BENCH_STREAM_CH	4
+#define SIM_BENCH_STREAM_SCANS	64
+/* One DOUT/RDY edge in this many is missed */
+#define SIM_BENCH_STREAM_MISS	97
+#define SIM_BENCH_ENGINE_BASE	0x44A00000
+#define SIM_BENCH_ENGINE_CLK_HZ	100000000
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Read conversions by polling the status register.
+ * @param dev - AD7124 device.
+ * @param model - AD7124 model.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_bench_ad7124_poll(struct ad7124_dev *dev,
+				     struct sim_model *model)
+{
+	uint64_t start = sim_time_ns();
+	int32_t value;
+	int32_t ret;
+	uint32_t i;
+
+	sim_stats_reset(model);
+	for (i = 0; i < SIM_BENCH_SAMPLES; i++) {
+		ret = ad7124_wait_for_conv_ready(dev, 10000);
+		if (ret < 0)
+			return ret;
+		ret = ad7124_read_data(dev, &value);
+		if (ret < 0)
+			return ret;
+	}
+	sim_bench_report("poll", model, start);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read conversions in continuous read mode, one transfer each.
+ * @param dev - AD7124 device.
+ * @param model - AD7124 model.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_bench_ad7124_cont_read(struct ad7124_dev *dev,
+					  struct sim_model *model)
+{
+	uint64_t start = sim_time_ns();
+	int32_t value;
+	int32_t ret;
+	uint8_t ch;
+	uint32_t i;
+
+	sim_stats_reset(model);
+	ret = ad7124_cont_read_start(dev);
+	if (ret < 0)
+		return ret;
+
+	for (i = 0; i < SIM_BENCH_SAMPLES; i++) {
+		/* Stands for the wait on the DOUT/RDY falling edge */
+		sim_advance_ns(SIM_BENCH_CONV_NS);
+		ret = ad7124_cont_read_sample(dev, &value, &ch);
+		if (ret < 0)
+			return ret;
+	}
+
+	sim_advance_ns(SIM_BENCH_CONV_NS);
+	ret = ad7124_cont_read_stop(dev);
+	if (ret < 0)
+		return ret;
+	sim_bench_report("cont_read", model, start);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Check that the samples of a scan come from consecutive conversions of
+ *	  the streamed channels, in order. The model stamps each result with
+ *	  its channel and a conversion count.
+ * @param scan - Scan, one sample per channel.
+ * @return SUCCESS if the scan is aligned, FAILURE otherwise.
+ */
+static int32_t sim_bench_ad7124_check_scan(const int32_t *scan)
+{
+	uint32_t count = (scan[0] - 0x800000) & 0xFFFF;
+	uint32_t ch;
+
+	for (ch = 0; ch < SIM_BENCH_STREAM_CH; ch++) {
+		if (((scan[ch] - 0x800000 - (ch << 16)) & 0xFFFFFF) !=
+		    ((count + ch) & 0xFFFF)) {
+			printf("stream: sample %"PRIu32" is 0x%06"PRIx32"\n",
+			       ch, (uint32_t)scan[ch]);
+			return FAILURE;
+		}
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Stream conversions through the DOUT/RDY interrupt into a trigger
+ *	  ring, missing an edge now and then. The partial scans have to be
+ *	  dropped so that every scan read stays aligned on the channels.
+ * @param dev - AD7124 device.
+ * @param model - AD7124 model.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_bench_ad7124_stream(struct ad7124_dev *dev,
+				       struct sim_model *model)
+{
+	struct iio_ad7124_stream_init_param stream_init = { 0 };
+	struct irq_init_param irq_init = { 0 };
+	struct iio_ad7124_stream *stream;
+	struct irq_ctrl_desc *irq;
+	int32_t scan[SIM_BENCH_STREAM_CH];
+	uint32_t nb_read = 0;
+	uint32_t i = 0;
+	uint64_t start;
+	int32_t ret;
+
+	ret = irq_ctrl_init(&irq, &irq_init);
+	if (ret < 0)
+		return ret;
+
+	stream_init.dev = dev;
+	stream_init.irq_ctrl = irq;
+	stream_init.ch_mask = SIM_BENCH_STREAM_MASK;
+	stream_init.ring_scans = SIM_BENCH_STREAM_SCANS;
+	stream_init.get_time_ns = sim_time_ns;
+	ret = iio_ad7124_stream_init(&stream, &stream_init);
+	if (ret < 0)
+		goto error_irq;
+
+	ret = iio_ad7124_device.prepare_transfer(dev, SIM_BENCH_STREAM_MASK);
+	if (ret < 0)
+		goto error_stream;
+
+	sim_stats_reset(model);
+	start = sim_time_ns();
+	while (nb_read < SIM_BENCH_SAMPLES / SIM_BENCH_STREAM_CH) {
+		/* A missed edge lets the next conversion overwrite the data */
+		if (!(++i % SIM_BENCH_STREAM_MISS))
+			sim_advance_ns(SIM_BENCH_CONV_NS);
+		sim_advance_ns(SIM_BENCH_CONV_NS);
+		sim_irq_fire(irq, 0);
+
+		if (stream->trig->nb_acquired == nb_read)
+			continue;
+
+		ret = iio_ad7124_device.read_dev(dev, scan, 1);
+		if (ret < 0)
+			goto error_transfer;
+
+		ret = sim_bench_ad7124_check_scan(scan);
+		if (ret < 0)
+			goto error_transfer;
+		nb_read++;
+	}
+	sim_bench_report("stream", model, start);
+
+	if (!stream->trig->errors || stream->trig->overruns) {
+		printf("stream: %"PRIu32" dropped scans, %"PRIu32" overruns\n",
+		       stream->trig->errors, stream->trig->overruns);
+		ret = FAILURE;
+	}
+
+error_transfer:
+	iio_ad7124_device.end_transfer(dev);
+error_stream:
+	iio_ad7124_stream_remove(stream);
+error_irq:
+	irq_ctrl_remove(irq);
+
+	return ret;
+}
+
+/**
+ * @brief Check that segments without cs_change reach the device as a single
+ *	  frame, even when one of them asks for a delay, and that an in-place
+ *	  segment gets its data back.
+ * @param dev - AD7124 device.
+ * @param model - AD7124 model.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t sim_bench_ad7124_spi_msg(struct ad7124_dev *dev,
+					struct sim_model *model)
+{
+	uint8_t cmd = AD7124_COMM_REG_WEN | AD7124_COMM_REG_RD |
+		      AD7124_COMM_REG_RA(AD7124_ID_REG);
+	uint8_t id[2] = {0};
+	uint8_t buf[2] = {cmd, 0};
+	struct spi_msg msgs[] = {
+		{ .tx_buff = &cmd, .bytes_number = 1, .delay_us = 10 },
+		{ .rx_buff = id, .bytes_number = sizeof(id), .cs_change = 1 },
+		{ .tx_buff = buf, .rx_buff = buf, .bytes_number = sizeof(buf) },
+	};
+	int32_t ret;
+
+	sim_stats_reset(model);
+	ret = spi_transfer(dev->spi_desc, msgs, ARRAY_SIZE(msgs));
+	if (ret < 0)
+		return ret;
+
+	if (model->stats.transactions != 2 || id[0] != SIM_BENCH_DEVICE_ID ||
+	    buf[1] != SIM_BENCH_DEVICE_ID) {
+		printf("spi_msg: %"PRIu64" frames, id 0x%02x 0x%02x\n",
+		       model->stats.transactions, id[0], buf[1]);
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Setup, polled and continuous reads over the sim SPI backend.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_bench_ad7124(void)
+{
+	struct sim_model *model;
+	struct ad7124_dev *dev;
+	uint64_t start;
+	int32_t ret;
+
+	ret = sim_ad7124_model_init(&model, SIM_BENCH_DEVICE_ID,
+				    SIM_BENCH_CONV_NS);
+	if (ret < 0)
+		return ret;
+
+	struct sim_spi_init_param sim_spi_init = {
+		.model = model
+	};
+	struct spi_init_param spi_init = {
+		.max_speed_hz = SIM_BENCH_SPI_HZ,
+		.chip_select = 0,
+		.mode = SPI_MODE_3,
+		.platform_ops = &sim_spi_platform_ops,
+		.extra = &sim_spi_init
+	};
+	struct ad7124_init_param ad7124_init = {
+		.spi_init = &spi_init,
+		.regs = ad7124_regs,
+		.spi_rdy_poll_cnt = 25000
+	};
+
+	sim_stats_reset(model);
+	start = sim_time_ns();
+	ret = ad7124_setup(&dev, &ad7124_init);
+	if (ret < 0)
+		goto error_model;
+	sim_bench_report("setup", model, start);
+
+	ret = sim_bench_ad7124_spi_msg(dev, model);
+	if (ret < 0)
+		goto error_dev;
+
+	ret = sim_bench_ad7124_poll(dev, model);
+	if (ret < 0)
+		goto error_dev;
+
+	ret = sim_bench_ad7124_cont_read(dev, model);
+	if (ret < 0)
+		goto error_dev;
+
+	ret = sim_bench_ad7124_stream(dev, model);
+
+error_dev:
+	ad7124_remove(dev);
+error_model:
+	sim_model_remove(model);
+
+	return ret;
+}
+
+/**
+ * @brief Polled reads with the AD7124 behind a SPI Engine core, so every
+ *        register access costs the MMIO traffic of a full engine message.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_bench_spi_engine(void)
+{
+	struct sim_model *engine;
+	struct sim_model *model;
+	struct ad7124_dev *dev;
+	int32_t ret;
+
+	ret = sim_ad7124_model_init(&model, SIM_BENCH_DEVICE_ID,
+				    SIM_BENCH_CONV_NS);
+	if (ret < 0)
+		return ret;
+
+	ret = sim_spi_engine_model_init(&engine, model, 8);
+	if (ret < 0)
+		goto error_model;
+
+	ret = sim_mmio_register(engine, SIM_BENCH_ENGINE_BASE, engine->size);
+	if (ret < 0)
+		goto error_engine;
+
+	struct spi_engine_init_param spi_engine_init = {
+		.ref_clk_hz = SIM_BENCH_ENGINE_CLK_HZ,
+		.type = SPI_ENGINE,
+		.spi_engine_baseaddr = SIM_BENCH_ENGINE_BASE,
+		.cs_delay = 0,
+		.data_width = 8,
+		.cmd_pool_size = 16,
+		.buf_pool_words = 8
+	};
+	struct spi_init_param spi_init = {
+		.max_speed_hz = SIM_BENCH_SPI_HZ,
+		.chip_select = 0,
+		.mode = SPI_MODE_3,
+		.platform_ops = &spi_eng_platform_ops,
+		.extra = &spi_engine_init
+	};
+	struct ad7124_init_param ad7124_init = {
+		.spi_init = &spi_init,
+		.regs = ad7124_regs,
+		.spi_rdy_poll_cnt = 25000
+	};
+
+	ret = ad7124_setup(&dev, &ad7124_init);
+	if (ret < 0)
+		goto error_engine;
+
+	ret = sim_bench_ad7124_spi_msg(dev, model);
+	if (ret < 0)
+		goto error_dev;
+
+	sim_stats_reset(model);
+	ret = sim_bench_ad7124_poll(dev, engine);
+	if (ret == SUCCESS)
+		sim_stats_print(model);
+
+error_dev:
+	ad7124_remove(dev);
+error_engine:
+	sim_model_remove(engine);
+error_model:
+	sim_model_remove(model);
+
+	return ret;
+}
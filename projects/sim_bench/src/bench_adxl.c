@@ -0,0 +1,355 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench_adxl.c
+ *   @brief  ADXL372 and ADXL362 FIFO watermark streaming through IIO triggers.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include "error.h"
+#include "util.h"
+#include "spi.h"
+#include "gpio.h"
+#include "irq.h"
+#include "iio_adxl372.h"
+#include "iio_adxl362.h"
+#include "sim_model.h"
+#include "sim_spi.h"
+#include "sim_gpio.h"
+#include "sim_irq.h"
+#include "sim_bench.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SIM_BENCH_ADXL_IRQ_ID		0
+#define SIM_BENCH_ADXL_SETS		6000
+/* Sets read from the ring at once, up to a watermark of single axis sets */
+#define SIM_BENCH_ADXL_READ_SETS	512
+#define SIM_BENCH_ADXL_WATERMARK	96
+#define SIM_BENCH_ADXL_RING_SETS	1024
+#define SIM_BENCH_ADXL372_SPI_HZ	10000000
+#define SIM_BENCH_ADXL372_PERIOD_NS	156250
+#define SIM_BENCH_ADXL362_SPI_HZ	5000000
+#define SIM_BENCH_ADXL362_PERIOD_NS	2500000
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct sim_bench_adxl
+ * @brief Streaming setup shared by both devices.
+ */
+struct sim_bench_adxl {
+	/** IIO device of the accelerometer */
+	struct iio_device	*iio_dev;
+	/** iio_adxl372 or iio_adxl362 descriptor */
+	void			*iio_desc;
+	/** Trigger of the IIO device */
+	struct iio_trigger_desc	*trig;
+	/** Accelerometer model */
+	struct sim_model	*model;
+	/** Interrupt controller INT1 is connected to */
+	struct irq_ctrl_desc	*irq;
+	/** Sample period of the model */
+	uint32_t		period_ns;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Check that sample sets carry consecutive samples of the active axes.
+ *	  The models output a ramp on each axis, offset by 0x100 per axis.
+ * @param buf - Sample sets.
+ * @param nb_sets - Number of sets.
+ * @param mask - Active axes.
+ * @param next - Ramp value expected for the next set, -1 if not known yet.
+ * @return SUCCESS if the sets are consecutive, FAILURE otherwise.
+ */
+static int32_t sim_bench_adxl_check(const int16_t *buf, uint32_t nb_sets,
+				    uint32_t mask, int32_t *next)
+{
+	uint32_t	ramp;
+	uint32_t	i;
+	uint8_t		axis;
+
+	for (i = 0; i < nb_sets; i++) {
+		for (axis = 0; axis < 3; axis++) {
+			if (!(mask & BIT(axis)))
+				continue;
+			ramp = (*buf++ - (axis << 8)) & 0xFFF;
+			if (*next >= 0 && ramp != (uint32_t)*next) {
+				printf("set %"PRIu32" axis %u: 0x%03"PRIx32
+				       " instead of 0x%03"PRIx32"\n", i, axis,
+				       ramp, (uint32_t)*next);
+				return FAILURE;
+			}
+			*next = ramp;
+		}
+		*next = (*next + 1) & 0xFFF;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Stream the active axes, raising INT1 each time the FIFO reaches the
+ *	  watermark, and check the sets read back through the IIO device.
+ * @param bench - Streaming setup.
+ * @param name - Step name.
+ * @param mask - Active axes.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_bench_adxl_stream(struct sim_bench_adxl *bench,
+				     const char *name, uint32_t mask)
+{
+	int16_t		buf[SIM_BENCH_ADXL_READ_SETS * 3];
+	uint32_t	set_size = hweight8(mask);
+	uint32_t	nb_read = 0;
+	uint32_t	nb;
+	uint64_t	start;
+	int32_t		next = -1;
+	int32_t		ret;
+
+	ret = bench->iio_dev->prepare_transfer(bench->iio_desc, mask);
+	if (ret < 0)
+		return ret;
+
+	sim_stats_reset(bench->model);
+	start = sim_time_ns();
+	while (nb_read < SIM_BENCH_ADXL_SETS) {
+		/* Time for the FIFO to reach the watermark */
+		sim_advance_ns((uint64_t)bench->period_ns *
+			       (SIM_BENCH_ADXL_WATERMARK / set_size));
+		ret = sim_irq_fire(bench->irq, SIM_BENCH_ADXL_IRQ_ID);
+		if (ret < 0)
+			goto error;
+
+		nb = min_t(uint32_t, bench->trig->nb_acquired - nb_read,
+			   SIM_BENCH_ADXL_READ_SETS);
+		if (!nb)
+			continue;
+
+		ret = bench->iio_dev->read_dev(bench->iio_desc, buf, nb);
+		if (ret < 0)
+			goto error;
+
+		ret = sim_bench_adxl_check(buf, nb, mask, &next);
+		if (ret < 0)
+			goto error;
+		nb_read += nb;
+	}
+	sim_bench_report(name, bench->model, start);
+
+	if (bench->trig->overruns || bench->trig->errors) {
+		printf("%s: %"PRIu32" ring overruns, %"PRIu32" read errors\n",
+		       name, bench->trig->overruns, bench->trig->errors);
+		ret = FAILURE;
+	}
+
+error:
+	bench->iio_dev->end_transfer(bench->iio_desc);
+
+	return ret;
+}
+
+/**
+ * @brief ADXL372 streaming of 3, 2 and 1 axes at 6400 Hz.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_bench_adxl372(void)
+{
+	struct iio_adxl372_desc	*iio_adxl372;
+	struct adxl372_dev	*dev;
+	struct sim_bench_adxl	bench = {
+		.period_ns = SIM_BENCH_ADXL372_PERIOD_NS
+	};
+	struct irq_init_param	irq_init = { 0 };
+	int32_t			ret;
+
+	ret = sim_adxl372_model_init(&bench.model);
+	if (ret < 0)
+		return ret;
+
+	ret = irq_ctrl_init(&bench.irq, &irq_init);
+	if (ret < 0)
+		goto error_model;
+
+	struct sim_spi_init_param sim_spi_init = {
+		.model = bench.model
+	};
+	struct adxl372_init_param adxl372_param = {
+		.spi_init = {
+			.max_speed_hz = SIM_BENCH_ADXL372_SPI_HZ,
+			.chip_select = 0,
+			.mode = SPI_MODE_0,
+			.platform_ops = &sim_spi_platform_ops,
+			.extra = &sim_spi_init
+		},
+		.gpio_int1 = { .platform_ops = &sim_gpio_platform_ops },
+		.gpio_int2 = { .platform_ops = &sim_gpio_platform_ops },
+		.odr = ADXL372_ODR_6400HZ,
+		.fifo_config = { .fifo_mode = ADXL372_FIFO_BYPASSED },
+		.op_mode = ADXL372_STANDBY,
+		.comm_type = SPI
+	};
+
+	ret = adxl372_init(&dev, adxl372_param);
+	if (ret < 0)
+		goto error_irq;
+
+	struct iio_adxl372_init_param iio_adxl372_param = {
+		.dev = dev,
+		.irq_ctrl = bench.irq,
+		.irq_id = SIM_BENCH_ADXL_IRQ_ID,
+		.watermark = SIM_BENCH_ADXL_WATERMARK,
+		.ring_sets = SIM_BENCH_ADXL_RING_SETS,
+		.get_time_ns = sim_time_ns
+	};
+
+	ret = iio_adxl372_init(&iio_adxl372, &iio_adxl372_param);
+	if (ret < 0)
+		goto error_dev;
+
+	iio_adxl372_get_dev_descriptor(iio_adxl372, &bench.iio_dev);
+	bench.iio_desc = iio_adxl372;
+	bench.trig = iio_adxl372->trig;
+
+	ret = sim_bench_adxl_stream(&bench, "xyz", 0x7);
+	if (ret < 0)
+		goto error_iio;
+
+	ret = sim_bench_adxl_stream(&bench, "xz", 0x5);
+	if (ret < 0)
+		goto error_iio;
+
+	ret = sim_bench_adxl_stream(&bench, "y", 0x2);
+
+error_iio:
+	iio_adxl372_remove(iio_adxl372);
+error_dev:
+	adxl372_remove(dev);
+error_irq:
+	irq_ctrl_remove(bench.irq);
+error_model:
+	sim_model_remove(bench.model);
+
+	return ret;
+}
+
+/**
+ * @brief ADXL362 streaming of 3 and 1 axes at 400 Hz.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_bench_adxl362(void)
+{
+	struct iio_adxl362_desc	*iio_adxl362;
+	struct adxl362_dev	*dev;
+	struct sim_bench_adxl	bench = {
+		.period_ns = SIM_BENCH_ADXL362_PERIOD_NS
+	};
+	struct irq_init_param	irq_init = { 0 };
+	int32_t			ret;
+
+	ret = sim_adxl362_model_init(&bench.model);
+	if (ret < 0)
+		return ret;
+
+	ret = irq_ctrl_init(&bench.irq, &irq_init);
+	if (ret < 0)
+		goto error_model;
+
+	struct sim_spi_init_param sim_spi_init = {
+		.model = bench.model
+	};
+	struct adxl362_init_param adxl362_param = {
+		.spi_init = {
+			.max_speed_hz = SIM_BENCH_ADXL362_SPI_HZ,
+			.chip_select = 0,
+			.mode = SPI_MODE_0,
+			.platform_ops = &sim_spi_platform_ops,
+			.extra = &sim_spi_init
+		}
+	};
+
+	ret = adxl362_init(&dev, adxl362_param);
+	if (ret < 0)
+		goto error_irq;
+
+	adxl362_software_reset(dev);
+	adxl362_set_output_rate(dev, ADXL362_ODR_400_HZ);
+
+	struct iio_adxl362_init_param iio_adxl362_param = {
+		.dev = dev,
+		.irq_ctrl = bench.irq,
+		.irq_id = SIM_BENCH_ADXL_IRQ_ID,
+		.watermark = SIM_BENCH_ADXL_WATERMARK,
+		.ring_sets = SIM_BENCH_ADXL_RING_SETS,
+		.get_time_ns = sim_time_ns
+	};
+
+	ret = iio_adxl362_init(&iio_adxl362, &iio_adxl362_param);
+	if (ret < 0)
+		goto error_dev;
+
+	iio_adxl362_get_dev_descriptor(iio_adxl362, &bench.iio_dev);
+	bench.iio_desc = iio_adxl362;
+	bench.trig = iio_adxl362->trig;
+
+	ret = sim_bench_adxl_stream(&bench, "xyz", 0x7);
+	if (ret < 0)
+		goto error_iio;
+
+	ret = sim_bench_adxl_stream(&bench, "z", 0x4);
+
+error_iio:
+	iio_adxl362_remove(iio_adxl362);
+error_dev:
+	adxl362_remove(dev);
+error_irq:
+	irq_ctrl_remove(bench.irq);
+error_model:
+	sim_model_remove(bench.model);
+
+	return ret;
+}
@@ -0,0 +1,210 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench_axi_dmac.c
+ *   @brief  Benchmark of DMA captures through the AXI DMAC core.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include "error.h"
+#include "delay.h"
+#include "axi_dmac.h"
+#include "sim_model.h"
+#include "sim_bench.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SIM_BENCH_DMAC_BASE		0x7C400000
+/* 100 MSPS, 2 channels of 16-bit I/Q */
+#define SIM_BENCH_DMAC_BYTES_PER_US	800
+/* No data is moved by the model, the address is only programmed */
+#define SIM_BENCH_DMAC_BUFF_ADDR	0x00800000
+#define SIM_BENCH_DMAC_BUFF_SIZE	65536
+#define SIM_BENCH_DMAC_CAPTURES		16
+#define SIM_BENCH_DMAC_TX_BASE		0x7C420000
+#define SIM_BENCH_DMAC_WAVE_ADDR	0x00A00000
+/* Time a waveform is played before it is replaced */
+#define SIM_BENCH_DMAC_PLAY_US		1000
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Waveform playback with axi_dmac_transfer_repeat(); the MMIO count
+ *        shows that a waveform is replayed without any work per pass and the
+ *        swap completes at the end of the pass in progress.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_bench_axi_dmac_repeat(void)
+{
+	struct axi_dmac_init dmac_init = {
+		.name = "tx_dmac",
+		.base = SIM_BENCH_DMAC_TX_BASE,
+		.direction = DMA_MEM_TO_DEV,
+		.flags = 0
+	};
+	struct sim_model *model;
+	struct axi_dmac *dmac;
+	uint64_t pass_ns;
+	uint64_t start;
+	uint64_t swap;
+	bool swapped;
+	int32_t ret;
+
+	ret = sim_axi_dmac_model_init(&model, SIM_BENCH_DMAC_BYTES_PER_US);
+	if (ret < 0)
+		return ret;
+
+	ret = sim_mmio_register(model, SIM_BENCH_DMAC_TX_BASE, model->size);
+	if (ret < 0)
+		goto error_model;
+
+	ret = axi_dmac_init(&dmac, &dmac_init);
+	if (ret < 0)
+		goto error_model;
+
+	sim_stats_reset(model);
+	start = sim_time_ns();
+	ret = axi_dmac_transfer_repeat(dmac, SIM_BENCH_DMAC_WAVE_ADDR,
+				       SIM_BENCH_DMAC_BUFF_SIZE);
+	if (ret < 0)
+		goto error_dmac;
+	udelay(SIM_BENCH_DMAC_PLAY_US);
+
+	swap = sim_time_ns();
+	ret = axi_dmac_transfer_repeat(dmac, SIM_BENCH_DMAC_WAVE_ADDR +
+				       SIM_BENCH_DMAC_BUFF_SIZE,
+				       SIM_BENCH_DMAC_BUFF_SIZE);
+	if (ret < 0)
+		goto error_dmac;
+	if (axi_dmac_transfer_repeat(dmac, SIM_BENCH_DMAC_WAVE_ADDR,
+				     SIM_BENCH_DMAC_BUFF_SIZE) != -EBUSY) {
+		printf("repeat: second swap accepted while one is pending\n");
+		ret = FAILURE;
+		goto error_dmac;
+	}
+	do {
+		udelay(1);
+		axi_dmac_is_repeat_swapped(dmac, &swapped);
+	} while (!swapped);
+	sim_bench_report("repeat", model, start);
+
+	/* The old waveform ends its pass in progress, then the new one plays */
+	pass_ns = ((uint64_t)SIM_BENCH_DMAC_BUFF_SIZE * 1000 +
+		   SIM_BENCH_DMAC_BYTES_PER_US - 1) / SIM_BENCH_DMAC_BYTES_PER_US;
+	if (sim_time_ns() - swap > pass_ns + 1000 ||
+	    dmac->repeat.address != SIM_BENCH_DMAC_WAVE_ADDR +
+	    SIM_BENCH_DMAC_BUFF_SIZE) {
+		printf("repeat: swap after %"PRIu64" ns, expected at most "
+		       "%"PRIu64" ns\n", sim_time_ns() - swap, pass_ns + 1000);
+		ret = FAILURE;
+	}
+
+	axi_dmac_transfer_stop(dmac);
+error_dmac:
+	axi_dmac_remove(dmac);
+error_model:
+	sim_model_remove(model);
+
+	return ret;
+}
+
+/**
+ * @brief Blocking captures; the MMIO count shows what the polling of
+ *        axi_dmac_transfer() costs on top of the transfer itself.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_bench_axi_dmac(void)
+{
+	struct axi_dmac_init dmac_init = {
+		.name = "rx_dmac",
+		.base = SIM_BENCH_DMAC_BASE,
+		.direction = DMA_DEV_TO_MEM,
+		.flags = 0
+	};
+	struct sim_model *model;
+	struct axi_dmac *dmac;
+	uint64_t start;
+	uint64_t min_ns;
+	int32_t ret;
+	uint32_t i;
+
+	ret = sim_axi_dmac_model_init(&model, SIM_BENCH_DMAC_BYTES_PER_US);
+	if (ret < 0)
+		return ret;
+
+	ret = sim_mmio_register(model, SIM_BENCH_DMAC_BASE, model->size);
+	if (ret < 0)
+		goto error_model;
+
+	ret = axi_dmac_init(&dmac, &dmac_init);
+	if (ret < 0)
+		goto error_model;
+
+	sim_stats_reset(model);
+	start = sim_time_ns();
+	for (i = 0; i < SIM_BENCH_DMAC_CAPTURES; i++) {
+		ret = axi_dmac_transfer(dmac, SIM_BENCH_DMAC_BUFF_ADDR,
+					SIM_BENCH_DMAC_BUFF_SIZE);
+		if (ret < 0)
+			goto error_dmac;
+	}
+	sim_bench_report("capture", model, start);
+
+	/* A capture cannot complete before its data has been moved. */
+	min_ns = (uint64_t)SIM_BENCH_DMAC_CAPTURES * SIM_BENCH_DMAC_BUFF_SIZE *
+		 1000 / SIM_BENCH_DMAC_BYTES_PER_US;
+	if (sim_time_ns() - start < min_ns) {
+		printf("capture: %"PRIu64" ns, expected at least %"PRIu64" ns\n",
+		       sim_time_ns() - start, min_ns);
+		ret = FAILURE;
+	}
+
+error_dmac:
+	axi_dmac_remove(dmac);
+error_model:
+	sim_model_remove(model);
+	if (ret < 0)
+		return ret;
+
+	return sim_bench_axi_dmac_repeat();
+}
@@ -0,0 +1,208 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench_pool.c
+ *   @brief  Cost of pool allocations against the heap.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "error.h"
+#include "util.h"
+#include "pool.h"
+#include "fifo.h"
+#include "sim_bench.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* A xilinx UART receive buffer and its FIFO element */
+#define SIM_BENCH_POOL_BLOCK_SIZE	(sizeof(struct fifo_element) + 256)
+/* Elements in flight, as a slow reader would leave queued */
+#define SIM_BENCH_POOL_DEPTH		8
+#define SIM_BENCH_POOL_ROUNDS		200000
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+static char sim_bench_pool_data[256];
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Host time, the allocators run on the CPU and not on a device model.
+ * @return Monotonic time in nanoseconds.
+ */
+static uint64_t sim_bench_pool_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * @brief Print the cost of one operation of a step.
+ * @param step - Step name.
+ * @param start_ns - Host time at the start of the step.
+ * @param nb_ops - Operations done by the step.
+ * @return None.
+ */
+static void sim_bench_pool_report(const char *step, uint64_t start_ns,
+				  uint32_t nb_ops)
+{
+	printf("%-10s %"PRIu64" ns/op\n", step,
+	       (sim_bench_pool_now_ns() - start_ns) / nb_ops);
+}
+
+/**
+ * @brief Queue and dequeue FIFO elements, the way the xilinx UART driver
+ *        does, with a pool or with the heap.
+ * @param pool - Pool to allocate from, NULL to use the heap.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_bench_pool_fifo(struct pool *pool)
+{
+	struct fifo_element *fifo = NULL;
+	int32_t ret;
+	uint32_t i;
+	uint32_t j;
+
+	for (i = 0; i < SIM_BENCH_POOL_ROUNDS; i++) {
+		for (j = 0; j < SIM_BENCH_POOL_DEPTH; j++) {
+			ret = fifo_insert_pool(&fifo, sim_bench_pool_data,
+					       sizeof(sim_bench_pool_data), pool);
+			if (ret < 0)
+				goto error;
+		}
+		while (fifo)
+			fifo = fifo_remove_pool(fifo, pool);
+	}
+
+	return SUCCESS;
+
+error:
+	while (fifo)
+		fifo = fifo_remove_pool(fifo, pool);
+
+	return ret;
+}
+
+/**
+ * @brief Allocation and release of blocks and FIFO elements from a pool and
+ *        from the heap, in host time per operation. Each round allocates
+ *        SIM_BENCH_POOL_DEPTH blocks before releasing them.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_bench_pool(void)
+{
+	void *blocks[SIM_BENCH_POOL_DEPTH];
+	struct pool_stats stats;
+	struct pool *pool;
+	uint32_t nb_ops = SIM_BENCH_POOL_ROUNDS * SIM_BENCH_POOL_DEPTH;
+	uint64_t start;
+	int32_t ret;
+	uint32_t i;
+	uint32_t j;
+
+	ret = pool_init(&pool, SIM_BENCH_POOL_BLOCK_SIZE, SIM_BENCH_POOL_DEPTH);
+	if (ret < 0)
+		return ret;
+
+	start = sim_bench_pool_now_ns();
+	for (i = 0; i < SIM_BENCH_POOL_ROUNDS; i++) {
+		for (j = 0; j < SIM_BENCH_POOL_DEPTH; j++) {
+			blocks[j] = malloc(SIM_BENCH_POOL_BLOCK_SIZE);
+			if (!blocks[j]) {
+				ret = -ENOMEM;
+				goto error;
+			}
+		}
+		for (j = 0; j < SIM_BENCH_POOL_DEPTH; j++)
+			free(blocks[j]);
+	}
+	sim_bench_pool_report("malloc", start, nb_ops);
+
+	start = sim_bench_pool_now_ns();
+	for (i = 0; i < SIM_BENCH_POOL_ROUNDS; i++) {
+		for (j = 0; j < SIM_BENCH_POOL_DEPTH; j++) {
+			blocks[j] = pool_alloc(pool);
+			if (!blocks[j]) {
+				ret = -ENOMEM;
+				goto error;
+			}
+		}
+		for (j = 0; j < SIM_BENCH_POOL_DEPTH; j++)
+			pool_free(pool, blocks[j]);
+	}
+	sim_bench_pool_report("pool", start, nb_ops);
+
+	start = sim_bench_pool_now_ns();
+	ret = sim_bench_pool_fifo(NULL);
+	if (ret < 0)
+		goto error;
+	sim_bench_pool_report("fifo_heap", start, nb_ops);
+
+	start = sim_bench_pool_now_ns();
+	ret = sim_bench_pool_fifo(pool);
+	if (ret < 0)
+		goto error;
+	sim_bench_pool_report("fifo_pool", start, nb_ops);
+
+	/* Every FIFO element must have fit in the pool. */
+	ret = pool_get_stats(pool, &stats);
+	if (ret < 0)
+		goto error;
+	if (stats.fails || stats.used) {
+		printf("pool: %"PRIu32" failed, %"PRIu32" in use\n",
+		       stats.fails, stats.used);
+		ret = FAILURE;
+	}
+
+error:
+	pool_remove(pool);
+
+	return ret;
+}
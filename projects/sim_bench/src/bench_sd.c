@@ -0,0 +1,183 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench_sd.c
+ *   @brief  Benchmark and read-back check of the SD card driver.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include "error.h"
+#include "spi.h"
+#include "sd.h"
+#include "sim_model.h"
+#include "sim_spi.h"
+#include "sim_bench.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SIM_BENCH_SD_SIZE_MB	64
+#define SIM_BENCH_SD_BLOCKS	8
+#define SIM_BENCH_SD_LEN	(SIM_BENCH_SD_BLOCKS * DATA_BLOCK_LEN)
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+static uint8_t sd_data[SIM_BENCH_SD_LEN];
+static uint8_t sd_copy[SIM_BENCH_SD_LEN];
+static uint8_t sd_back[SIM_BENCH_SD_LEN];
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Check that a write left the source buffer intact and that the card
+ *        returns the same data. The diskio cache hands its sector buffers to
+ *        sd_write() and sd_stream_push() and serves later reads from them.
+ * @param sd - SD card.
+ * @param step - Step name.
+ * @param address - Address the data was written at.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_bench_sd_check(struct sd_desc *sd, const char *step,
+				  uint64_t address)
+{
+	int32_t ret;
+
+	if (memcmp(sd_data, sd_copy, SIM_BENCH_SD_LEN)) {
+		printf("%s: source buffer modified\n", step);
+		return FAILURE;
+	}
+
+	ret = sd_read(sd, sd_back, address, SIM_BENCH_SD_LEN);
+	if (ret < 0)
+		return ret;
+
+	if (memcmp(sd_back, sd_copy, SIM_BENCH_SD_LEN)) {
+		printf("%s: read back mismatch\n", step);
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Multi-block writes with sd_write() and with a CMD25 stream, each
+ *        followed by the read-back check.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_bench_sd(void)
+{
+	struct sim_model *model;
+	struct spi_desc *spi;
+	struct sd_desc *sd;
+	uint64_t start;
+	int32_t ret;
+	uint32_t i;
+
+	ret = sim_sd_model_init(&model, SIM_BENCH_SD_SIZE_MB);
+	if (ret < 0)
+		return ret;
+
+	struct sim_spi_init_param sim_spi_init = {
+		.model = model
+	};
+	struct spi_init_param spi_param = {
+		.max_speed_hz = 25000000,
+		.chip_select = 0,
+		.mode = SPI_MODE_0,
+		.platform_ops = &sim_spi_platform_ops,
+		.extra = &sim_spi_init
+	};
+
+	ret = spi_init(&spi, &spi_param);
+	if (ret < 0)
+		goto error_model;
+
+	struct sd_init_param sd_init_param = {
+		.spi_desc = spi
+	};
+
+	ret = sd_init(&sd, &sd_init_param);
+	if (ret < 0)
+		goto error_spi;
+
+	for (i = 0; i < SIM_BENCH_SD_LEN; i++)
+		sd_data[i] = i * 7 + (i >> 9);
+	memcpy(sd_copy, sd_data, SIM_BENCH_SD_LEN);
+
+	sim_stats_reset(model);
+	start = sim_time_ns();
+	ret = sd_write(sd, sd_data, 0, SIM_BENCH_SD_LEN);
+	if (ret < 0)
+		goto error_sd;
+	sim_bench_report("write", model, start);
+
+	ret = sim_bench_sd_check(sd, "write", 0);
+	if (ret < 0)
+		goto error_sd;
+
+	sim_stats_reset(model);
+	start = sim_time_ns();
+	ret = sd_stream_begin(sd, SD_STREAM_WRITE, SIM_BENCH_SD_LEN);
+	if (ret < 0)
+		goto error_sd;
+	ret = sd_stream_push(sd, sd_data, SIM_BENCH_SD_BLOCKS);
+	if (ret < 0)
+		goto error_sd;
+	ret = sd_stream_stop(sd);
+	if (ret < 0)
+		goto error_sd;
+	sim_bench_report("stream", model, start);
+
+	ret = sim_bench_sd_check(sd, "stream", SIM_BENCH_SD_LEN);
+
+error_sd:
+	sd_remove(sd);
+error_spi:
+	spi_remove(spi);
+error_model:
+	sim_model_remove(model);
+
+	return ret;
+}
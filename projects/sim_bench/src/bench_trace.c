@@ -0,0 +1,252 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench_trace.c
+ *   @brief  Trace ring drains over a UART and through an IIO attribute.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "util.h"
+#include "trace.h"
+#include "iio_trace.h"
+#include "sim_model.h"
+#include "sim_uart.h"
+#include "sim_bench.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SIM_BENCH_TRACE_EVENTS		512
+/* Events recorded past a full ring in the attribute step */
+#define SIM_BENCH_TRACE_LOST		16
+#define SIM_BENCH_TRACE_BAUD		921600
+/* Sync, id, core, number of arguments, timestamp and two arguments */
+#define SIM_BENCH_TRACE_FRAME_SIZE	18
+#define SIM_BENCH_TRACE_ATTR_SIZE	256
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Trace timestamp source, simulated time in microseconds.
+ * @return The timestamp.
+ */
+static uint32_t sim_bench_trace_us(void)
+{
+	return sim_time_ns() / 1000;
+}
+
+/**
+ * @brief Record events numbered from first.
+ * @param first - Number of the first event.
+ * @param nb - Number of events.
+ */
+static void sim_bench_trace_record(uint32_t first, uint32_t nb)
+{
+	uint32_t i;
+
+	for (i = first; i < first + nb; i++) {
+		trace_event2(TRACE_ID_USER, i, ~i);
+		sim_advance_ns(1000);
+	}
+}
+
+/**
+ * @brief Drain the events to a UART and decode the frames it sent.
+ * @param uart - UART descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_bench_trace_uart(struct uart_desc *uart)
+{
+	uint8_t		*frames;
+	uint8_t		*frame;
+	uint64_t	start;
+	uint32_t	size;
+	uint32_t	a0;
+	uint32_t	a1;
+	uint32_t	i;
+	int32_t		ret;
+
+	size = SIM_BENCH_TRACE_EVENTS * SIM_BENCH_TRACE_FRAME_SIZE;
+	frames = malloc(size);
+	if (!frames)
+		return -ENOMEM;
+
+	sim_bench_trace_record(0, SIM_BENCH_TRACE_EVENTS);
+
+	start = sim_time_ns();
+	ret = trace_uart_drain(uart);
+	if (ret < 0)
+		goto out;
+	printf("%-10s %"PRIu64" us, %"PRIu32" events\n", "uart",
+	       (sim_time_ns() - start) / 1000, SIM_BENCH_TRACE_EVENTS);
+
+	if (sim_uart_tx(uart, frames, size) != size || uart_get_errors(uart)) {
+		printf("uart: frame stream size mismatch\n");
+		ret = FAILURE;
+		goto out;
+	}
+
+	for (i = 0; i < SIM_BENCH_TRACE_EVENTS; i++) {
+		frame = frames + i * SIM_BENCH_TRACE_FRAME_SIZE;
+		a0 = frame[10] | frame[11] << 8 | frame[12] << 16 |
+		     (uint32_t)frame[13] << 24;
+		a1 = frame[14] | frame[15] << 8 | frame[16] << 16 |
+		     (uint32_t)frame[17] << 24;
+		if ((frame[0] | frame[1] << 8) != TRACE_FRAME_SYNC ||
+		    (frame[2] | frame[3] << 8) != TRACE_ID_USER ||
+		    frame[5] != 2 || a0 != i || a1 != ~i) {
+			printf("uart: bad frame %"PRIu32"\n", i);
+			ret = FAILURE;
+			goto out;
+		}
+	}
+
+out:
+	free(frames);
+
+	return ret;
+}
+
+/**
+ * @brief Overrun the ring, then drain it through the IIO attribute a few
+ *	  lines at a time.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_bench_trace_attr(void)
+{
+	char		buf[SIM_BENCH_TRACE_ATTR_SIZE];
+	uint32_t	nb_lines = 0;
+	uint32_t	nb_reads = 0;
+	uint32_t	lost = 0;
+	uint32_t	ts, core, id, a0, a1;
+	char		*line;
+	char		*end;
+	ssize_t		ret;
+
+	sim_bench_trace_record(0, SIM_BENCH_TRACE_EVENTS +
+			       SIM_BENCH_TRACE_LOST);
+
+	do {
+		ret = iio_trace_show(NULL, buf, sizeof(buf), NULL, 0);
+		if (ret < 0)
+			return ret;
+		nb_reads++;
+
+		for (line = buf; line < buf + ret; line = end + 1) {
+			end = strchr(line, '\n');
+			if (!end || sscanf(line, "%"SCNu32" %"SCNu32" %"SCNx32
+					   " %"SCNx32" %"SCNx32, &ts, &core, &id,
+					   &a0, &a1) < 4)
+				return FAILURE;
+
+			if (id == TRACE_ID_LOST) {
+				lost += a0;
+				continue;
+			}
+			if (id != TRACE_ID_USER ||
+			    a0 != SIM_BENCH_TRACE_LOST + nb_lines) {
+				printf("attr: bad line \"%.*s\"\n",
+				       (int)(end - line), line);
+				return FAILURE;
+			}
+			nb_lines++;
+		}
+	} while (ret);
+
+	printf("%-10s %"PRIu32" reads, %"PRIu32" events, %"PRIu32" lost\n",
+	       "attr", nb_reads, nb_lines, lost);
+
+	if (nb_lines != SIM_BENCH_TRACE_EVENTS ||
+	    lost != SIM_BENCH_TRACE_LOST)
+		return FAILURE;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Trace drains over a UART at 921600 baud and through the IIO trace
+ *	  attribute.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_bench_trace(void)
+{
+	struct trace_init_param		trace_param = {
+		.nb_events = SIM_BENCH_TRACE_EVENTS,
+		.timestamp = sim_bench_trace_us
+	};
+	struct sim_uart_init_param	sim_uart_init = {
+		.tx_size = SIM_BENCH_TRACE_EVENTS * SIM_BENCH_TRACE_FRAME_SIZE
+	};
+	struct uart_init_param		uart_param = {
+		.baud_rate = SIM_BENCH_TRACE_BAUD,
+		.size = UART_CS_8,
+		.parity = UART_PAR_NO,
+		.stop = UART_STOP_1,
+		.extra = &sim_uart_init
+	};
+	struct uart_desc		*uart;
+	int32_t				ret;
+
+	ret = uart_init(&uart, &uart_param);
+	if (ret < 0)
+		return ret;
+
+	ret = trace_init(&trace_param);
+	if (ret < 0)
+		goto error_uart;
+
+	ret = sim_bench_trace_uart(uart);
+	if (ret < 0)
+		goto error_trace;
+
+	ret = sim_bench_trace_attr();
+
+error_trace:
+	trace_remove();
+error_uart:
+	uart_remove(uart);
+
+	return ret;
+}
@@ -0,0 +1,282 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench_unpack.c
+ *   @brief  Throughput of the sample unpacking helpers.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "error.h"
+#include "util.h"
+#include "unpack.h"
+#include "sim_bench.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define SIM_BENCH_UNPACK_SAMPLES	4096
+#define SIM_BENCH_UNPACK_ROUNDS		1000
+#define SIM_BENCH_UNPACK_CHANNELS	4
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+enum sim_bench_unpack_fmt {
+	SIM_BENCH_UNPACK_U32,
+	SIM_BENCH_UNPACK_S32,
+	SIM_BENCH_UNPACK_S16,
+	SIM_BENCH_UNPACK_LJUST16_U16,
+	SIM_BENCH_UNPACK_LJUST16_S16,
+	SIM_BENCH_UNPACK_SELECT,
+	SIM_BENCH_UNPACK_DEINTERLEAVE_U16,
+	SIM_BENCH_UNPACK_DEINTERLEAVE_U32,
+};
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+static const struct {
+	const char *name;
+	enum sim_bench_unpack_fmt fmt;
+	uint8_t bits;
+} sim_bench_unpack_cases[] = {
+	{ "u32_12", SIM_BENCH_UNPACK_U32, 12 },
+	{ "u32_16", SIM_BENCH_UNPACK_U32, 16 },
+	{ "u32_18", SIM_BENCH_UNPACK_U32, 18 },
+	{ "u32_20", SIM_BENCH_UNPACK_U32, 20 },
+	{ "u32_24", SIM_BENCH_UNPACK_U32, 24 },
+	{ "u32_26", SIM_BENCH_UNPACK_U32, 26 },
+	{ "u32_14", SIM_BENCH_UNPACK_U32, 14 },
+	{ "s32_24", SIM_BENCH_UNPACK_S32, 24 },
+	{ "s16_12", SIM_BENCH_UNPACK_S16, 12 },
+	{ "s16_16", SIM_BENCH_UNPACK_S16, 16 },
+	{ "lj_u16_12", SIM_BENCH_UNPACK_LJUST16_U16, 12 },
+	{ "lj_s16_14", SIM_BENCH_UNPACK_LJUST16_S16, 14 },
+	{ "select", SIM_BENCH_UNPACK_SELECT, 8 },
+	{ "deint_u16", SIM_BENCH_UNPACK_DEINTERLEAVE_U16, 16 },
+	{ "deint_u32", SIM_BENCH_UNPACK_DEINTERLEAVE_U32, 32 },
+};
+
+static uint8_t sim_bench_unpack_src[SIM_BENCH_UNPACK_SAMPLES * 4];
+static uint32_t sim_bench_unpack_dst[SIM_BENCH_UNPACK_SAMPLES];
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Host time, the unpacking runs on the CPU and not on a device model.
+ * @return Monotonic time in nanoseconds.
+ */
+static uint64_t sim_bench_unpack_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * @brief Bit by bit reference of a packed MSB first sample.
+ * @param src - Packed stream.
+ * @param idx - Sample index.
+ * @param bits - Sample width.
+ * @return The zero-extended sample.
+ */
+static uint32_t sim_bench_unpack_ref(const uint8_t *src, uint32_t idx,
+				     uint8_t bits)
+{
+	uint32_t pos = idx * bits;
+	uint32_t val = 0;
+	uint8_t i;
+
+	for (i = 0; i < bits; i++, pos++)
+		val = (val << 1) | ((src[pos / 8] >> (7 - pos % 8)) & 1);
+
+	return val;
+}
+
+/**
+ * @brief Check the fast paths of the packed formats against the reference.
+ * @param fmt - Packed format.
+ * @param bits - Sample width.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t sim_bench_unpack_check(enum sim_bench_unpack_fmt fmt,
+				      uint8_t bits)
+{
+	uint32_t *dst = sim_bench_unpack_dst;
+	uint32_t ref;
+	uint32_t val;
+	uint32_t i;
+
+	for (i = 0; i < SIM_BENCH_UNPACK_SAMPLES; i++) {
+		ref = sim_bench_unpack_ref(sim_bench_unpack_src, i, bits);
+		switch (fmt) {
+		case SIM_BENCH_UNPACK_U32:
+			val = dst[i];
+			break;
+		case SIM_BENCH_UNPACK_S32:
+			val = dst[i];
+			if (bits < 32 && (ref & BIT(bits - 1)))
+				ref |= ~(BIT(bits) - 1);
+			break;
+		case SIM_BENCH_UNPACK_S16:
+			val = (uint16_t)((int16_t *)dst)[i];
+			if (ref & BIT(bits - 1))
+				ref |= ~(BIT(bits) - 1);
+			ref &= 0xFFFF;
+			break;
+		default:
+			return SUCCESS;
+		}
+		if (val != ref) {
+			printf("%u bits sample %"PRIu32": 0x%08"PRIx32
+			       ", expected 0x%08"PRIx32"\n", bits, i, val, ref);
+			return FAILURE;
+		}
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Unpack one block of samples in the given format.
+ * @param fmt - Format.
+ * @param bits - Sample width.
+ * @return None.
+ */
+static void sim_bench_unpack_run(enum sim_bench_unpack_fmt fmt, uint8_t bits)
+{
+	uint16_t *dst16[SIM_BENCH_UNPACK_CHANNELS];
+	uint32_t *dst32[SIM_BENCH_UNPACK_CHANNELS];
+	const uint8_t *src = sim_bench_unpack_src;
+	uint32_t *dst = sim_bench_unpack_dst;
+	uint32_t scans = SIM_BENCH_UNPACK_SAMPLES / SIM_BENCH_UNPACK_CHANNELS;
+	uint32_t i;
+
+	switch (fmt) {
+	case SIM_BENCH_UNPACK_U32:
+		unpack_u32(dst, src, SIM_BENCH_UNPACK_SAMPLES, bits);
+		break;
+	case SIM_BENCH_UNPACK_S32:
+		unpack_s32((int32_t *)dst, src, SIM_BENCH_UNPACK_SAMPLES, bits);
+		break;
+	case SIM_BENCH_UNPACK_S16:
+		unpack_s16((int16_t *)dst, src, SIM_BENCH_UNPACK_SAMPLES, bits);
+		break;
+	case SIM_BENCH_UNPACK_LJUST16_U16:
+		unpack_ljust16_u16((uint16_t *)dst, src,
+				   SIM_BENCH_UNPACK_SAMPLES, bits);
+		break;
+	case SIM_BENCH_UNPACK_LJUST16_S16:
+		unpack_ljust16_s16((int16_t *)dst, src,
+				   SIM_BENCH_UNPACK_SAMPLES, bits);
+		break;
+	case SIM_BENCH_UNPACK_SELECT:
+		/* Channels 0 and 2 of 4, the AD7768 style status byte dropped */
+		unpack_select_u32_u16((uint16_t *)dst, (const uint32_t *)src,
+				      SIM_BENCH_UNPACK_SAMPLES,
+				      SIM_BENCH_UNPACK_CHANNELS, 0x5, bits);
+		break;
+	case SIM_BENCH_UNPACK_DEINTERLEAVE_U16:
+		for (i = 0; i < SIM_BENCH_UNPACK_CHANNELS; i++)
+			dst16[i] = (uint16_t *)dst + i * scans;
+		deinterleave_u16(dst16, (const uint16_t *)src,
+				 SIM_BENCH_UNPACK_CHANNELS, scans);
+		break;
+	case SIM_BENCH_UNPACK_DEINTERLEAVE_U32:
+		for (i = 0; i < SIM_BENCH_UNPACK_CHANNELS; i++)
+			dst32[i] = dst + i * scans;
+		deinterleave_u32(dst32, (const uint32_t *)src,
+				 SIM_BENCH_UNPACK_CHANNELS, scans);
+		break;
+	}
+}
+
+/**
+ * @brief Unpacking throughput of each format, in samples per second of host
+ *        time. The packed fast paths are checked against a bit by bit
+ *        reference first.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_bench_unpack(void)
+{
+	enum sim_bench_unpack_fmt fmt;
+	uint64_t start;
+	uint64_t ns;
+	uint32_t seed = 0x12345678;
+	uint8_t bits;
+	uint32_t i;
+	uint32_t r;
+	int32_t ret;
+
+	for (i = 0; i < sizeof(sim_bench_unpack_src); i++) {
+		seed = seed * 1664525 + 1013904223;
+		sim_bench_unpack_src[i] = seed >> 24;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(sim_bench_unpack_cases); i++) {
+		fmt = sim_bench_unpack_cases[i].fmt;
+		bits = sim_bench_unpack_cases[i].bits;
+
+		sim_bench_unpack_run(fmt, bits);
+		ret = sim_bench_unpack_check(fmt, bits);
+		if (ret < 0)
+			return ret;
+
+		start = sim_bench_unpack_now_ns();
+		for (r = 0; r < SIM_BENCH_UNPACK_ROUNDS; r++)
+			sim_bench_unpack_run(fmt, bits);
+		ns = sim_bench_unpack_now_ns() - start;
+
+		printf("%-10s %"PRIu64" Msamples/s\n",
+		       sim_bench_unpack_cases[i].name,
+		       (uint64_t)SIM_BENCH_UNPACK_SAMPLES *
+		       SIM_BENCH_UNPACK_ROUNDS * 1000 / (ns ? ns : 1));
+	}
+
+	return SUCCESS;
+}
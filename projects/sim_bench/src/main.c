@@ -0,0 +1,106 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/main.c
+ *   @brief  Host benchmarks of the drivers on the simulation platform.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include "error.h"
+#include "util.h"
+#include "sim_bench.h"
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+static const struct {
+	const char *name;
+	int32_t (*run)(void);
+} sim_benches[] = {
+	{ "ad7124", sim_bench_ad7124 },
+	{ "spi_engine", sim_bench_spi_engine },
+	{ "ad9361", sim_bench_ad9361 },
+	{ "axi_dmac", sim_bench_axi_dmac },
+	{ "sd", sim_bench_sd },
+	{ "unpack", sim_bench_unpack },
+	{ "pool", sim_bench_pool },
+	{ "adxl372", sim_bench_adxl372 },
+	{ "adxl362", sim_bench_adxl362 },
+	{ "trace", sim_bench_trace },
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Print the traffic of a benchmark step.
+ * @param step - Step name.
+ * @param model - Device model.
+ * @param start_ns - Simulated time at the start of the step.
+ * @return None.
+ */
+void sim_bench_report(const char *step, struct sim_model *model,
+		      uint64_t start_ns)
+{
+	printf("%-10s %"PRIu64" us, ", step, (sim_time_ns() - start_ns) / 1000);
+	sim_stats_print(model);
+}
+
+/***************************************************************************//**
+ * @brief main
+*******************************************************************************/
+int main(void)
+{
+	int32_t failed = 0;
+	int32_t ret;
+	uint32_t i;
+
+	for (i = 0; i < ARRAY_SIZE(sim_benches); i++) {
+		printf("[%s]\n", sim_benches[i].name);
+		ret = sim_benches[i].run();
+		if (ret < 0) {
+			printf("%s failed: %"PRId32"\n", sim_benches[i].name, ret);
+			failed++;
+		}
+	}
+
+	return failed ? 1 : 0;
+}
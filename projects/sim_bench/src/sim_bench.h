@@ -0,0 +1,86 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/sim_bench.h
+ *   @brief  Benchmarks run by the sim_bench host program.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef SIM_BENCH_H_
+#define SIM_BENCH_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "sim_model.h"
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Print the modeled time and the traffic of a benchmark step. */
+void sim_bench_report(const char *step, struct sim_model *model,
+		      uint64_t start_ns);
+
+/* AD7124 setup, polled and continuous reads over the sim SPI backend. */
+int32_t sim_bench_ad7124(void);
+
+/* AD7124 polled reads through the SPI Engine core. */
+int32_t sim_bench_spi_engine(void);
+
+/* AD9361 initialization and calibrations. */
+int32_t sim_bench_ad9361(void);
+
+/* Blocking DMA captures through the AXI DMAC core. */
+int32_t sim_bench_axi_dmac(void);
+
+/* SD card multi-block writes, read back from the card. */
+int32_t sim_bench_sd(void);
+
+/* Host throughput of the sample unpacking helpers. */
+int32_t sim_bench_unpack(void);
+
+/* Host cost of pool allocations and FIFO elements against the heap. */
+int32_t sim_bench_pool(void);
+
+/* ADXL372 FIFO watermark streaming through an IIO trigger. */
+int32_t sim_bench_adxl372(void);
+
+/* ADXL362 FIFO watermark streaming through an IIO trigger. */
+int32_t sim_bench_adxl362(void);
+
+/* Trace ring drains over a UART and through an IIO attribute. */
+int32_t sim_bench_trace(void);
+
+#endif // SIM_BENCH_H_
@@ -0,0 +1,93 @@
+#!/bin/python
+
+import argparse
+import struct
+import sys
+
+description_help='''Decode a binary event trace written by trace_drain() (util/trace.c)
+Examples:\n
+	Decode a capture saved from the UART
+	>python trace_decode.py trace.bin
+	Decode with application event names and a 100 MHz timestamp counter
+	>python trace_decode.py trace.bin -names=my_events.txt -freq=100000000
+
+	The names file holds one "<id> <name>" pair per line, ids in decimal or hex.
+'''
+
+# Keep in sync with enum trace_id in include/trace.h
+TRACE_IDS = {
+	0x000: 'LOST',
+	0x001: 'AXI_DMAC_IRQ',
+	0x002: 'SPI_ENGINE_XFER',
+	0x003: 'ADXL372_FIFO',
+}
+
+TRACE_FRAME_SYNC = 0x5254
+TRACE_FRAME_HDR = struct.Struct('<HHBBI')
+TRACE_MAX_ARGS = 4
+
+def parse_input():
+	parser = argparse.ArgumentParser(description=description_help,\
+				formatter_class=argparse.RawTextHelpFormatter)
+	parser.add_argument('input', help="Binary trace file, - for stdin")
+	parser.add_argument('-names', help="File with application event names")
+	parser.add_argument('-freq', type=float, default=0,
+			help="Timestamp frequency in Hz. Ticks are printed if not set")
+	return parser.parse_args()
+
+def load_names(path):
+	names = dict(TRACE_IDS)
+	if path is None:
+		return names
+	with open(path) as f:
+		for line in f:
+			line = line.split('#')[0].split()
+			if len(line) >= 2:
+				names[int(line[0], 0)] = line[1]
+	return names
+
+def decode(data):
+	pos = 0
+	while pos + TRACE_FRAME_HDR.size <= len(data):
+		sync, id, core, nb_args, ts = TRACE_FRAME_HDR.unpack_from(data, pos)
+		if sync != TRACE_FRAME_SYNC or nb_args > TRACE_MAX_ARGS:
+			# Resynchronize on the next byte
+			pos += 1
+			continue
+		end = pos + TRACE_FRAME_HDR.size + 4 * nb_args
+		if end > len(data):
+			break
+		args = struct.unpack_from('<%dI' % nb_args, data,
+					  pos + TRACE_FRAME_HDR.size)
+		yield (id, core, ts, args)
+		pos = end
+
+def fmt_time(ticks, freq):
+	if freq:
+		return '%14.3f us' % (ticks * 1e6 / freq)
+	return '%10u' % ticks
+
+def main():
+	args = parse_input()
+	names = load_names(args.names)
+	if args.input == '-':
+		data = sys.stdin.buffer.read()
+	else:
+		with open(args.input, 'rb') as f:
+			data = f.read()
+
+	last = {}
+	for (id, core, ts, ev_args) in decode(data):
+		if id == 0:
+			print("core %u: %u events lost" % (core, ev_args[0]))
+			last.pop(core, None)
+			continue
+		delta = (ts - last[core]) & 0xFFFFFFFF if core in last else 0
+		last[core] = ts
+		name = names.get(id, 'ID_0x%03x' % id)
+		print("%s +%s core %u %-20s %s" % (fmt_time(ts, args.freq),
+			fmt_time(delta, args.freq).strip(), core, name,
+			' '.join('0x%08x' % a for a in ev_args)))
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,256 @@
+/***************************************************************************//**
+ *   @file   clk_plan.c
+ *   @brief  Multi-chip clock plan solver with a cache of solved plans.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "clk_plan.h"
+
+/******************************************************************************/
+/************************** Functions Implementation **************************/
+/******************************************************************************/
+
+/**
+ * Allocate a clock plan cache.
+ * @param desc - The clock plan descriptor.
+ * @param param - The initialization parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t clk_plan_init(struct clk_plan_desc **desc,
+		      const struct clk_plan_init_param *param)
+{
+	struct clk_plan_desc *plan_desc;
+	uint32_t i;
+
+	if (!desc || !param || !param->outputs || !param->num_plans ||
+	    !param->num_outputs || param->num_outputs > CLK_PLAN_MAX_OUTPUTS)
+		return -EINVAL;
+
+	for (i = 0; i < param->num_outputs; i++)
+		if (!param->outputs[i].solve || !param->outputs[i].apply)
+			return -EINVAL;
+
+	plan_desc = (struct clk_plan_desc *)calloc(1, sizeof(*plan_desc));
+	if (!plan_desc)
+		return -ENOMEM;
+
+	plan_desc->plans = (struct clk_plan *)calloc(param->num_plans,
+			   sizeof(*plan_desc->plans));
+	if (!plan_desc->plans) {
+		free(plan_desc);
+		return -ENOMEM;
+	}
+
+	plan_desc->outputs = param->outputs;
+	plan_desc->num_outputs = param->num_outputs;
+	plan_desc->num_plans = param->num_plans;
+
+	*desc = plan_desc;
+
+	return SUCCESS;
+}
+
+/**
+ * Free the resources allocated by clk_plan_init().
+ * @param desc - The clock plan descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t clk_plan_remove(struct clk_plan_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	free(desc->plans);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * Drop all cached plans, e.g. after the parent rate of an output changed.
+ * @param desc - The clock plan descriptor.
+ */
+void clk_plan_flush(struct clk_plan_desc *desc)
+{
+	uint32_t i;
+
+	for (i = 0; i < desc->num_plans; i++)
+		desc->plans[i].valid = false;
+}
+
+/**
+ * Find the cached plan matching a reference and a set of rates.
+ * @param desc - The clock plan descriptor.
+ * @param ref_rate - The reference rate.
+ * @param rates - Requested rate of each output.
+ * @return The cached plan or NULL if there is none.
+ */
+static struct clk_plan *clk_plan_lookup(struct clk_plan_desc *desc,
+					uint64_t ref_rate,
+					const uint64_t *rates)
+{
+	struct clk_plan *plan;
+	uint32_t i;
+
+	for (i = 0; i < desc->num_plans; i++) {
+		plan = &desc->plans[i];
+		if (!plan->valid || plan->ref_rate != ref_rate)
+			continue;
+		if (!memcmp(plan->req_rate, rates,
+			    desc->num_outputs * sizeof(*rates)))
+			return plan;
+	}
+
+	return NULL;
+}
+
+/**
+ * Pick the cache entry to be overwritten by a new plan.
+ * @param desc - The clock plan descriptor.
+ * @return A free entry or the least recently used one.
+ */
+static struct clk_plan *clk_plan_victim(struct clk_plan_desc *desc)
+{
+	struct clk_plan *victim = &desc->plans[0];
+	uint32_t i;
+
+	for (i = 0; i < desc->num_plans; i++) {
+		if (!desc->plans[i].valid)
+			return &desc->plans[i];
+		if ((int32_t)(desc->plans[i].stamp - victim->stamp) < 0)
+			victim = &desc->plans[i];
+	}
+
+	return victim;
+}
+
+/**
+ * Look up the plan for a set of output rates, solving it on a cache miss.
+ * @param desc - The clock plan descriptor.
+ * @param ref_rate - The reference rate the outputs are derived from.
+ * @param rates - Requested rate of each output (num_outputs entries).
+ * @param plan - The solved plan. Valid until the entry is replaced.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t clk_plan_solve(struct clk_plan_desc *desc, uint64_t ref_rate,
+		       const uint64_t *rates, struct clk_plan **plan)
+{
+	const struct clk_plan_output *out;
+	struct clk_plan *p;
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc || !rates || !plan)
+		return -EINVAL;
+
+	p = clk_plan_lookup(desc, ref_rate, rates);
+	if (p) {
+		desc->hits++;
+		goto found;
+	}
+
+	desc->misses++;
+	p = clk_plan_victim(desc);
+	p->valid = false;
+	p->ref_rate = ref_rate;
+
+	for (i = 0; i < desc->num_outputs; i++) {
+		out = &desc->outputs[i];
+		p->req_rate[i] = rates[i];
+		ret = out->solve(out->dev, out->chan, rates[i], &p->setting[i]);
+		if (ret < 0)
+			return ret;
+	}
+
+	p->valid = true;
+found:
+	p->stamp = ++desc->stamp;
+	*plan = p;
+
+	return SUCCESS;
+}
+
+/**
+ * Program all the clock outputs from a solved plan. No divider search is done
+ * here, only register writes.
+ * @param desc - The clock plan descriptor.
+ * @param plan - The solved plan.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t clk_plan_apply(struct clk_plan_desc *desc,
+		       const struct clk_plan *plan)
+{
+	const struct clk_plan_output *out;
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc || !plan || !plan->valid)
+		return -EINVAL;
+
+	for (i = 0; i < desc->num_outputs; i++) {
+		out = &desc->outputs[i];
+		ret = out->apply(out->dev, out->chan, &plan->setting[i]);
+		if (ret < 0)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * Solve (or look up) and program a set of output rates.
+ * @param desc - The clock plan descriptor.
+ * @param ref_rate - The reference rate the outputs are derived from.
+ * @param rates - Requested rate of each output (num_outputs entries).
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t clk_plan_set_rates(struct clk_plan_desc *desc, uint64_t ref_rate,
+			   const uint64_t *rates)
+{
+	struct clk_plan *plan;
+	int32_t ret;
+
+	ret = clk_plan_solve(desc, ref_rate, rates, &plan);
+	if (ret < 0)
+		return ret;
+
+	return clk_plan_apply(desc, plan);
+}
@@ -44,6 +44,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include "fifo.h"
+#include "pool.h"
 #include "error.h"
 
 /******************************************************************************/
@@ -51,23 +52,30 @@
 /******************************************************************************/
 
 /**
- * @brief Create new fifo element
+ * @brief Create new fifo element. The element and its data are allocated
+ * as one block, from the pool when they fit in a pool block.
  * @param buff - Data to be saved in fifo.
  * @param len - Length of the data.
+ * @param pool - Pool to allocate from, NULL to use the heap.
  * @return fifo element in case of success, NULL otherwise
  */
-static struct fifo_element * fifo_new_element(char *buff, uint32_t len)
+static struct fifo_element * fifo_new_element(char *buff, uint32_t len,
+		struct pool *pool)
 {
-	struct fifo_element *q = calloc(1, sizeof(struct fifo_element));
-	if (!q)
-		return NULL;
+	struct fifo_element *q = NULL;
+	uint32_t size = sizeof(struct fifo_element) + len;
+
+	if (size <= pool_block_size(pool))
+		q = pool_alloc(pool);
+	if (!q) {
+		q = malloc(size);
+		if (!q)
+			return NULL;
+	}
 
+	q->next = NULL;
 	q->len = len;
-	q->data = calloc(1, len);
-	if (!(q->data)) {
-		free(q);
-		return NULL;
-	}
+	q->data = (char *)(q + 1);
 	memcpy(q->data, buff, len);
 
 	return q;
@@ -90,20 +98,23 @@ static struct fifo_element *fifo_get_last(struct fifo_element *p_fifo)
 }
 
 /**
- * @brief Insert element to fifo, in the last position.
+ * @brief Insert element to fifo, in the last position. The element is
+ * allocated from a pool when possible and from the heap otherwise.
  * @param p_fifo - Pointer to fifo.
  * @param buff - Data to be saved in fifo.
  * @param len - Length of the data.
+ * @param pool - Pool created with pool_init(), NULL to use the heap.
  * @return SUCCESS in case of success, FAILURE otherwise
  */
-int32_t fifo_insert(struct fifo_element **p_fifo, char *buff, uint32_t len)
+int32_t fifo_insert_pool(struct fifo_element **p_fifo, char *buff,
+			 uint32_t len, struct pool *pool)
 {
 	struct fifo_element *p, *q;
 
 	if (len <= 0)
 		return FAILURE;
 
-	q = fifo_new_element(buff, len);
+	q = fifo_new_element(buff, len, pool);
 	if (!q)
 		return FAILURE;
 
@@ -118,19 +129,43 @@ int32_t fifo_insert(struct fifo_element **p_fifo, char *buff, uint32_t len)
 }
 
 /**
- * @brief Remove fifo head
+ * @brief Insert element to fifo, in the last position.
  * @param p_fifo - Pointer to fifo.
+ * @param buff - Data to be saved in fifo.
+ * @param len - Length of the data.
+ * @return SUCCESS in case of success, FAILURE otherwise
+ */
+int32_t fifo_insert(struct fifo_element **p_fifo, char *buff, uint32_t len)
+{
+	return fifo_insert_pool(p_fifo, buff, len, NULL);
+}
+
+/**
+ * @brief Remove fifo head inserted with fifo_insert_pool().
+ * @param p_fifo - Pointer to fifo.
+ * @param pool - Pool given to fifo_insert_pool().
  * @return next element in fifo if exists, NULL otherwise.
  */
-struct fifo_element * fifo_remove(struct fifo_element *p_fifo)
+struct fifo_element * fifo_remove_pool(struct fifo_element *p_fifo,
+				       struct pool *pool)
 {
 	struct fifo_element *p = p_fifo;
 
 	if (p_fifo != NULL) {
 		p_fifo = p_fifo->next;
-		free(p->data);
-		free(p);
+		if (pool_free(pool, p))
+			free(p);
 	}
 
 	return p_fifo;
 }
+
+/**
+ * @brief Remove fifo head
+ * @param p_fifo - Pointer to fifo.
+ * @return next element in fifo if exists, NULL otherwise.
+ */
+struct fifo_element * fifo_remove(struct fifo_element *p_fifo)
+{
+	return fifo_remove_pool(p_fifo, NULL);
+}
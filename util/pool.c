@@ -0,0 +1,260 @@
+/***************************************************************************//**
+ *   @file   pool.c
+ *   @brief  Fixed-size block memory pool.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include "pool.h"
+#include "error.h"
+#include "util.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Alignment of the blocks, enough for any scalar type used by the drivers */
+#define POOL_ALIGN	8
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct pool
+ * @brief Pool descriptor
+ */
+struct pool {
+	/** Storage of all the blocks */
+	uint8_t		*mem;
+	/** Size requested for a block */
+	uint32_t	block_size;
+	/** Distance between two blocks */
+	uint32_t	stride;
+	/** Number of blocks */
+	uint32_t	nb_blocks;
+	/** Free blocks, linked through their first word */
+	void		*free_list;
+#ifndef POOL_NO_STATS
+	/** Usage statistics */
+	struct pool_stats	stats;
+#endif
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Create a pool of fixed-size blocks
+ *
+ * All the memory is allocated here, pool_alloc() and pool_free() only move
+ * blocks on and off a free list, so they take constant time and cannot
+ * fragment the heap.
+ *
+ * @note The pool is not protected against concurrent access. If it is used
+ * from interrupt context and from the main loop, pool_alloc() and pool_free()
+ * should be called inside a critical section.
+ *
+ * @param desc - Where to store the pool reference
+ * @param block_size - Size of a block in bytes
+ * @param nb_blocks - Number of blocks
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : On invalid parameters
+ *  - -ENOMEM : If the memory could not be allocated
+ */
+int32_t pool_init(struct pool **desc, uint32_t block_size, uint32_t nb_blocks)
+{
+	struct pool	*ldesc;
+	uint32_t	stride;
+	uint32_t	i;
+
+	if (!desc || !block_size || !nb_blocks)
+		return -EINVAL;
+
+	stride = max_t(uint32_t, block_size, sizeof(void *));
+	stride = (stride + POOL_ALIGN - 1) & ~(POOL_ALIGN - 1);
+	if (stride < block_size || nb_blocks > UINT32_MAX / stride)
+		return -EINVAL;
+
+	ldesc = (struct pool *)calloc(1, sizeof(*ldesc));
+	if (!ldesc)
+		return -ENOMEM;
+
+	ldesc->mem = (uint8_t *)malloc(stride * nb_blocks);
+	if (!ldesc->mem) {
+		free(ldesc);
+		return -ENOMEM;
+	}
+
+	ldesc->block_size = block_size;
+	ldesc->stride = stride;
+	ldesc->nb_blocks = nb_blocks;
+
+	/* Chain the blocks in address order */
+	for (i = 0; i < nb_blocks - 1; i++)
+		*(void **)(ldesc->mem + i * stride) = ldesc->mem + (i + 1) * stride;
+	*(void **)(ldesc->mem + i * stride) = NULL;
+	ldesc->free_list = ldesc->mem;
+
+	*desc = ldesc;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the memory of the pool. Blocks still in use become invalid.
+ * @param desc - Pool reference
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : If desc is NULL
+ */
+int32_t pool_remove(struct pool *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	free(desc->mem);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Take a block from the pool. The block is not cleared.
+ * @param desc - Pool reference
+ * @return Address of the block, NULL if desc is NULL or the pool is empty
+ */
+void *pool_alloc(struct pool *desc)
+{
+	void *block;
+
+	if (!desc)
+		return NULL;
+
+	block = desc->free_list;
+	if (!block) {
+#ifndef POOL_NO_STATS
+		desc->stats.fails++;
+#endif
+		return NULL;
+	}
+	desc->free_list = *(void **)block;
+
+#ifndef POOL_NO_STATS
+	desc->stats.allocs++;
+	desc->stats.used++;
+	if (desc->stats.used > desc->stats.high_water)
+		desc->stats.high_water = desc->stats.used;
+#endif
+
+	return block;
+}
+
+/**
+ * @brief Give a block back to the pool
+ *
+ * Callers that fall back to the heap when the pool is empty or not used can
+ * free any block with:
+ *	if (pool_free(pool, block))
+ *		free(block);
+ *
+ * @param desc - Pool reference, may be NULL
+ * @param block - Block returned by pool_alloc()
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : If desc is NULL or the block does not belong to the pool
+ */
+int32_t pool_free(struct pool *desc, void *block)
+{
+	uintptr_t offset;
+
+	if (!desc || !block)
+		return -EINVAL;
+
+	offset = (uintptr_t)block - (uintptr_t)desc->mem;
+	if ((uintptr_t)block < (uintptr_t)desc->mem ||
+	    offset >= (uintptr_t)desc->stride * desc->nb_blocks ||
+	    offset % desc->stride)
+		return -EINVAL;
+
+	*(void **)block = desc->free_list;
+	desc->free_list = block;
+
+#ifndef POOL_NO_STATS
+	desc->stats.used--;
+#endif
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the usable size of a block
+ * @param desc - Pool reference, may be NULL
+ * @return Block size in bytes, 0 if desc is NULL
+ */
+uint32_t pool_block_size(struct pool *desc)
+{
+	return desc ? desc->block_size : 0;
+}
+
+/**
+ * @brief Get the usage statistics of the pool
+ * @param desc - Pool reference
+ * @param stats - Where to store the statistics
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : On invalid parameters
+ *  - -ENOSYS : If the library is built with POOL_NO_STATS
+ */
+int32_t pool_get_stats(struct pool *desc, struct pool_stats *stats)
+{
+	if (!desc || !stats)
+		return -EINVAL;
+
+#ifndef POOL_NO_STATS
+	*stats = desc->stats;
+
+	return SUCCESS;
+#else
+	return -ENOSYS;
+#endif
+}
@@ -0,0 +1,366 @@
+/***************************************************************************//**
+ *   @file   trace.c
+ *   @brief  Binary event tracing into per-core ring buffers.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include "trace.h"
+#include "error.h"
+#include "util.h"
+#include "uart.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Events copied out of a ring at a time by trace_drain() */
+#define TRACE_DRAIN_CHUNK	8
+/* Sync, id, core, number of arguments and timestamp */
+#define TRACE_FRAME_HDR_SIZE	10
+#define TRACE_FRAME_MAX_SIZE	(TRACE_FRAME_HDR_SIZE + 4 * TRACE_MAX_ARGS)
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct trace_ring
+ * @brief Ring of one core. Writers reserve a slot with an atomic increment of
+ * head, so events from interrupt handlers never wait for the interrupted code.
+ * Old events are overwritten when the reader falls behind.
+ */
+struct trace_ring {
+	/** Event storage */
+	struct trace_event	*events;
+	/** Number of events - 1 */
+	uint32_t		mask;
+	/** Index of the next event to be written */
+	uint32_t		head;
+	/** Index of the next event to be read */
+	uint32_t		tail;
+};
+
+/******************************************************************************/
+/***************************** Static variables *******************************/
+/******************************************************************************/
+
+static struct trace_ring trace_rings[TRACE_NB_CORES];
+static uint32_t (*trace_timestamp)(void);
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Allocate the rings and start recording events
+ * @param param - Initialization parameters
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : On invalid parameters or if tracing is already initialized
+ *  - -ENOMEM : If the rings could not be allocated
+ */
+int32_t trace_init(const struct trace_init_param *param)
+{
+	struct trace_event *events;
+	uint32_t i;
+
+	if (!param || !param->nb_events ||
+	    (param->nb_events & (param->nb_events - 1)))
+		return -EINVAL;
+
+	if (trace_rings[0].events)
+		return -EINVAL;
+
+	trace_timestamp = param->timestamp;
+
+	for (i = 0; i < TRACE_NB_CORES; i++) {
+		events = calloc(param->nb_events, sizeof(*events));
+		if (!events) {
+			trace_remove();
+			return -ENOMEM;
+		}
+		trace_rings[i].mask = param->nb_events - 1;
+		trace_rings[i].head = 0;
+		trace_rings[i].tail = 0;
+		__atomic_store_n(&trace_rings[i].events, events,
+				 __ATOMIC_RELEASE);
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Stop recording events and free the rings. No trace point may run
+ * concurrently.
+ */
+void trace_remove(void)
+{
+	struct trace_event *events;
+	uint32_t i;
+
+	for (i = 0; i < TRACE_NB_CORES; i++) {
+		events = trace_rings[i].events;
+		__atomic_store_n(&trace_rings[i].events, NULL,
+				 __ATOMIC_RELEASE);
+		free(events);
+	}
+}
+
+/**
+ * @brief Record an event in the ring of the calling core. Use the
+ * trace_event0() ... trace_event4() macros instead of calling this directly.
+ * @param id - Event id
+ * @param nb_args - Number of valid arguments
+ * @param a0 - First argument
+ * @param a1 - Second argument
+ * @param a2 - Third argument
+ * @param a3 - Fourth argument
+ */
+void trace_record(uint16_t id, uint8_t nb_args, uint32_t a0, uint32_t a1,
+		  uint32_t a2, uint32_t a3)
+{
+	struct trace_ring *ring = &trace_rings[TRACE_CORE_ID()];
+	struct trace_event *events;
+	struct trace_event *ev;
+	uint32_t idx;
+
+	events = __atomic_load_n(&ring->events, __ATOMIC_ACQUIRE);
+	if (!events)
+		return;
+
+	idx = __atomic_fetch_add(&ring->head, 1, __ATOMIC_RELAXED);
+	ev = &events[idx & ring->mask];
+
+	/* Mark the slot as incomplete before changing its content */
+	__atomic_store_n(&ev->seq, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	ev->timestamp = trace_timestamp ? trace_timestamp() : 0;
+	ev->id = id;
+	ev->nb_args = nb_args;
+	ev->core = TRACE_CORE_ID();
+	ev->args[0] = a0;
+	ev->args[1] = a1;
+	ev->args[2] = a2;
+	ev->args[3] = a3;
+
+	__atomic_store_n(&ev->seq, idx + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Copy the oldest unread events of a core out of its ring
+ *
+ * Reading stops at the first event that is still being written. There must
+ * be a single reader for each ring.
+ *
+ * @param core - Ring to read from
+ * @param events - Where to store the events
+ * @param max - Size of events
+ * @param nb_events - Number of events read
+ * @param nb_lost - Number of events overwritten before they could be read,
+ *		    may be NULL
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : On invalid parameters or if tracing is not initialized
+ */
+int32_t trace_read(uint8_t core, struct trace_event *events, uint32_t max,
+		   uint32_t *nb_events, uint32_t *nb_lost)
+{
+	struct trace_ring *ring;
+	struct trace_event *ev;
+	uint32_t head, tail, seq, lost = 0, n = 0;
+
+	if (core >= TRACE_NB_CORES || !events || !nb_events)
+		return -EINVAL;
+
+	ring = &trace_rings[core];
+	if (!ring->events)
+		return -EINVAL;
+
+	head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	tail = ring->tail;
+	if (head - tail > ring->mask + 1) {
+		lost = head - tail - (ring->mask + 1);
+		tail = head - (ring->mask + 1);
+	}
+
+	while (tail != head && n < max) {
+		ev = &ring->events[tail & ring->mask];
+		seq = __atomic_load_n(&ev->seq, __ATOMIC_ACQUIRE);
+		if (seq != tail + 1) {
+			/* A newer event already took the slot */
+			if ((int32_t)(seq - (tail + 1)) > 0) {
+				lost++;
+				tail++;
+				continue;
+			}
+			break;
+		}
+
+		events[n] = *ev;
+
+		/* The slot may have been reused while it was copied */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&ev->seq, __ATOMIC_RELAXED) != seq) {
+			lost++;
+			tail++;
+			continue;
+		}
+		n++;
+		tail++;
+	}
+
+	ring->tail = tail;
+	*nb_events = n;
+	if (nb_lost)
+		*nb_lost = lost;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Serialize an event as a little endian frame
+ * @param buf - Where to write the frame, TRACE_FRAME_MAX_SIZE bytes
+ * @param ev - The event
+ * @return Size of the frame
+ */
+static uint32_t trace_frame(uint8_t *buf, const struct trace_event *ev)
+{
+	uint32_t i, len = 0;
+
+	buf[len++] = TRACE_FRAME_SYNC & 0xFF;
+	buf[len++] = TRACE_FRAME_SYNC >> 8;
+	buf[len++] = ev->id & 0xFF;
+	buf[len++] = ev->id >> 8;
+	buf[len++] = ev->core;
+	buf[len++] = ev->nb_args;
+	for (i = 0; i < 4; i++)
+		buf[len++] = ev->timestamp >> (8 * i);
+	for (i = 0; i < 4 * ev->nb_args; i++)
+		buf[len++] = ev->args[i / 4] >> (8 * (i % 4));
+
+	return len;
+}
+
+/**
+ * @brief Write all unread events as binary frames, for example to a UART.
+ * tools/scripts/trace_decode.py turns the stream back into text.
+ *
+ * Each frame holds TRACE_FRAME_SYNC, the event id, core and number of
+ * arguments, the timestamp and the arguments, little endian. Lost events are
+ * reported with a TRACE_ID_LOST frame.
+ *
+ * @param write - Called with each chunk of frames
+ * @param ctx - First parameter of write
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - Negative error code from trace_read() or write otherwise
+ */
+int32_t trace_drain(int32_t (*write)(void *ctx, const uint8_t *data,
+				     uint32_t len), void *ctx)
+{
+	struct trace_event events[TRACE_DRAIN_CHUNK];
+	uint8_t buf[(TRACE_DRAIN_CHUNK + 1) * TRACE_FRAME_MAX_SIZE];
+	struct trace_event lost_ev = { 0 };
+	uint32_t core, i, n, lost, len;
+	int32_t ret;
+
+	if (!write)
+		return -EINVAL;
+
+	for (core = 0; core < TRACE_NB_CORES; core++) {
+		do {
+			ret = trace_read(core, events, TRACE_DRAIN_CHUNK, &n,
+					 &lost);
+			if (ret < 0)
+				return ret;
+
+			len = 0;
+			if (lost) {
+				lost_ev.id = TRACE_ID_LOST;
+				lost_ev.core = core;
+				lost_ev.nb_args = 1;
+				lost_ev.args[0] = lost;
+				lost_ev.timestamp = n ? events[0].timestamp : 0;
+				len += trace_frame(buf, &lost_ev);
+			}
+			for (i = 0; i < n; i++)
+				len += trace_frame(buf + len, &events[i]);
+
+			if (len) {
+				ret = write(ctx, buf, len);
+				if (ret < 0)
+					return ret;
+			}
+		} while (n == TRACE_DRAIN_CHUNK);
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief trace_drain() write callback sending the frames to a UART
+ * @param ctx - UART descriptor
+ * @param data - Frames
+ * @param len - Size of the frames
+ * @return Return code of uart_write()
+ */
+static int32_t trace_uart_write(void *ctx, const uint8_t *data, uint32_t len)
+{
+	return uart_write(ctx, data, len);
+}
+
+/**
+ * @brief Write all unread events as binary frames to a UART, see
+ * trace_drain(). Meant to be called from the main loop, uart_write() blocks.
+ * @param uart - UART descriptor
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : If uart is NULL
+ *  - Negative error code from trace_drain() otherwise
+ */
+int32_t trace_uart_drain(struct uart_desc *uart)
+{
+	if (!uart)
+		return -EINVAL;
+
+	return trace_drain(trace_uart_write, uart);
+}
@@ -0,0 +1,544 @@
+/***************************************************************************//**
+ *   @file   unpack.c
+ *   @brief  Unpack and deinterleave kernels for ADC sample formats.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stddef.h>
+#include "unpack.h"
+#include "error.h"
+
+#if defined(UNPACK_NEON)
+#include <arm_neon.h>
+#elif defined(UNPACK_SSE2)
+#include <emmintrin.h>
+#endif
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Sign-extend a value of bits width without relying on the
+ *	  implementation defined right shift of negative numbers.
+ * @param val - Value, bits above the width must be 0.
+ * @param bits - Width of the value.
+ * @return The sign-extended value.
+ */
+static inline uint32_t unpack_sext(uint32_t val, uint8_t bits)
+{
+	uint32_t m = (uint32_t)1 << (bits - 1);
+
+	return (val ^ m) - m;
+}
+
+/**
+ * @brief Bit by bit unpack of any width, used for the tails of the fast paths.
+ * @param dst - Destination.
+ * @param src - Packed samples, starting on a byte boundary.
+ * @param nb_samples - Number of samples.
+ * @param bits - Sample width, 1 to 32.
+ */
+static void unpack_generic(uint32_t *dst, const uint8_t *src,
+			   uint32_t nb_samples, uint8_t bits)
+{
+	uint64_t mask = ((uint64_t)1 << bits) - 1;
+	uint64_t acc = 0;
+	uint8_t nbits = 0;
+	uint32_t i;
+
+	for (i = 0; i < nb_samples; i++) {
+		while (nbits < bits) {
+			acc = (acc << 8) | *src++;
+			nbits += 8;
+		}
+		nbits -= bits;
+		dst[i] = (acc >> nbits) & mask;
+	}
+}
+
+/**
+ * @brief Unpack whole groups of samples that end on a byte boundary.
+ * @param dst - Destination.
+ * @param src - Packed samples.
+ * @param nb_samples - Number of samples.
+ * @param bits - Sample width.
+ * @return Number of samples unpacked, the rest is left to unpack_generic().
+ */
+static uint32_t unpack_groups(uint32_t *dst, const uint8_t *src,
+			      uint32_t nb_samples, uint8_t bits)
+{
+	const uint8_t *s = src;
+	uint32_t i = 0;
+
+	switch (bits) {
+	case 12:
+		for (; i + 2 <= nb_samples; i += 2, s += 3) {
+			dst[i] = ((uint32_t)s[0] << 4) | (s[1] >> 4);
+			dst[i + 1] = ((uint32_t)(s[1] & 0x0f) << 8) | s[2];
+		}
+		break;
+	case 16:
+#if defined(UNPACK_NEON)
+		for (; i + 8 <= nb_samples; i += 8, s += 16) {
+			uint16x8_t v;
+
+			v = vreinterpretq_u16_u8(vrev16q_u8(vld1q_u8(s)));
+			vst1q_u32(&dst[i], vmovl_u16(vget_low_u16(v)));
+			vst1q_u32(&dst[i + 4], vmovl_u16(vget_high_u16(v)));
+		}
+#elif defined(UNPACK_SSE2)
+		for (; i + 8 <= nb_samples; i += 8, s += 16) {
+			__m128i v = _mm_loadu_si128((const __m128i *)s);
+			__m128i zero = _mm_setzero_si128();
+
+			v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+			_mm_storeu_si128((__m128i *)&dst[i],
+					 _mm_unpacklo_epi16(v, zero));
+			_mm_storeu_si128((__m128i *)&dst[i + 4],
+					 _mm_unpackhi_epi16(v, zero));
+		}
+#endif
+		for (; i < nb_samples; i++, s += 2)
+			dst[i] = ((uint32_t)s[0] << 8) | s[1];
+		break;
+	case 18:
+		for (; i + 4 <= nb_samples; i += 4, s += 9) {
+			dst[i] = ((uint32_t)s[0] << 10) | ((uint32_t)s[1] << 2) |
+				 (s[2] >> 6);
+			dst[i + 1] = ((uint32_t)(s[2] & 0x3f) << 12) |
+				     ((uint32_t)s[3] << 4) | (s[4] >> 4);
+			dst[i + 2] = ((uint32_t)(s[4] & 0x0f) << 14) |
+				     ((uint32_t)s[5] << 6) | (s[6] >> 2);
+			dst[i + 3] = ((uint32_t)(s[6] & 0x03) << 16) |
+				     ((uint32_t)s[7] << 8) | s[8];
+		}
+		break;
+	case 20:
+		for (; i + 2 <= nb_samples; i += 2, s += 5) {
+			dst[i] = ((uint32_t)s[0] << 12) | ((uint32_t)s[1] << 4) |
+				 (s[2] >> 4);
+			dst[i + 1] = ((uint32_t)(s[2] & 0x0f) << 16) |
+				     ((uint32_t)s[3] << 8) | s[4];
+		}
+		break;
+	case 24:
+#if defined(UNPACK_NEON)
+		for (; i + 8 <= nb_samples; i += 8, s += 24) {
+			uint8x8x3_t b = vld3_u8(s);
+			uint16x8_t lo = vorrq_u16(vshll_n_u8(b.val[1], 8),
+						  vmovl_u8(b.val[2]));
+			uint16x8_t hi = vmovl_u8(b.val[0]);
+
+			vst1q_u32(&dst[i],
+				  vorrq_u32(vshll_n_u16(vget_low_u16(hi), 16),
+					    vmovl_u16(vget_low_u16(lo))));
+			vst1q_u32(&dst[i + 4],
+				  vorrq_u32(vshll_n_u16(vget_high_u16(hi), 16),
+					    vmovl_u16(vget_high_u16(lo))));
+		}
+#endif
+		for (; i < nb_samples; i++, s += 3)
+			dst[i] = ((uint32_t)s[0] << 16) | ((uint32_t)s[1] << 8) |
+				 s[2];
+		break;
+	case 26:
+		for (; i + 4 <= nb_samples; i += 4, s += 13) {
+			dst[i] = ((uint32_t)s[0] << 18) | ((uint32_t)s[1] << 10) |
+				 ((uint32_t)s[2] << 2) | (s[3] >> 6);
+			dst[i + 1] = ((uint32_t)(s[3] & 0x3f) << 20) |
+				     ((uint32_t)s[4] << 12) |
+				     ((uint32_t)s[5] << 4) | (s[6] >> 4);
+			dst[i + 2] = ((uint32_t)(s[6] & 0x0f) << 22) |
+				     ((uint32_t)s[7] << 14) |
+				     ((uint32_t)s[8] << 6) | (s[9] >> 2);
+			dst[i + 3] = ((uint32_t)(s[9] & 0x03) << 24) |
+				     ((uint32_t)s[10] << 16) |
+				     ((uint32_t)s[11] << 8) | s[12];
+		}
+		break;
+	default:
+		break;
+	}
+
+	return i;
+}
+
+/**
+ * @brief Unpack samples of bits width to zero-extended 32-bit values.
+ * @param dst - Destination, nb_samples values.
+ * @param src - Packed samples, MSB first.
+ * @param nb_samples - Number of samples.
+ * @param bits - Sample width, 1 to 32.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t unpack_u32(uint32_t *dst, const uint8_t *src, uint32_t nb_samples,
+		   uint8_t bits)
+{
+	uint32_t done;
+
+	if (!dst || !src || !bits || bits > 32)
+		return -EINVAL;
+
+	done = unpack_groups(dst, src, nb_samples, bits);
+	/* Groups end on a byte boundary */
+	unpack_generic(dst + done, src + (done * bits) / 8, nb_samples - done,
+		       bits);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Unpack samples of bits width to sign-extended 32-bit values.
+ * @param dst - Destination, nb_samples values.
+ * @param src - Packed two's complement samples, MSB first.
+ * @param nb_samples - Number of samples.
+ * @param bits - Sample width, 1 to 32.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t unpack_s32(int32_t *dst, const uint8_t *src, uint32_t nb_samples,
+		   uint8_t bits)
+{
+	uint32_t *udst = (uint32_t *)dst;
+	uint32_t i;
+	int32_t ret;
+
+	ret = unpack_u32(udst, src, nb_samples, bits);
+	if (ret != SUCCESS)
+		return ret;
+
+	if (bits < 32)
+		for (i = 0; i < nb_samples; i++)
+			udst[i] = unpack_sext(udst[i], bits);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Unpack samples of up to 16 bits to sign-extended 16-bit values.
+ * @param dst - Destination, nb_samples values.
+ * @param src - Packed two's complement samples, MSB first.
+ * @param nb_samples - Number of samples.
+ * @param bits - Sample width, 1 to 16.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t unpack_s16(int16_t *dst, const uint8_t *src, uint32_t nb_samples,
+		   uint8_t bits)
+{
+	uint32_t tmp[32];
+	uint32_t chunk;
+	uint32_t i;
+
+	if (!dst || !src || !bits || bits > 16)
+		return -EINVAL;
+
+	if (bits == 16)
+		return unpack_ljust16_s16(dst, src, nb_samples, 16);
+
+	/* Chunks of 32 samples end on a byte boundary for any width */
+	while (nb_samples) {
+		chunk = nb_samples < 32 ? nb_samples : 32;
+		unpack_u32(tmp, src, chunk, bits);
+		for (i = 0; i < chunk; i++)
+			dst[i] = (int16_t)unpack_sext(tmp[i], bits);
+		dst += chunk;
+		src += (chunk * bits) / 8;
+		nb_samples -= chunk;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Unpack left-justified samples to zero-extended 16-bit values.
+ * @param dst - Destination, nb_samples values.
+ * @param src - Big endian 16-bit words, the sample in the bits MSBs.
+ * @param nb_samples - Number of samples.
+ * @param bits - Sample width, 1 to 16.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t unpack_ljust16_u16(uint16_t *dst, const uint8_t *src,
+			   uint32_t nb_samples, uint8_t bits)
+{
+	uint8_t shift = 16 - bits;
+	uint32_t i = 0;
+
+	if (!dst || !src || !bits || bits > 16)
+		return -EINVAL;
+
+#if defined(UNPACK_NEON)
+	int16x8_t vshift = vdupq_n_s16(-shift);
+
+	for (; i + 8 <= nb_samples; i += 8) {
+		uint16x8_t v;
+
+		v = vreinterpretq_u16_u8(vrev16q_u8(vld1q_u8(&src[2 * i])));
+		vst1q_u16(&dst[i], vshlq_u16(v, vshift));
+	}
+#elif defined(UNPACK_SSE2)
+	__m128i vshift = _mm_cvtsi32_si128(shift);
+
+	for (; i + 8 <= nb_samples; i += 8) {
+		__m128i v = _mm_loadu_si128((const __m128i *)&src[2 * i]);
+
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+		_mm_storeu_si128((__m128i *)&dst[i], _mm_srl_epi16(v, vshift));
+	}
+#endif
+	for (; i < nb_samples; i++)
+		dst[i] = (((uint16_t)src[2 * i] << 8) | src[2 * i + 1]) >> shift;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Unpack left-justified samples to sign-extended 16-bit values.
+ * @param dst - Destination, nb_samples values.
+ * @param src - Big endian 16-bit words, the two's complement sample in the
+ *		bits MSBs.
+ * @param nb_samples - Number of samples.
+ * @param bits - Sample width, 1 to 16.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t unpack_ljust16_s16(int16_t *dst, const uint8_t *src,
+			   uint32_t nb_samples, uint8_t bits)
+{
+	uint16_t *udst = (uint16_t *)dst;
+	uint32_t i = 0;
+	int32_t ret;
+
+	ret = unpack_ljust16_u16(udst, src, nb_samples, bits);
+	if (ret != SUCCESS || bits == 16)
+		return ret;
+
+#if defined(UNPACK_NEON)
+	int16x8_t vshift = vdupq_n_s16(16 - bits);
+
+	for (; i + 8 <= nb_samples; i += 8) {
+		int16x8_t v = vreinterpretq_s16_u16(vld1q_u16(&udst[i]));
+
+		/* Move the sign bit up and back down arithmetically */
+		v = vshlq_s16(vshlq_s16(v, vshift), vnegq_s16(vshift));
+		vst1q_s16(&dst[i], v);
+	}
+#elif defined(UNPACK_SSE2)
+	__m128i vshift = _mm_cvtsi32_si128(16 - bits);
+
+	for (; i + 8 <= nb_samples; i += 8) {
+		__m128i v = _mm_loadu_si128((const __m128i *)&udst[i]);
+
+		v = _mm_sra_epi16(_mm_sll_epi16(v, vshift), vshift);
+		_mm_storeu_si128((__m128i *)&dst[i], v);
+	}
+#endif
+	for (; i < nb_samples; i++)
+		udst[i] = unpack_sext(udst[i], bits);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Keep the enabled channels out of interleaved 32-bit words.
+ * @param dst - Destination, one value per enabled channel word.
+ * @param src - Interleaved words, starting with channel 0.
+ * @param nb_words - Number of words, a partial last scan is allowed.
+ * @param nb_channels - Number of words in a scan, 1 to 32.
+ * @param ch_mask - Channels to keep.
+ * @param shift - Right shift applied to each word before truncating it to 16
+ *		  bits.
+ * @return Number of values stored.
+ */
+uint32_t unpack_select_u32_u16(uint16_t *dst, const uint32_t *src,
+			       uint32_t nb_words, uint8_t nb_channels,
+			       uint32_t ch_mask, uint8_t shift)
+{
+	uint32_t all = nb_channels < 32 ? ((uint32_t)1 << nb_channels) - 1 :
+		       0xffffffff;
+	uint32_t i = 0, j = 0;
+	uint8_t ch;
+
+	if (!nb_channels || nb_channels > 32)
+		return 0;
+
+	ch_mask &= all;
+	if (ch_mask == all) {
+#if defined(UNPACK_NEON)
+		int32x4_t vshift = vdupq_n_s32(-shift);
+
+		for (; i + 8 <= nb_words; i += 8) {
+			uint16x4_t lo = vmovn_u32(vshlq_u32(vld1q_u32(&src[i]),
+							    vshift));
+			uint16x4_t hi = vmovn_u32(vshlq_u32(vld1q_u32(&src[i + 4]),
+							    vshift));
+
+			vst1q_u16(&dst[i], vcombine_u16(lo, hi));
+		}
+#elif defined(UNPACK_SSE2)
+		__m128i vshift = _mm_cvtsi32_si128(shift);
+
+		for (; i + 8 <= nb_words; i += 8) {
+			__m128i lo = _mm_loadu_si128((const __m128i *)&src[i]);
+			__m128i hi = _mm_loadu_si128((const __m128i *)&src[i + 4]);
+
+			/* Sign-extend the low halves so packs keeps them */
+			lo = _mm_srl_epi32(lo, vshift);
+			hi = _mm_srl_epi32(hi, vshift);
+			lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+			hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+			_mm_storeu_si128((__m128i *)&dst[i],
+					 _mm_packs_epi32(lo, hi));
+		}
+#endif
+		for (; i < nb_words; i++)
+			dst[i] = src[i] >> shift;
+
+		return nb_words;
+	}
+
+	ch = 0;
+	for (i = 0; i < nb_words; i++) {
+		if (ch_mask & ((uint32_t)1 << ch))
+			dst[j++] = src[i] >> shift;
+		if (++ch == nb_channels)
+			ch = 0;
+	}
+
+	return j;
+}
+
+/**
+ * @brief Split interleaved 16-bit scans into one array per channel.
+ * @param dst - One destination array of nb_scans values per channel.
+ * @param src - Interleaved scans.
+ * @param nb_channels - Number of channels in a scan.
+ * @param nb_scans - Number of scans.
+ */
+void deinterleave_u16(uint16_t **dst, const uint16_t *src,
+		      uint8_t nb_channels, uint32_t nb_scans)
+{
+	uint32_t i = 0;
+	uint8_t ch;
+
+#if defined(UNPACK_NEON)
+	if (nb_channels == 2) {
+		for (; i + 8 <= nb_scans; i += 8) {
+			uint16x8x2_t v = vld2q_u16(&src[2 * i]);
+
+			vst1q_u16(&dst[0][i], v.val[0]);
+			vst1q_u16(&dst[1][i], v.val[1]);
+		}
+	} else if (nb_channels == 4) {
+		for (; i + 8 <= nb_scans; i += 8) {
+			uint16x8x4_t v = vld4q_u16(&src[4 * i]);
+
+			for (ch = 0; ch < 4; ch++)
+				vst1q_u16(&dst[ch][i], v.val[ch]);
+		}
+	}
+#elif defined(UNPACK_SSE2)
+	if (nb_channels == 2) {
+		for (; i + 8 <= nb_scans; i += 8) {
+			__m128i a = _mm_loadu_si128((const __m128i *)&src[2 * i]);
+			__m128i b = _mm_loadu_si128((const __m128i *)&src[2 * i + 8]);
+			__m128i even, odd;
+
+			even = _mm_packs_epi32(
+				       _mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+				       _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+			odd = _mm_packs_epi32(_mm_srai_epi32(a, 16),
+					      _mm_srai_epi32(b, 16));
+			_mm_storeu_si128((__m128i *)&dst[0][i], even);
+			_mm_storeu_si128((__m128i *)&dst[1][i], odd);
+		}
+	}
+#endif
+	for (; i < nb_scans; i++)
+		for (ch = 0; ch < nb_channels; ch++)
+			dst[ch][i] = src[i * nb_channels + ch];
+}
+
+/**
+ * @brief Split interleaved 32-bit scans into one array per channel.
+ * @param dst - One destination array of nb_scans values per channel.
+ * @param src - Interleaved scans.
+ * @param nb_channels - Number of channels in a scan.
+ * @param nb_scans - Number of scans.
+ */
+void deinterleave_u32(uint32_t **dst, const uint32_t *src,
+		      uint8_t nb_channels, uint32_t nb_scans)
+{
+	uint32_t i = 0;
+	uint8_t ch;
+
+#if defined(UNPACK_NEON)
+	if (nb_channels == 2) {
+		for (; i + 4 <= nb_scans; i += 4) {
+			uint32x4x2_t v = vld2q_u32(&src[2 * i]);
+
+			vst1q_u32(&dst[0][i], v.val[0]);
+			vst1q_u32(&dst[1][i], v.val[1]);
+		}
+	} else if (nb_channels == 4) {
+		for (; i + 4 <= nb_scans; i += 4) {
+			uint32x4x4_t v = vld4q_u32(&src[4 * i]);
+
+			for (ch = 0; ch < 4; ch++)
+				vst1q_u32(&dst[ch][i], v.val[ch]);
+		}
+	}
+#elif defined(UNPACK_SSE2)
+	if (nb_channels == 2) {
+		for (; i + 4 <= nb_scans; i += 4) {
+			__m128i a = _mm_loadu_si128((const __m128i *)&src[2 * i]);
+			__m128i b = _mm_loadu_si128((const __m128i *)&src[2 * i + 4]);
+			__m128i lo = _mm_unpacklo_epi32(a, b);
+			__m128i hi = _mm_unpackhi_epi32(a, b);
+
+			/* lo and hi hold both channels of scans 0, 2 and 1, 3 */
+			_mm_storeu_si128((__m128i *)&dst[0][i],
+					 _mm_unpacklo_epi32(lo, hi));
+			_mm_storeu_si128((__m128i *)&dst[1][i],
+					 _mm_unpackhi_epi32(lo, hi));
+		}
+	}
+#endif
+	for (; i < nb_scans; i++)
+		for (ch = 0; ch < nb_channels; ch++)
+			dst[ch][i] = src[i * nb_channels + ch];
+}